@@ -25,9 +25,9 @@ Abstract:
 #define XNAMATH_VERSION 201
 
 #if !defined(_XM_X64_) && !defined(_XM_X86_)
-#if defined(_M_AMD64) || defined(_AMD64_)
+#if defined(_M_AMD64) || defined(_AMD64_) || defined(__x86_64__)
 #define _XM_X64_
-#elif defined(_M_IX86) || defined(_X86_)
+#elif defined(_M_IX86) || defined(_X86_) || defined(__i386__)
 #define _XM_X86_
 #endif
 #endif
@@ -65,7 +65,23 @@ Abstract:
 #pragma warning(pop)
 #endif
 
+#if defined(_MSC_VER)
 #include <sal.h>
+#else
+// SAL annotations are MSVC only; undefined again at the end of this file
+#define __in
+#define __in_z
+#define __in_ecount(size)
+#define __in_bcount(size)
+#define __out
+#define __out_ecount(size)
+#define __out_bcount(size)
+#endif
+
+// GCC/Clang implement the XMVECTOR (__m128) operators natively
+#if defined(__GNUC__) && !defined(XM_NO_OPERATOR_OVERLOADS)
+#define XM_NO_OPERATOR_OVERLOADS
+#endif
 
 #if !defined(XMINLINE)
 #if !defined(XM_NO_MISALIGNED_VECTOR_ACCESS)
@@ -2857,7 +2873,7 @@ XMFINLINE XMVECTOR XMVectorInsert(FXMVECTOR VD, FXMVECTOR VS, UINT VSLeftRotateE
 }
 
 // Implemented for VMX128 intrinsics as #defines aboves
-#endif _XM_NO_INTRINSICS_ || _XM_SSE_INTRINSICS_
+#endif // _XM_NO_INTRINSICS_ || _XM_SSE_INTRINSICS_
 
 //------------------------------------------------------------------------------
 
@@ -2962,6 +2978,108 @@ XMFINLINE XMVECTOR XMVectorReciprocal
 
 //------------------------------------------------------------------------------
 
+XMFINLINE XMVECTOR XMVectorReciprocalEst
+(
+    FXMVECTOR V
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = 1.0f / V.vector4_f32[0];
+    Result.vector4_f32[1] = 1.0f / V.vector4_f32[1];
+    Result.vector4_f32[2] = 1.0f / V.vector4_f32[2];
+    Result.vector4_f32[3] = 1.0f / V.vector4_f32[3];
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+	return _mm_rcp_ps(V);
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorReciprocalSqrtEst
+(
+    FXMVECTOR V
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = 1.0f / sqrtf(V.vector4_f32[0]);
+    Result.vector4_f32[1] = 1.0f / sqrtf(V.vector4_f32[1]);
+    Result.vector4_f32[2] = 1.0f / sqrtf(V.vector4_f32[2]);
+    Result.vector4_f32[3] = 1.0f / sqrtf(V.vector4_f32[3]);
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+	return _mm_rsqrt_ps(V);
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorMultiplyAdd
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2, 
+    FXMVECTOR V3
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = V1.vector4_f32[0] * V2.vector4_f32[0] + V3.vector4_f32[0];
+    Result.vector4_f32[1] = V1.vector4_f32[1] * V2.vector4_f32[1] + V3.vector4_f32[1];
+    Result.vector4_f32[2] = V1.vector4_f32[2] * V2.vector4_f32[2] + V3.vector4_f32[2];
+    Result.vector4_f32[3] = V1.vector4_f32[3] * V2.vector4_f32[3] + V3.vector4_f32[3];
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+	XMVECTOR vResult = _mm_mul_ps( V1, V2 );
+	return _mm_add_ps( vResult, V3 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorNegativeMultiplySubtract
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2, 
+    FXMVECTOR V3
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = V3.vector4_f32[0] - (V1.vector4_f32[0] * V2.vector4_f32[0]);
+    Result.vector4_f32[1] = V3.vector4_f32[1] - (V1.vector4_f32[1] * V2.vector4_f32[1]);
+    Result.vector4_f32[2] = V3.vector4_f32[2] - (V1.vector4_f32[2] * V2.vector4_f32[2]);
+    Result.vector4_f32[3] = V3.vector4_f32[3] - (V1.vector4_f32[3] * V2.vector4_f32[3]);
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+	XMVECTOR R = _mm_mul_ps( V1, V2 );
+	return _mm_sub_ps( V3, R );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
 XMFINLINE VOID XMStoreFloat4A
 (
     XMFLOAT4A*   pDestination, 
@@ -2987,6 +3105,375 @@ XMFINLINE VOID XMStoreFloat4A
 #endif // _XM_VMX128_INTRINSICS_
 }
 
+//------------------------------------------------------------------------------
+
+XMFINLINE VOID XMStoreFloat2
+(
+    XMFLOAT2*    pDestination, 
+    FXMVECTOR     V
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMASSERT(pDestination);
+
+    pDestination->x = V.vector4_f32[0];
+    pDestination->y = V.vector4_f32[1];
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMASSERT(pDestination);
+
+    _mm_storel_pi( (__m64*)pDestination, V );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE VOID XMStoreFloat
+(
+    FLOAT*       pDestination, 
+    FXMVECTOR     V
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMASSERT(pDestination);
+
+    *pDestination = V.vector4_f32[0];
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMASSERT(pDestination);
+
+    _mm_store_ss( pDestination, V );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorSelect
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2, 
+    FXMVECTOR Control
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_u32[0] = (V1.vector4_u32[0] & ~Control.vector4_u32[0]) | (V2.vector4_u32[0] & Control.vector4_u32[0]);
+    Result.vector4_u32[1] = (V1.vector4_u32[1] & ~Control.vector4_u32[1]) | (V2.vector4_u32[1] & Control.vector4_u32[1]);
+    Result.vector4_u32[2] = (V1.vector4_u32[2] & ~Control.vector4_u32[2]) | (V2.vector4_u32[2] & Control.vector4_u32[2]);
+    Result.vector4_u32[3] = (V1.vector4_u32[3] & ~Control.vector4_u32[3]) | (V2.vector4_u32[3] & Control.vector4_u32[3]);
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMVECTOR vTemp1 = _mm_andnot_ps(Control,V1);
+    XMVECTOR vTemp2 = _mm_and_ps(V2,Control);
+    return _mm_or_ps(vTemp1,vTemp2);
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorEqual
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Control;
+
+    Control.vector4_u32[0] = (V1.vector4_f32[0] == V2.vector4_f32[0]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[1] = (V1.vector4_f32[1] == V2.vector4_f32[1]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[2] = (V1.vector4_f32[2] == V2.vector4_f32[2]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[3] = (V1.vector4_f32[3] == V2.vector4_f32[3]) ? 0xFFFFFFFF : 0;
+
+    return Control;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    return _mm_cmpeq_ps( V1, V2 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorEqualR
+(
+    UINT*    pCR,
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+    UINT ux, uy, uz, uw, CR;
+    XMVECTOR Control;
+
+    XMASSERT( pCR );
+
+    ux = (V1.vector4_f32[0] == V2.vector4_f32[0]) ? 0xFFFFFFFFU : 0;
+    uy = (V1.vector4_f32[1] == V2.vector4_f32[1]) ? 0xFFFFFFFFU : 0;
+    uz = (V1.vector4_f32[2] == V2.vector4_f32[2]) ? 0xFFFFFFFFU : 0;
+    uw = (V1.vector4_f32[3] == V2.vector4_f32[3]) ? 0xFFFFFFFFU : 0;
+    CR = 0;
+    if (ux&uy&uz&uw)
+    {
+        // All elements are equal
+        CR = XM_CRMASK_CR6TRUE;
+    }
+    else if (!(ux|uy|uz|uw))
+    {
+        // All elements are not equal
+        CR = XM_CRMASK_CR6FALSE;
+    }
+    *pCR = CR;
+    Control.vector4_u32[0] = ux;
+    Control.vector4_u32[1] = uy;
+    Control.vector4_u32[2] = uz;
+    Control.vector4_u32[3] = uw;
+    return Control;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMASSERT( pCR );
+    XMVECTOR vTemp = _mm_cmpeq_ps(V1,V2);
+    UINT CR = 0;
+    int iTest = _mm_movemask_ps(vTemp);
+    if (iTest==0xf)
+    {
+        CR = XM_CRMASK_CR6TRUE;
+    }
+    else if (!iTest)
+    {
+        // All elements are not equal
+        CR = XM_CRMASK_CR6FALSE;
+    }
+    *pCR = CR;
+    return vTemp;
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorGreater
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Control;
+
+    Control.vector4_u32[0] = (V1.vector4_f32[0] > V2.vector4_f32[0]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[1] = (V1.vector4_f32[1] > V2.vector4_f32[1]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[2] = (V1.vector4_f32[2] > V2.vector4_f32[2]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[3] = (V1.vector4_f32[3] > V2.vector4_f32[3]) ? 0xFFFFFFFF : 0;
+
+    return Control;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    return _mm_cmpgt_ps( V1, V2 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorGreaterR
+(
+    UINT*    pCR,
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+    UINT ux, uy, uz, uw, CR;
+    XMVECTOR Control;
+
+    XMASSERT( pCR );
+
+    ux = (V1.vector4_f32[0] > V2.vector4_f32[0]) ? 0xFFFFFFFFU : 0;
+    uy = (V1.vector4_f32[1] > V2.vector4_f32[1]) ? 0xFFFFFFFFU : 0;
+    uz = (V1.vector4_f32[2] > V2.vector4_f32[2]) ? 0xFFFFFFFFU : 0;
+    uw = (V1.vector4_f32[3] > V2.vector4_f32[3]) ? 0xFFFFFFFFU : 0;
+    CR = 0;
+    if (ux&uy&uz&uw)
+    {
+        // All elements are greater
+        CR = XM_CRMASK_CR6TRUE;
+    }
+    else if (!(ux|uy|uz|uw))
+    {
+        // All elements are not greater
+        CR = XM_CRMASK_CR6FALSE;
+    }
+    *pCR = CR;
+    Control.vector4_u32[0] = ux;
+    Control.vector4_u32[1] = uy;
+    Control.vector4_u32[2] = uz;
+    Control.vector4_u32[3] = uw;
+    return Control;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMASSERT( pCR );
+    XMVECTOR vTemp = _mm_cmpgt_ps(V1,V2);
+    UINT CR = 0;
+    int iTest = _mm_movemask_ps(vTemp);
+    if (iTest==0xf)
+    {
+        CR = XM_CRMASK_CR6TRUE;
+    }
+    else if (!iTest)
+    {
+        // All elements are not greater
+        CR = XM_CRMASK_CR6FALSE;
+    }
+    *pCR = CR;
+    return vTemp;
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorLess
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Control;
+
+    Control.vector4_u32[0] = (V1.vector4_f32[0] < V2.vector4_f32[0]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[1] = (V1.vector4_f32[1] < V2.vector4_f32[1]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[2] = (V1.vector4_f32[2] < V2.vector4_f32[2]) ? 0xFFFFFFFF : 0;
+    Control.vector4_u32[3] = (V1.vector4_f32[3] < V2.vector4_f32[3]) ? 0xFFFFFFFF : 0;
+
+    return Control;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    return _mm_cmplt_ps( V1, V2 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorMin
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = (V1.vector4_f32[0] < V2.vector4_f32[0]) ? V1.vector4_f32[0] : V2.vector4_f32[0];
+    Result.vector4_f32[1] = (V1.vector4_f32[1] < V2.vector4_f32[1]) ? V1.vector4_f32[1] : V2.vector4_f32[1];
+    Result.vector4_f32[2] = (V1.vector4_f32[2] < V2.vector4_f32[2]) ? V1.vector4_f32[2] : V2.vector4_f32[2];
+    Result.vector4_f32[3] = (V1.vector4_f32[3] < V2.vector4_f32[3]) ? V1.vector4_f32[3] : V2.vector4_f32[3];
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    return _mm_min_ps( V1, V2 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorMax
+(
+    FXMVECTOR V1, 
+    FXMVECTOR V2
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    Result.vector4_f32[0] = (V1.vector4_f32[0] > V2.vector4_f32[0]) ? V1.vector4_f32[0] : V2.vector4_f32[0];
+    Result.vector4_f32[1] = (V1.vector4_f32[1] > V2.vector4_f32[1]) ? V1.vector4_f32[1] : V2.vector4_f32[1];
+    Result.vector4_f32[2] = (V1.vector4_f32[2] > V2.vector4_f32[2]) ? V1.vector4_f32[2] : V2.vector4_f32[2];
+    Result.vector4_f32[3] = (V1.vector4_f32[3] > V2.vector4_f32[3]) ? V1.vector4_f32[3] : V2.vector4_f32[3];
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    return _mm_max_ps( V1, V2 );
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorClamp
+(
+    FXMVECTOR V, 
+    FXMVECTOR Min, 
+    FXMVECTOR Max
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+
+    XMVECTOR Result;
+
+    XMASSERT(XMVector4LessOrEqual(Min, Max));
+
+    Result = XMVectorMax(Min, V);
+    Result = XMVectorMin(Max, Result);
+
+    return Result;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMVECTOR vResult;
+    XMASSERT(XMVector4LessOrEqual(Min, Max));
+    vResult = _mm_max_ps(Min,V);
+    vResult = _mm_min_ps(vResult,Max);
+    return vResult;
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+
+XMFINLINE XMVECTOR XMVectorAbs
+(
+    FXMVECTOR V
+)
+{
+#if defined(_XM_NO_INTRINSICS_)
+    XMVECTOR vResult = {
+        fabsf(V.vector4_f32[0]),
+        fabsf(V.vector4_f32[1]),
+        fabsf(V.vector4_f32[2]),
+        fabsf(V.vector4_f32[3])
+    };
+    return vResult;
+
+#elif defined(_XM_SSE_INTRINSICS_)
+    XMVECTOR vResult = _mm_setzero_ps();
+    vResult = _mm_sub_ps(vResult,V);
+    vResult = _mm_max_ps(vResult,V);
+    return vResult;
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+
+#if !defined(XM_NO_OPERATOR_OVERLOADS)
 
 //------------------------------------------------------------------------------
 
@@ -3082,6 +3569,8 @@ XMFINLINE XMVECTOR operator/
     return XMVectorMultiply(V1, InvV);
 }
 
+#endif // !XM_NO_OPERATOR_OVERLOADS
+
 //------------------------------------------------------------------------------
 // Initialize a vector with four floating point values
 XMFINLINE XMVECTOR XMVectorSet
@@ -3191,7 +3680,7 @@ XMFINLINE FLOAT XMVectorGetX(FXMVECTOR V)
 #if defined(_XM_NO_INTRINSICS_)
     return V.vector4_f32[0];
 #elif defined(_XM_SSE_INTRINSICS_)
-#if defined(_MSC_VER) && (_MSC_VER>=1500)
+#if (defined(_MSC_VER) && (_MSC_VER>=1500)) || defined(__GNUC__)
     return _mm_cvtss_f32(V);    
 #else
     return V.m128_f32[0];
@@ -3230,9 +3719,61 @@ XMFINLINE XMVECTOR XMVector4Reflect
 #endif // _XM_VMX128_INTRINSICS_
 }
 
+//------------------------------------------------------------------------------
+// Template forms of XMVectorSwizzle/XMVectorPermute (as in DirectXMath), the
+// element indices pick the instruction at compile time, see vswizzle.inl
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+#if defined(__SSE3__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace XMInternal
+{
+	#include "vswizzle.inl"
+}
+#endif
+
+template<UINT E0, UINT E1, UINT E2, UINT E3>
+XMFINLINE XMVECTOR XMVectorSwizzle(FXMVECTOR V)
+{
+#if defined(_XM_NO_INTRINSICS_)
+    return XMVectorSwizzle(V, E0, E1, E2, E3);
+#elif defined(_XM_SSE_INTRINSICS_)
+    return XMInternal::VSwizzle<E0,E1,E2,E3>(V);
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
+//------------------------------------------------------------------------------
+// 0-3 select from V1, 4-7 from V2
+
+template<UINT PermuteX, UINT PermuteY, UINT PermuteZ, UINT PermuteW>
+XMFINLINE XMVECTOR XMVectorPermute(FXMVECTOR V1, FXMVECTOR V2)
+{
+#if defined(_XM_NO_INTRINSICS_)
+    XMVECTORF32 vResult = { (PermuteX < 4 ? V1 : V2).vector4_f32[PermuteX & 3], (PermuteY < 4 ? V1 : V2).vector4_f32[PermuteY & 3],
+                            (PermuteZ < 4 ? V1 : V2).vector4_f32[PermuteZ & 3], (PermuteW < 4 ? V1 : V2).vector4_f32[PermuteW & 3] };
+    return vResult.v;
+#elif defined(_XM_SSE_INTRINSICS_)
+    return XMInternal::VPermute<PermuteX,PermuteY,PermuteZ,PermuteW>(V1, V2);
+#else // _XM_VMX128_INTRINSICS_
+#endif // _XM_VMX128_INTRINSICS_
+}
+
 
 
 #pragma warning(pop)
 
+#if !defined(_MSC_VER)
+#undef __in
+#undef __in_z
+#undef __in_ecount
+#undef __in_bcount
+#undef __out
+#undef __out_ecount
+#undef __out_bcount
+#endif
+
 #endif // __XNAMATH_H__
 
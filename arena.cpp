@@ -0,0 +1,157 @@
+//--------------------------------------------------------------------------------------
+// File: arena.cpp
+//
+// Aligned bump allocator on a reserved region of address space, see arena.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+#include "arena.h"
+
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+	#define MAP_ANONYMOUS		MAP_ANON
+#endif
+
+#if !defined(_WIN32) && !defined(MAP_NORESERVE)
+	#define MAP_NORESERVE		0
+#endif
+
+// granularity of the commits, and of the capacity
+static const size_t cArenaCommit = 64*1024;
+
+// alignment of the region with huge pages (x86-64 2 MB pages)
+static const size_t cArenaHugePage = 2*1024*1024;
+
+static inline size_t ArenaRoundUp(size_t bytes, size_t align)
+{
+	return (bytes + align - 1) & ~(align - 1);
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+bool ArenaInit(Arena *pArena, size_t capacity, bool hugePages)
+{
+	memset(pArena, 0x00, sizeof(*pArena));
+
+	capacity = ArenaRoundUp(capacity, cArenaCommit);
+
+#if defined(_WIN32)
+	SIZE_T largePage = hugePages ? GetLargePageMinimum() : 0;
+
+	// large pages can't be committed piecewise, the whole capacity is backed now
+	if (largePage)
+	{
+		SIZE_T size = ArenaRoundUp(capacity, largePage);
+
+		pArena->pMap = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+		if (pArena->pMap)
+		{
+			pArena->mapSize = size;
+			pArena->capacity = size;
+			pArena->committed = size;
+			pArena->hugePages = true;
+		}
+	}
+
+	if (!pArena->pMap)
+	{
+		pArena->pMap = VirtualAlloc(NULL, capacity, MEM_RESERVE, PAGE_READWRITE);
+		pArena->mapSize = capacity;
+		pArena->capacity = capacity;
+	}
+
+	if (!pArena->pMap)
+	{
+		return false;
+	}
+
+	pArena->pBase = (BYTE*)pArena->pMap;
+#else
+	// one huge page extra to align the start, pages are backed on first touch
+	size_t align = hugePages ? cArenaHugePage : 0;
+	size_t size = capacity + align;
+	void *pMap = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (pMap == MAP_FAILED)
+	{
+		return false;
+	}
+
+	pArena->pMap = pMap;
+	pArena->mapSize = size;
+	pArena->pBase = align ? (BYTE*)ArenaRoundUp((size_t)pMap, align) : (BYTE*)pMap;
+	pArena->capacity = capacity;
+	pArena->committed = capacity;
+
+#if defined(MADV_HUGEPAGE)
+	pArena->hugePages = hugePages && madvise(pArena->pBase, capacity, MADV_HUGEPAGE) == 0;
+#endif
+#endif
+
+	return true;
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+void* ArenaAlloc(Arena *pArena, size_t bytes, size_t align)
+{
+	size_t beg = ArenaRoundUp(pArena->used, align);
+	size_t end = beg + bytes;
+
+	if (!pArena->pBase || end > pArena->capacity || end < beg)
+	{
+		return NULL;
+	}
+
+#if defined(_WIN32)
+	if (end > pArena->committed)
+	{
+		size_t commit = ArenaRoundUp(end, cArenaCommit);
+
+		if (!VirtualAlloc(pArena->pBase + pArena->committed, commit - pArena->committed, MEM_COMMIT, PAGE_READWRITE))
+		{
+			return NULL;
+		}
+
+		pArena->committed = commit;
+	}
+#endif
+
+	pArena->used = end;
+
+	return pArena->pBase + beg;
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+void ArenaReset(Arena *pArena)
+{
+	pArena->used = 0;
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+void ArenaShutDown(Arena *pArena)
+{
+	if (pArena->pMap)
+	{
+#if defined(_WIN32)
+		VirtualFree(pArena->pMap, 0, MEM_RELEASE);
+#else
+		munmap(pArena->pMap, pArena->mapSize);
+#endif
+	}
+
+	memset(pArena, 0x00, sizeof(*pArena));
+}
@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------------
+// File: arena.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __ARENA__
+#define __ARENA__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Arena: one contiguous region of address space, reserved once and handed
+//	out front to back. Blocks are never freed one by one, ArenaReset takes
+//	them all back at once and keeps the pages for the next fill, ArenaShutDown
+//	returns the region to the OS.
+//
+//	ArenaInit		reserves capacity bytes, page aligned (2 MB with huge
+//					pages). Pages are backed as they are handed out
+//					(VirtualAlloc MEM_COMMIT, the first touch of an mmap).
+//					hugePages asks for MADV_HUGEPAGE on Linux, MEM_LARGE_PAGES
+//					on Windows (needs SeLockMemoryPrivilege and backs the
+//					whole capacity up front), the arena falls back to normal
+//					pages without them
+//	ArenaAlloc		bytes aligned to align (a power of 2, cArenaAlign for a
+//					cache line), NULL when the capacity is used up
+//	ArenaReset		every block is free again
+//	ArenaShutDown	releases the region, the Arena is zeroed
+///////////////////////////////////////////////////////////////////////////////
+
+const size_t cArenaAlign = 64;
+
+typedef struct Arena
+{
+	BYTE*				pBase;			// start of the handed out region
+	size_t				capacity;		// bytes reserved from pBase
+	size_t				committed;		// bytes backed from pBase
+	size_t				used;			// bytes handed out from pBase
+	void*				pMap;			// the reservation as the OS returned it
+	size_t				mapSize;
+	bool				hugePages;		// the region is on huge/large pages
+
+}	Arena;
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+extern bool ArenaInit(Arena *pArena, size_t capacity, bool hugePages);
+extern void* ArenaAlloc(Arena *pArena, size_t bytes, size_t align = cArenaAlign);
+extern void ArenaReset(Arena *pArena);
+extern void ArenaShutDown(Arena *pArena);
+
+#endif // #ifndef __ARENA__
@@ -0,0 +1,1913 @@
+//--------------------------------------------------------------------------------------
+// File: bench.cpp
+//
+// Headless benchmark runner. Times Cloth::TimeStep and the do_3band loops of every
+// math library with no DXUT, D3D or XAudio2 dependency (build with SIMD_HEADLESS)
+// and writes the results as CSV so they can be collected by a build farm.
+// The runtime dispatched builds (dispatch.h) the CPU supports are timed as well,
+// the one picked at startup is marked with '*'.
+//--------------------------------------------------------------------------------------
+
+#include "platform.h"
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include <float.h>
+#include "common.h"
+#include "arena.h"
+#include "cloth.h"
+#include "dispatch.h"
+#include "sine.h"
+#include "soa.h"
+#include "stream.h"
+#include "recip.h"
+#include "trans.h"
+#include "mat.h"
+#include "quat.h"
+#include "half.h"
+#include "callconv.h"
+
+//--------------------------------------------------------------------------------------
+// Consts & Defines
+//--------------------------------------------------------------------------------------
+
+// BenchTrans::func, picks the input range and the double reference
+#define	BENCH_TRANS_SIN				(0)
+#define	BENCH_TRANS_COS				(1)
+#define	BENCH_TRANS_SINCOS			(2)
+#define	BENCH_TRANS_EXP				(3)
+#define	BENCH_TRANS_LOG				(4)
+#define	BENCH_TRANS_POW				(5)
+#define	BENCH_TRANS_ATAN2			(6)
+
+// BenchMat functions
+#define	BENCH_MAT_FRAMES			(0)
+#define	BENCH_MAT_INVERT			(1)
+#define	BENCH_MAT_INVERT_AFFINE		(2)
+#define	BENCH_MAT_POINTS			(3)
+#define	BENCH_MAT_COUNT				(4)
+
+//--------------------------------------------------------------------------------------
+// Aux Structs
+//--------------------------------------------------------------------------------------
+
+typedef struct BenchLibrary
+{
+	const char*		name;
+	void			(*clothSimulate)(float fTimeStep, int reps, double *totalTimeOut);
+	void			(*clothShutDown)(void);
+	void			(*clothSetFastConstraints)(int newtonSteps);
+	int				(*clothGetPositions)(float *pXYZ, int maxParticles);
+	float			clothDamping[2];	// the solver's CLOTH_*_D1/D2, for the FPU reference
+	int				clothConstraintOrder;	// CLOTH_ORDER_*, for the FPU reference
+	void			(*processAudioBlock)(int beg, int end);
+	int				audioBanks;		// 4-track banks per register, the window shrinks to match
+
+}	BenchLibrary;
+
+typedef struct BenchSine
+{
+	const char*		name;
+	void			(*sinArray)(float *pIn, float *pOut, int count);
+
+}	BenchSine;
+
+typedef struct BenchSoa
+{
+	const char*		name;
+	void			(*soaArray)(float *pA, float *pB, float *pOut, int count);
+
+}	BenchSoa;
+
+typedef struct BenchStream
+{
+	const char*		name;
+	void			(*streamArray)(float *pA, float *pB, float *pC, float *pOut, int count);
+	int				offset;			// floats added to every pointer (misaligns them)
+
+}	BenchStream;
+
+typedef struct BenchRecip
+{
+	const char*		name;
+	void			(*recipArray)(float *pIn, float *pOut, int count);
+	bool			rsqrt;			// 1/sqrt(x) instead of 1/x
+
+}	BenchRecip;
+
+typedef struct BenchTrans
+{
+	const char*		name;
+	void			(*transArray)(float *pA, float *pB, float *pOut, int count);
+	int				func;			// BENCH_TRANS_*
+
+}	BenchTrans;
+
+// mat.h, NULL where a library has no such kernel
+typedef struct BenchMat
+{
+	const char*		name;
+	void			(*transformFrames)(const float *pLocal, const int *pParent, float *pWorld, int count);
+	void			(*invertFrames)(const float *pWorld, float *pOut, int count);
+	void			(*invertFramesAffine)(const float *pWorld, float *pOut, int count);
+	void			(*transformPoints)(const float *pMat, const float *pIn, float *pOut, int count);
+
+}	BenchMat;
+
+typedef struct BenchQuat
+{
+	const char*		name;
+	void			(*quatArray)(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	bool			slerp;			// nlerp otherwise
+	bool			soa;			// pQ0, pQ1 and pOut are Vec4x4 blocks
+
+}	BenchQuat;
+
+typedef struct BenchHalf
+{
+	const char*		name;
+	void			(*halfArray)(float *pX, void *pStore, int count);
+	bool			half;			// pStore holds Half4, Vec4 or Float3 otherwise
+	bool			verlet;			// pStore is read back (m_oldx), the vertices are only written
+
+}	BenchHalf;
+
+typedef struct BenchCall
+{
+	const char*		name;
+	void			(*chain)(int prim, bool live, int reps, double *totalTimeOut);
+
+}	BenchCall;
+
+// a cloth solver for -demo diff, with the Verlet damping it was built with
+typedef struct BenchDiffCloth
+{
+	void			(*clothSimulate)(float fTimeStep, int reps, double *totalTimeOut);
+	void			(*clothShutDown)(void);
+	void			(*clothSetFastConstraints)(int newtonSteps);
+	int				(*clothGetPositions)(float *pXYZ, int maxParticles);
+	float			clothDamping[2];
+	int				clothConstraintOrder;
+
+}	BenchDiffCloth;
+
+typedef struct BenchOptions
+{
+	bool			runAudio;
+	bool			runCloth;
+	bool			runMadd;
+	bool			runSine;
+	bool			runSoa;
+	bool			runStream;
+	bool			runRecip;
+	bool			runTrans;
+	bool			runMat;
+	bool			runQuat;
+	bool			runHalf;
+	bool			runCall;
+	bool			runStore;
+	bool			runDiff;
+	bool			runDenormal;
+	bool			hugePages;
+	int				reps;
+	int				warmup;
+	int				samples;
+	const char*		outFile;
+
+}	BenchOptions;
+
+//--------------------------------------------------------------------------------------
+// Globals
+//--------------------------------------------------------------------------------------
+
+extern __declspec(align(128))		AudioSampleStruct	g_AudioSample;
+
+// the MATHLIB_TYPE_* libraries first, then VCLASS_SIMDTYPE in double and its wide builds
+static const BenchLibrary g_benchLibs[] =
+{
+	{ "VMath",			CLOTH_VMATH::ClothSimulate,				CLOTH_VMATH::ClothShutDown,				CLOTH_VMATH::ClothSetFastConstraints,			CLOTH_VMATH::ClothGetPositions,			{ CLOTH_VMATH_D1, CLOTH_VMATH_D2 },			CLOTH_ORDER_SEQUENTIAL,	ProcessAudioBlockVMath,				1 },
+	{ "XNAMath",		CLOTH_XNAMATH::ClothSimulate,			CLOTH_XNAMATH::ClothShutDown,			CLOTH_XNAMATH::ClothSetFastConstraints,			CLOTH_XNAMATH::ClothGetPositions,			{ CLOTH_XNAMATH_D1, CLOTH_XNAMATH_D2 },			CLOTH_ORDER_SEQUENTIAL,	ProcessAudioBlockXNAMath,			1 },
+	{ "VClass",			CLOTH_VCLASS::ClothSimulate,			CLOTH_VCLASS::ClothShutDown,			CLOTH_VCLASS::ClothSetFastConstraints,			CLOTH_VCLASS::ClothGetPositions,			{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },			CLOTH_ORDER_SEQUENTIAL,	ProcessAudioBlockVClass,			1 },
+	{ "VClassTypedef",	CLOTH_VCLASS_TYPEDEF::ClothSimulate,	CLOTH_VCLASS_TYPEDEF::ClothShutDown,	CLOTH_VCLASS_TYPEDEF::ClothSetFastConstraints,	CLOTH_VCLASS_TYPEDEF::ClothGetPositions,	{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },	CLOTH_ORDER_SEQUENTIAL,	ProcessAudioBlockVClassTypedef,		1 },
+	{ "VClassSIMDType",	CLOTH_VCLASS_SIMDTYPE::ClothSimulate,	CLOTH_VCLASS_SIMDTYPE::ClothShutDown,	CLOTH_VCLASS_SIMDTYPE::ClothSetFastConstraints,	CLOTH_VCLASS_SIMDTYPE::ClothGetPositions,	{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },	CLOTH_ORDER_SEQUENTIAL,	ProcessAudioBlockVClassSIMDType,	1 },
+	{ "VClassSIMDTypeDouble",CLOTH_VCLASS_SIMDTYPE_DOUBLE::ClothSimulate,CLOTH_VCLASS_SIMDTYPE_DOUBLE::ClothShutDown,CLOTH_VCLASS_SIMDTYPE_DOUBLE::ClothSetFastConstraints,CLOTH_VCLASS_SIMDTYPE_DOUBLE::ClothGetPositions,{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },CLOTH_ORDER_SEQUENTIAL,ProcessAudioBlockVClassSIMDTypeDouble,1 },
+#if defined(VCLASS_SIMDTYPE_AVX)
+	{ "VClassSIMDType8",CLOTH_VCLASS_SIMDTYPE8::ClothSimulate,	CLOTH_VCLASS_SIMDTYPE8::ClothShutDown,	CLOTH_VCLASS_SIMDTYPE8::ClothSetFastConstraints,CLOTH_VCLASS_SIMDTYPE8::ClothGetPositions,{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },CLOTH_ORDER_SEQUENTIAL,ProcessAudioBlockVClassSIMDType8,	2 },
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	{ "VClassSIMDType16",CLOTH_VCLASS_SIMDTYPE16::ClothSimulate,CLOTH_VCLASS_SIMDTYPE16::ClothShutDown,	CLOTH_VCLASS_SIMDTYPE16::ClothSetFastConstraints,CLOTH_VCLASS_SIMDTYPE16::ClothGetPositions,{ CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 },CLOTH_ORDER_ROWS,ProcessAudioBlockVClassSIMDType16,	4 },
+#endif
+};
+
+static const int g_benchLibCount = sizeof(g_benchLibs)/sizeof(g_benchLibs[0]);
+
+// samples of the tracks before the silence in -demo denormal
+const int cBenchDenormalBurst = 64;
+
+// testsine.cpp's polynomial, VMATH against the class operators with and without expression templates
+static const BenchSine g_benchSines[] =
+{
+	{ "VMath/VSin",				SINE_VMATH::VSinArray },
+	{ "VMath/VSin2",			SINE_VMATH::VSin2Array },
+	{ "VClass",					SINE_VCLASS::VSinArray },
+	{ "VClass/expr",			SINE_VCLASS_EXPR::VSinArray },
+	{ "VClassSIMDType",			SINE_VCLASS_SIMDTYPE::VSinArray },
+	{ "VClassSIMDType/expr",	SINE_VCLASS_SIMDTYPE_EXPR::VSinArray },
+	{ "VMath/Sin",				SINE_VMATH::SinArray },
+	{ "libm/sinf",				SINE_LIBM::SinArray },
+};
+
+static const int g_benchSineCount = sizeof(g_benchSines)/sizeof(g_benchSines[0]);
+
+// VMATH one vector at a time against the Vec4x4 versions, transposing the AoS arrays, packed Float3 arrays or on SoA data
+static const BenchSoa g_benchSoas[] =
+{
+	{ "VMath/Dot",			SOA_VMATH::DotArray },
+	{ "VMath/Dot4",			SOA_VMATH::Dot4Array },
+	{ "VMath/Dot4SoA",		SOA_VMATH::Dot4SoAArray },
+	{ "VMath/Normalize",	SOA_VMATH::NormalizeArray },
+	{ "VMath/Normalize4",	SOA_VMATH::Normalize4Array },
+	{ "VMath/Normalize3",	SOA_VMATH::Normalize3Array },
+	{ "VMath/Reflect",		SOA_VMATH::ReflectArray },
+	{ "VMath/Reflect4",		SOA_VMATH::Reflect4Array },
+	{ "VMath/Reflect3",		SOA_VMATH::Reflect3Array },
+	{ "VMath/Reflect4SoA",	SOA_VMATH::Reflect4SoAArray },
+};
+
+static const int g_benchSoaCount = sizeof(g_benchSoas)/sizeof(g_benchSoas[0]);
+
+// hand written __m128 loops against VMATH::Stream, aligned and misaligned by one float
+static const BenchStream g_benchStreams[] =
+{
+	{ "VMath/MulAdd loop",				STREAM_VMATH::MulAddLoop,	0 },
+	{ "VMath/Stream::MulAdd",			STREAM_VMATH::MulAddStream,	0 },
+	{ "VMath/Stream::MulAdd unaligned",	STREAM_VMATH::MulAddStream,	1 },
+	{ "VMath/Dot loop",					STREAM_VMATH::DotLoop,		0 },
+	{ "VMath/Stream::Dot",				STREAM_VMATH::DotStream,	0 },
+	{ "VMath/Stream::Dot unaligned",	STREAM_VMATH::DotStream,	1 },
+	{ "VMath/Peak loop",				STREAM_VMATH::PeakLoop,		0 },
+	{ "VMath/Stream::Peak",				STREAM_VMATH::PeakStream,	0 },
+	{ "VMath/Energy loop",				STREAM_VMATH::EnergyLoop,	0 },
+	{ "VMath/Stream::SumSquares",		STREAM_VMATH::EnergyStream,	0 },
+};
+
+static const int g_benchStreamCount = sizeof(g_benchStreams)/sizeof(g_benchStreams[0]);
+
+// MulAdd with cached against non-temporal stores of pOut, for -demo nt
+static const BenchStream g_benchStores[] =
+{
+	{ "VMath/MulAdd loop",				STREAM_VMATH::MulAddLoop,		0 },
+	{ "VMath/MulAdd loop NT",			STREAM_VMATH::MulAddLoopNT,		0 },
+	{ "VMath/Stream::MulAdd",			STREAM_VMATH::MulAddStream,		0 },
+	{ "VMath/Stream::MulAddNT",			STREAM_VMATH::MulAddStreamNT,	0 },
+};
+
+static const int g_benchStoreCount = sizeof(g_benchStores)/sizeof(g_benchStores[0]);
+
+// Vec4 samples per array of -demo nt, 256 KB to 32 MB of output
+static const int g_benchStoreSamples[] = { 1 << 14, 1 << 18, 1 << 21 };
+
+static const int g_benchStoreSampleCount = sizeof(g_benchStoreSamples)/sizeof(g_benchStoreSamples[0]);
+
+// floats of the working set -demo nt reads back after every pass, 1 MB
+static const int cBenchStoreVictim = 1 << 18;
+
+// true division and square root against the estimates with 0, 1 and 2 Newton-Raphson steps
+static const BenchRecip g_benchRecips[] =
+{
+	{ "VMath/VReciprocal",			RECIP_VMATH::ReciprocalArray,			false },
+	{ "VMath/VReciprocalEst<0>",	RECIP_VMATH::ReciprocalEstArray<0>,		false },
+	{ "VMath/VReciprocalEst<1>",	RECIP_VMATH::ReciprocalEstArray<1>,		false },
+	{ "VMath/VReciprocalEst<2>",	RECIP_VMATH::ReciprocalEstArray<2>,		false },
+	{ "VMath/VReciprocal(Sqrt)",	RECIP_VMATH::RsqrtArray,				true },
+	{ "VMath/VRsqrtEst<0>",			RECIP_VMATH::RsqrtEstArray<0>,			true },
+	{ "VMath/VRsqrtEst<1>",			RECIP_VMATH::RsqrtEstArray<1>,			true },
+	{ "VMath/VRsqrtEst<2>",			RECIP_VMATH::RsqrtEstArray<2>,			true },
+};
+
+static const int g_benchRecipCount = sizeof(g_benchRecips)/sizeof(g_benchRecips[0]);
+
+// vtranscendental.inl against libm one float at a time
+static const BenchTrans g_benchTranss[] =
+{
+	{ "libm/sinf",					TRANS_LIBM::SinArray,						BENCH_TRANS_SIN },
+	{ "libm/cosf",					TRANS_LIBM::CosArray,						BENCH_TRANS_COS },
+	{ "libm/sinf+cosf",				TRANS_LIBM::SinCosArray,					BENCH_TRANS_SINCOS },
+	{ "libm/expf",					TRANS_LIBM::ExpArray,						BENCH_TRANS_EXP },
+	{ "libm/logf",					TRANS_LIBM::LogArray,						BENCH_TRANS_LOG },
+	{ "libm/powf",					TRANS_LIBM::PowArray,						BENCH_TRANS_POW },
+	{ "libm/atan2f",				TRANS_LIBM::Atan2Array,						BENCH_TRANS_ATAN2 },
+	{ "VMath/Sin",					TRANS_VMATH::SinArray,						BENCH_TRANS_SIN },
+	{ "VMath/Cos",					TRANS_VMATH::CosArray,						BENCH_TRANS_COS },
+	{ "VMath/SinCos",				TRANS_VMATH::SinCosArray,					BENCH_TRANS_SINCOS },
+	{ "VMath/Exp",					TRANS_VMATH::ExpArray,						BENCH_TRANS_EXP },
+	{ "VMath/Log",					TRANS_VMATH::LogArray,						BENCH_TRANS_LOG },
+	{ "VMath/Pow",					TRANS_VMATH::PowArray,						BENCH_TRANS_POW },
+	{ "VMath/Atan2",				TRANS_VMATH::Atan2Array,					BENCH_TRANS_ATAN2 },
+	{ "VClassSIMDType/Sin",			TRANS_VCLASS_SIMDTYPE::SinArray,			BENCH_TRANS_SIN },
+	{ "VClassSIMDType/Cos",			TRANS_VCLASS_SIMDTYPE::CosArray,			BENCH_TRANS_COS },
+	{ "VClassSIMDType/SinCos",		TRANS_VCLASS_SIMDTYPE::SinCosArray,			BENCH_TRANS_SINCOS },
+	{ "VClassSIMDType/Exp",			TRANS_VCLASS_SIMDTYPE::ExpArray,			BENCH_TRANS_EXP },
+	{ "VClassSIMDType/Log",			TRANS_VCLASS_SIMDTYPE::LogArray,			BENCH_TRANS_LOG },
+	{ "VClassSIMDType/Pow",			TRANS_VCLASS_SIMDTYPE::PowArray,			BENCH_TRANS_POW },
+	{ "VClassSIMDType/Atan2",		TRANS_VCLASS_SIMDTYPE::Atan2Array,			BENCH_TRANS_ATAN2 },
+#if defined(VCLASS_SIMDTYPE_AVX)
+	{ "VClassSIMDType8/Sin",		TRANS_VCLASS_SIMDTYPE8::SinArray,			BENCH_TRANS_SIN },
+	{ "VClassSIMDType8/Cos",		TRANS_VCLASS_SIMDTYPE8::CosArray,			BENCH_TRANS_COS },
+	{ "VClassSIMDType8/SinCos",		TRANS_VCLASS_SIMDTYPE8::SinCosArray,		BENCH_TRANS_SINCOS },
+	{ "VClassSIMDType8/Exp",		TRANS_VCLASS_SIMDTYPE8::ExpArray,			BENCH_TRANS_EXP },
+	{ "VClassSIMDType8/Log",		TRANS_VCLASS_SIMDTYPE8::LogArray,			BENCH_TRANS_LOG },
+	{ "VClassSIMDType8/Pow",		TRANS_VCLASS_SIMDTYPE8::PowArray,			BENCH_TRANS_POW },
+	{ "VClassSIMDType8/Atan2",		TRANS_VCLASS_SIMDTYPE8::Atan2Array,			BENCH_TRANS_ATAN2 },
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	{ "VClassSIMDType16/Sin",		TRANS_VCLASS_SIMDTYPE16::SinArray,			BENCH_TRANS_SIN },
+	{ "VClassSIMDType16/Cos",		TRANS_VCLASS_SIMDTYPE16::CosArray,			BENCH_TRANS_COS },
+	{ "VClassSIMDType16/SinCos",	TRANS_VCLASS_SIMDTYPE16::SinCosArray,		BENCH_TRANS_SINCOS },
+	{ "VClassSIMDType16/Exp",		TRANS_VCLASS_SIMDTYPE16::ExpArray,			BENCH_TRANS_EXP },
+	{ "VClassSIMDType16/Log",		TRANS_VCLASS_SIMDTYPE16::LogArray,			BENCH_TRANS_LOG },
+	{ "VClassSIMDType16/Pow",		TRANS_VCLASS_SIMDTYPE16::PowArray,			BENCH_TRANS_POW },
+	{ "VClassSIMDType16/Atan2",		TRANS_VCLASS_SIMDTYPE16::Atan2Array,		BENCH_TRANS_ATAN2 },
+#endif
+};
+
+static const int g_benchTransCount = sizeof(g_benchTranss)/sizeof(g_benchTranss[0]);
+
+// Mat4 against plain float loops, the wide VCLASS_SIMDTYPE builds only transform points
+static const BenchMat g_benchMats[] =
+{
+	{ "Scalar",				MAT_SCALAR::TransformFrames,			MAT_SCALAR::InvertFrames,			MAT_SCALAR::InvertFramesAffine,				MAT_SCALAR::TransformPoints },
+	{ "VMath",				MAT_VMATH::TransformFrames,				MAT_VMATH::InvertFrames,			MAT_VMATH::InvertFramesAffine,				MAT_VMATH::TransformPoints },
+	{ "VClassSIMDType",		MAT_VCLASS_SIMDTYPE::TransformFrames,	MAT_VCLASS_SIMDTYPE::InvertFrames,	MAT_VCLASS_SIMDTYPE::InvertFramesAffine,	MAT_VCLASS_SIMDTYPE::TransformPoints },
+#if defined(VCLASS_SIMDTYPE_AVX)
+	{ "VClassSIMDType8",	NULL,									NULL,								NULL,										MAT_VCLASS_SIMDTYPE8::TransformPoints },
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	{ "VClassSIMDType16",	NULL,									NULL,								NULL,										MAT_VCLASS_SIMDTYPE16::TransformPoints },
+#endif
+};
+
+static const int g_benchMatCount = sizeof(g_benchMats)/sizeof(g_benchMats[0]);
+
+// key interpolation one key at a time, 4 keys transposed on the fly, and on SoA data
+static const BenchQuat g_benchQuats[] =
+{
+	{ "Scalar/Nlerp",			QUAT_SCALAR::NlerpArray,			false,	false },
+	{ "VMath/QNlerp",			QUAT_VMATH::NlerpArray,				false,	false },
+	{ "VMath/QNlerp4",			QUAT_VMATH::Nlerp4Array,			false,	false },
+	{ "VMath/QNlerp4SoA",		QUAT_VMATH::Nlerp4SoAArray,			false,	true },
+	{ "Scalar/Slerp",			QUAT_SCALAR::SlerpArray,			true,	false },
+	{ "VMath/QSlerp",			QUAT_VMATH::SlerpArray,				true,	false },
+	{ "VMath/QSlerp4",			QUAT_VMATH::Slerp4Array,			true,	false },
+	{ "VMath/QSlerp4SoA",		QUAT_VMATH::Slerp4SoAArray,			true,	true },
+};
+
+static const int g_benchQuatCount = sizeof(g_benchQuats)/sizeof(g_benchQuats[0]);
+
+// float against half storage of m_oldx and the vertex positions
+static const BenchHalf g_benchHalfs[] =
+{
+	{ "VMath/Verlet/float",		HALF_VMATH::VerletFloat,	false,	true },
+	{ "VMath/Verlet/half",		HALF_VMATH::VerletHalf,		true,	true },
+	{ "VMath/Vertices/float3",	HALF_VMATH::VerticesFloat3,	false,	false },
+	{ "VMath/Vertices/half",	HALF_VMATH::VerticesHalf,	true,	false },
+};
+
+static const int g_benchHalfCount = sizeof(g_benchHalfs)/sizeof(g_benchHalfs[0]);
+
+// cloth widths of -demo half, 65 is the NDEBUG cloth, the larger ones put m_x and m_oldx past the L2
+static const int g_benchHalfWidths[] = { 65, 256, 512, 1024 };
+
+static const int g_benchHalfWidthCount = sizeof(g_benchHalfWidths)/sizeof(g_benchHalfWidths[0]);
+
+// the conventions of callconv.h this compiler has, inlined first
+static const BenchCall g_benchCalls[] =
+{
+	{ "inline",			CALL_INLINE::Chain },
+	{ "value",			CALL_VALUE::Chain },
+	{ "cref",			CALL_CREF::Chain },
+#if defined(CALLCONV_VECTORCALL)
+	{ "vectorcall",		CALL_VECTORCALL::Chain },
+#endif
+#if defined(CALLCONV_MSABI)
+	{ "ms_abi",			CALL_MSABI::Chain },
+#endif
+#if defined(CALLCONV_SYSV)
+	{ "sysv_abi",		CALL_SYSV::Chain },
+#endif
+};
+
+static const int g_benchCallCount = sizeof(g_benchCalls)/sizeof(g_benchCalls[0]);
+
+// indexed by CALL_PRIM_*
+static const char* const g_benchCallPrims[CALL_PRIM_COUNT] = { "VAdd", "VMAdd", "Dot", "MTransform" };
+
+//--------------------------------------------------------------------------------------
+// Synthetic 4 track PCM input (replaces the wav files loaded by LoadPCM)
+//--------------------------------------------------------------------------------------
+// the most 4-track banks an EQ of g_benchLibs filters, bank 0 is g_AudioSample's tracks
+static int BenchAudioBankCount(void)
+{
+	int	banks = 1;
+
+	for(int lib=0; lib<g_benchLibCount; lib++)
+	{
+		banks = (g_benchLibs[lib].audioBanks <= banks) ? banks : g_benchLibs[lib].audioBanks;
+	}
+
+	return banks;
+}
+
+// every bank gets its own 4 continuous tracks, each bank pitched up a little from the one before
+static void BenchAudioInit(int samples, bool hugePages)
+{
+	const float	cFreq[4] = { 55.f, 220.f, 440.f, 880.f };
+	int			banks = BenchAudioBankCount();
+
+	// 8 tracks of shorts and 2 of __m128 per bank, each rounded to a cache line
+	size_t	trackSize = ((size_t)samples*2 + cArenaAlign - 1) & ~(cArenaAlign - 1);
+	size_t	simdSize = (size_t)samples*sizeof(__m128);
+	size_t	bankSize = 8*trackSize + 2*simdSize;
+
+	if (!AudioSampleInit(banks*bankSize, hugePages))
+	{
+		fprintf(stderr, "audio: can't reserve the sample buffers\n");
+		exit(1);
+	}
+
+	for(int bank=0; bank<banks; bank++)
+	{
+		BYTE**	ppWavSrc = bank ? g_AudioSample.bank[bank - 1].pWavDataSrc : g_AudioSample.pWavDataSrc;
+		BYTE**	ppWavDest = bank ? g_AudioSample.bank[bank - 1].pWavDataDest : g_AudioSample.pWavDataDest;
+
+		for(int ch=0; ch<4; ch++)
+		{
+			short*	pTrack = (short*)AudioSampleAlloc(samples*2);
+			float	f = cFreq[ch]*(1.f + 0.25f*(float)bank);
+
+			for(int jj=0; jj<samples; jj++)
+			{
+				float	t = (float)jj / 44100.f;
+				float	s = sinf(2.f*3.1415926535f*f*t) + 0.25f*sinf(2.f*3.1415926535f*f*7.f*t);
+
+				pTrack[jj] = (short)(s*12000.f);
+			}
+
+			ppWavSrc[ch] = (BYTE*)pTrack;
+			ppWavDest[ch] = (BYTE*)AudioSampleAlloc(samples*2);
+		}
+
+		AudioSampleInterleaveBank(bank, samples);
+	}
+
+	for(int ch=0; ch<4; ch++)
+	{
+		g_AudioSample.wavSize[ch] = samples*2;
+	}
+
+	fprintf(stderr, "audio: %d samples of %d tracks, %.1f MB of buffers on %s pages\n", samples, 4*banks, (double)(banks*bankSize)/(1024.*1024.), AudioSampleHugePages() ? "huge" : "4 KB");
+}
+
+static void BenchAudioShutDown(void)
+{
+	AudioSampleShutDown();
+
+	memset(&g_AudioSample, 0x00, sizeof(g_AudioSample));
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+static void BenchReport(FILE* pOut, const char* demo, const char* lib, int reps, double totalTime)
+{
+	fprintf(pOut, "%s,%s,%d,%.6f,%.6f\n", demo, lib, reps, totalTime*1000., (totalTime/(double)reps)*1000.);
+}
+
+// -warmup untimed runs of call(), then the row of -reps timed ones
+template<class Call>
+static void BenchTimed(FILE* pOut, const BenchOptions& opt, const char* demo, const char* lib, const Call& call)
+{
+	for(int ii=0; ii<opt.warmup; ii++)
+	{
+		call();
+	}
+
+	double totalTime = 0.;
+
+	for(int ii=0; ii<opt.reps; ii++)
+	{
+		PerformanceCounterStart();
+
+		call();
+
+		totalTime += PerformanceCounterEnd();
+	}
+
+	BenchReport(pOut, demo, lib, opt.reps, totalTime);
+}
+
+static void BenchAudioLibrary(FILE* pOut, const BenchOptions& opt, const char* demo, const char* name, void (*initEQState)(void), void (*processAudioBlock)(int beg, int end), int audioBanks)
+{
+	int end = opt.samples/audioBanks - 1;
+
+	initEQState();
+
+	BenchTimed(pOut, opt, demo, name, [&]() { processAudioBlock(0, end); });
+}
+
+static void BenchClothLibrary(FILE* pOut, const BenchOptions& opt, const char* name, void (*clothSimulate)(float fTimeStep, int reps, double *totalTimeOut), void (*clothShutDown)(void))
+{
+	const float	timeStep = 1.f/60.f;
+	double		totalTime = 0.;
+
+	clothShutDown();
+	clothSimulate(timeStep, opt.warmup, &totalTime);
+	clothSimulate(timeStep, opt.reps, &totalTime);
+	clothShutDown();
+
+	BenchReport(pOut, "cloth", name, opt.reps, totalTime);
+}
+
+// dispatched VCLASS_SIMDTYPE builds the CPU can run, reported as VClassSIMDType@<isa>
+static void BenchDispatchName(char* name, size_t size, const SimdKernels* pKernels)
+{
+	snprintf(name, size, "VClassSIMDType@%s%s", pKernels->name, (pKernels == g_pSimdKernels) ? "*" : "");
+}
+
+static void BenchAudio(FILE* pOut, const BenchOptions& opt)
+{
+	BenchAudioInit(opt.samples, opt.hugePages);
+
+	for(int lib=0; lib<g_benchLibCount; lib++)
+	{
+		BenchAudioLibrary(pOut, opt, "audio", g_benchLibs[lib].name, InitEQStates, g_benchLibs[lib].processAudioBlock, g_benchLibs[lib].audioBanks);
+	}
+
+	BenchAudioLibrary(pOut, opt, "audio", "FPU", InitEQStates, ProcessAudioBlockFPU, 1);
+
+	for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+	{
+		const SimdKernels*	pKernels = SimdGetKernels(isa);
+		char				name[64];
+
+		BenchDispatchName(name, sizeof(name), pKernels);
+		BenchAudioLibrary(pOut, opt, "audio", name, pKernels->initEQState, pKernels->processAudioBlock, 1);
+	}
+
+	BenchAudioShutDown();
+}
+
+// one EQ with MXCSR as the caller left it, then under DenormalScope
+static void BenchDenormalLibrary(FILE* pOut, const BenchOptions& opt, const char* name, void (*initEQState)(void), void (*processAudioBlock)(int beg, int end), int audioBanks)
+{
+	char	row[80];
+
+	g_denormalFlush = false;
+	snprintf(row, sizeof(row), "%s/denormals", name);
+	BenchAudioLibrary(pOut, opt, "denormal", row, initEQState, processAudioBlock, audioBanks);
+
+	g_denormalFlush = true;
+	snprintf(row, sizeof(row), "%s/ftz", name);
+	BenchAudioLibrary(pOut, opt, "denormal", row, initEQState, processAudioBlock, audioBanks);
+}
+
+// The EQs on decaying silence: cBenchDenormalBurst samples of the tracks at the start
+// of every bank, zeros after.
+// Without EQ_DENORMAL_BIAS the poles decay into the denormals and stay there, once
+// lf times a pole rounds to 0 the pole stops moving. <library>/denormals runs with
+// FTZ/DAZ off and pays the assists on every sample of the silence, <library>/ftz
+// flushes the poles to zero.
+static void BenchDenormal(FILE* pOut, const BenchOptions& opt)
+{
+	BenchAudioInit(opt.samples, opt.hugePages);
+
+	// the interleaved copy for the SIMD EQs and the tracks for the FPU one
+	for(int bank=0; bank<BenchAudioBankCount(); bank++)
+	{
+		__m128*	pSIMDSrc = bank ? g_AudioSample.bank[bank - 1].pSIMDWavDataSrc : g_AudioSample.pSIMDWavDataSrc;
+		BYTE**	ppWavSrc = bank ? g_AudioSample.bank[bank - 1].pWavDataSrc : g_AudioSample.pWavDataSrc;
+
+		for(int ii=cBenchDenormalBurst; ii<opt.samples; ii++)
+		{
+			pSIMDSrc[ii] = _mm_setzero_ps();
+
+			for(int ch=0; ch<4; ch++)
+			{
+				((short*)ppWavSrc[ch])[ii] = 0;
+			}
+		}
+	}
+
+#ifdef EQ_DENORMAL_BIAS
+	fprintf(stderr, "denormal: built with EQ_DENORMAL_BIAS, vsa keeps the poles off the denormals\n");
+#endif
+
+	for(int lib=0; lib<g_benchLibCount; lib++)
+	{
+		BenchDenormalLibrary(pOut, opt, g_benchLibs[lib].name, InitEQStates, g_benchLibs[lib].processAudioBlock, g_benchLibs[lib].audioBanks);
+	}
+
+	BenchDenormalLibrary(pOut, opt, "FPU", InitEQStates, ProcessAudioBlockFPU, 1);
+
+	for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+	{
+		const SimdKernels*	pKernels = SimdGetKernels(isa);
+		char				name[64];
+
+		BenchDispatchName(name, sizeof(name), pKernels);
+		BenchDenormalLibrary(pOut, opt, name, pKernels->initEQState, pKernels->processAudioBlock, 1);
+	}
+
+	BenchAudioShutDown();
+}
+
+// the cloth with the constraints on VRsqrtEst and 0, 1, 2 Newton steps, reported as <library>/rsqrt+N
+static void BenchClothFast(FILE* pOut, const BenchOptions& opt)
+{
+	char	row[80];
+
+	for(int steps=0; steps<=2; steps++)
+	{
+		for(int lib=0; lib<g_benchLibCount; lib++)
+		{
+			snprintf(row, sizeof(row), "%s/rsqrt+%d", g_benchLibs[lib].name, steps);
+
+			g_benchLibs[lib].clothSetFastConstraints(steps);
+			BenchClothLibrary(pOut, opt, row, g_benchLibs[lib].clothSimulate, g_benchLibs[lib].clothShutDown);
+			g_benchLibs[lib].clothSetFastConstraints(CLOTH_CONSTRAINTS_EXACT);
+		}
+
+		for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+		{
+			const SimdKernels*	pKernels = SimdGetKernels(isa);
+			char				name[64];
+
+			BenchDispatchName(name, sizeof(name), pKernels);
+			snprintf(row, sizeof(row), "%s/rsqrt+%d", name, steps);
+
+			pKernels->clothSetFastConstraints(steps);
+			BenchClothLibrary(pOut, opt, row, pKernels->clothSimulate, pKernels->clothShutDown);
+			pKernels->clothSetFastConstraints(CLOTH_CONSTRAINTS_EXACT);
+		}
+	}
+}
+
+static void BenchCloth(FILE* pOut, const BenchOptions& opt)
+{
+	for(int lib=0; lib<g_benchLibCount; lib++)
+	{
+		BenchClothLibrary(pOut, opt, g_benchLibs[lib].name, g_benchLibs[lib].clothSimulate, g_benchLibs[lib].clothShutDown);
+	}
+
+	BenchClothLibrary(pOut, opt, "FPU", CLOTH_FPU::ClothSimulate, CLOTH_FPU::ClothShutDown);
+
+	for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+	{
+		const SimdKernels*	pKernels = SimdGetKernels(isa);
+		char				name[64];
+
+		BenchDispatchName(name, sizeof(name), pKernels);
+		BenchClothLibrary(pOut, opt, name, pKernels->clothSimulate, pKernels->clothShutDown);
+	}
+
+	BenchClothFast(pOut, opt);
+}
+
+// latency of the dependent x*a+b chain, separate mul+add against VMAdd
+static void BenchMadd(FILE* pOut, const BenchOptions& opt)
+{
+	for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+	{
+		const SimdKernels*	pKernels = SimdGetKernels(isa);
+		char				name[64];
+		char				row[80];
+
+		BenchDispatchName(name, sizeof(name), pKernels);
+
+		for(int fused=0; fused<2; fused++)
+		{
+			double	totalTime = 0.;
+
+			pKernels->maddLatency(opt.warmup, fused != 0, &totalTime);
+			totalTime = 0.;
+			pKernels->maddLatency(opt.reps, fused != 0, &totalTime);
+
+			snprintf(row, sizeof(row), "%s/%s", name, fused ? "madd" : "mul+add");
+			BenchReport(pOut, "madd", row, opt.reps, totalTime);
+		}
+	}
+}
+
+// VSin over -samples Vec4 of angles in [-pi, pi], the worst absolute error goes to stderr
+static void BenchSineArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		count = 4*opt.samples;
+	float*	pIn = (float*)new __m128[ opt.samples ];
+	float*	pSin = (float*)new __m128[ opt.samples ];
+
+	for(int ii=0; ii<count; ii++)
+	{
+		pIn[ii] = -3.14159265f + 6.2831853f*(float)ii/(float)count;
+	}
+
+	for(int lib=0; lib<g_benchSineCount; lib++)
+	{
+		BenchTimed(pOut, opt, "sine", g_benchSines[lib].name, [&]() { g_benchSines[lib].sinArray(pIn, pSin, count); });
+
+		double maxError = 0.;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			double err = fabs((double)pSin[ii] - sin((double)pIn[ii]));
+
+			maxError = (err > maxError) ? err : maxError;
+		}
+
+		fprintf(stderr, "sine accuracy: %s max abs error %.3g\n", g_benchSines[lib].name, maxError);
+	}
+
+	delete[] (__m128*)pIn;
+	delete[] (__m128*)pSin;
+}
+
+// AoS against SoA over -samples Vec4 (rounded down to a multiple of 4)
+static void BenchSoaArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		count = opt.samples & ~3;
+	float*	pA = (float*)new __m128[ count ];
+	float*	pB = (float*)new __m128[ count ];
+	float*	pRes = (float*)new __m128[ count ];
+
+	for(int ii=0; ii<4*count; ii++)
+	{
+		pA[ii] = 1.f + (float)(ii % 7);
+		pB[ii] = 0.5f - (float)(ii % 5)*0.25f;
+	}
+
+	for(int lib=0; lib<g_benchSoaCount; lib++)
+	{
+		BenchTimed(pOut, opt, "soa", g_benchSoas[lib].name, [&]() { g_benchSoas[lib].soaArray(pA, pB, pRes, count); });
+	}
+
+	delete[] (__m128*)pA;
+	delete[] (__m128*)pB;
+	delete[] (__m128*)pRes;
+}
+
+// 1/x and 1/sqrt(x) over 4*(-samples) floats in [1e-3, 1e3], the worst relative error
+// against double goes to stderr
+static void BenchRecipArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		count = 4*opt.samples;
+	float*	pIn = (float*)new __m128[ opt.samples ];
+	float*	pRes = (float*)new __m128[ opt.samples ];
+
+	for(int ii=0; ii<count; ii++)
+	{
+		pIn[ii] = (float)pow(10., -3. + 6.*(double)ii/(double)count);
+	}
+
+	for(int lib=0; lib<g_benchRecipCount; lib++)
+	{
+		const BenchRecip&	br = g_benchRecips[lib];
+
+		BenchTimed(pOut, opt, "rcp", br.name, [&]() { br.recipArray(pIn, pRes, count); });
+
+		double maxError = 0.;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			double ref = br.rsqrt ? 1./sqrt((double)pIn[ii]) : 1./(double)pIn[ii];
+			double err = fabs(((double)pRes[ii] - ref)/ref);
+
+			maxError = (err > maxError) ? err : maxError;
+		}
+
+		fprintf(stderr, "rcp accuracy: %s max relative error %.3g (%.1f bits)\n", br.name, maxError, (maxError > 0.) ? -log(maxError)/log(2.) : 24.);
+	}
+
+	delete[] (__m128*)pIn;
+	delete[] (__m128*)pRes;
+}
+
+// inputs of BENCH_TRANS_* over their documented range (vtranscendental.inl)
+static void BenchTransInput(int func, float* pA, float* pB, int count)
+{
+	unsigned int seed = 12345;
+
+	for(int ii=0; ii<count; ii++)
+	{
+		double	t = (double)ii/(double)count;
+
+		seed = seed*1664525u + 1013904223u;
+
+		switch(func)
+		{
+			case BENCH_TRANS_SIN:
+			case BENCH_TRANS_COS:
+			case BENCH_TRANS_SINCOS:
+				pA[ii] = (float)(-8192. + 16384.*t);
+				break;
+			case BENCH_TRANS_EXP:
+				pA[ii] = (float)(-87. + 175.*t);
+				break;
+			case BENCH_TRANS_LOG:
+				pA[ii] = (float)pow(2., -126. + 253.*t);
+				break;
+			case BENCH_TRANS_POW:
+				// x in [0.01, 100], y in [-8, 8]: |y*log(x)| <= 37
+				pA[ii] = (float)pow(10., -2. + 4.*t);
+				pB[ii] = -8.f + 16.f*(float)(seed >> 8)/16777216.f;
+				break;
+			case BENCH_TRANS_ATAN2:
+				pA[ii] = -100.f + 200.f*(float)(seed >> 8)/16777216.f;
+				pB[ii] = (float)(-100. + 200.*t);
+				break;
+		}
+	}
+}
+
+// double result pOut[ii] approximates, ii < 2*count for SinCos
+static double BenchTransReference(int func, const float* pA, const float* pB, int ii, int count)
+{
+	switch(func)
+	{
+		case BENCH_TRANS_SIN:		return sin((double)pA[ii]);
+		case BENCH_TRANS_COS:		return cos((double)pA[ii]);
+		case BENCH_TRANS_SINCOS:	return (ii < count) ? sin((double)pA[ii]) : cos((double)pA[ii - count]);
+		case BENCH_TRANS_EXP:		return exp((double)pA[ii]);
+		case BENCH_TRANS_LOG:		return log((double)pA[ii]);
+		case BENCH_TRANS_POW:		return pow((double)pA[ii], (double)pB[ii]);
+		case BENCH_TRANS_ATAN2:		return atan2((double)pA[ii], (double)pB[ii]);
+	}
+
+	return 0.;
+}
+
+// Sin/Cos/.../Atan2 over 4*(-samples) floats (rounded down to a multiple of 16),
+// the worst error in ulp of the float result goes to stderr
+static void BenchTransArrays(FILE* pOut, const BenchOptions& opt)
+{
+	// whole 16 float blocks for the AVX-512 kernels, at least one
+	int		count = (4*opt.samples + 15) & ~15;
+	float*	pA = (float*)_mm_malloc(count*sizeof(float), 64);
+	float*	pB = (float*)_mm_malloc(count*sizeof(float), 64);
+	float*	pRes = (float*)_mm_malloc(2*count*sizeof(float), 64);
+
+	for(int lib=0; lib<g_benchTransCount; lib++)
+	{
+		const BenchTrans&	bt = g_benchTranss[lib];
+		int					outCount = (bt.func == BENCH_TRANS_SINCOS) ? 2*count : count;
+
+		BenchTransInput(bt.func, pA, pB, count);
+
+		BenchTimed(pOut, opt, "trans", bt.name, [&]() { bt.transArray(pA, pB, pRes, count); });
+
+		double	maxUlp = 0.;
+		int		worst = 0;
+
+		for(int ii=0; ii<outCount; ii++)
+		{
+			double	ref = BenchTransReference(bt.func, pA, pB, ii, count);
+			float	reff = fabsf((float)ref);
+
+			if (reff > FLT_MAX)
+			{
+				continue;
+			}
+
+			double	ulp = (double)(nextafterf(reff, INFINITY) - reff);
+			double	err = fabs((double)pRes[ii] - ref)/ulp;
+
+			if (!(err <= maxUlp))
+			{
+				maxUlp = err;
+				worst = ii;
+			}
+		}
+
+		fprintf(stderr, "trans accuracy: %s max error %.2f ulp (at %g)\n", bt.name, maxUlp, pA[worst % count]);
+	}
+
+	_mm_free(pA);
+	_mm_free(pB);
+	_mm_free(pRes);
+}
+
+// inputs of -demo mat: a 4-ary hierarchy of frames rotated, scaled and translated
+// relative to their parent (the parent of ii is (ii-1)/4), points in [-10, 10]^3
+static void BenchMatInput(float* pLocal, int* pParent, int frames, float* pPoints, int count)
+{
+	unsigned int seed = 12345;
+
+	for(int ii=0; ii<frames; ii++)
+	{
+		double	ca = cos(0.37*ii), sa = sin(0.37*ii);
+		double	cb = cos(0.11*ii), sb = sin(0.11*ii);
+		double	s = 0.95 + 0.1*(double)(ii % 11)/10.;
+		float*	m = pLocal + 16*ii;
+
+		// Rz(a)*Rx(b)*s, D3DX row vectors
+		m[0] = (float)(s*ca);	m[1] = (float)(s*sa*cb);	m[2] = (float)(s*sa*sb);	m[3] = 0.f;
+		m[4] = (float)(-s*sa);	m[5] = (float)(s*ca*cb);	m[6] = (float)(s*ca*sb);	m[7] = 0.f;
+		m[8] = 0.f;				m[9] = (float)(-s*sb);		m[10] = (float)(s*cb);		m[11] = 0.f;
+		m[12] = (float)(1 + ii % 3);	m[13] = 0.5f*(float)(ii % 5) - 1.f;	m[14] = 0.25f*(float)(ii % 7);	m[15] = 1.f;
+
+		pParent[ii] = ii ? (ii - 1)/4 : -1;
+	}
+
+	for(int ii=0; ii<4*count; ii++)
+	{
+		seed = seed*1664525u + 1013904223u;
+
+		pPoints[ii] = ((ii & 3) == 3) ? 1.f : -10.f + 20.f*(float)(seed >> 8)/16777216.f;
+	}
+}
+
+// worst |m*inverse - I| in double over count matrices
+static double BenchMatResidual(const float* pMat, const float* pInv, int count)
+{
+	double maxError = 0.;
+
+	for(int ii=0; ii<count; ii++)
+	{
+		const float*	m = pMat + 16*ii;
+		const float*	r = pInv + 16*ii;
+
+		for(int row=0; row<4; row++)
+		{
+			for(int col=0; col<4; col++)
+			{
+				double	p = 0.;
+
+				for(int kk=0; kk<4; kk++)
+				{
+					p += (double)m[4*row + kk]*(double)r[4*kk + col];
+				}
+
+				double	err = fabs(p - ((row == col) ? 1. : 0.));
+
+				maxError = (err > maxError) ? err : maxError;
+			}
+		}
+	}
+
+	return maxError;
+}
+
+// worst |a - b|/max(1, |b|)
+static double BenchMatDiff(const float* pA, const float* pB, int count)
+{
+	double maxError = 0.;
+
+	for(int ii=0; ii<count; ii++)
+	{
+		double	ref = fabs((double)pB[ii]);
+		double	err = fabs((double)pA[ii] - (double)pB[ii])/((ref > 1.) ? ref : 1.);
+
+		maxError = (err > maxError) ? err : maxError;
+	}
+
+	return maxError;
+}
+
+// -samples frames through TransformFrames/InvertFrames/InvertFramesAffine and
+// 4*(-samples) points (rounded down to a multiple of 4) through the deepest world
+// matrix. The worst difference to the scalar loops (frames, points) and the worst
+// |M*inverse(M) - I| (inverses) go to stderr.
+static void BenchMatArrays(FILE* pOut, const BenchOptions& opt)
+{
+	static const char* const cOpNames[BENCH_MAT_COUNT] = { "TransformFrames", "InvertFrames", "InvertFramesAffine", "TransformPoints" };
+
+	int		frames = opt.samples;
+	int		count = 4*opt.samples & ~3;
+	int*	pParent = new int[ frames ];
+	float*	pLocal = (float*)_mm_malloc(16*frames*sizeof(float), 64);
+	float*	pWorld = (float*)_mm_malloc(16*frames*sizeof(float), 64);
+	float*	pIn = (float*)_mm_malloc(4*count*sizeof(float), 64);
+	float*	pRef = (float*)_mm_malloc(4*count*sizeof(float), 64);
+	float*	pRes = (float*)_mm_malloc(((16*frames > 4*count) ? 16*frames : 4*count)*sizeof(float), 64);
+	char	row[80];
+
+	BenchMatInput(pLocal, pParent, frames, pIn, count);
+
+	MAT_SCALAR::TransformFrames(pLocal, pParent, pWorld, frames);
+	MAT_SCALAR::TransformPoints(pWorld + 16*(frames - 1), pIn, pRef, count);
+
+	for(int op=0; op<BENCH_MAT_COUNT; op++)
+	{
+		for(int lib=0; lib<g_benchMatCount; lib++)
+		{
+			const BenchMat&	bm = g_benchMats[lib];
+
+			if ((op == BENCH_MAT_FRAMES && !bm.transformFrames) || (op == BENCH_MAT_INVERT && !bm.invertFrames) ||
+				(op == BENCH_MAT_INVERT_AFFINE && !bm.invertFramesAffine) || (op == BENCH_MAT_POINTS && !bm.transformPoints))
+			{
+				continue;
+			}
+
+			snprintf(row, sizeof(row), "%s/%s", bm.name, cOpNames[op]);
+			BenchTimed(pOut, opt, "mat", row, [&]()
+			{
+				switch(op)
+				{
+					case BENCH_MAT_FRAMES:			bm.transformFrames(pLocal, pParent, pRes, frames);						break;
+					case BENCH_MAT_INVERT:			bm.invertFrames(pWorld, pRes, frames);									break;
+					case BENCH_MAT_INVERT_AFFINE:	bm.invertFramesAffine(pWorld, pRes, frames);							break;
+					case BENCH_MAT_POINTS:			bm.transformPoints(pWorld + 16*(frames - 1), pIn, pRes, count);		break;
+				}
+			});
+
+			switch(op)
+			{
+				case BENCH_MAT_FRAMES:
+					fprintf(stderr, "mat accuracy: %s max relative difference to Scalar %.3g\n", row, BenchMatDiff(pRes, pWorld, 16*frames));
+					break;
+				case BENCH_MAT_INVERT:
+				case BENCH_MAT_INVERT_AFFINE:
+					fprintf(stderr, "mat accuracy: %s max |M*inverse - I| %.3g\n", row, BenchMatResidual(pWorld, pRes, frames));
+					break;
+				case BENCH_MAT_POINTS:
+					fprintf(stderr, "mat accuracy: %s max relative difference to Scalar %.3g\n", row, BenchMatDiff(pRes, pRef, 4*count));
+					break;
+			}
+		}
+	}
+
+	delete[] pParent;
+	_mm_free(pLocal);
+	_mm_free(pWorld);
+	_mm_free(pIn);
+	_mm_free(pRef);
+	_mm_free(pRes);
+}
+
+// count key pairs: random unit q0, q1 = q0 turned by up to pi (mostly by a little, as
+// animation keys are) with every 3rd q1 negated, t in [0, 1]
+static void BenchQuatInput(float* pQ0, float* pQ1, float* pT, int count)
+{
+	unsigned int seed = 12345;
+	double r[8];
+
+	for(int ii=0; ii<count; ii++)
+	{
+		for(int jj=0; jj<8; jj++)
+		{
+			seed = seed*1664525u + 1013904223u;
+			r[jj] = (double)(seed >> 8)/16777216.;
+		}
+
+		double	q[4] = { r[0] - 0.5, r[1] - 0.5, r[2] - 0.5, r[3] - 0.5 };
+		double	len = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+
+		// the turn: angle r4^2*pi around the axis (1, r5, r6)
+		double	a[3] = { 1., r[5] - 0.5, r[6] - 0.5 };
+		double	alen = sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+		double	half = 0.5*r[4]*r[4]*3.14159265358979323846;
+		double	d[4] = { sin(half)*a[0]/alen, sin(half)*a[1]/alen, sin(half)*a[2]/alen, cos(half) };
+		double	sign = (ii % 3 == 2) ? -1. : 1.;
+
+		for(int jj=0; jj<4; jj++)
+		{
+			q[jj] /= len;
+			pQ0[4*ii + jj] = (float)q[jj];
+		}
+
+		// Hamilton product d*q
+		pQ1[4*ii + 0] = (float)(sign*(d[3]*q[0] + d[0]*q[3] + d[1]*q[2] - d[2]*q[1]));
+		pQ1[4*ii + 1] = (float)(sign*(d[3]*q[1] - d[0]*q[2] + d[1]*q[3] + d[2]*q[0]));
+		pQ1[4*ii + 2] = (float)(sign*(d[3]*q[2] + d[0]*q[1] - d[1]*q[0] + d[2]*q[3]));
+		pQ1[4*ii + 3] = (float)(sign*(d[3]*q[3] - d[0]*q[0] - d[1]*q[1] - d[2]*q[2]));
+
+		pT[ii] = (float)r[7];
+	}
+}
+
+// double slerp/nlerp of key ii
+static void BenchQuatReference(const float* pQ0, const float* pQ1, const float* pT, int ii, bool slerp, double* pRef)
+{
+	const float*	q0 = pQ0 + 4*ii;
+	const float*	q1 = pQ1 + 4*ii;
+	double			t = pT[ii];
+	double			c = 0.;
+
+	for(int jj=0; jj<4; jj++)
+	{
+		c += (double)q0[jj]*(double)q1[jj];
+	}
+
+	double	sign = (c < 0.) ? -1. : 1.;
+	double	w0 = 1. - t;
+	double	w1 = t;
+
+	c *= sign;
+
+	if (slerp && c < 1.)
+	{
+		double theta = acos(c);
+
+		w0 = sin((1. - t)*theta)/sin(theta);
+		w1 = sin(t*theta)/sin(theta);
+	}
+
+	double len = 0.;
+
+	for(int jj=0; jj<4; jj++)
+	{
+		pRef[jj] = w0*q0[jj] + sign*w1*q1[jj];
+		len += pRef[jj]*pRef[jj];
+	}
+
+	for(int jj=0; jj<4; jj++)
+	{
+		pRef[jj] /= sqrt(len);
+	}
+}
+
+// -samples (rounded down to a multiple of 4) key pairs through nlerp and slerp, the
+// worst component error against double goes to stderr
+static void BenchQuatArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		count = opt.samples & ~3;
+	float*	pQ0 = (float*)new __m128[ count ];
+	float*	pQ1 = (float*)new __m128[ count ];
+	float*	pQ0SoA = (float*)new __m128[ count ];
+	float*	pQ1SoA = (float*)new __m128[ count ];
+	float*	pT = (float*)new __m128[ count/4 ];
+	float*	pRes = (float*)new __m128[ count ];
+
+	BenchQuatInput(pQ0, pQ1, pT, count);
+
+	// SoA blocks: x0 x1 x2 x3 y0 ... per 4 keys
+	for(int ii=0; ii<count; ii++)
+	{
+		for(int jj=0; jj<4; jj++)
+		{
+			pQ0SoA[16*(ii/4) + 4*jj + (ii & 3)] = pQ0[4*ii + jj];
+			pQ1SoA[16*(ii/4) + 4*jj + (ii & 3)] = pQ1[4*ii + jj];
+		}
+	}
+
+	for(int lib=0; lib<g_benchQuatCount; lib++)
+	{
+		const BenchQuat&	bq = g_benchQuats[lib];
+		float*				pA = bq.soa ? pQ0SoA : pQ0;
+		float*				pB = bq.soa ? pQ1SoA : pQ1;
+
+		BenchTimed(pOut, opt, "quat", bq.name, [&]() { bq.quatArray(pA, pB, pT, pRes, count); });
+
+		double maxError = 0.;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			double ref[4];
+
+			BenchQuatReference(pQ0, pQ1, pT, ii, bq.slerp, ref);
+
+			for(int jj=0; jj<4; jj++)
+			{
+				float	res = bq.soa ? pRes[16*(ii/4) + 4*jj + (ii & 3)] : pRes[4*ii + jj];
+				double	err = fabs((double)res - ref[jj]);
+
+				maxError = (err > maxError) ? err : maxError;
+			}
+		}
+
+		fprintf(stderr, "quat accuracy: %s max error %.3g\n", bq.name, maxError);
+	}
+
+	delete[] (__m128*)pQ0;
+	delete[] (__m128*)pQ1;
+	delete[] (__m128*)pQ0SoA;
+	delete[] (__m128*)pQ1SoA;
+	delete[] (__m128*)pT;
+	delete[] (__m128*)pRes;
+}
+
+// hand loops against VMATH::Stream over 4*(-samples) floats
+static void BenchStreamArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		count = 4*(opt.samples & ~3);
+	float*	pA = (float*)new __m128[ count/4 + 1 ];
+	float*	pB = (float*)new __m128[ count/4 + 1 ];
+	float*	pC = (float*)new __m128[ count/4 + 1 ];
+	float*	pRes = (float*)new __m128[ count/4 + 1 ];
+
+	for(int ii=0; ii<count+4; ii++)
+	{
+		pA[ii] = 1.f + (float)(ii % 7)*0.125f;
+		pB[ii] = 0.5f - (float)(ii % 5)*0.25f;
+		pC[ii] = (float)(ii % 3);
+	}
+
+	for(int lib=0; lib<g_benchStreamCount; lib++)
+	{
+		const BenchStream&	bs = g_benchStreams[lib];
+		int					o = bs.offset;
+
+		BenchTimed(pOut, opt, "stream", bs.name, [&]() { bs.streamArray(pA + o, pB + o, pC + o, pRes + o, count); });
+	}
+
+	delete[] (__m128*)pA;
+	delete[] (__m128*)pB;
+	delete[] (__m128*)pC;
+	delete[] (__m128*)pRes;
+}
+
+// MulAdd over large arrays with cached and non-temporal stores: the pass itself, then
+// a re-read of a working set that was resident before it, slower by what the output
+// pushed out of the cache
+static void BenchStoreArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		maxCount = 4*g_benchStoreSamples[g_benchStoreSampleCount - 1];
+	float*	pA = (float*)new __m128[ maxCount/4 ];
+	float*	pB = (float*)new __m128[ maxCount/4 ];
+	float*	pC = (float*)new __m128[ maxCount/4 ];
+	float*	pRes = (float*)new __m128[ maxCount/4 ];
+	float*	pVictim = (float*)new __m128[ cBenchStoreVictim/4 ];
+	char	row[80];
+
+	for(int ii=0; ii<maxCount; ii++)
+	{
+		pA[ii] = 1.f + (float)(ii % 7)*0.125f;
+		pB[ii] = 0.5f - (float)(ii % 5)*0.25f;
+		pC[ii] = (float)(ii % 3);
+		pRes[ii] = 0.f;
+	}
+
+	for(int ii=0; ii<cBenchStoreVictim; ii++)
+	{
+		pVictim[ii] = (float)(ii % 11)*0.0625f;
+	}
+
+	for(int size=0; size<g_benchStoreSampleCount; size++)
+	{
+		int count = 4*g_benchStoreSamples[size];
+
+		for(int lib=0; lib<g_benchStoreCount; lib++)
+		{
+			const BenchStream&	bs = g_benchStores[lib];
+			float				dot;
+
+			for(int ii=0; ii<opt.warmup; ii++)
+			{
+				bs.streamArray(pA, pB, pC, pRes, count);
+			}
+
+			double totalTime = 0.;
+			double rereadTime = 0.;
+
+			for(int ii=0; ii<opt.reps; ii++)
+			{
+				STREAM_VMATH::DotStream(pVictim, pVictim, NULL, &dot, cBenchStoreVictim);
+
+				PerformanceCounterStart();
+
+				bs.streamArray(pA, pB, pC, pRes, count);
+
+				totalTime += PerformanceCounterEnd();
+
+				PerformanceCounterStart();
+
+				STREAM_VMATH::DotStream(pVictim, pVictim, NULL, &dot, cBenchStoreVictim);
+
+				rereadTime += PerformanceCounterEnd();
+			}
+
+			snprintf(row, sizeof(row), "%s/%d", bs.name, count/4);
+			BenchReport(pOut, "nt", row, opt.reps, totalTime);
+
+			snprintf(row, sizeof(row), "%s/%d/reread", bs.name, count/4);
+			BenchReport(pOut, "nt", row, opt.reps, rereadTime);
+		}
+	}
+
+	delete[] (__m128*)pA;
+	delete[] (__m128*)pB;
+	delete[] (__m128*)pC;
+	delete[] (__m128*)pRes;
+	delete[] (__m128*)pVictim;
+}
+
+// float against half storage over cloth sized particle arrays, the Verlet rows start
+// from the same grid at rest and the difference of the half run is printed to stderr
+static void BenchHalfArrays(FILE* pOut, const BenchOptions& opt)
+{
+	int		maxCount = g_benchHalfWidths[g_benchHalfWidthCount - 1]*g_benchHalfWidths[g_benchHalfWidthCount - 1];
+	float*	pX = (float*)new __m128[ maxCount ];
+	float*	pXRef = (float*)new __m128[ maxCount ];
+	float*	pStore = (float*)new __m128[ maxCount ];
+	char	row[80];
+
+	fprintf(stderr, "half conversion: %s\n", HALF_VMATH::HalfF16C() ? "F16C" : "SSE2");
+
+	for(int size=0; size<g_benchHalfWidthCount; size++)
+	{
+		int		width = g_benchHalfWidths[size];
+		int		count = width*width;
+		double	maxDiff = 0.;
+
+		for(int lib=0; lib<g_benchHalfCount; lib++)
+		{
+			const BenchHalf&	bh = g_benchHalfs[lib];
+
+			// the cloth's rest grid, m_oldx = m_x or a zero step
+			for(int ii=0; ii<count; ii++)
+			{
+				pX[4*ii] = 1.f;
+				pX[4*ii + 1] = 2.f + (float)(ii / width)*(5.f/(float)width);
+				pX[4*ii + 2] = (float)(ii % width)*(5.f/(float)width);
+				pX[4*ii + 3] = 0.f;
+			}
+
+			if (bh.half)
+			{
+				memset(pStore, 0, count*sizeof(__m128));
+			}
+			else
+			{
+				memcpy(pStore, pX, count*sizeof(__m128));
+			}
+
+			for(int ii=0; ii<opt.warmup; ii++)
+			{
+				bh.halfArray(pX, pStore, count);
+			}
+
+			double totalTime = 0.;
+
+			for(int ii=0; ii<opt.reps; ii++)
+			{
+				PerformanceCounterStart();
+
+				bh.halfArray(pX, pStore, count);
+
+				totalTime += PerformanceCounterEnd();
+			}
+
+			snprintf(row, sizeof(row), "%s/%d", bh.name, count);
+			BenchReport(pOut, "half", row, opt.reps, totalTime);
+
+			if (bh.verlet && !bh.half)
+			{
+				memcpy(pXRef, pX, count*sizeof(__m128));
+			}
+			else if (bh.verlet)
+			{
+				for(int ii=0; ii<4*count; ii++)
+				{
+					maxDiff = fmax(maxDiff, fabs((double)pX[ii] - (double)pXRef[ii]));
+				}
+			}
+		}
+
+		fprintf(stderr, "half: %dx%d particles, m_x %d KB, m_oldx %d KB float / %d KB half, Verlet on half max abs difference %.3g after %d steps\n",
+			width, width, count*16/1024, count*16/1024, count*8/1024, maxDiff, opt.warmup + opt.reps);
+	}
+
+	delete[] (__m128*)pX;
+	delete[] (__m128*)pXRef;
+	delete[] (__m128*)pStore;
+}
+
+// dependent chains of calls through each calling convention, the time per call goes to stderr
+static void BenchCallChains(FILE* pOut, const BenchOptions& opt)
+{
+	char	row[80];
+
+	for(int prim=0; prim<CALL_PRIM_COUNT; prim++)
+	{
+		for(int live=0; live<2; live++)
+		{
+			for(int conv=0; conv<g_benchCallCount; conv++)
+			{
+				double	totalTime = 0.;
+
+				g_benchCalls[conv].chain(prim, live != 0, opt.warmup, &totalTime);
+				totalTime = 0.;
+				g_benchCalls[conv].chain(prim, live != 0, opt.reps, &totalTime);
+
+				snprintf(row, sizeof(row), "%s/%s%s", g_benchCallPrims[prim], g_benchCalls[conv].name, live ? "/live" : "");
+				BenchReport(pOut, "call", row, opt.reps, totalTime);
+
+				fprintf(stderr, "call: %s %.2f ns per call\n", row, totalTime*1e9/((double)opt.reps*1024.));
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------
+// -demo diff: every library against the plain float solver and EQ (cloth_fpu.cpp,
+// eq_fpu.cpp) on the same input, step by step
+//--------------------------------------------------------------------------------------
+
+// enough for the 65x65 release cloth, the debug one is 20x20
+const int		cBenchDiffParticles = 65*65;
+
+// samples per compared EQ block
+const int		cBenchDiffBlock = 256;
+
+// the cloth folds onto itself, a difference in the last bit doubles every few steps.
+// The first cBenchDiffSteps are held to the tolerance, the later ones only reported
+const int		cBenchDiffSteps = 16;
+
+// worst |library - FPU| allowed on the positions over those steps (the cloth spans
+// about 5 units), exact constraints then VRsqrtEst with 0, 1, 2 Newton steps
+static const double g_benchDiffClothTolerance[] = { 2e-3, 5e-2, 2e-3, 2e-3 };
+
+// the VMATH cloth's steps m_x - m_oldx in half floats (CLOTH_HALF_STORAGE), 11 bits
+// of mantissa on each step's movement
+const double	cBenchDiffHalfTolerance = 5e-3;
+
+// and on the EQ output, the samples are in [-32768, 32767]
+const double	cBenchDiffAudioTolerance = 0.5;
+
+// <library> for the exact constraints, <library>/rsqrt+N for the fast ones
+static void BenchDiffClothName(char* row, size_t size, const char* name, int newtonSteps)
+{
+	if (newtonSteps == CLOTH_CONSTRAINTS_EXACT)
+	{
+		snprintf(row, size, "%s", name);
+	}
+	else
+	{
+		snprintf(row, size, "%s/rsqrt+%d", name, newtonSteps);
+	}
+}
+
+
+// |v - ref| in ulp of max(|ref|, 1), values that cross zero are measured at the
+// scale of the data instead of in ulp of a denormal
+static double BenchDiffUlp(float ref, float v)
+{
+	float	scale = (fabsf(ref) < 1.f) ? 1.f : fabsf(ref);
+
+	return fabs((double)v - (double)ref)/(double)(nextafterf(scale, INFINITY) - scale);
+}
+
+// worst |p - pRef| and its ulp over count floats, NaN counts as infinitely far
+static void BenchDiffArrays(const float* pRef, const float* p, int count, double* pMaxAbs, double* pMaxUlp)
+{
+	for(int ii=0; ii<count; ii++)
+	{
+		double	err = fabs((double)p[ii] - (double)pRef[ii]);
+		double	ulp = BenchDiffUlp(pRef[ii], p[ii]);
+
+		*pMaxAbs = (err <= *pMaxAbs) ? *pMaxAbs : ((err == err) ? err : INFINITY);
+		*pMaxUlp = (ulp <= *pMaxUlp) ? *pMaxUlp : ((ulp == ulp) ? ulp : INFINITY);
+	}
+}
+
+static void BenchDiffReport(FILE* pOut, const char* demo, const char* lib, int step, double maxAbs, double maxUlp)
+{
+	fprintf(pOut, "%s,%s,%d,%g,%.1f\n", demo, lib, step, maxAbs, maxUlp);
+}
+
+// the worst step of a library goes to stderr, false if it is over tolerance
+static bool BenchDiffSummary(const char* demo, const char* lib, double maxAbs, double maxUlp, double tolerance)
+{
+	bool	ok = (maxAbs <= tolerance);
+
+	fprintf(stderr, "diff: %s %s max %g (%.1f ulp)%s\n", demo, lib, maxAbs, maxUlp, ok ? "" : " over tolerance");
+
+	return ok;
+}
+
+// -reps TimeSteps of a solver and of CLOTH_FPU with the same damping and stick order, every
+// position compared after each step
+static bool BenchDiffClothLibrary(FILE* pOut, const BenchOptions& opt, const char* name, const BenchDiffCloth& cloth, int newtonSteps, double tolerance)
+{
+	const float	timeStep = 1.f/60.f;
+	float*		pRef = new float[3*cBenchDiffParticles];
+	float*		pPos = new float[3*cBenchDiffParticles];
+	double		maxAbs = 0.;
+	double		maxUlp = 0.;
+	double		time;
+	bool		ok = true;
+
+	cloth.clothShutDown();
+	cloth.clothSetFastConstraints(newtonSteps);
+	CLOTH_FPU::ClothShutDown();
+	CLOTH_FPU::ClothSetDamping(cloth.clothDamping[0], cloth.clothDamping[1]);
+	CLOTH_FPU::ClothSetConstraintOrder(cloth.clothConstraintOrder);
+
+	for(int step=0; step<opt.reps; step++)
+	{
+		double	stepAbs = 0.;
+		double	stepUlp = 0.;
+
+		cloth.clothSimulate(timeStep, 1, &time);
+		CLOTH_FPU::ClothSimulate(timeStep, 1, &time);
+
+		int		count = CLOTH_FPU::ClothGetPositions(pRef, cBenchDiffParticles);
+
+		ok &= (cloth.clothGetPositions(pPos, cBenchDiffParticles) == count);
+
+		BenchDiffArrays(pRef, pPos, 3*count, &stepAbs, &stepUlp);
+		BenchDiffReport(pOut, "cloth", name, step, stepAbs, stepUlp);
+
+		if (step < cBenchDiffSteps)
+		{
+			maxAbs = (stepAbs <= maxAbs) ? maxAbs : stepAbs;
+			maxUlp = (stepUlp <= maxUlp) ? maxUlp : stepUlp;
+		}
+	}
+
+	cloth.clothSetFastConstraints(CLOTH_CONSTRAINTS_EXACT);
+	cloth.clothShutDown();
+	CLOTH_FPU::ClothShutDown();
+
+	delete[] pRef;
+	delete[] pPos;
+
+	return BenchDiffSummary("cloth", name, maxAbs, maxUlp, tolerance) && ok;
+}
+
+// swaps the 4 tracks of g_AudioSample with those of a bank, so the FPU EQ runs on it
+static void BenchDiffSwapBank(int bank)
+{
+	AudioBankStruct&	other = g_AudioSample.bank[bank - 1];
+	AudioBankStruct		t = other;
+
+	other.pSIMDWavDataSrc = g_AudioSample.pSIMDWavDataSrc;
+	other.pSIMDWavDataDest = g_AudioSample.pSIMDWavDataDest;
+	g_AudioSample.pSIMDWavDataSrc = t.pSIMDWavDataSrc;
+	g_AudioSample.pSIMDWavDataDest = t.pSIMDWavDataDest;
+
+	for(int ch=0; ch<4; ch++)
+	{
+		other.pWavDataSrc[ch] = g_AudioSample.pWavDataSrc[ch];
+		other.pWavDataDest[ch] = g_AudioSample.pWavDataDest[ch];
+		g_AudioSample.pWavDataSrc[ch] = t.pWavDataSrc[ch];
+		g_AudioSample.pWavDataDest[ch] = t.pWavDataDest[ch];
+	}
+}
+
+// the FPU EQ over the whole of every bank from a reset state, 4*samples floats per bank
+static void BenchDiffAudioReference(int samples, float* pRef)
+{
+	for(int bank=0; bank<BenchAudioBankCount(); bank++)
+	{
+		if (bank)
+		{
+			BenchDiffSwapBank(bank);
+		}
+
+		InitEQStates();
+
+		for(int beg=0; beg<samples; beg+=cBenchDiffBlock)
+		{
+			ProcessAudioBlockFPU(beg, (beg + cBenchDiffBlock - 1 < samples - 1) ? beg + cBenchDiffBlock - 1 : samples - 1);
+		}
+
+		memcpy(pRef + 4*(size_t)samples*bank, g_AudioSample.pSIMDWavDataDest, 4*(size_t)samples*sizeof(float));
+
+		if (bank)
+		{
+			BenchDiffSwapBank(bank);
+		}
+	}
+}
+
+// the EQ of a library over the -samples window in cBenchDiffBlock sample steps, each of
+// the audioBanks banks it filters against the FPU EQ over the same continuous tracks
+static bool BenchDiffAudioLibrary(FILE* pOut, const char* name, void (*initEQState)(void), void (*processAudioBlock)(int beg, int end), int samples, int audioBanks, const float* pRef)
+{
+	int		end = samples - 1;
+	double	maxAbs = 0.;
+	double	maxUlp = 0.;
+
+	InitEQStates();
+	initEQState();
+
+	for(int beg=0; beg<=end; beg+=cBenchDiffBlock)
+	{
+		int		last = (beg + cBenchDiffBlock - 1 < end) ? beg + cBenchDiffBlock - 1 : end;
+		double	stepAbs = 0.;
+		double	stepUlp = 0.;
+
+		processAudioBlock(beg, last);
+
+		for(int bank=0; bank<audioBanks; bank++)
+		{
+			const float*	pDest = (const float*)(bank ? g_AudioSample.bank[bank - 1].pSIMDWavDataDest : g_AudioSample.pSIMDWavDataDest);
+
+			BenchDiffArrays(pRef + 4*(size_t)samples*bank + 4*beg, pDest + 4*beg, 4*(last - beg + 1), &stepAbs, &stepUlp);
+		}
+
+		BenchDiffReport(pOut, "audio", name, beg/cBenchDiffBlock, stepAbs, stepUlp);
+
+		maxAbs = (stepAbs <= maxAbs) ? maxAbs : stepAbs;
+		maxUlp = (stepUlp <= maxUlp) ? maxUlp : stepUlp;
+	}
+
+	return BenchDiffSummary("audio", name, maxAbs, maxUlp, cBenchDiffAudioTolerance);
+}
+
+static void BenchDiffNoInit(void)
+{
+}
+
+// every library and dispatched build against the FPU reference, the cloth exact and
+// with the fast constraints, false if any goes over its tolerance
+static bool BenchDiff(FILE* pOut, const BenchOptions& opt)
+{
+	bool	ok = true;
+	char	row[80];
+
+	fprintf(pOut, "demo,library,step,max_abs,max_ulp\n");
+
+	//cloth
+	for(int steps=CLOTH_CONSTRAINTS_EXACT; steps<=2; steps++)
+	{
+		double	tolerance = g_benchDiffClothTolerance[steps - CLOTH_CONSTRAINTS_EXACT];
+
+		for(int lib=0; lib<g_benchLibCount; lib++)
+		{
+			const BenchLibrary&	bl = g_benchLibs[lib];
+			BenchDiffCloth		cloth = { bl.clothSimulate, bl.clothShutDown, bl.clothSetFastConstraints, bl.clothGetPositions, { bl.clothDamping[0], bl.clothDamping[1] }, bl.clothConstraintOrder };
+
+			BenchDiffClothName(row, sizeof(row), bl.name, steps);
+#ifdef CLOTH_HALF_STORAGE
+			ok &= BenchDiffClothLibrary(pOut, opt, row, cloth, steps, !strcmp(bl.name, "VMath") ? fmax(tolerance, cBenchDiffHalfTolerance) : tolerance);
+#else
+			ok &= BenchDiffClothLibrary(pOut, opt, row, cloth, steps, tolerance);
+#endif
+		}
+
+		for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+		{
+			const SimdKernels*	pKernels = SimdGetKernels(isa);
+			BenchDiffCloth		cloth = { pKernels->clothSimulate, pKernels->clothShutDown, pKernels->clothSetFastConstraints, pKernels->clothGetPositions, { CLOTH_VCLASS_D1, CLOTH_VCLASS_D2 }, pKernels->clothConstraintOrder };
+			char				name[64];
+
+			BenchDispatchName(name, sizeof(name), pKernels);
+			BenchDiffClothName(row, sizeof(row), name, steps);
+			ok &= BenchDiffClothLibrary(pOut, opt, row, cloth, steps, tolerance);
+		}
+	}
+
+	//audio
+	BenchAudioInit(opt.samples, false);
+
+	float*	pRef = new float[4*(size_t)opt.samples*BenchAudioBankCount()];
+
+	BenchDiffAudioReference(opt.samples, pRef);
+
+	for(int lib=0; lib<g_benchLibCount; lib++)
+	{
+		ok &= BenchDiffAudioLibrary(pOut, g_benchLibs[lib].name, BenchDiffNoInit, g_benchLibs[lib].processAudioBlock, opt.samples, g_benchLibs[lib].audioBanks, pRef);
+	}
+
+	for(int isa=SIMD_ISA_MIN; isa<=g_pSimdKernels->isa; isa++)
+	{
+		const SimdKernels*	pKernels = SimdGetKernels(isa);
+		char				name[64];
+
+		BenchDispatchName(name, sizeof(name), pKernels);
+		ok &= BenchDiffAudioLibrary(pOut, name, pKernels->initEQState, pKernels->processAudioBlock, opt.samples, 1, pRef);
+	}
+
+	delete[] pRef;
+
+	BenchAudioShutDown();
+
+	fprintf(stderr, "diff: %s\n", ok ? "all libraries within tolerance" : "FAILED");
+
+	return ok;
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+static void BenchUsage(const char* exe)
+{
+	fprintf(stderr,
+		"usage: %s [-demo audio|cloth|madd|sine|soa|stream|rcp|trans|mat|quat|half|call|nt|denormal|all|diff] [-reps N] [-warmup N] [-samples N] [-hugepages] [-o file.csv]\n"
+		"  -demo     which kernels to time (default all)\n"
+		"            madd times a chain of 1024 dependent x*a+b per rep\n"
+		"            sine times testsine.cpp's VSin over -samples Vec4, with VMATH::Sin and sinf\n"
+		"            soa times Dot/Normalize/Reflect against Dot4/Normalize4/Reflect4,\n"
+		"            and Normalize3/Reflect3 on packed Float3 arrays\n"
+		"            stream times hand written loops against VMATH::Stream\n"
+		"            cloth also times the fast constraints, VRsqrtEst with 0-2 Newton steps\n"
+		"            (<library>/rsqrt+N)\n"
+		"            rcp times division/sqrt against VReciprocalEst/VRsqrtEst with 0-2 Newton steps\n"
+		"            trans times Sin/Cos/SinCos/Exp/Log/Pow/Atan2 against libm\n"
+		"            mat times Mat4 frame hierarchy, inverses and points against float loops\n"
+		"            quat times QNlerp/QSlerp one key at a time, 4 at a time and on SoA keys\n"
+		"            half times the Verlet step and the vertex positions on float against\n"
+		"            half storage, for 65x65 to 1024x1024 particles (<row>/<particles>)\n"
+		"            call times chains of 1024 non-inlined VAdd/VMAdd/Dot/MTransform calls\n"
+		"            per rep by value, const ref and the other ABIs the compiler has\n"
+		"            (<function>/<convention>), /live with 8 vectors kept across the calls\n"
+		"            nt times MulAdd with cached and non-temporal stores on 16K to 2M Vec4\n"
+		"            (<row>/<samples>), and the read back of a 1 MB working set after each\n"
+		"            pass (<row>/<samples>/reread), the cache the output evicted\n"
+		"            denormal times the EQs on 64 samples of the tracks then silence, with\n"
+		"            MXCSR FTZ/DAZ off (<library>/denormals) and on (<library>/ftz)\n"
+		"            diff runs every library and dispatched build against the plain float\n"
+		"            cloth and EQ on the same input and writes the worst abs/ulp error per\n"
+		"            cloth step and EQ block (not part of all), exits 1 over tolerance\n"
+		"            in the first 16 cloth steps or any EQ block\n"
+		"  -reps     timed EQ passes / cloth TimeSteps per library, compared steps for\n"
+		"            diff (default 100)\n"
+		"  -warmup   untimed repetitions before measuring (default 10)\n"
+		"  -samples  SIMD samples per EQ pass (default 4097, the UI window)\n"
+		"  -hugepages  the EQ sample buffers on huge pages (MADV_HUGEPAGE, MEM_LARGE_PAGES)\n"
+		"  -o        write the CSV to a file instead of stdout\n",
+		exe);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions	opt;
+
+	opt.runAudio	= true;
+	opt.runCloth	= true;
+	opt.runMadd		= true;
+	opt.runSine		= true;
+	opt.runSoa		= true;
+	opt.runStream	= true;
+	opt.runRecip	= true;
+	opt.runTrans	= true;
+	opt.runMat		= true;
+	opt.runQuat		= true;
+	opt.runHalf		= true;
+	opt.runCall		= true;
+	opt.runStore	= true;
+	opt.runDiff		= false;
+	opt.runDenormal	= true;
+	opt.hugePages	= false;
+	opt.reps		= 100;
+	opt.warmup		= 10;
+	opt.samples		= 2*2048 + 1;
+	opt.outFile		= NULL;
+
+	for(int ii=1; ii<argc; ii++)
+	{
+		const char*	arg = argv[ii];
+		const char*	val = (ii+1 < argc) ? argv[ii+1] : NULL;
+
+		if (!strcmp(arg, "-demo") && val)
+		{
+			opt.runAudio = !strcmp(val, "audio") || !strcmp(val, "all");
+			opt.runCloth = !strcmp(val, "cloth") || !strcmp(val, "all");
+			opt.runMadd = !strcmp(val, "madd") || !strcmp(val, "all");
+			opt.runSine = !strcmp(val, "sine") || !strcmp(val, "all");
+			opt.runSoa = !strcmp(val, "soa") || !strcmp(val, "all");
+			opt.runStream = !strcmp(val, "stream") || !strcmp(val, "all");
+			opt.runRecip = !strcmp(val, "rcp") || !strcmp(val, "all");
+			opt.runTrans = !strcmp(val, "trans") || !strcmp(val, "all");
+			opt.runMat = !strcmp(val, "mat") || !strcmp(val, "all");
+			opt.runQuat = !strcmp(val, "quat") || !strcmp(val, "all");
+			opt.runHalf = !strcmp(val, "half") || !strcmp(val, "all");
+			opt.runCall = !strcmp(val, "call") || !strcmp(val, "all");
+			opt.runStore = !strcmp(val, "nt") || !strcmp(val, "all");
+			opt.runDiff = !strcmp(val, "diff");
+			opt.runDenormal = !strcmp(val, "denormal") || !strcmp(val, "all");
+			ii++;
+		}
+		else if (!strcmp(arg, "-reps") && val)
+		{
+			opt.reps = atoi(val);
+			ii++;
+		}
+		else if (!strcmp(arg, "-warmup") && val)
+		{
+			opt.warmup = atoi(val);
+			ii++;
+		}
+		else if (!strcmp(arg, "-samples") && val)
+		{
+			opt.samples = atoi(val);
+			ii++;
+		}
+		else if (!strcmp(arg, "-hugepages"))
+		{
+			opt.hugePages = true;
+		}
+		else if (!strcmp(arg, "-o") && val)
+		{
+			opt.outFile = val;
+			ii++;
+		}
+		else
+		{
+			BenchUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (opt.reps <= 0 || opt.warmup < 0 || opt.samples <= 0 || (!opt.runAudio && !opt.runCloth && !opt.runMadd && !opt.runSine && !opt.runSoa && !opt.runStream && !opt.runRecip && !opt.runTrans && !opt.runMat && !opt.runQuat && !opt.runHalf && !opt.runCall && !opt.runStore && !opt.runDiff && !opt.runDenormal))
+	{
+		BenchUsage(argv[0]);
+		return 1;
+	}
+
+	FILE*	pOut = stdout;
+
+	if (opt.outFile)
+	{
+		pOut = fopen(opt.outFile, "w");
+
+		if (!pOut)
+		{
+			fprintf(stderr, "Failed to open %s\n", opt.outFile);
+			return 1;
+		}
+	}
+
+	fprintf(stderr, "runtime dispatch: %s\n", g_pSimdKernels->name);
+
+	if (opt.runDiff)
+	{
+		bool	ok = BenchDiff(pOut, opt);
+
+		if (pOut != stdout)
+		{
+			fclose(pOut);
+		}
+
+		return ok ? 0 : 1;
+	}
+
+	fprintf(pOut, "demo,library,reps,total_ms,avg_ms\n");
+
+	if (opt.runAudio)
+	{
+		BenchAudio(pOut, opt);
+	}
+
+	if (opt.runCloth)
+	{
+		BenchCloth(pOut, opt);
+	}
+
+	if (opt.runMadd)
+	{
+		BenchMadd(pOut, opt);
+	}
+
+	if (opt.runSine)
+	{
+		BenchSineArrays(pOut, opt);
+	}
+
+	if (opt.runSoa)
+	{
+		BenchSoaArrays(pOut, opt);
+	}
+
+	if (opt.runStream)
+	{
+		BenchStreamArrays(pOut, opt);
+	}
+
+	if (opt.runRecip)
+	{
+		BenchRecipArrays(pOut, opt);
+	}
+
+	if (opt.runTrans)
+	{
+		BenchTransArrays(pOut, opt);
+	}
+
+	if (opt.runMat)
+	{
+		BenchMatArrays(pOut, opt);
+	}
+
+	if (opt.runQuat)
+	{
+		BenchQuatArrays(pOut, opt);
+	}
+
+	if (opt.runHalf)
+	{
+		BenchHalfArrays(pOut, opt);
+	}
+
+	if (opt.runCall)
+	{
+		BenchCallChains(pOut, opt);
+	}
+
+	if (opt.runStore)
+	{
+		BenchStoreArrays(pOut, opt);
+	}
+
+	if (opt.runDenormal)
+	{
+		BenchDenormal(pOut, opt);
+	}
+
+	if (pOut != stdout)
+	{
+		fclose(pOut);
+	}
+
+	return 0;
+}
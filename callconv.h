@@ -0,0 +1,97 @@
+//--------------------------------------------------------------------------------------
+// File: callconv.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __CALLCONV__
+#define __CALLCONV__
+
+///////////////////////////////////////////////////////////////////////////////
+//	How a SIMD value crosses a call that isn't inlined, for simd_bench
+//	-demo call. The VMATH primitives below are built once per convention in
+//	callconv_funcs.cpp and called from callconv.cpp, a different unit, so
+//	the compiler has to keep to the ABI:
+//
+//	CALL_INLINE		the same code inlined, the baseline
+//	CALL_VALUE		Vec4/Mat4 by value (VMATH). System V passes a Vec4 in
+//					an xmm register and a Mat4 on the stack, MSVC x64 both
+//					through a pointer to a copy
+//	CALL_CREF		const Vec4&/const Mat4& (VCLASS_TYPEDEF simd_param,
+//					XNAMath's FXMVECTOR/CXMMATRIX on x64)
+//	CALL_VECTORCALL	__vectorcall, MSVC only: Vec4 in xmm0-5, a Mat4 as a
+//					homogeneous vector aggregate in 4 registers
+//	CALL_MSABI		by value on the Windows x64 convention, GCC/Clang on
+//					x86-64 outside Windows (__attribute__((ms_abi)))
+//	CALL_SYSV		by value on the System V convention, GCC/Clang on
+//					Windows x64 (__attribute__((sysv_abi)))
+//
+//	Chain times cChainLength dependent calls per rep. live keeps 8 more
+//	vectors alive across every call: System V saves no xmm register across
+//	a call so the caller spills them, Windows x64 keeps xmm6-15 callee-saved.
+///////////////////////////////////////////////////////////////////////////////
+
+#define	CALL_PRIM_VADD				(0)		// VAdd(x, a)
+#define	CALL_PRIM_VMADD				(1)		// VMAdd(x, a, b)
+#define	CALL_PRIM_DOT				(2)		// Dot(x, a)
+#define	CALL_PRIM_MTRANSFORM		(3)		// MTransform(x, m)
+#define	CALL_PRIM_COUNT				(4)
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#define	CALLCONV_VECTORCALL
+#endif
+
+// CALL_VALUE's Mat4, 32 bit MSVC can't pass an aligned struct by value (C2719)
+#if defined(_MSC_VER) && defined(_M_IX86)
+	#define	CALLCONV_VALUE_MAT		const Mat4&
+#else
+	#define	CALLCONV_VALUE_MAT		Mat4
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+	#if defined(_WIN32)
+		#define	CALLCONV_SYSV
+	#else
+		#define	CALLCONV_MSABI
+	#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace CALL_INLINE
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+
+namespace CALL_VALUE
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+
+namespace CALL_CREF
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+
+#if defined(CALLCONV_VECTORCALL)
+namespace CALL_VECTORCALL
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+#endif
+
+#if defined(CALLCONV_MSABI)
+namespace CALL_MSABI
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+#endif
+
+#if defined(CALLCONV_SYSV)
+namespace CALL_SYSV
+{
+	extern void Chain(int prim, bool live, int reps, double *totalTimeOut);
+}
+#endif
+
+#endif // #ifndef __CALLCONV__
@@ -0,0 +1,140 @@
+//--------------------------------------------------------------------------------------
+// File: callconv.inl
+//
+// The -demo call primitives and loops for one calling convention, see callconv.h.
+// Included inside the convention's namespace after defining:
+//
+//	CALL_CONV			calling convention keyword or attribute (may be empty)
+//	CALL_VEC			parameter type of a Vec4
+//	CALL_MAT			parameter type of a Mat4
+//	CALL_FUNC			storage of the definitions: __declspec(noinline) or inline
+//	CALLCONV_FUNCS		(optional) define the primitives, declare them otherwise
+//	CALLCONV_LOOPS		(optional) define Chain
+//--------------------------------------------------------------------------------------
+
+typedef VMATH::Vec4		Vec4;
+typedef VMATH::Mat4		Mat4;
+
+///////////////////////////////////////////////////////////////////////////////
+// Primitives, each the VMATH function of the same name
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(CALLCONV_FUNCS)
+
+CALL_FUNC Vec4 CALL_CONV CallVAdd(CALL_VEC va, CALL_VEC vb)
+{
+	return(VMATH::VAdd(va, vb));
+}
+
+CALL_FUNC Vec4 CALL_CONV CallVMAdd(CALL_VEC va, CALL_VEC vb, CALL_VEC vc)
+{
+	return(VMATH::VMAdd(va, vb, vc));
+}
+
+CALL_FUNC Vec4 CALL_CONV CallDot(CALL_VEC va, CALL_VEC vb)
+{
+	return(VMATH::Dot(va, vb));
+}
+
+CALL_FUNC Vec4 CALL_CONV CallMTransform(CALL_VEC v, CALL_MAT m)
+{
+	return(VMATH::MTransform(v, m));
+}
+
+#else
+
+// callconv_funcs.cpp
+extern Vec4 CALL_CONV CallVAdd(CALL_VEC va, CALL_VEC vb);
+extern Vec4 CALL_CONV CallVMAdd(CALL_VEC va, CALL_VEC vb, CALL_VEC vc);
+extern Vec4 CALL_CONV CallDot(CALL_VEC va, CALL_VEC vb);
+extern Vec4 CALL_CONV CallMTransform(CALL_VEC v, CALL_MAT m);
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Chain
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(CALLCONV_LOOPS)
+
+template <int Prim>
+inline Vec4 CallPrim(Vec4 x, Vec4 a, Vec4 b, const Mat4& m)
+{
+	switch(Prim)
+	{
+		case CALL_PRIM_VADD:		return(CallVAdd(x, a));
+		case CALL_PRIM_VMADD:		return(CallVMAdd(x, a, b));
+		case CALL_PRIM_DOT:			return(CallDot(x, a));
+		default:					return(CallMTransform(x, m));
+	}
+}
+
+// x = Prim(x, ...) cChainLength times per rep, live adds 8 sums of x kept across the calls
+template <int Prim>
+void ChainT(bool live, int reps, double *totalTimeOut)
+{
+	float	s = g_chainSink;
+	Vec4	a = VMATH::VReplicate(0.25f);
+	Vec4	b = VMATH::VReplicate(0.5f);
+	Mat4	m = VMATH::MIdentity();
+	Vec4	x = VMATH::VReplicate(s);
+
+	if (!live)
+	{
+		PerformanceCounterStart();
+
+		for(int ii=0; ii<reps; ii++)
+		{
+			for(int jj=0; jj<cChainLength; jj++)
+			{
+				x = CallPrim<Prim>(x, a, b, m);
+			}
+		}
+
+		*totalTimeOut += PerformanceCounterEnd();
+	}
+	else
+	{
+		Vec4	l0 = x, l1 = x, l2 = x, l3 = x;
+		Vec4	l4 = x, l5 = x, l6 = x, l7 = x;
+
+		PerformanceCounterStart();
+
+		for(int ii=0; ii<reps; ii++)
+		{
+			for(int jj=0; jj<cChainLength; jj++)
+			{
+				x = CallPrim<Prim>(x, a, b, m);
+
+				l0 = VMATH::VAdd(l0, x);
+				l1 = VMATH::VSub(l1, x);
+				l2 = VMATH::VMax(l2, x);
+				l3 = VMATH::VMin(l3, x);
+				l4 = VMATH::VAdd(l4, l0);
+				l5 = VMATH::VSub(l5, l1);
+				l6 = VMATH::VMax(l6, l3);
+				l7 = VMATH::VMin(l7, l2);
+			}
+		}
+
+		*totalTimeOut += PerformanceCounterEnd();
+
+		x = VMATH::VAdd(VMATH::VAdd(VMATH::VAdd(l0, l1), VMATH::VAdd(l2, l3)), VMATH::VAdd(VMATH::VAdd(l4, l5), VMATH::VAdd(l6, l7)));
+	}
+
+	VMATH::GetX(&s, x);
+	g_chainSink = s;
+}
+
+void Chain(int prim, bool live, int reps, double *totalTimeOut)
+{
+	switch(prim)
+	{
+		case CALL_PRIM_VADD:		ChainT<CALL_PRIM_VADD>(live, reps, totalTimeOut); break;
+		case CALL_PRIM_VMADD:		ChainT<CALL_PRIM_VMADD>(live, reps, totalTimeOut); break;
+		case CALL_PRIM_DOT:			ChainT<CALL_PRIM_DOT>(live, reps, totalTimeOut); break;
+		case CALL_PRIM_MTRANSFORM:	ChainT<CALL_PRIM_MTRANSFORM>(live, reps, totalTimeOut); break;
+	}
+}
+
+#endif
@@ -0,0 +1,81 @@
+//--------------------------------------------------------------------------------------
+// File: callconv_funcs.cpp
+//
+// The -demo call primitives, one non-inlined copy per calling convention. A separate
+// unit from the loops in callconv.cpp, see callconv.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "callconv.h"
+
+#define	CALLCONV_FUNCS
+#define	CALL_FUNC				__declspec(noinline)
+
+namespace CALL_VALUE
+{
+	#define	CALL_CONV
+	#define	CALL_VEC			Vec4
+	#define	CALL_MAT			CALLCONV_VALUE_MAT
+	#include "callconv.inl"
+	#undef	CALL_CONV
+	#undef	CALL_VEC
+	#undef	CALL_MAT
+}
+
+namespace CALL_CREF
+{
+	#define	CALL_CONV
+	#define	CALL_VEC			const Vec4&
+	#define	CALL_MAT			const Mat4&
+	#include "callconv.inl"
+	#undef	CALL_CONV
+	#undef	CALL_VEC
+	#undef	CALL_MAT
+}
+
+#if defined(CALLCONV_VECTORCALL)
+namespace CALL_VECTORCALL
+{
+	#define	CALL_CONV			__vectorcall
+	#define	CALL_VEC			Vec4
+	#define	CALL_MAT			Mat4
+	#include "callconv.inl"
+	#undef	CALL_CONV
+	#undef	CALL_VEC
+	#undef	CALL_MAT
+}
+#endif
+
+#if defined(CALLCONV_MSABI)
+namespace CALL_MSABI
+{
+	#define	CALL_CONV			__attribute__((ms_abi))
+	#define	CALL_VEC			Vec4
+	#define	CALL_MAT			Mat4
+	#include "callconv.inl"
+	#undef	CALL_CONV
+	#undef	CALL_VEC
+	#undef	CALL_MAT
+}
+#endif
+
+#if defined(CALLCONV_SYSV)
+namespace CALL_SYSV
+{
+	#define	CALL_CONV			__attribute__((sysv_abi))
+	#define	CALL_VEC			Vec4
+	#define	CALL_MAT			Mat4
+	#include "callconv.inl"
+	#undef	CALL_CONV
+	#undef	CALL_VEC
+	#undef	CALL_MAT
+}
+#endif
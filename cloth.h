@@ -8,6 +8,29 @@
 
 #define	CLOTH_NUM_ITERATIONS		(8)
 
+// ClothSetFastConstraints: stick lengths from Sqrt and a division (default), or
+// from the reciprocal sqrt estimate refined by 0, 1 or 2 Newton-Raphson steps.
+// Each solver's StickDiff returns (|delta| - restlength)/|delta|. With
+// CLOTH_CONSTRAINTS_EXACT it takes a square root and a division, Steps >= 0
+// computes 1 - restlength*rsqrt(|delta|^2) with the estimate refined Steps times.
+#define	CLOTH_CONSTRAINTS_EXACT		(-1)
+
+// Verlet damping x += d1*x - d2*oldx of each solver, a little different per
+// library so the optimizer can't unify the code. CLOTH_FPU takes any pair
+// (ClothSetDamping) to follow the solver it is checked against.
+#define	CLOTH_VMATH_D1				(0.99902f)
+#define	CLOTH_VMATH_D2				(0.99897f)
+#define	CLOTH_XNAMATH_D1			(0.99903f)
+#define	CLOTH_XNAMATH_D2			(0.99899f)
+#define	CLOTH_VCLASS_D1				(0.99901f)
+#define	CLOTH_VCLASS_D2				(0.99898f)
+
+// Order the sticks are relaxed in: particle by particle (every solver but the
+// ones built with CLOTH_VCLASS_WIDE_CONSTRAINTS), or row by row with the
+// horizontal sticks even then odd and the vertical sticks after them
+#define	CLOTH_ORDER_SEQUENTIAL		(0)
+#define	CLOTH_ORDER_ROWS			(1)
+
 ///////////////////////////////////////////////////////////////////////////////
 //								Externs
 ///////////////////////////////////////////////////////////////////////////////
@@ -16,50 +39,140 @@ namespace CLOTH_VCLASS_TYPEDEF
 {
 	extern HRESULT ClothInit(void);
 	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
 	extern HRESULT ClothCopyVertices(bool addColor);
 	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
 	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
 	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
 }
 
 namespace CLOTH_VCLASS_SIMDTYPE
 {
 	extern HRESULT ClothInit(void);
 	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
 	extern HRESULT ClothCopyVertices(bool addColor);
 	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
 	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
 	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
 }
 
+// the VCLASS_SIMDTYPE solver in double (Vec4d)
+namespace CLOTH_VCLASS_SIMDTYPE_DOUBLE
+{
+	extern HRESULT ClothInit(void);
+	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
+	extern HRESULT ClothCopyVertices(bool addColor);
+	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
+	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
+	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace CLOTH_VCLASS_SIMDTYPE8
+{
+	extern HRESULT ClothInit(void);
+	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
+	extern HRESULT ClothCopyVertices(bool addColor);
+	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
+	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
+	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace CLOTH_VCLASS_SIMDTYPE16
+{
+	extern HRESULT ClothInit(void);
+	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
+	extern HRESULT ClothCopyVertices(bool addColor);
+	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
+	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
+	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
+}
+#endif
+
 namespace CLOTH_VCLASS
 {
 	extern HRESULT ClothInit(void);
 	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
 	extern HRESULT ClothCopyVertices(bool addColor);
 	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
 	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
 	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
 }
 
 namespace CLOTH_VMATH
 {
 	extern HRESULT ClothInit(void);
 	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
 	extern HRESULT ClothCopyVertices(bool addColor);
 	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
 	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
 	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
 }
 
 namespace CLOTH_XNAMATH
 {
 	extern HRESULT ClothInit(void);
 	extern void ClothShutDown(void);
+#ifndef SIMD_HEADLESS
 	extern HRESULT ClothCopyVertices(bool addColor);
 	extern HRESULT ClothAnimateAndRender(IDirect3DDevice9* pd3dDevice, D3DXMATRIXA16* mWorld, D3DXMATRIXA16* mView, D3DXMATRIXA16* mProj, float fTimeStep, int reps, double *totalTimeOut);
+#endif
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
+	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
+	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
+}
+
+// plain float reference solver (cloth_fpu.cpp), no SIMD and no fused
+// multiply-adds, for simd_bench -demo diff
+namespace CLOTH_FPU
+{
+	extern HRESULT ClothInit(void);
+	extern void ClothShutDown(void);
+	extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
 	extern void ClothSetGlobalParam(float rot, float trans, float gravity);
 	extern void ClothUIHack(void);
+	extern void ClothSetFastConstraints(int newtonSteps);
+	extern int ClothGetPositions(float *pXYZ, int maxParticles);
+	extern void ClothSetDamping(float d1, float d2);
+	extern void ClothSetConstraintOrder(int order);
 }
 
 #endif // #ifndef __CLOTH__
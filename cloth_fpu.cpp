@@ -0,0 +1,447 @@
+//--------------------------------------------------------------------------------------
+//	File: cloth_fpu.cpp
+//
+//	Original algorithm extracted from the white paper:
+//	Advanced Character Physics by Thomas Jakobsen
+//	http://www.teknikus.dk/tj/gdc2001.htm
+//
+//	The plain float solver, one component at a time with no SIMD library: the
+//	reference the other solvers are checked against (simd_bench -demo diff).
+//	Built with fused multiply-adds off, every a*b+c rounds twice.
+///////////////////////////////////////////////////////////////////////////////
+
+//--------------------------------------------------------------------------------------
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#include <xaudio2.h>
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "common.h"
+#include "arena.h"
+#include "cloth.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//								Consts & Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define	FPU_PI				(3.1415926535897932384626433832795f)
+#define	FPU_DTOR(angle)		((FPU_PI/180.0f)*((float)angle))
+
+namespace CLOTH_FPU
+{
+	const int	cClothMaxConstraints	= 16;
+
+	#ifdef NDEBUG
+		const int	cClothWidth				= 65;
+		const int	cClothHeight			= 65;
+	#else
+		const int	cClothWidth				= 20;
+		const int	cClothHeight			= 20;
+	#endif
+
+	const int	cClothSize				= cClothWidth*cClothHeight;
+	const float	cClothRestLength		= (1.f/(float)(cClothWidth))*5.f;
+	const float	cClothBox				= 50.f;		// Verlet keeps the particles in [-cClothBox, cClothBox]
+
+
+	///////////////////////////////////////////////////////////////////////////////
+	//								Structs
+	///////////////////////////////////////////////////////////////////////////////
+
+	typedef struct Vec3
+	{
+		float			x, y, z;
+
+	}	Vec3;
+
+	typedef struct ClothConstraints
+	{
+		int				cIndex[cClothMaxConstraints];
+		int				cIndexCount;
+
+	}	ClothConstraints, *PClothConstraints;
+
+	typedef struct Cloth
+	{
+		// cClothSize particles each, from g_clothArena
+		Vec3*						m_x;
+		Vec3*						m_oldx;
+		Vec3*						m_a;
+		Vec3						m_vGravity;
+		float						fTimeStep;
+		float						restlength;
+		Vec3						hook[2];
+		Vec3						worldTrans;
+
+		bool						clothInit;
+		float						rot;
+		float						dist;
+
+		ClothConstraints			cnstr[cClothSize];
+		int							NUM_ITERATIONS;
+		int							NUM_PARTICLES;
+
+		void AccumulateForces();
+		void Verlet();
+		void SatisfyConstraints();
+		void SatisfyConstraintsRows();
+		void TimeStep();
+
+	}	Cloth, *PCloth;
+
+
+	///////////////////////////////////////////////////////////////////////////////
+	//								Globals
+	///////////////////////////////////////////////////////////////////////////////
+
+	Cloth	g_cloth;
+
+	// m_x, m_oldx and m_a, outside g_cloth so ClothInit doesn't reset it
+	static Arena	g_clothArena;
+
+	// ClothSetDamping and ClothSetConstraintOrder, outside g_cloth so ClothInit
+	// doesn't reset them
+	float	g_clothDamping[2] = { CLOTH_VMATH_D1, CLOTH_VMATH_D2 };
+	int		g_clothConstraintOrder = CLOTH_ORDER_SEQUENTIAL;
+
+
+	///////////////////////////////////////////////////////////////////////////////
+	//								Functions
+	///////////////////////////////////////////////////////////////////////////////
+
+	inline Vec3 Vec3Set(float x, float y, float z)
+	{
+		Vec3 v = { x, y, z };
+		return(v);
+	}
+
+	inline float Vec3Dot(const Vec3& va, const Vec3& vb)
+	{
+		return(va.x*vb.x + va.y*vb.y + va.z*vb.z);
+	}
+
+	inline float Clamp(float v, float lo, float hi)
+	{
+		return((v < lo) ? lo : ((v > hi) ? hi : v));
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Get cloth index
+	///////////////////////////////////////////////////////////////////////////////
+	inline int GetI(int x, int y)
+	{
+		return((y*cClothWidth) + x);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	//
+	///////////////////////////////////////////////////////////////////////////////
+	HRESULT ClothInit(void)
+	{
+		int w = cClothWidth;
+		int h = cClothHeight;
+
+		memset(&g_cloth, 0x00, sizeof(g_cloth));
+
+		// the particle arrays, back to back and cache line aligned, on the pages the
+		// first ClothInit reserved
+		if (!g_clothArena.pBase && !ArenaInit(&g_clothArena, 3*cClothSize*sizeof(Vec3) + 3*cArenaAlign, false))
+		{
+			return (E_FAIL);
+		}
+
+		ArenaReset(&g_clothArena);
+
+		g_cloth.m_x = (Vec3*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec3));
+		g_cloth.m_oldx = (Vec3*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec3));
+		g_cloth.m_a = (Vec3*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec3));
+
+		memset(g_cloth.m_a, 0x00, cClothSize*sizeof(Vec3));
+
+		g_cloth.worldTrans = Vec3Set(1.f, 2.f, 0.f);
+
+		//build patch constraints
+		for(int yy=0; yy<=h-2; yy++)
+		{
+			for(int xx=0; xx<=w-2; xx++)
+			{
+				int ii, jj;
+				jj = 0; ii = GetI(xx, yy);
+				g_cloth.cnstr[ii].cIndex[jj++] = GetI(xx+1, yy);
+				g_cloth.cnstr[ii].cIndex[jj++] = GetI(xx, yy+1);
+				g_cloth.cnstr[ii].cIndexCount = jj;
+			}
+		}
+
+		//bottom gaps
+		for(int xx=0; xx<=w-2; xx++)
+		{
+			int ii, jj;
+			ii = GetI(xx, h-1);
+			jj = g_cloth.cnstr[ii].cIndexCount;
+			assert(jj == 0);
+			g_cloth.cnstr[ii].cIndex[jj++] = GetI(xx+1, h-1);
+			g_cloth.cnstr[ii].cIndexCount = jj;
+		}
+
+		//right gaps
+		for(int yy=0; yy<=h-2; yy++)
+		{
+			int ii, jj;
+			ii = GetI(w-1, yy);
+			jj = g_cloth.cnstr[ii].cIndexCount;
+			assert(jj == 0);
+			g_cloth.cnstr[ii].cIndex[jj++] = GetI(w-1, yy+1);
+			g_cloth.cnstr[ii].cIndexCount = jj;
+		}
+
+		//setup intial rest points
+		for(int yy=0; yy<=h-1; yy++)
+		{
+			for(int xx=0; xx<=w-1; xx++)
+			{
+				int		ii = GetI(xx, yy);
+
+				float	x = ((float)xx)*cClothRestLength;
+				float	y = ((float)yy)*cClothRestLength;
+
+				g_cloth.m_x[ii] = Vec3Set(x + g_cloth.worldTrans.x, y + g_cloth.worldTrans.y, g_cloth.worldTrans.z);
+				g_cloth.m_oldx[ii] = g_cloth.m_x[ii];
+			}
+		}
+
+		g_cloth.hook[1] = g_cloth.m_x[0];
+		g_cloth.hook[0] = g_cloth.m_x[cClothWidth-1];
+
+		Vec3	diff = Vec3Set(g_cloth.hook[1].x - g_cloth.hook[0].x, g_cloth.hook[1].y - g_cloth.hook[0].y, g_cloth.hook[1].z - g_cloth.hook[0].z);
+		g_cloth.dist = sqrtf(Vec3Dot(diff, diff))*0.5f;
+
+		//other inital values
+		g_cloth.m_vGravity = Vec3Set(0.f, -1.5f, 0.f);
+		g_cloth.NUM_PARTICLES = cClothSize;
+		g_cloth.NUM_ITERATIONS = CLOTH_NUM_ITERATIONS;
+		g_cloth.restlength = cClothRestLength;
+
+		return(S_OK);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	//
+	///////////////////////////////////////////////////////////////////////////////
+	void ClothShutDown(void)
+	{
+		memset(&g_cloth, 0x00, sizeof(g_cloth));
+		ArenaReset(&g_clothArena);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Runs reps simulation steps and returns the time spent inside TimeStep
+	///////////////////////////////////////////////////////////////////////////////
+	void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut)
+	{
+		DenormalScope denormals;
+
+		if (!g_cloth.clothInit)
+		{
+			ClothInit();
+			g_cloth.clothInit = !g_cloth.clothInit;
+		}
+
+		ClothUIHack();
+		g_cloth.fTimeStep = fTimeStep;
+
+		*totalTimeOut = 0.;
+
+		for(int ii=0; ii<reps; ii++)
+		{
+			double time;
+
+			PerformanceCounterStart();
+
+			g_cloth.TimeStep();
+
+			time = PerformanceCounterEnd();
+
+			*totalTimeOut += time;
+		}
+	}
+
+	void ClothUIHack(void)
+	{
+		float	s = sinf(g_cloth.rot);
+		float	c = cosf(g_cloth.rot);
+
+		float	x0 = -g_cloth.dist;
+		float	x1 = +g_cloth.dist;
+
+		g_cloth.hook[0] = Vec3Set(x0*c + g_cloth.worldTrans.x, g_cloth.worldTrans.y, x0*s + g_cloth.worldTrans.z);
+		g_cloth.hook[1] = Vec3Set(x1*c + g_cloth.worldTrans.x, g_cloth.worldTrans.y, x1*s + g_cloth.worldTrans.z);
+	}
+
+	void ClothSetGlobalParam(float rot, float trans, float gravity)
+	{
+		g_cloth.rot = FPU_DTOR(rot);
+		g_cloth.worldTrans = Vec3Set(1.f, trans, 0.f);
+		g_cloth.m_vGravity = Vec3Set(0.f, gravity, 0.f);
+	}
+
+	// the reference always takes the sqrt and the division
+	void ClothSetFastConstraints(int /*newtonSteps*/)
+	{
+	}
+
+	void ClothSetDamping(float d1, float d2)
+	{
+		g_clothDamping[0] = d1;
+		g_clothDamping[1] = d2;
+	}
+
+	void ClothSetConstraintOrder(int order)
+	{
+		g_clothConstraintOrder = order;
+	}
+
+	// x, y, z of up to maxParticles particles, returns how many
+	int ClothGetPositions(float *pXYZ, int maxParticles)
+	{
+		int count = (maxParticles < cClothSize) ? maxParticles : cClothSize;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			pXYZ[3*ii] = g_cloth.m_x[ii].x;
+			pXYZ[3*ii + 1] = g_cloth.m_x[ii].y;
+			pXYZ[3*ii + 2] = g_cloth.m_x[ii].z;
+		}
+
+		return(count);
+	}
+
+
+	///////////////////////////////////////////////////////////////////////////////
+	//							Simulation Code
+	///////////////////////////////////////////////////////////////////////////////
+
+	// Verlet integration step
+	void Cloth::Verlet()
+	{
+		float	d1 = g_clothDamping[0];
+		float	d2 = g_clothDamping[1];
+		float	dt2 = fTimeStep*fTimeStep;
+
+		for(int i=0; i<NUM_PARTICLES; i++)
+		{
+			Vec3& x = m_x[i];
+			Vec3 temp = x;
+			Vec3& oldx = m_oldx[i];
+			Vec3& a = m_a[i];
+
+			x.x += d1*x.x - d2*oldx.x + a.x*dt2;
+			x.y += d1*x.y - d2*oldx.y + a.y*dt2;
+			x.z += d1*x.z - d2*oldx.z + a.z*dt2;
+
+			x.x = Clamp(x.x, -cClothBox, cClothBox);
+			x.y = Clamp(x.y, -cClothBox, cClothBox);
+			x.z = Clamp(x.z, -cClothBox, cClothBox);
+
+			oldx = temp;
+		}
+	}
+
+	// This function should accumulate forces for each particle
+	void Cloth::AccumulateForces()
+	{
+		// All particles are influenced by gravity
+		for(int i=0; i<NUM_PARTICLES; i++)  m_a[i] = m_vGravity;
+	}
+
+	// One stick, always through the sqrt and the division
+	inline void SatisfyStick(Vec3& x1, Vec3& x2, float restlength)
+	{
+		Vec3 delta = Vec3Set(x2.x - x1.x, x2.y - x1.y, x2.z - x1.z);
+		float deltalength = sqrtf(Vec3Dot(delta, delta));
+		float diff = 0.5f*((deltalength - restlength)/deltalength);
+
+		x1.x += delta.x*diff;
+		x1.y += delta.y*diff;
+		x1.z += delta.z*diff;
+		x2.x -= delta.x*diff;
+		x2.y -= delta.y*diff;
+		x2.z -= delta.z*diff;
+	}
+
+	// Here constraints should be satisfied
+	void Cloth::SatisfyConstraints()
+	{
+		if (g_clothConstraintOrder == CLOTH_ORDER_ROWS)
+		{
+			SatisfyConstraintsRows();
+			return;
+		}
+
+		// Implements simulation of a stick in a box
+		for(int j=0; j<NUM_ITERATIONS; j++)
+		{
+			// First satisfy (C1)
+			m_x[0] = hook[0];
+			m_x[cClothWidth-1] = hook[1];
+
+			// For all particles
+			for(int i=0; i<NUM_PARTICLES-1; i++)
+			{
+				// Then satisfy (C2)
+				Vec3& x1 = m_x[i];
+
+				for(int cc=0; cc<cnstr[i].cIndexCount; cc++)
+				{
+					//get 2nd particle index
+					int i2 = cnstr[i].cIndex[cc];
+
+					SatisfyStick(x1, m_x[i2], restlength);
+				}
+			}
+		}
+	}
+
+	// CLOTH_ORDER_ROWS, the order of the CLOTH_VCLASS_WIDE_CONSTRAINTS sweep in
+	// cloth_vclass.inl, one stick at a time
+	void Cloth::SatisfyConstraintsRows()
+	{
+		for(int j=0; j<NUM_ITERATIONS; j++)
+		{
+			m_x[0] = hook[0];
+			m_x[cClothWidth-1] = hook[1];
+
+			for(int yy=0; yy<cClothHeight; yy++)
+			{
+				for(int parity=0; parity<2; parity++)
+				{
+					for(int xx=parity; xx<=cClothWidth-2; xx+=2)
+					{
+						SatisfyStick(m_x[GetI(xx, yy)], m_x[GetI(xx+1, yy)], restlength);
+					}
+				}
+
+				if (yy == cClothHeight-1)
+				{
+					break;
+				}
+
+				for(int xx=0; xx<cClothWidth; xx++)
+				{
+					SatisfyStick(m_x[GetI(xx, yy)], m_x[GetI(xx, yy+1)], restlength);
+				}
+			}
+		}
+	}
+
+	void Cloth::TimeStep()
+	{
+		AccumulateForces();
+		Verlet();
+		SatisfyConstraints();
+	}
+}
@@ -7,6 +7,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 //--------------------------------------------------------------------------------------
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include "DXUTgui.h"
 #include "DXUTguiIME.h"
@@ -16,10 +19,12 @@
 #include "SDKmisc.h"
 #include "resource.h"
 #include <xaudio2.h>
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include <math.h>
 #include "common.h"
+#include "arena.h"
 #include "vclass.h"
 #include "vclass_typedef.h"
 #include "vclass_simdtype.h"
@@ -53,3 +58,39 @@ namespace CLOTH_VCLASS_SIMDTYPE
 
 	#include "cloth_vclass.inl"
 }
+
+namespace CLOTH_VCLASS_SIMDTYPE_DOUBLE
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	// the same solver on 4 doubles per particle, cloth_vclass.inl is written against Vec4
+	typedef VCLASS_SIMDTYPE::Vec4d	Vec4;
+
+	#include "cloth_vclass.inl"
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace CLOTH_VCLASS_SIMDTYPE8
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	// Verlet and AccumulateForces run on Vec8, two particles per register
+	#define CLOTH_VCLASS_WIDE	Vec8
+	#include "cloth_vclass.inl"
+	#undef CLOTH_VCLASS_WIDE
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace CLOTH_VCLASS_SIMDTYPE16
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	// the whole TimeStep on Vec16, four particles (or sticks) per register
+	#define CLOTH_VCLASS_WIDE	Vec16
+	#define CLOTH_VCLASS_WIDE_CONSTRAINTS
+	#include "cloth_vclass.inl"
+	#undef CLOTH_VCLASS_WIDE_CONSTRAINTS
+	#undef CLOTH_VCLASS_WIDE
+}
+#endif
@@ -10,6 +10,7 @@
 
 	const int	cClothSize				= cClothWidth*cClothHeight;
 	const float	cClothRestLength		= (1.f/(float)(cClothWidth))*5.f;
+	const float	cClothBox				= 50.f;		// Verlet keeps the particles in [-cClothBox, cClothBox]
 	const int	cIndicesArrSize			= 32768;
 
 
@@ -26,9 +27,10 @@
 
 	typedef struct Cloth
 	{
-		Vec4						m_x[cClothSize];
-		Vec4						m_oldx[cClothSize];
-		Vec4						m_a[cClothSize];
+		// cClothSize particles each, from g_clothArena
+		Vec4*						m_x;
+		Vec4*						m_oldx;
+		Vec4*						m_a;
 		Vec4						m_vGravity;
 		Vec4						fTimeStep;
 		Vec4						restlength;
@@ -43,14 +45,17 @@
 		int							NUM_ITERATIONS;
 		int							NUM_PARTICLES;
 
+#ifndef SIMD_HEADLESS
 		LPDIRECT3DVERTEXBUFFER9		pVB;
 		LPDIRECT3DINDEXBUFFER9		pVI;
+#endif
 		int							vertCount;
 		int							primCount;
 
 		void AccumulateForces();
 		void Verlet();
 		void SatisfyConstraints();
+		template <int Steps> void SatisfyConstraintsT();
 		void TimeStep();
 
 	}	Cloth, *PCloth;
@@ -62,6 +67,12 @@
 
 	__declspec(align(128))	Cloth	g_cloth;
 
+	// m_x, m_oldx and m_a, outside g_cloth so ClothInit doesn't reset it
+	static Arena	g_clothArena;
+
+	// ClothSetFastConstraints, outside g_cloth so ClothInit doesn't reset it
+	int		g_clothNewtonSteps = CLOTH_CONSTRAINTS_EXACT;
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//								Functions
@@ -75,6 +86,39 @@
 		return((y*cClothWidth) + x);
 	}
 
+	///////////////////////////////////////////////////////////////////////////////
+	// Clear g_cloth member by member, Vec4 isn't safe to memset
+	///////////////////////////////////////////////////////////////////////////////
+	static void ClothClear(void)
+	{
+		Vec4	zero(0.f);
+
+		g_cloth.m_x = NULL;
+		g_cloth.m_oldx = NULL;
+		g_cloth.m_a = NULL;
+		g_cloth.m_vGravity = zero;
+		g_cloth.fTimeStep = zero;
+		g_cloth.restlength = zero;
+		g_cloth.hook[0] = zero;
+		g_cloth.hook[1] = zero;
+		g_cloth.worldTrans = zero;
+
+		g_cloth.clothInit = false;
+		g_cloth.rot = 0.f;
+		g_cloth.dist = 0.f;
+
+		memset(g_cloth.cnstr, 0x00, sizeof(g_cloth.cnstr));
+		g_cloth.NUM_ITERATIONS = 0;
+		g_cloth.NUM_PARTICLES = 0;
+
+#ifndef SIMD_HEADLESS
+		g_cloth.pVB = NULL;
+		g_cloth.pVI = NULL;
+#endif
+		g_cloth.vertCount = 0;
+		g_cloth.primCount = 0;
+	}
+
 	///////////////////////////////////////////////////////////////////////////////
 	//
 	///////////////////////////////////////////////////////////////////////////////
@@ -85,7 +129,25 @@
 		int w = cClothWidth;
 		int h = cClothHeight;
 
-		memset(&g_cloth, 0x00, sizeof(g_cloth));
+		ClothClear();
+
+		// the particle arrays, back to back and cache line aligned, on the pages the
+		// first ClothInit reserved
+		if (!g_clothArena.pBase && !ArenaInit(&g_clothArena, 3*cClothSize*sizeof(Vec4) + 3*cArenaAlign, false))
+		{
+			return (E_FAIL);
+		}
+
+		ArenaReset(&g_clothArena);
+
+		g_cloth.m_x = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+		g_cloth.m_oldx = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+		g_cloth.m_a = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+
+		for(int ii=0; ii<cClothSize; ii++)
+		{
+			g_cloth.m_a[ii] = Vec4(0.f);
+		}
 
 		g_cloth.worldTrans = Vec4(1.f, 2.f, 0.f, 0.f);
 
@@ -170,6 +232,7 @@
 		g_cloth.restlength = Vec4(cClothRestLength);
 
 
+#ifndef SIMD_HEADLESS
 		//setup index buffers
 		WORD indicesArr[cIndicesArrSize];		//nasty, create tmp array on stack
 		memset(indicesArr, 0x00, sizeof(indicesArr));
@@ -241,6 +304,7 @@
 		}
 
 		ClothCopyVertices(true);
+#endif
 		return(hr);
 	}
 
@@ -249,12 +313,16 @@
 	///////////////////////////////////////////////////////////////////////////////
 	void ClothShutDown(void)
 	{
+#ifndef SIMD_HEADLESS
 		SAFE_RELEASE(g_cloth.pVB);
 		SAFE_RELEASE(g_cloth.pVI);
-		memset(&g_cloth, 0x00, sizeof(g_cloth));
+#endif
+		ClothClear();
+		ArenaReset(&g_clothArena);
 	}
 
 
+#ifndef SIMD_HEADLESS
 	///////////////////////////////////////////////////////////////////////////////
 	//
 	///////////////////////////////////////////////////////////////////////////////
@@ -289,14 +357,12 @@
 				for(int xx=0; xx<=w-1; xx++)
 				{
 					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
+					const Vec4&	x = g_cloth.m_x[ii];
 
-					//VStore(f, g_cloth.m_x[ii]);
-					g_cloth.m_x[ii].Store(f);
-
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
+					// x, y, z are lanes 3, 2, 1 of m_x
+					Vec4::GetX(&pV[kk].x, Vec4::Swizzle<3,3,3,3>(x));
+					Vec4::GetX(&pV[kk].y, Vec4::Swizzle<2,3,2,3>(x));
+					Vec4::GetX(&pV[kk].z, Vec4::Swizzle<1,1,3,3>(x));
 
 					//add some cool colors since I won't lit the patches
 					float	xF = (1.f-((float)xx * ((float)1.f/(w-1))))*255.f;
@@ -315,14 +381,12 @@
 				for(int xx=0; xx<=w-1; xx++)
 				{
 					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
-
-					//VStore(f, g_cloth.m_x[ii]);
-					g_cloth.m_x[ii].Store(f);
+					const Vec4&	x = g_cloth.m_x[ii];
 
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
+					// x, y, z are lanes 3, 2, 1 of m_x
+					Vec4::GetX(&pV[kk].x, Vec4::Swizzle<3,3,3,3>(x));
+					Vec4::GetX(&pV[kk].y, Vec4::Swizzle<2,3,2,3>(x));
+					Vec4::GetX(&pV[kk].z, Vec4::Swizzle<1,1,3,3>(x));
 					kk++;
 				}
 			}
@@ -341,6 +405,39 @@
 	{
 		HRESULT hr = S_OK;
 
+		ClothSimulate(fTimeStep, reps, totalTimeOut);
+
+		ClothCopyVertices(false);
+
+		// Turn off culling, so we see the front and back of the triangle
+		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_NONE );
+
+		// Turn off D3D lighting, since we are providing our own vertex colors
+		pd3dDevice->SetRenderState( D3DRS_LIGHTING, FALSE );
+
+		pd3dDevice->SetTransform( D3DTS_WORLD, mWorld );
+		pd3dDevice->SetTransform( D3DTS_VIEW, mView );
+		pd3dDevice->SetTransform( D3DTS_PROJECTION, mProj );
+
+		// Render the vertex buffer contents
+		pd3dDevice->SetStreamSource( 0, g_cloth.pVB, 0, sizeof( CUSTOMVERTEX ) );
+		pd3dDevice->SetFVF( D3DFVF_CUSTOMVERTEX );
+		pd3dDevice->SetIndices( g_cloth.pVI);
+		pd3dDevice->DrawIndexedPrimitive( D3DPT_LINELIST, 0, 0, g_cloth.vertCount, 0,  g_cloth.primCount);
+
+		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_CCW );
+
+		return(hr);
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Runs reps simulation steps and returns the time spent inside TimeStep
+	///////////////////////////////////////////////////////////////////////////////
+	void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut)
+	{
+		DenormalScope denormals;
+
 		if (!g_cloth.clothInit)
 		{
 			ClothInit();
@@ -364,28 +461,6 @@
 
 			*totalTimeOut += time;
 		}
-
-		ClothCopyVertices(false);
-
-		// Turn off culling, so we see the front and back of the triangle
-		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_NONE );
-
-		// Turn off D3D lighting, since we are providing our own vertex colors
-		pd3dDevice->SetRenderState( D3DRS_LIGHTING, FALSE );
-
-		pd3dDevice->SetTransform( D3DTS_WORLD, mWorld );
-		pd3dDevice->SetTransform( D3DTS_VIEW, mView );
-		pd3dDevice->SetTransform( D3DTS_PROJECTION, mProj );
-
-		// Render the vertex buffer contents
-		pd3dDevice->SetStreamSource( 0, g_cloth.pVB, 0, sizeof( CUSTOMVERTEX ) );
-		pd3dDevice->SetFVF( D3DFVF_CUSTOMVERTEX );
-		pd3dDevice->SetIndices( g_cloth.pVI);
-		pd3dDevice->DrawIndexedPrimitive( D3DPT_LINELIST, 0, 0, g_cloth.vertCount, 0,  g_cloth.primCount);
-
-		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_CCW );
-
-		return(hr);
 	}
 
 	void ClothUIHack(void)
@@ -415,6 +490,29 @@
 		g_cloth.m_vGravity = Vec4(0.f, gravity, 0.f, 0.f);
 	}
 
+	void ClothSetFastConstraints(int newtonSteps)
+	{
+		g_clothNewtonSteps = newtonSteps;
+	}
+
+	// x, y, z of up to maxParticles particles, returns how many
+	int ClothGetPositions(float *pXYZ, int maxParticles)
+	{
+		int count = (maxParticles < cClothSize) ? maxParticles : cClothSize;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			const Vec4&	x = g_cloth.m_x[ii];
+
+			// x, y, z are lanes 3, 2, 1 of m_x
+			Vec4::GetX(&pXYZ[3*ii], Vec4::Swizzle<3,3,3,3>(x));
+			Vec4::GetX(&pXYZ[3*ii + 1], Vec4::Swizzle<2,2,2,2>(x));
+			Vec4::GetX(&pXYZ[3*ii + 2], Vec4::Swizzle<1,1,1,1>(x));
+		}
+
+		return(count);
+	}
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//							Simulation Code
@@ -423,8 +521,40 @@
 	// Verlet integration step
 	void Cloth::Verlet()
 	{
-		Vec4	d1 = Vec4(0.99901f);
-		Vec4	d2 = Vec4(0.99898f);
+#ifdef CLOTH_VCLASS_WIDE
+		// cParticles particles per register, the last register is masked
+		typedef CLOTH_VCLASS_WIDE				VecW;
+		typedef VecW::rep_type::mask_type		MaskW;
+
+		const int	cParticles = VecW::cWidth/4;
+		float		dt;
+
+		Vec4::GetX(&dt, fTimeStep);
+
+		VecW	wd1 = VecW(CLOTH_VCLASS_D1);
+		VecW	wd2 = VecW(CLOTH_VCLASS_D2);
+		VecW	wdt = VecW(dt);
+		VecW	wboxMin = VecW(-cClothBox);
+		VecW	wboxMax = VecW(cClothBox);
+
+		for(int i=0; i<NUM_PARTICLES; i+=cParticles)
+		{
+			MaskW m = VecW::rep_type::TailMask(4*(NUM_PARTICLES-i));
+
+			VecW x = VecW::Load(m, (float*)&m_x[i]);
+			VecW oldx = VecW::Load(m, (float*)&m_oldx[i]);
+			VecW a = VecW::Load(m, (float*)&m_a[i]);
+
+			x.Store(m, (float*)&m_oldx[i]);
+			x = VecW::VMAdd(a, wdt*wdt, VecW::VNMSub(wd2, oldx, VecW::VMAdd(wd1, x, x)));
+			x = VecW::VClamp(x, wboxMin, wboxMax);
+			x.Store(m, (float*)&m_x[i]);
+		}
+#else
+		Vec4	d1 = Vec4(CLOTH_VCLASS_D1);
+		Vec4	d2 = Vec4(CLOTH_VCLASS_D2);
+		Vec4	boxMin = Vec4(-cClothBox);
+		Vec4	boxMax = Vec4(cClothBox);
 
 		for(int i=0; i<NUM_PARTICLES; i++)
 		{
@@ -432,20 +562,166 @@
 			Vec4 temp = x;
 			Vec4& oldx = m_oldx[i];
 			Vec4& a = m_a[i];
-			x += (d1*x)-(d2*oldx)+a*fTimeStep*fTimeStep;
+			x = Vec4::VMAdd(a, fTimeStep*fTimeStep, Vec4::VNMSub(d2, oldx, Vec4::VMAdd(d1, x, x)));
+			x = Vec4::VClamp(x, boxMin, boxMax);
 			oldx = temp;
 		}
+#endif
 	}
 
 	// This function should accumulate forces for each particle
 	void Cloth::AccumulateForces()
 	{    
 		// All particles are influenced by gravity
+#ifdef CLOTH_VCLASS_WIDE
+		typedef CLOTH_VCLASS_WIDE				VecW;
+		typedef VecW::rep_type::mask_type		MaskW;
+
+		const int	cParticles = VecW::cWidth/4;
+		__declspec(align(16)) float	g[4];
+
+		m_vGravity.Store(g);
+
+		VecW	gravity = VecW(g[3], g[2], g[1], g[0]);
+
+		for(int i=0; i<NUM_PARTICLES; i+=cParticles)
+		{
+			MaskW m = VecW::rep_type::TailMask(4*(NUM_PARTICLES-i));
+
+			gravity.Store(m, (float*)&m_a[i]);
+		}
+#else
 		for(int i=0; i<NUM_PARTICLES; i++)  m_a[i] = m_vGravity;
+#endif
+	}
+
+	// half*(|delta|-restlength)/|delta|, see CLOTH_CONSTRAINTS_EXACT
+	template <int Steps, typename V>
+	inline V StickDiff(const V& delta, const V& restlength, const V& half)
+	{
+		if (Steps == CLOTH_CONSTRAINTS_EXACT)
+		{
+			V deltalength = V::Sqrt(V::Dot(delta,delta));
+			return half*((deltalength-restlength)/deltalength);
+		}
+
+		V invlength = V::template VRsqrtEst<(Steps < 0) ? 0 : Steps>(V::Dot(delta,delta));
+		return half*V::VNMSub(restlength, invlength, V(1.f));
 	}
 
-	// Here constraints should be satisfied
 	void Cloth::SatisfyConstraints()
+	{
+		switch(g_clothNewtonSteps)
+		{
+			case 0:		SatisfyConstraintsT<0>(); break;
+			case 1:		SatisfyConstraintsT<1>(); break;
+			case 2:		SatisfyConstraintsT<2>(); break;
+			default:	SatisfyConstraintsT<CLOTH_CONSTRAINTS_EXACT>(); break;
+		}
+	}
+
+#ifdef CLOTH_VCLASS_WIDE_CONSTRAINTS
+	// One stick per particle pair (x1[k], x2[k]) of the registers. Masked-off
+	// lanes hold zeros and turn into NaN, the caller's masked stores drop them.
+	template <int Steps>
+	inline void SatisfyStick(CLOTH_VCLASS_WIDE& x1, CLOTH_VCLASS_WIDE& x2, const CLOTH_VCLASS_WIDE& restlength, const CLOTH_VCLASS_WIDE& half)
+	{
+		typedef CLOTH_VCLASS_WIDE	VecW;
+
+		VecW delta = x2-x1;
+		VecW diff = StickDiff<Steps>(delta, restlength, half);
+		x1 = VecW::VMAdd(delta, diff, x1);
+		x2 = VecW::VNMSub(delta, diff, x2);
+	}
+
+	// Here constraints should be satisfied
+	// Wide version: rows are swept top-down like the sequential loop below.
+	// Within a row the horizontal sticks are split in even/odd sets and the
+	// vertical sticks are all independent, so neither set shares a particle
+	// and each is solved cParticles sticks at a time. Only the visiting order
+	// inside a row differs, results are close but not bitwise.
+	// Relies on the grid topology built in ClothInit.
+	template <int Steps>
+	void Cloth::SatisfyConstraintsT()
+	{
+		typedef CLOTH_VCLASS_WIDE				VecW;
+		typedef VecW::rep_type::mask_type		MaskW;
+
+		const int	cParticles = VecW::cWidth/4;
+		const int	w = cClothWidth;
+		const int	h = cClothHeight;
+
+		VecW	wrest;
+		VecW	whalf = VecW(0.5f);
+		float	r;
+
+		Vec4::GetX(&r, restlength);
+		wrest = VecW(r);
+
+		for(int j=0; j<NUM_ITERATIONS; j++)
+		{
+			// First satisfy (C1)
+			m_x[0] = hook[0];
+			m_x[cClothWidth-1] = hook[1];
+
+			// Sweep the rows top-down like the sequential loop
+			for(int yy=0; yy<h; yy++)
+			{
+				float*	pRow1 = (float*)&m_x[GetI(0, yy)];
+
+				// Horizontal sticks (xx,yy)-(xx+1,yy), even xx then odd xx
+				for(int parity=0; parity<2; parity++)
+				{
+					for(int xx=parity; xx<=w-2; xx+=2*cParticles)
+					{
+						int sticks = (w-2-xx)/2 + 1;
+						int count = 2*(sticks < cParticles ? sticks : cParticles);
+
+						MaskW ma = VecW::rep_type::TailMask(4*count);
+						MaskW mb = VecW::rep_type::TailMask(4*(count-cParticles));
+
+						VecW a = VecW::Load(ma, pRow1 + 4*xx);
+						VecW b = VecW::Load(mb, pRow1 + 4*(xx+cParticles));
+						VecW x1, x2;
+
+						VecW::Deinterleave(a, b, x1, x2);
+						SatisfyStick<Steps>(x1, x2, wrest, whalf);
+						VecW::Interleave(x1, x2, a, b);
+
+						a.Store(ma, pRow1 + 4*xx);
+						b.Store(mb, pRow1 + 4*(xx+cParticles));
+					}
+				}
+
+				if (yy == h-1)
+				{
+					break;
+				}
+
+				// Vertical sticks (xx,yy)-(xx,yy+1)
+				float*	pRow2 = (float*)&m_x[GetI(0, yy+1)];
+
+				for(int xx=0; xx<w; xx+=cParticles)
+				{
+					MaskW m = VecW::rep_type::TailMask(4*(w-xx));
+
+					VecW x1 = VecW::Load(m, pRow1 + 4*xx);
+					VecW x2 = VecW::Load(m, pRow2 + 4*xx);
+
+					SatisfyStick<Steps>(x1, x2, wrest, whalf);
+
+					x1.Store(m, pRow1 + 4*xx);
+					x2.Store(m, pRow2 + 4*xx);
+				}
+			}
+		}
+	}
+#else
+	// Here constraints should be satisfied
+	// Stays 4-wide for CLOTH_VCLASS_WIDE: the relaxation is Gauss-Seidel, each
+	// constraint sees the positions written by the previous one
+	template <int Steps>
+	void Cloth::SatisfyConstraintsT()
 	{
 		Vec4	half = Vec4(0.5f);
 
@@ -469,14 +745,14 @@
 
 					Vec4& x2 = m_x[i2];
 					Vec4 delta = x2-x1;
-					Vec4 deltalength = Vec4::Sqrt(Vec4::Dot(delta,delta));
-					Vec4 diff = (deltalength-restlength)/deltalength;
-					x1 += delta*half*diff;
-					x2 -= delta*half*diff;
+					Vec4 diff = StickDiff<Steps>(delta, restlength, half);
+					x1 = Vec4::VMAdd(delta, diff, x1);
+					x2 = Vec4::VNMSub(delta, diff, x2);
 				}
 			}
 		}
 	}
+#endif
 
 	void Cloth::TimeStep()
 	{
@@ -7,6 +7,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 //--------------------------------------------------------------------------------------
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include "DXUTgui.h"
 #include "DXUTguiIME.h"
@@ -16,10 +19,12 @@
 #include "SDKmisc.h"
 #include "resource.h"
 #include <xaudio2.h>
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include <math.h>
 #include "common.h"
+#include "arena.h"
 #include "vmath.h"
 #include "cloth.h"
 
@@ -49,6 +54,7 @@ namespace CLOTH_VMATH
 
 	const int	cClothSize				= cClothWidth*cClothHeight;
 	const float	cClothRestLength		= (1.f/(float)(cClothWidth))*5.f;
+	const float	cClothBox				= 50.f;		// Verlet keeps the particles in [-cClothBox, cClothBox]
 	const int	cIndicesArrSize			= 32768;
 
 
@@ -65,9 +71,19 @@ namespace CLOTH_VMATH
 
 	typedef struct Cloth
 	{
-		Vec4						m_x[cClothSize];
-		Vec4						m_oldx[cClothSize];
-		Vec4						m_a[cClothSize];
+		// cClothSize particles each, from g_clothArena
+		Vec4*						m_x;
+#if defined(CLOTH_HALF_STORAGE)
+		// CLOTH_HALF_STORAGE (cmake -DSIMD_CLOTH_HALF=ON) keeps the step m_x - m_oldx
+		// as Half4 instead of m_oldx, half the bytes, and 11 bits of mantissa relative
+		// to the step rather than to the position. The constraints move m_x after
+		// Verlet, so Verlet leaves the old positions in m_a and StoreSteps takes the
+		// step once they are done
+		Half4*						m_dx;
+#else
+		Vec4*						m_oldx;
+#endif
+		Vec4*						m_a;
 		Vec4						m_vGravity;
 		Vec4						fTimeStep;
 		Vec4						restlength;
@@ -82,14 +98,21 @@ namespace CLOTH_VMATH
 		int							NUM_ITERATIONS;
 		int							NUM_PARTICLES;
 
+#ifndef SIMD_HEADLESS
+		DWORD						m_color[cClothSize];
 		LPDIRECT3DVERTEXBUFFER9		pVB;
 		LPDIRECT3DINDEXBUFFER9		pVI;
+#endif
 		int							vertCount;
 		int							primCount;
 
 		void AccumulateForces();
 		void Verlet();
 		void SatisfyConstraints();
+		template <int Steps> void SatisfyConstraintsT();
+#if defined(CLOTH_HALF_STORAGE)
+		void StoreSteps();
+#endif
 		void TimeStep();
 
 	}	Cloth, *PCloth;
@@ -101,6 +124,12 @@ namespace CLOTH_VMATH
 
 	__declspec(align(128))	Cloth	g_cloth;
 
+	// m_x, m_oldx (m_dx) and m_a, outside g_cloth so ClothInit doesn't reset it
+	static Arena	g_clothArena;
+
+	// ClothSetFastConstraints, outside g_cloth so ClothInit doesn't reset it
+	int		g_clothNewtonSteps = CLOTH_CONSTRAINTS_EXACT;
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//								Functions
@@ -126,6 +155,25 @@ namespace CLOTH_VMATH
 
 		memset(&g_cloth, 0x00, sizeof(g_cloth));
 
+		// the particle arrays, back to back and cache line aligned, on the pages the
+		// first ClothInit reserved
+		if (!g_clothArena.pBase && !ArenaInit(&g_clothArena, 3*cClothSize*sizeof(Vec4) + 3*cArenaAlign, false))
+		{
+			return (E_FAIL);
+		}
+
+		ArenaReset(&g_clothArena);
+
+		g_cloth.m_x = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+#if defined(CLOTH_HALF_STORAGE)
+		g_cloth.m_dx = (Half4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Half4));
+#else
+		g_cloth.m_oldx = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+#endif
+		g_cloth.m_a = (Vec4*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(Vec4));
+
+		memset(g_cloth.m_a, 0x00, cClothSize*sizeof(Vec4));
+
 		g_cloth.worldTrans = VLoad(1.f, 2.f, 0.f, 0.f);
 
 		//build patch constraints
@@ -188,8 +236,12 @@ namespace CLOTH_VMATH
 
 				Vec4	localPos = VLoad(x, y, 0.f, 0.f);
 
-				g_cloth.m_x[ii] = 
-				g_cloth.m_oldx[ii] = VAdd(localPos, g_cloth.worldTrans);
+				g_cloth.m_x[ii] = VAdd(localPos, g_cloth.worldTrans);
+#if defined(CLOTH_HALF_STORAGE)
+				VStoreHalf(&g_cloth.m_dx[ii], VLoad(0.f));
+#else
+				g_cloth.m_oldx[ii] = g_cloth.m_x[ii];
+#endif
 			}
 		}
 
@@ -209,6 +261,7 @@ namespace CLOTH_VMATH
 		g_cloth.restlength = VLoad(cClothRestLength);
 
 
+#ifndef SIMD_HEADLESS
 		//setup index buffers
 		WORD indicesArr[cIndicesArrSize];		//nasty, create tmp array on stack
 		memset(indicesArr, 0x00, sizeof(indicesArr));
@@ -280,6 +333,7 @@ namespace CLOTH_VMATH
 		}
 
 		ClothCopyVertices(true);
+#endif
 		return(hr);
 	}
 
@@ -288,12 +342,16 @@ namespace CLOTH_VMATH
 	///////////////////////////////////////////////////////////////////////////////
 	void ClothShutDown(void)
 	{
+#ifndef SIMD_HEADLESS
 		SAFE_RELEASE(g_cloth.pVB);
 		SAFE_RELEASE(g_cloth.pVI);
+#endif
 		memset(&g_cloth, 0x00, sizeof(g_cloth));
+		ArenaReset(&g_clothArena);
 	}
 
 
+#ifndef SIMD_HEADLESS
 	///////////////////////////////////////////////////////////////////////////////
 	//
 	///////////////////////////////////////////////////////////////////////////////
@@ -320,53 +378,50 @@ namespace CLOTH_VMATH
 		//memcpy( pVertices, g_Vertices, sizeof( g_Vertices ) );
 		CUSTOMVERTEX*	pV = (CUSTOMVERTEX*)pVertices;
 
+		// the buffer is write only for the CPU: whole 16 byte vertices go out with
+		// non-temporal stores (the color kept in m_color), field stores if the lock
+		// is not 16 byte aligned
+		bool stream = !((UINT_PTR)pV & 15);
+
 		int kk=0;
-		if (addColor)
+		for(int yy=0; yy<=h-1; yy++)
 		{
-			for(int yy=0; yy<=h-1; yy++)
+			for(int xx=0; xx<=w-1; xx++)
 			{
-				for(int xx=0; xx<=w-1; xx++)
-				{
-					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
-
-					VStore(f, g_cloth.m_x[ii]);
-					//g_cloth.m_x[ii].Store(f);
-
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
+				int ii = GetI(xx, yy);
 
+				if (addColor)
+				{
 					//add some cool colors since I won't lit the patches
 					float	xF = (1.f-((float)xx * ((float)1.f/(w-1))))*255.f;
 					float	yF = (1.f-((float)yy * ((float)1.f/(h-1))))*255.f;
 
-					
-					pV[kk].color = D3DCOLOR_ARGB(0xff, (short)xF, (short)yF, 0xff);
-					kk++;
+					g_cloth.m_color[ii] = D3DCOLOR_ARGB(0xff, (short)xF, (short)yF, 0xff);
 				}
-			}
-		}
-		else
-		{
-			for(int yy=0; yy<=h-1; yy++)
-			{
-				for(int xx=0; xx<=w-1; xx++)
-				{
-					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
 
-					VStore(f, g_cloth.m_x[ii]);
-					//g_cloth.m_x[ii].Store(f);
+				// x, y, z are lanes 3, 2, 1 of m_x
+				Vec4 p = Swizzle<3,2,1,0>(g_cloth.m_x[ii]);
+
+				if (stream)
+				{
+					Vec4 c = _mm_castsi128_ps(_mm_cvtsi32_si128((int)g_cloth.m_color[ii]));
 
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
-					kk++;
+					VStoreStream((float*)&pV[kk], Permute<0,1,2,4>(p, c));
 				}
+				else
+				{
+					_mm_storel_pi((__m64*)&pV[kk].x, p);
+					GetX(&pV[kk].z, Swizzle<2,3,2,3>(p));
+					pV[kk].color = g_cloth.m_color[ii];
+				}
+				kk++;
 			}
 		}
 
+		if (stream)
+		{
+			VStoreFence();
+		}
 
 		g_cloth.pVB->Unlock();
 
@@ -380,29 +435,7 @@ namespace CLOTH_VMATH
 	{
 		HRESULT hr = S_OK;
 
-		if (!g_cloth.clothInit)
-		{
-			ClothInit();
-			g_cloth.clothInit = !g_cloth.clothInit;
-		}
-
-		ClothUIHack();
-		g_cloth.fTimeStep = VLoad(fTimeStep);
-
-		*totalTimeOut = 0.;
-
-		for(int ii=0; ii<reps; ii++)
-		{
-			double time;
-
-			PerformanceCounterStart();
-
-			g_cloth.TimeStep();
-
-			time = PerformanceCounterEnd();
-
-			*totalTimeOut += time;
-		}
+		ClothSimulate(fTimeStep, reps, totalTimeOut);
 
 		ClothCopyVertices(false);
 
@@ -426,22 +459,47 @@ namespace CLOTH_VMATH
 
 		return(hr);
 	}
+#endif
 
-	void ClothUIHack(void)
+	///////////////////////////////////////////////////////////////////////////////
+	// Runs reps simulation steps and returns the time spent inside TimeStep
+	///////////////////////////////////////////////////////////////////////////////
+	void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut)
 	{
-		float	s = sinf(g_cloth.rot);
-		float	c = cosf(g_cloth.rot);
+		DenormalScope denormals;
+
+		if (!g_cloth.clothInit)
+		{
+			ClothInit();
+			g_cloth.clothInit = !g_cloth.clothInit;
+		}
 
-		float	x0 = -g_cloth.dist;
-		float	x0r = x0*c;
-		float	z0r = x0*s;
+		ClothUIHack();
+		g_cloth.fTimeStep = VLoad(fTimeStep);
 
-		float	x1 = +g_cloth.dist;
-		float	x1r = x1*c;
-		float	z1r = x1*s;
+		*totalTimeOut = 0.;
 
-		Vec4	pa = VAdd(VLoad(x0r, 0.f, z0r, 0.f), g_cloth.worldTrans);
-		Vec4	pb = VAdd(VLoad(x1r, 0.f, z1r, 0.f), g_cloth.worldTrans);
+		for(int ii=0; ii<reps; ii++)
+		{
+			double time;
+
+			PerformanceCounterStart();
+
+			g_cloth.TimeStep();
+
+			time = PerformanceCounterEnd();
+
+			*totalTimeOut += time;
+		}
+	}
+
+	void ClothUIHack(void)
+	{
+		// (cos, 0, sin, 0) of rot in one Sin, sin(0) = 0
+		Vec4	cs = Sin(VLoad(g_cloth.rot + 1.57079632679489662f, 0.f, g_cloth.rot, 0.f));
+
+		Vec4	pa = VMAdd(VReplicate(-g_cloth.dist), cs, g_cloth.worldTrans);
+		Vec4	pb = VMAdd(VReplicate(+g_cloth.dist), cs, g_cloth.worldTrans);
 
 		g_cloth.hook[0] = pa;
 		g_cloth.hook[1] = pb;
@@ -454,6 +512,27 @@ namespace CLOTH_VMATH
 		g_cloth.m_vGravity = VLoad(0.f, gravity, 0.f, 0.f);
 	}
 
+	void ClothSetFastConstraints(int newtonSteps)
+	{
+		g_clothNewtonSteps = newtonSteps;
+	}
+
+	// x, y, z of up to maxParticles particles, returns how many
+	int ClothGetPositions(float *pXYZ, int maxParticles)
+	{
+		int count = (maxParticles < cClothSize) ? maxParticles : cClothSize;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			// x, y, z are lanes 3, 2, 1 of m_x
+			GetX(&pXYZ[3*ii], Swizzle<3,3,3,3>(g_cloth.m_x[ii]));
+			GetX(&pXYZ[3*ii + 1], Swizzle<2,2,2,2>(g_cloth.m_x[ii]));
+			GetX(&pXYZ[3*ii + 2], Swizzle<1,1,1,1>(g_cloth.m_x[ii]));
+		}
+
+		return(count);
+	}
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//							Simulation Code
@@ -462,25 +541,35 @@ namespace CLOTH_VMATH
 	// Verlet integration step
 	void Cloth::Verlet()
 	{
-		Vec4	d1 = VReplicate(0.99902f);
-		Vec4	d2 = VReplicate(0.99897f);
+		Vec4	d1 = VReplicate(CLOTH_VMATH_D1);
+		Vec4	d2 = VReplicate(CLOTH_VMATH_D2);
+		Vec4	boxMin = VReplicate(-cClothBox);
+		Vec4	boxMax = VReplicate(cClothBox);
 
 		for(int i=0; i<NUM_PARTICLES; i++)
 		{
 			Vec4& x = m_x[i];
 			Vec4 temp = x;
+#if defined(CLOTH_HALF_STORAGE)
+			Vec4 oldx = VSub(x, VLoadHalf(&m_dx[i]));
+#else
 			Vec4& oldx = m_oldx[i];
+#endif
 			Vec4& a = m_a[i];
 
 #ifdef __INTEL_COMPILER	//for intel compiler using overloaded operators usually generate better code
 			x += (d1*x)-(d2*oldx)+a*fTimeStep*fTimeStep;
 #else
-			Vec4 t0 = VMul(a, VMul(fTimeStep, fTimeStep));
-			Vec4 t1 = VSub(VMul(d1,x), VMul(d2,oldx));
-			x = VAdd(x, VAdd(t0, t1));
+			Vec4 t0 = VNMSub(d2, oldx, VMAdd(d1, x, x));
+			x = VMAdd(a, VMul(fTimeStep, fTimeStep), t0);
 #endif
-			
+			x = VClamp(x, boxMin, boxMax);
+
+#if defined(CLOTH_HALF_STORAGE)
+			a = temp;
+#else
 			oldx = temp;
+#endif
 		}
 	}
 
@@ -493,7 +582,33 @@ namespace CLOTH_VMATH
 
 
 	// Here constraints should be satisfied
+	// (|delta|-restlength)/|delta|, see CLOTH_CONSTRAINTS_EXACT
+	template <int Steps>
+	inline Vec4 StickDiff(Vec4 delta, Vec4 restlength)
+	{
+		if (Steps == CLOTH_CONSTRAINTS_EXACT)
+		{
+			Vec4 deltalength = Sqrt(Dot(delta,delta));
+			return(VDiv(VSub(deltalength,restlength),deltalength));
+		}
+
+		Vec4 invlength = VRsqrtEst<(Steps < 0) ? 0 : Steps>(Dot(delta,delta));
+		return(VNMSub(restlength, invlength, VReplicate(1.f)));
+	}
+
 	void Cloth::SatisfyConstraints()
+	{
+		switch(g_clothNewtonSteps)
+		{
+			case 0:		SatisfyConstraintsT<0>(); break;
+			case 1:		SatisfyConstraintsT<1>(); break;
+			case 2:		SatisfyConstraintsT<2>(); break;
+			default:	SatisfyConstraintsT<CLOTH_CONSTRAINTS_EXACT>(); break;
+		}
+	}
+
+	template <int Steps>
+	void Cloth::SatisfyConstraintsT()
 	{
 		Vec4	half = VReplicate(0.5f);
 
@@ -518,28 +633,37 @@ namespace CLOTH_VMATH
 #ifdef __INTEL_COMPILER
 					Vec4& x2 = m_x[i2];
 					Vec4 delta = x2-x1;
-					Vec4 deltalength = Sqrt(Dot(delta,delta));
-					Vec4 diff = (deltalength-restlength)/deltalength;
+					Vec4 diff = StickDiff<Steps>(delta, restlength);
 					x1 += delta*half*diff;
 					x2 -= delta*half*diff;
 #else
 					Vec4& x2 = m_x[i2];
 					Vec4 delta = VSub(x2, x1);
-					Vec4 deltalength = Sqrt(Dot(delta,delta));
-					Vec4 diff = VDiv(VSub(deltalength,restlength),deltalength);
-					Vec4 t0 = VMul(delta, VMul(half, diff));
-					x1 = VAdd(x1, t0);
-					x2 = VSub(x2, t0);
+					Vec4 diff = StickDiff<Steps>(delta, restlength);
+					Vec4 t0 = VMul(half, diff);
+					x1 = VMAdd(delta, t0, x1);
+					x2 = VNMSub(delta, t0, x2);
 #endif
 				}
 			}
 		}
 	}
 
+#if defined(CLOTH_HALF_STORAGE)
+	// m_x - m_oldx as Half4, m_oldx is in m_a since Verlet
+	void Cloth::StoreSteps()
+	{
+		for(int i=0; i<NUM_PARTICLES; i++)  VStoreHalf(&m_dx[i], VSub(m_x[i], m_a[i]));
+	}
+#endif
+
 	void Cloth::TimeStep()
 	{
 		AccumulateForces();
 		Verlet();
 		SatisfyConstraints();
+#if defined(CLOTH_HALF_STORAGE)
+		StoreSteps();
+#endif
 	}
 }
@@ -7,13 +7,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include <xaudio2.h>
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include "_xnamath_.h"
 #include <math.h>
 #include "common.h"
+#include "arena.h"
 #include "cloth.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,6 +44,7 @@ namespace CLOTH_XNAMATH
 
 	const int	cClothSize				= cClothWidth*cClothHeight;
 	const float	cClothRestLength		= (1.f/(float)(cClothWidth))*5.f;
+	const float	cClothBox				= 50.f;		// Verlet keeps the particles in [-cClothBox, cClothBox]
 	const int	cIndicesArrSize			= 32768;
 
 
@@ -55,9 +61,10 @@ namespace CLOTH_XNAMATH
 
 	typedef struct Cloth
 	{
-		XMVECTOR					m_x[cClothSize];
-		XMVECTOR					m_oldx[cClothSize];
-		XMVECTOR					m_a[cClothSize];
+		// cClothSize particles each, from g_clothArena
+		XMVECTOR*				m_x;
+		XMVECTOR*				m_oldx;
+		XMVECTOR*				m_a;
 		XMVECTOR					m_vGravity;
 		XMVECTOR					fTimeStep;
 		XMVECTOR					restlength;
@@ -72,14 +79,17 @@ namespace CLOTH_XNAMATH
 		int							NUM_ITERATIONS;
 		int							NUM_PARTICLES;
 
+#ifndef SIMD_HEADLESS
 		LPDIRECT3DVERTEXBUFFER9		pVB;
 		LPDIRECT3DINDEXBUFFER9		pVI;
+#endif
 		int							vertCount;
 		int							primCount;
 
 		void AccumulateForces();
 		void Verlet();
 		void SatisfyConstraints();
+		template <int Steps> void SatisfyConstraintsT();
 		void TimeStep();
 
 	}	Cloth, *PCloth;
@@ -91,6 +101,12 @@ namespace CLOTH_XNAMATH
 
 	__declspec(align(128))	Cloth	g_cloth;
 
+	// m_x, m_oldx and m_a, outside g_cloth so ClothInit doesn't reset it
+	static Arena	g_clothArena;
+
+	// ClothSetFastConstraints, outside g_cloth so ClothInit doesn't reset it
+	int		g_clothNewtonSteps = CLOTH_CONSTRAINTS_EXACT;
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//								Functions
@@ -116,6 +132,21 @@ namespace CLOTH_XNAMATH
 
 		memset(&g_cloth, 0x00, sizeof(g_cloth));
 
+		// the particle arrays, back to back and cache line aligned, on the pages the
+		// first ClothInit reserved
+		if (!g_clothArena.pBase && !ArenaInit(&g_clothArena, 3*cClothSize*sizeof(XMVECTOR) + 3*cArenaAlign, false))
+		{
+			return (E_FAIL);
+		}
+
+		ArenaReset(&g_clothArena);
+
+		g_cloth.m_x = (XMVECTOR*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(XMVECTOR));
+		g_cloth.m_oldx = (XMVECTOR*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(XMVECTOR));
+		g_cloth.m_a = (XMVECTOR*)ArenaAlloc(&g_clothArena, cClothSize*sizeof(XMVECTOR));
+
+		memset(g_cloth.m_a, 0x00, cClothSize*sizeof(XMVECTOR));
+
 		//g_cloth.worldTrans = XMVectorSet(1.f, 2.f, 0.f, 0.f);
 		g_cloth.worldTrans = XMVectorSet(0.f, 0.f, 2.f, 1.f);
 
@@ -202,6 +233,7 @@ namespace CLOTH_XNAMATH
 		g_cloth.restlength = XMVectorReplicate(cClothRestLength);
 
 
+#ifndef SIMD_HEADLESS
 		//setup index buffers
 		WORD indicesArr[cIndicesArrSize];		//nasty, create tmp array on stack
 		memset(indicesArr, 0x00, sizeof(indicesArr));
@@ -273,6 +305,7 @@ namespace CLOTH_XNAMATH
 		}
 
 		ClothCopyVertices(true);
+#endif
 		return(hr);
 	}
 
@@ -281,12 +314,16 @@ namespace CLOTH_XNAMATH
 	///////////////////////////////////////////////////////////////////////////////
 	void ClothShutDown(void)
 	{
+#ifndef SIMD_HEADLESS
 		SAFE_RELEASE(g_cloth.pVB);
 		SAFE_RELEASE(g_cloth.pVI);
+#endif
 		memset(&g_cloth, 0x00, sizeof(g_cloth));
+		ArenaReset(&g_clothArena);
 	}
 
 
+#ifndef SIMD_HEADLESS
 	///////////////////////////////////////////////////////////////////////////////
 	//
 	///////////////////////////////////////////////////////////////////////////////
@@ -321,15 +358,11 @@ namespace CLOTH_XNAMATH
 				for(int xx=0; xx<=w-1; xx++)
 				{
 					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
+					// x, y, z are lanes 3, 2, 1 of m_x
+					XMVECTOR p = XMVectorSwizzle<3,2,1,0>(g_cloth.m_x[ii]);
 
-					//VStore(f, g_cloth.m_x[ii]);
-					//g_cloth.m_x[ii].Store(f);
-					XMStoreFloat4A((XMFLOAT4A*)f, g_cloth.m_x[ii]);
-
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
+					XMStoreFloat2((XMFLOAT2*)&pV[kk].x, p);
+					XMStoreFloat(&pV[kk].z, XMVectorSwizzle<2,3,2,3>(p));
 
 					//add some cool colors since I won't lit the patches
 					float	xF = (1.f-((float)xx * ((float)1.f/(w-1))))*255.f;
@@ -348,15 +381,11 @@ namespace CLOTH_XNAMATH
 				for(int xx=0; xx<=w-1; xx++)
 				{
 					int ii = GetI(xx, yy);
-					__declspec(align(128)) float	f[4];
-
-					//VStore(f, g_cloth.m_x[ii]);
-					//g_cloth.m_x[ii].Store(f);
-					XMStoreFloat4A((XMFLOAT4A*)f, g_cloth.m_x[ii]);
+					// x, y, z are lanes 3, 2, 1 of m_x
+					XMVECTOR p = XMVectorSwizzle<3,2,1,0>(g_cloth.m_x[ii]);
 
-					pV[kk].x = f[3];
-					pV[kk].y = f[2];
-					pV[kk].z = f[1];
+					XMStoreFloat2((XMFLOAT2*)&pV[kk].x, p);
+					XMStoreFloat(&pV[kk].z, XMVectorSwizzle<2,3,2,3>(p));
 					kk++;
 				}
 			}
@@ -375,6 +404,39 @@ namespace CLOTH_XNAMATH
 	{
 		HRESULT hr = S_OK;
 
+		ClothSimulate(fTimeStep, reps, totalTimeOut);
+
+		ClothCopyVertices(false);
+
+		// Turn off culling, so we see the front and back of the triangle
+		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_NONE );
+
+		// Turn off D3D lighting, since we are providing our own vertex colors
+		pd3dDevice->SetRenderState( D3DRS_LIGHTING, FALSE );
+
+		pd3dDevice->SetTransform( D3DTS_WORLD, mWorld );
+		pd3dDevice->SetTransform( D3DTS_VIEW, mView );
+		pd3dDevice->SetTransform( D3DTS_PROJECTION, mProj );
+
+		// Render the vertex buffer contents
+		pd3dDevice->SetStreamSource( 0, g_cloth.pVB, 0, sizeof( CUSTOMVERTEX ) );
+		pd3dDevice->SetFVF( D3DFVF_CUSTOMVERTEX );
+		pd3dDevice->SetIndices( g_cloth.pVI);
+		pd3dDevice->DrawIndexedPrimitive( D3DPT_LINELIST, 0, 0, g_cloth.vertCount, 0,  g_cloth.primCount);
+
+		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_CCW );
+
+		return(hr);
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Runs reps simulation steps and returns the time spent inside TimeStep
+	///////////////////////////////////////////////////////////////////////////////
+	void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut)
+	{
+		DenormalScope denormals;
+
 		if (!g_cloth.clothInit)
 		{
 			ClothInit();
@@ -398,28 +460,6 @@ namespace CLOTH_XNAMATH
 
 			*totalTimeOut += time;
 		}
-
-		ClothCopyVertices(false);
-
-		// Turn off culling, so we see the front and back of the triangle
-		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_NONE );
-
-		// Turn off D3D lighting, since we are providing our own vertex colors
-		pd3dDevice->SetRenderState( D3DRS_LIGHTING, FALSE );
-
-		pd3dDevice->SetTransform( D3DTS_WORLD, mWorld );
-		pd3dDevice->SetTransform( D3DTS_VIEW, mView );
-		pd3dDevice->SetTransform( D3DTS_PROJECTION, mProj );
-
-		// Render the vertex buffer contents
-		pd3dDevice->SetStreamSource( 0, g_cloth.pVB, 0, sizeof( CUSTOMVERTEX ) );
-		pd3dDevice->SetFVF( D3DFVF_CUSTOMVERTEX );
-		pd3dDevice->SetIndices( g_cloth.pVI);
-		pd3dDevice->DrawIndexedPrimitive( D3DPT_LINELIST, 0, 0, g_cloth.vertCount, 0,  g_cloth.primCount);
-
-		pd3dDevice->SetRenderState( D3DRS_CULLMODE, D3DCULL_CCW );
-
-		return(hr);
 	}
 
 	void ClothUIHack(void)
@@ -453,6 +493,28 @@ namespace CLOTH_XNAMATH
 		g_cloth.m_vGravity = XMVectorSet(0.f, 0.f, gravity, 0.f);
 	}
 
+	void ClothSetFastConstraints(int newtonSteps)
+	{
+		g_clothNewtonSteps = newtonSteps;
+	}
+
+	// x, y, z of up to maxParticles particles, returns how many
+	int ClothGetPositions(float *pXYZ, int maxParticles)
+	{
+		int count = (maxParticles < cClothSize) ? maxParticles : cClothSize;
+
+		for(int ii=0; ii<count; ii++)
+		{
+			// x, y, z are lanes 3, 2, 1 of m_x
+			XMVECTOR p = XMVectorSwizzle<3,2,1,0>(g_cloth.m_x[ii]);
+
+			XMStoreFloat2((XMFLOAT2*)&pXYZ[3*ii], p);
+			XMStoreFloat(&pXYZ[3*ii + 2], XMVectorSwizzle<2,3,2,3>(p));
+		}
+
+		return(count);
+	}
+
 
 	///////////////////////////////////////////////////////////////////////////////
 	//							Simulation Code
@@ -461,8 +523,10 @@ namespace CLOTH_XNAMATH
 	// Verlet integration step
 void Cloth::Verlet()
 {
-	XMVECTOR	d1 = XMVectorReplicate(0.99903f);		
-	XMVECTOR	d2 = XMVectorReplicate(0.99899f); //had to change the constant so the optimizer does not unify the code
+	XMVECTOR	d1 = XMVectorReplicate(CLOTH_XNAMATH_D1);		
+	XMVECTOR	d2 = XMVectorReplicate(CLOTH_XNAMATH_D2); //had to change the constant so the optimizer does not unify the code
+	XMVECTOR	boxMin = XMVectorReplicate(-cClothBox);
+	XMVECTOR	boxMax = XMVectorReplicate(cClothBox);
 
 	for(int i=0; i<NUM_PARTICLES; i++)
 	{
@@ -471,6 +535,7 @@ void Cloth::Verlet()
 		XMVECTOR& oldx = m_oldx[i];
 		XMVECTOR& a = m_a[i];
 		x += (d1*x)-(d2*oldx)+a*fTimeStep*fTimeStep;
+		x = XMVectorClamp(x, boxMin, boxMax);
 		oldx = temp;
 	}
 }
@@ -483,8 +548,44 @@ void Cloth::Verlet()
 	}
 
 
-// Here constraints should be satisfied
+// (|delta|-restlength)/|delta|, see CLOTH_CONSTRAINTS_EXACT
+template <int Steps>
+inline XMVECTOR StickDiff(FXMVECTOR delta, FXMVECTOR restlength)
+{
+	if (Steps == CLOTH_CONSTRAINTS_EXACT)
+	{
+		XMVECTOR deltalength = XMVectorSqrt(XMVector4Dot(delta,delta));
+		return (deltalength-restlength)/deltalength;
+	}
+
+	XMVECTOR one = XMVectorReplicate(1.f);
+	XMVECTOR half = XMVectorReplicate(0.5f);
+	XMVECTOR lengthSq = XMVector4Dot(delta,delta);
+	XMVECTOR invlength = XMVectorReciprocalSqrtEst(lengthSq);
+
+	for(int ii=0; ii<Steps; ii++)
+	{
+		// r += r/2*(1 - v*r*r)
+		invlength = XMVectorMultiplyAdd(half*invlength, XMVectorNegativeMultiplySubtract(lengthSq*invlength, invlength, one), invlength);
+	}
+
+	return XMVectorNegativeMultiplySubtract(restlength, invlength, one);
+}
+
 void Cloth::SatisfyConstraints()
+{
+	switch(g_clothNewtonSteps)
+	{
+		case 0:		SatisfyConstraintsT<0>(); break;
+		case 1:		SatisfyConstraintsT<1>(); break;
+		case 2:		SatisfyConstraintsT<2>(); break;
+		default:	SatisfyConstraintsT<CLOTH_CONSTRAINTS_EXACT>(); break;
+	}
+}
+
+// Here constraints should be satisfied
+template <int Steps>
+void Cloth::SatisfyConstraintsT()
 {
 	XMVECTOR	half = XMVectorReplicate(0.5f);
 
@@ -508,8 +609,7 @@ void Cloth::SatisfyConstraints()
 
 				XMVECTOR& x2 = m_x[i2];
 				XMVECTOR delta = x2-x1;
-				XMVECTOR deltalength = XMVectorSqrt(XMVector4Dot(delta,delta));
-				XMVECTOR diff = (deltalength-restlength)/deltalength;
+				XMVECTOR diff = StickDiff<Steps>(delta, restlength);
 				x1 += delta*half*diff;
 				x2 -= delta*half*diff;
 			}
@@ -2,6 +2,9 @@
 // File: common.cpp
 //--------------------------------------------------------------------------------------
 
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include "DXUTgui.h"
 #include "DXUTguiIME.h"
@@ -11,6 +14,7 @@
 #include "SDKmisc.h"
 #include "resource.h"
 #include <xaudio2.h>
+#endif
 #include <math.h>
 #include <xmmintrin.h>
 #include <emmintrin.h>
@@ -22,20 +26,33 @@
 //--------------------------------------------------------------------------------------
 
 //performance counters
+#if defined(_WIN32)
 LARGE_INTEGER g_qwTimeBefore = { 0 };
 LARGE_INTEGER g_qwTimeAfter = { 0 };
 LARGE_INTEGER g_ticksPerSecond = { 0 };
+#else
+struct timespec g_qwTimeBefore = { 0 };
+struct timespec g_qwTimeAfter = { 0 };
+#endif
+
+//start and end of the latency chains
+volatile float g_chainSink = 1.f;
 
 //tunning hacks
 float	g_floatValues[16] = { 0 };
 int		g_intValues[16]  = { 0 };
+bool	g_denormalFlush = true;
 
 //--------------------------------------------------------------------------------------
 //	Debug
 //--------------------------------------------------------------------------------------
 void DBugVec(WCHAR *str, float* p)
 {
+#ifdef SIMD_HEADLESS
+	fprintf(stderr, "\n%ls: (%5.4f, %5.4f, %5.4f, %5.4f)", str, p[0], p[1], p[2], p[3]);
+#else
 	WCHAR wszOutput[1024];
 	swprintf_s(wszOutput, 1024, L"\n%s: (%5.4f, %5.4f, %5.4f, %5.4f)", str, p[0], p[1], p[2], p[3]);
 	OutputDebugString(wszOutput);
+#endif
 }
@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------------------------
 // forward declarations hacks
 //--------------------------------------------------------------------------------------
+#ifndef SIMD_HEADLESS
 extern HRESULT InitXAudio2(void);
 extern HRESULT PlayPCM( IXAudio2* pXaudio2, LPCWSTR szFilename );
 extern HRESULT PlayChannels(void);
@@ -17,32 +18,143 @@ extern double ProcessAudioXNAMath(int audioFrames);
 extern double ProcessAudioVClass(int audioFrames);
 extern double ProcessAudioVClassTypedef(int audioFrames);
 extern double ProcessAudioVClassSIMDType(int audioFrames);
+#endif
+
+//EQ kernels over the SIMD sample window [beg, end] (eq_exec.cpp, eq_xna_exec.cpp)
+extern void InitEQStates(void);
+extern void InitEQStateXNAMath(void);
+extern void AllocEQStateXNAMath(void);
+//the EQ states and the sample buffers, from one cache line aligned region (eq_exec.cpp, arena.h)
+extern bool AudioSampleInit(size_t capacity, bool hugePages);
+extern void* AudioSampleAlloc(size_t bytes);
+extern bool AudioSampleHugePages(void);
+extern void AudioSampleReset(void);
+extern void AudioSampleShutDown(void);
+extern HRESULT AudioSampleInterleave(int samples);
+extern void AudioSampleDeinterleave(int beg, int end);
+//the same on a bank of 4 tracks, bank 0 is the 4 above and 1 .. cAudioBanks - 1 g_AudioSample.bank
+extern HRESULT AudioSampleInterleaveBank(int bank, int samples);
+extern void AudioSampleDeinterleaveBank(int bank, int beg, int end);
+extern void ProcessAudioBlockVMath(int beg, int end);
+extern void ProcessAudioBlockXNAMath(int beg, int end);
+extern void ProcessAudioBlockVClass(int beg, int end);
+extern void ProcessAudioBlockVClassTypedef(int beg, int end);
+extern void ProcessAudioBlockVClassSIMDType(int beg, int end);
+//VClassSIMDType on Vec4d, 4 tracks in double precision
+extern void ProcessAudioBlockVClassSIMDTypeDouble(int beg, int end);
+#if defined(VCLASS_SIMDTYPE_AVX)
+//8 tracks: the window [beg, end] of banks 0 and 1
+extern void ProcessAudioBlockVClassSIMDType8(int beg, int end);
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+//16 tracks: the window [beg, end] of banks 0 to 3
+extern void ProcessAudioBlockVClassSIMDType16(int beg, int end);
+#endif
+//plain float reference, one track at a time (eq_fpu.cpp)
+extern void ProcessAudioBlockFPU(int beg, int end);
 
 //globals
+#ifndef SIMD_HEADLESS
 extern IXAudio2* g_pXAudio2;
+#endif
+#if defined(_WIN32)
 extern LARGE_INTEGER g_qwTimeBefore;
 extern LARGE_INTEGER g_qwTimeAfter;
 extern LARGE_INTEGER g_ticksPerSecond;
+#else
+extern struct timespec g_qwTimeBefore;
+extern struct timespec g_qwTimeAfter;
+#endif
 extern float g_floatValues[16];
 extern int g_intValues[16];
 extern void DBugVec(WCHAR *str, float* p);
 
 //--------------------------------------------------------------------------------------
 //									inline time functions
+//	static: the dispatch_<isa>.cpp units compile these with their own instruction set,
+//	an out-of-line copy must not be shared with the other units
 //--------------------------------------------------------------------------------------
-inline void PerformanceCounterStart(void)
+#if defined(_WIN32)
+static inline void PerformanceCounterStart(void)
 {
 	QueryPerformanceFrequency(&g_ticksPerSecond);
 	QueryPerformanceCounter( &g_qwTimeBefore );
 }
 
-inline double PerformanceCounterEnd(void)
+static inline double PerformanceCounterEnd(void)
 {
 	QueryPerformanceCounter( &g_qwTimeAfter );
 	double	diff = (double)(g_qwTimeAfter.QuadPart - g_qwTimeBefore.QuadPart);
 	double time = diff/(double)g_ticksPerSecond.QuadPart;
 	return(time);
 }
+#else
+static inline void PerformanceCounterStart(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &g_qwTimeBefore);
+}
+
+static inline double PerformanceCounterEnd(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &g_qwTimeAfter);
+	double	sec = (double)(g_qwTimeAfter.tv_sec - g_qwTimeBefore.tv_sec);
+	double	nsec = (double)(g_qwTimeAfter.tv_nsec - g_qwTimeBefore.tv_nsec);
+	double time = sec + nsec*1e-9;
+	return(time);
+}
+#endif
+
+//--------------------------------------------------------------------------------------
+//									latency chains
+//	MADD::Latency (dispatch_kernels.inl) and the callconv Chain (callconv.inl) time
+//	cChainLength dependent operations per rep. They start from g_chainSink and store
+//	the end back, so the compiler can neither fold the chain nor sink it past the timer
+//--------------------------------------------------------------------------------------
+const int cChainLength = 1024;
+
+extern volatile float g_chainSink;
+
+//--------------------------------------------------------------------------------------
+//									denormals
+//	DenormalScope sets MXCSR flush-to-zero (denormal results become 0) and
+//	denormals-are-zero (denormal inputs read as 0) for its lifetime and puts the
+//	caller's MXCSR back on the way out. The EQ and cloth kernels open one around
+//	their loops: without it an operation on a denormal takes a microcode assist of
+//	100+ cycles on most x86 cores. g_denormalFlush = false leaves MXCSR alone
+//	(simd_bench -demo denormal times both).
+//	Unnamed namespace for the same reason as the static time functions above.
+//--------------------------------------------------------------------------------------
+
+const unsigned int cMxcsrFlushToZero		= 0x8000;
+const unsigned int cMxcsrDenormalsAreZero	= 0x0040;
+
+extern bool g_denormalFlush;
+
+namespace
+{
+	class DenormalScope
+	{
+	public:
+		DenormalScope() : m_mxcsr(_mm_getcsr())
+		{
+			if (g_denormalFlush)
+			{
+				_mm_setcsr(m_mxcsr | cMxcsrFlushToZero | cMxcsrDenormalsAreZero);
+			}
+		}
+
+		~DenormalScope()
+		{
+			_mm_setcsr(m_mxcsr);
+		}
+
+	private:
+		DenormalScope(const DenormalScope&);
+		DenormalScope& operator=(const DenormalScope&);
+
+		unsigned int	m_mxcsr;
+	};
+}
 
 //--------------------------------------------------------------------------------------
 //									defines & consts
@@ -55,6 +167,7 @@ inline double PerformanceCounterEnd(void)
 #define MATHLIB_TYPE_VCLASS_SIMDTYPE	(4)
 #define	MATHLIB_TYPE_MAX				(MATHLIB_TYPE_VCLASS_SIMDTYPE)
 #define	MATHLIB_TYPE_MIN				(MATHLIB_TYPE_VMATH)
+#define	MATHLIB_TYPE_COUNT				(MATHLIB_TYPE_MAX + 1)
 
 #define DEMO_TYPE_AUDIO			(0)
 #define DEMO_TYPE_CLOTH			(1)
@@ -78,6 +191,19 @@ typedef struct CUSTOMVERTEX
 // Aux Structs
 //--------------------------------------------------------------------------------------
 
+// banks of 4 tracks, one per 128-bit group of the 8 and 16 track EQs
+const int cAudioBanks = 4;
+
+// 4 more tracks for the wide EQs, in the layout of the first 4 below
+typedef struct AudioBankStruct
+{
+	__m128*					pSIMDWavDataSrc;
+	__m128*					pSIMDWavDataDest;
+	BYTE*					pWavDataSrc[4];
+	BYTE*					pWavDataDest[4];
+
+}	AudioBankStruct;
+
 typedef struct AudioSampleStruct
 {
 	__m128*					pSIMDWavDataSrc;		//source copy for processing SIMD friendly
@@ -89,7 +215,12 @@ typedef struct AudioSampleStruct
 
 
 	int						wavSize[4];
+
+	AudioBankStruct			bank[cAudioBanks - 1];	//tracks 4 to 15, same size as the first 4,
+													//only the 8 and 16 track EQs read them
+#ifndef SIMD_HEADLESS
 	IXAudio2SourceVoice*	pSourceVoice[4];
+#endif
 
 }	AudioChannelStruct;
 
@@ -0,0 +1,125 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch.cpp
+//
+// cpuid based selection of the dispatch_<isa>.cpp kernel builds. This unit is compiled
+// for the baseline (SSE2) instruction set like the rest of the program.
+//--------------------------------------------------------------------------------------
+
+#include "platform.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include "dispatch.h"
+
+//--------------------------------------------------------------------------------------
+// Kernel tables (dispatch_<isa>.cpp)
+//--------------------------------------------------------------------------------------
+extern const SimdKernels g_simdKernelsSSE2;
+extern const SimdKernels g_simdKernelsSSE41;
+extern const SimdKernels g_simdKernelsAVX2;
+extern const SimdKernels g_simdKernelsAVX512;
+
+// indexed by SIMD_ISA_*
+static const SimdKernels* const g_simdKernels[SIMD_ISA_MAX + 1] =
+{
+	&g_simdKernelsSSE2,
+	&g_simdKernelsSSE41,
+	&g_simdKernelsAVX2,
+	&g_simdKernelsAVX512,
+};
+
+//--------------------------------------------------------------------------------------
+// cpuid / xgetbv
+//--------------------------------------------------------------------------------------
+static void SimdCpuid(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int*)regs, (int)leaf, (int)subLeaf);
+#else
+	__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// register state the OS saves on context switches (XCR0)
+static UINT64 SimdXgetbv(void)
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int lo, hi;
+
+	__asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+
+	return ((UINT64)hi << 32) | lo;
+#endif
+}
+
+//--------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------
+int SimdDetectISA(void)
+{
+	const UINT64	cXCR0AVX		= 0x06;		// XMM | YMM
+	const UINT64	cXCR0AVX512		= 0xe6;		// XMM | YMM | opmask | ZMM_Hi256 | Hi16_ZMM
+
+	unsigned int	regs[4];
+	unsigned int	maxLeaf;
+	int				isa = SIMD_ISA_SSE2;
+
+	SimdCpuid(0, 0, regs);
+	maxLeaf = regs[0];
+
+	if (maxLeaf < 1)
+	{
+		return(isa);
+	}
+
+	SimdCpuid(1, 0, regs);
+
+	bool	sse41	= (regs[2] & (1 << 19)) != 0;
+	bool	fma		= (regs[2] & (1 << 12)) != 0;
+	bool	osxsave	= (regs[2] & (1 << 27)) != 0;
+	bool	avx		= (regs[2] & (1 << 28)) != 0;
+	bool	avx2	= false;
+	bool	avx512	= false;
+	UINT64	xcr0	= osxsave ? SimdXgetbv() : 0;
+
+	if (maxLeaf >= 7)
+	{
+		SimdCpuid(7, 0, regs);
+
+		avx2	= (regs[1] & (1 << 5)) != 0;
+		avx512	= (regs[1] & (1 << 16)) != 0;
+	}
+
+	if (sse41)
+	{
+		isa = SIMD_ISA_SSE41;
+	}
+
+	if (avx && avx2 && fma && (xcr0 & cXCR0AVX) == cXCR0AVX)
+	{
+		isa = SIMD_ISA_AVX2;
+
+		if (avx512 && (xcr0 & cXCR0AVX512) == cXCR0AVX512)
+		{
+			isa = SIMD_ISA_AVX512;
+		}
+	}
+
+	return(isa);
+}
+
+const SimdKernels* SimdGetKernels(int isa)
+{
+	if (isa < SIMD_ISA_MIN || isa > SIMD_ISA_MAX)
+	{
+		return(NULL);
+	}
+
+	return(g_simdKernels[isa]);
+}
+
+const SimdKernels* const g_pSimdKernels = SimdGetKernels(SimdDetectISA());
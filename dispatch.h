@@ -0,0 +1,66 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __DISPATCH__
+#define __DISPATCH__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Runtime CPU dispatch of the VCLASS_SIMDTYPE cloth and EQ kernels.
+//	dispatch_<isa>.cpp build the same kernels once per instruction set, the
+//	best one for the running CPU is picked once at startup (g_pSimdKernels).
+//
+//	SSE2, SSE4.1	- Vec4 everywhere
+//	AVX2+FMA		- Verlet/AccumulateForces on Vec8, fused multiply-adds
+//	AVX-512			- the whole cloth TimeStep on Vec16 (see cloth_vclass.inl)
+//
+//	The EQ stays 4 tracks wide in every build: the 4 tracks of one sample fill
+//	a Vec4 and the next sample depends on this one.
+//
+//	Only simd_bench (CMake) builds and calls these tables. The D3D9 demo
+//	(CustomUI_2010.vcxproj) keeps the fixed-ISA VClassSIMDType cloth and EQ:
+//	the VS2010 toolset has no AVX2/AVX-512 code generation for
+//	dispatch_avx2/avx512.cpp, and the UI's EQ gains (UpdateEQ) and
+//	ClothAnimateAndRender/ClothSetGlobalParam have no entry here.
+///////////////////////////////////////////////////////////////////////////////
+
+#define	SIMD_ISA_SSE2				(0)
+#define	SIMD_ISA_SSE41				(1)
+#define	SIMD_ISA_AVX2				(2)
+#define	SIMD_ISA_AVX512				(3)
+#define	SIMD_ISA_MAX				(SIMD_ISA_AVX512)
+#define	SIMD_ISA_MIN				(SIMD_ISA_SSE2)
+
+typedef struct SimdKernels
+{
+	const char*		name;
+	int				isa;
+
+	void			(*clothSimulate)(float fTimeStep, int reps, double *totalTimeOut);
+	void			(*clothShutDown)(void);
+	void			(*clothSetFastConstraints)(int newtonSteps);
+	int				(*clothGetPositions)(float *pXYZ, int maxParticles);
+	int				clothConstraintOrder;		//CLOTH_ORDER_*
+
+	void			(*initEQState)(void);
+	void			(*processAudioBlock)(int beg, int end);
+
+	//dependent x*a+b chain (1024 per rep), fused = VMAdd or a separate mul and add
+	void			(*maddLatency)(int reps, bool fused, double *totalTimeOut);
+
+}	SimdKernels;
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+//highest SIMD_ISA_* supported by both the CPU and the OS (cpuid + xgetbv)
+extern int SimdDetectISA(void);
+
+//kernels built for isa, NULL if isa is out of range
+extern const SimdKernels* SimdGetKernels(int isa);
+
+//best kernels for this machine, resolved once during static initialization
+extern const SimdKernels* const g_pSimdKernels;
+
+#endif // #ifndef __DISPATCH__
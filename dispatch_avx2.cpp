@@ -0,0 +1,17 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch_avx2.cpp
+//
+// AVX2+FMA build of the dispatched kernels. CMakeLists.txt compiles this file with -mavx2 -mfma, /arch:AVX2 on MSVC.
+//--------------------------------------------------------------------------------------
+
+#undef VCLASS_SIMDTYPE_AVX
+#undef VCLASS_SIMDTYPE_AVX512
+#define	VCLASS_SIMDTYPE_AVX
+#define	CLOTH_VCLASS_WIDE		Vec8
+
+#define	SIMD_ISA_NAMESPACE		SIMD_AVX2
+#define	SIMD_ISA_TABLE			g_simdKernelsAVX2
+#define	SIMD_ISA_INDEX			SIMD_ISA_AVX2
+#define	SIMD_ISA_NAME			"AVX2+FMA"
+
+#include "dispatch_kernels.inl"
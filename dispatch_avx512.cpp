@@ -0,0 +1,19 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch_avx512.cpp
+//
+// AVX-512 build of the dispatched kernels. CMakeLists.txt compiles this file with -mavx512f -mavx2 -mfma, /arch:AVX512 on MSVC.
+//--------------------------------------------------------------------------------------
+
+#undef VCLASS_SIMDTYPE_AVX
+#undef VCLASS_SIMDTYPE_AVX512
+#define	VCLASS_SIMDTYPE_AVX
+#define	VCLASS_SIMDTYPE_AVX512
+#define	CLOTH_VCLASS_WIDE		Vec16
+#define	CLOTH_VCLASS_WIDE_CONSTRAINTS
+
+#define	SIMD_ISA_NAMESPACE		SIMD_AVX512
+#define	SIMD_ISA_TABLE			g_simdKernelsAVX512
+#define	SIMD_ISA_INDEX			SIMD_ISA_AVX512
+#define	SIMD_ISA_NAME			"AVX-512"
+
+#include "dispatch_kernels.inl"
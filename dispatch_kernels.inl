@@ -0,0 +1,183 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch_kernels.inl
+//
+// One instruction set build of the VCLASS_SIMDTYPE cloth and EQ kernels, included by
+// dispatch_<isa>.cpp after defining:
+//
+//	SIMD_ISA_NAMESPACE	namespace holding this build
+//	SIMD_ISA_TABLE		name of the exported SimdKernels table
+//	SIMD_ISA_INDEX		SIMD_ISA_*
+//	SIMD_ISA_NAME		printable name
+//	CLOTH_VCLASS_WIDE	(optional) wide type for the cloth, see cloth_vclass.inl
+//	CLOTH_VCLASS_WIDE_CONSTRAINTS	(optional) the sticks on CLOTH_VCLASS_WIDE too
+//
+// vclass_simdtype.h is included inside SIMD_ISA_NAMESPACE too, so the inline
+// functions and templates of each build get their own symbols and the linker can't
+// hand the SSE2 build an AVX-512 copy.
+//--------------------------------------------------------------------------------------
+
+#include "platform.h"
+#include <immintrin.h>
+#include <math.h>
+#include "common.h"
+#include "arena.h"
+#include "cloth.h"
+#include "dispatch.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//								Consts & Defines
+///////////////////////////////////////////////////////////////////////////////
+
+#define	VCLASS_PI				(3.1415926535897932384626433832795f)
+#define	VCLASS_DTOR(angle)		((VCLASS_PI/180.0f)*((float)angle))
+#define	VCLASS_RTOD(angle)		((180.0f/VCLASS_PI)*((float)angle))
+
+extern __declspec(align(128))		AudioSampleStruct	g_AudioSample;
+
+namespace SIMD_ISA_NAMESPACE
+{
+	#include "vclass_simdtype.h"
+
+	namespace CLOTH
+	{
+		using namespace VCLASS_SIMDTYPE;
+
+		// as declared for the CLOTH_* namespaces in cloth.h
+		extern HRESULT ClothInit(void);
+		extern void ClothShutDown(void);
+		extern void ClothSimulate(float fTimeStep, int reps, double *totalTimeOut);
+		extern void ClothSetGlobalParam(float rot, float trans, float gravity);
+		extern void ClothUIHack(void);
+		extern void ClothSetFastConstraints(int newtonSteps);
+		extern int ClothGetPositions(float *pXYZ, int maxParticles);
+
+		#include "cloth_vclass.inl"
+	}
+
+	namespace EQ
+	{
+		using namespace VCLASS_SIMDTYPE;
+
+		// same layout as EQ_VCLASS_SIMDTYPE::EQSTATE (eq.h)
+		typedef struct
+		{
+		  Vec4  lf;       // Frequency
+		  Vec4  f1p0;     // Poles ...
+		  Vec4  f1p1;
+		  Vec4  f1p2;
+		  Vec4  f1p3;
+
+		  Vec4  hf;       // Frequency
+		  Vec4  f2p0;     // Poles ...
+		  Vec4  f2p1;
+		  Vec4  f2p2;
+		  Vec4  f2p3;
+
+		  Vec4  sdm1;     // Sample data minus 1
+		  Vec4  sdm2;     //                   2
+		  Vec4  sdm3;     //                   3
+
+		  Vec4  lg;       // low  gain
+		  Vec4  mg;       // mid  gain
+		  Vec4  hg;       // high gain
+
+		} EQSTATE;
+
+		#include "eq_vclass.inl"
+
+		__declspec(align(128))		EQSTATE g_eq;
+
+		void InitEQState(void)
+		{
+			init_3band_state(&g_eq,880,5000,44100);
+		}
+
+		// same as ProcessAudioBlockVClassSIMDType (eq_exec.cpp)
+		void ProcessAudioBlock(int beg, int end)
+		{
+			DenormalScope denormals;
+
+			Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+			Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+			Vec4 base(32768.f);
+			Vec4 lo(-32768.f);
+			Vec4 hi(32767.f);
+
+			for(int ii=beg; ii<=end; ii++)
+			{
+				//loads
+				Vec4 sampleIn = pSrc[ii];
+				sampleIn = sampleIn / base;
+
+				Vec4 sampleOut = do_3band(&g_eq, sampleIn);
+
+				//denormalize
+				sampleOut = sampleOut*base;
+
+				//clip to 16 bits
+				sampleOut = Vec4::VClamp(sampleOut, lo, hi);
+
+				//stores
+				pDest[ii] = sampleOut;
+			}
+
+			//unshuffle and send it to the data channels
+			AudioSampleDeinterleave(beg, end);
+		}
+	}
+
+	namespace MADD
+	{
+		using namespace VCLASS_SIMDTYPE;
+
+		// Dependent x = x*a + b chain, either as VMAdd or as a mul feeding an add
+		// (the FMA units are built with -ffp-contract=off so the latter stays two ops)
+		void Latency(int reps, bool fused, double *totalTimeOut)
+		{
+			float	s = g_chainSink;
+			Vec4	a(0.999f);
+			Vec4	b(0.001f);
+			Vec4	x(s);
+
+			PerformanceCounterStart();
+
+			for(int ii=0; ii<reps; ii++)
+			{
+				for(int jj=0; jj<cChainLength; jj++)
+				{
+					if (fused)
+					{
+						x = Vec4::VMAdd(x, a, b);
+					}
+					else
+					{
+						x = x*a + b;
+					}
+				}
+			}
+
+			Vec4::GetX(&s, x);
+			g_chainSink = s;
+
+			*totalTimeOut += PerformanceCounterEnd();
+		}
+	}
+}
+
+extern const SimdKernels SIMD_ISA_TABLE =
+{
+	SIMD_ISA_NAME,
+	SIMD_ISA_INDEX,
+	SIMD_ISA_NAMESPACE::CLOTH::ClothSimulate,
+	SIMD_ISA_NAMESPACE::CLOTH::ClothShutDown,
+	SIMD_ISA_NAMESPACE::CLOTH::ClothSetFastConstraints,
+	SIMD_ISA_NAMESPACE::CLOTH::ClothGetPositions,
+#ifdef CLOTH_VCLASS_WIDE_CONSTRAINTS
+	CLOTH_ORDER_ROWS,
+#else
+	CLOTH_ORDER_SEQUENTIAL,
+#endif
+	SIMD_ISA_NAMESPACE::EQ::InitEQState,
+	SIMD_ISA_NAMESPACE::EQ::ProcessAudioBlock,
+	SIMD_ISA_NAMESPACE::MADD::Latency,
+};
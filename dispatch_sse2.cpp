@@ -0,0 +1,15 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch_sse2.cpp
+//
+// SSE2 build of the dispatched kernels. CMakeLists.txt compiles this file with -msse2, /arch:SSE2 on MSVC.
+//--------------------------------------------------------------------------------------
+
+#undef VCLASS_SIMDTYPE_AVX
+#undef VCLASS_SIMDTYPE_AVX512
+
+#define	SIMD_ISA_NAMESPACE		SIMD_SSE2
+#define	SIMD_ISA_TABLE			g_simdKernelsSSE2
+#define	SIMD_ISA_INDEX			SIMD_ISA_SSE2
+#define	SIMD_ISA_NAME			"SSE2"
+
+#include "dispatch_kernels.inl"
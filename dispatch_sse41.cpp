@@ -0,0 +1,15 @@
+//--------------------------------------------------------------------------------------
+// File: dispatch_sse41.cpp
+//
+// SSE4.1 build of the dispatched kernels. CMakeLists.txt compiles this file with -msse4.1.
+//--------------------------------------------------------------------------------------
+
+#undef VCLASS_SIMDTYPE_AVX
+#undef VCLASS_SIMDTYPE_AVX512
+
+#define	SIMD_ISA_NAMESPACE		SIMD_SSE41
+#define	SIMD_ISA_TABLE			g_simdKernelsSSE41
+#define	SIMD_ISA_INDEX			SIMD_ISA_SSE41
+#define	SIMD_ISA_NAME			"SSE4.1"
+
+#include "dispatch_kernels.inl"
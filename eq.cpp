@@ -1,6 +1,9 @@
 //--------------------------------------------------------------------------------------
 // File: eq.cpp
 //--------------------------------------------------------------------------------------
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include "DXUTgui.h"
 #include "DXUTguiIME.h"
@@ -10,6 +13,7 @@
 #include "SDKmisc.h"
 #include "resource.h"
 #include <xaudio2.h>
+#endif
 //#include <xnamath.h>
 #include <xmmintrin.h>
 #include <emmintrin.h>
@@ -62,9 +66,7 @@ namespace EQ_VMATH
 	// -----------
 
 	static const float cPi = 3.1415926535897932384626433832795f;
-	static float vsaf = (1.0f / 4294967295.0f);   // Very small amount (Denormal Fix)
-	static Vec4 vsa = VLoad(vsaf);
-	static Vec4 M_PI = VLoad(cPi);
+	static const unsigned int cVsa = 0x2f800000;	// Very small amount (Denormal Fix), 1/4294967295 as a float, EQ_DENORMAL_BIAS (eq.h)
 
 
 	// ---------------
@@ -120,6 +122,10 @@ namespace EQ_VMATH
 
 	Vec4 do_3band(EQSTATE* es, Vec4& sample)
 	{
+#ifdef EQ_DENORMAL_BIAS
+		const Vec4 vsa = VConst<cVsa>();
+#endif
+
 #ifndef __INTEL_COMPILER	//for intel compiler using overloaded operators usually generate better code
 		// Locals
 
@@ -128,32 +134,40 @@ namespace EQ_VMATH
 		// Filter #1 (lowpass)
 
 		//es.f1p0  += (es.lf * (sample   - es.f1p0)) + vsa;
-		es->f1p0 = VAdd(es->f1p0, VAdd(VMul(es->lf, VSub(sample, es->f1p0)), vsa));
+#ifdef EQ_DENORMAL_BIAS
+		es->f1p0 = VAdd(es->f1p0, VMAdd(es->lf, VSub(sample, es->f1p0), vsa));
+#else
+		es->f1p0 = VMAdd(es->lf, VSub(sample, es->f1p0), es->f1p0);
+#endif
 
 		//es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
-		es->f1p1 = VAdd(es->f1p1, VMul(es->lf, VSub(es->f1p0, es->f1p1)));
+		es->f1p1 = VMAdd(es->lf, VSub(es->f1p0, es->f1p1), es->f1p1);
 
 		//es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
-		es->f1p2 = VAdd(es->f1p2, VMul(es->lf, VSub(es->f1p1, es->f1p2)));
+		es->f1p2 = VMAdd(es->lf, VSub(es->f1p1, es->f1p2), es->f1p2);
 
 		//es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
-		es->f1p3 = VAdd(es->f1p3, VMul(es->lf, VSub(es->f1p2, es->f1p3)));
+		es->f1p3 = VMAdd(es->lf, VSub(es->f1p2, es->f1p3), es->f1p3);
 
 		l          = es->f1p3;
 
 		// Filter #2 (highpass)
 
 		//es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
-		es->f2p0 = VAdd(es->f2p0, VAdd(VMul(es->hf, VSub(sample, es->f2p0)), vsa));
+#ifdef EQ_DENORMAL_BIAS
+		es->f2p0 = VAdd(es->f2p0, VMAdd(es->hf, VSub(sample, es->f2p0), vsa));
+#else
+		es->f2p0 = VMAdd(es->hf, VSub(sample, es->f2p0), es->f2p0);
+#endif
 
 		//es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
-		es->f2p1 = VAdd(es->f2p1, VMul(es->hf, VSub(es->f2p0, es->f2p1)));
+		es->f2p1 = VMAdd(es->hf, VSub(es->f2p0, es->f2p1), es->f2p1);
 
 		//es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
-		es->f2p2 = VAdd(es->f2p2, VMul(es->hf, VSub(es->f2p1, es->f2p2)));
+		es->f2p2 = VMAdd(es->hf, VSub(es->f2p1, es->f2p2), es->f2p2);
 
 		//es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
-		es->f2p3 = VAdd(es->f2p3, VMul(es->hf, VSub(es->f2p2, es->f2p3)));
+		es->f2p3 = VMAdd(es->hf, VSub(es->f2p2, es->f2p3), es->f2p3);
 
 		//h          = es->sdm3 - es->f2p3;
 		h = VSub(es->sdm3, es->f2p3);
@@ -163,26 +177,16 @@ namespace EQ_VMATH
 		//m          = es->sdm3 - (h + l);
 		m = VSub(es->sdm3, VAdd(h, l));
 
-		// Scale, Combine and store
-
-		//l         *= es->lg;
-		//m         *= es->mg;
-		//h         *= es->hg;
-
-		l = VMul(l, es->lg);
-		m = VMul(m, es->mg);
-		h = VMul(h, es->hg);
-
 		// Shuffle history buffer 
 
 		es->sdm3   = es->sdm2;
 		es->sdm2   = es->sdm1;
 		es->sdm1   = sample;                
 
-		// Return result
+		// Scale, Combine and return
 
-		//return(l + m + h);
-		return(VAdd(l, VAdd(m, h)));
+		//return(l*es->lg + m*es->mg + h*es->hg);
+		return(VMAdd(l, es->lg, VMAdd(m, es->mg, VMul(h, es->hg))));
 #else
 	  // Locals
 
@@ -190,7 +194,11 @@ namespace EQ_VMATH
 
 	  // Filter #1 (lowpass)
 
+#ifdef EQ_DENORMAL_BIAS
 	  es->f1p0  += (es->lf * (sample   - es->f1p0)) + vsa;
+#else
+	  es->f1p0  += (es->lf * (sample   - es->f1p0));
+#endif
 	  es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
 	  es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
 	  es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
@@ -199,7 +207,11 @@ namespace EQ_VMATH
 
 	  // Filter #2 (highpass)
 	  
+#ifdef EQ_DENORMAL_BIAS
 	  es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
+#else
+	  es->f2p0  += (es->hf * (sample   - es->f2p0));
+#endif
 	  es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
 	  es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
 	  es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
@@ -249,3 +261,22 @@ namespace EQ_VCLASS_SIMDTYPE
 
 	#include "eq_vclass.inl"
 }
+
+namespace EQ_VCLASS_SIMDTYPE_DOUBLE
+{
+	#include "eq_vclass.inl"
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace EQ_VCLASS_SIMDTYPE8
+{
+	#include "eq_vclass.inl"
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace EQ_VCLASS_SIMDTYPE16
+{
+	#include "eq_vclass.inl"
+}
+#endif
@@ -5,6 +5,11 @@
 #ifndef __EQ3BAND__
 #define __EQ3BAND__
 
+// do_3band adds vsa (1/4294967295) to the first pole of each filter only with
+// EQ_DENORMAL_BIAS, the old P4 denormal fix. Without it the poles decay through
+// the denormals on silence, the ProcessAudioBlock* kernels run under DenormalScope
+// (common.h) and flush them to zero instead.
+
 namespace EQ_VMATH
 {
 	using namespace VMATH;
@@ -201,4 +206,207 @@ namespace EQ_VCLASS_SIMDTYPE
 	extern Vec4	do_3band(EQSTATE* es, Vec4& sample);
 }
 
+namespace EQ_VCLASS_SIMDTYPE_DOUBLE
+{
+	// 4 tracks in double precision, eq_vclass.inl is written against Vec4
+	typedef VCLASS_SIMDTYPE::Vec4d	Vec4;
+
+	// ------------
+	//| Structures |
+	// ------------
+
+	typedef struct
+	{
+	  // Filter #1 (Low band)
+
+	  Vec4  lf;       // Frequency
+	  Vec4  f1p0;     // Poles ...
+	  Vec4  f1p1;     
+	  Vec4  f1p2;
+	  Vec4  f1p3;
+
+	  // Filter #2 (High band)
+
+	  Vec4  hf;       // Frequency
+	  Vec4  f2p0;     // Poles ...
+	  Vec4  f2p1;
+	  Vec4  f2p2;
+	  Vec4  f2p3;
+
+	  // Sample history buffer
+
+	  Vec4  sdm1;     // Sample data minus 1
+	  Vec4  sdm2;     //                   2
+	  Vec4  sdm3;     //                   3
+
+	  // Gain Controls
+
+	  Vec4  lg;       // low  gain
+	  Vec4  mg;       // mid  gain
+	  Vec4  hg;       // high gain
+	  
+	} EQSTATE;  
+
+
+	// ---------
+	//| Exports |
+	// ---------
+
+	extern void	init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq);
+	extern Vec4	do_3band(EQSTATE* es, Vec4& sample);
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace EQ_VCLASS_SIMDTYPE8
+{
+	// 8 tracks per register (two 4-track banks), eq_vclass.inl is written against Vec4
+	typedef VCLASS_SIMDTYPE::Vec8	Vec4;
+
+	// ------------
+	//| Structures |
+	// ------------
+
+	typedef struct
+	{
+	  // Filter #1 (Low band)
+
+	  Vec4  lf;       // Frequency
+	  Vec4  f1p0;     // Poles ...
+	  Vec4  f1p1;     
+	  Vec4  f1p2;
+	  Vec4  f1p3;
+
+	  // Filter #2 (High band)
+
+	  Vec4  hf;       // Frequency
+	  Vec4  f2p0;     // Poles ...
+	  Vec4  f2p1;
+	  Vec4  f2p2;
+	  Vec4  f2p3;
+
+	  // Sample history buffer
+
+	  Vec4  sdm1;     // Sample data minus 1
+	  Vec4  sdm2;     //                   2
+	  Vec4  sdm3;     //                   3
+
+	  // Gain Controls
+
+	  Vec4  lg;       // low  gain
+	  Vec4  mg;       // mid  gain
+	  Vec4  hg;       // high gain
+	  
+	} EQSTATE;  
+
+
+	// ---------
+	//| Exports |
+	// ---------
+
+	extern void	init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq);
+	extern Vec4	do_3band(EQSTATE* es, Vec4& sample);
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace EQ_VCLASS_SIMDTYPE16
+{
+	// 16 tracks per register (four 4-track banks), eq_vclass.inl is written against Vec4
+	typedef VCLASS_SIMDTYPE::Vec16	Vec4;
+
+	// ------------
+	//| Structures |
+	// ------------
+
+	typedef struct
+	{
+	  // Filter #1 (Low band)
+
+	  Vec4  lf;       // Frequency
+	  Vec4  f1p0;     // Poles ...
+	  Vec4  f1p1;     
+	  Vec4  f1p2;
+	  Vec4  f1p3;
+
+	  // Filter #2 (High band)
+
+	  Vec4  hf;       // Frequency
+	  Vec4  f2p0;     // Poles ...
+	  Vec4  f2p1;
+	  Vec4  f2p2;
+	  Vec4  f2p3;
+
+	  // Sample history buffer
+
+	  Vec4  sdm1;     // Sample data minus 1
+	  Vec4  sdm2;     //                   2
+	  Vec4  sdm3;     //                   3
+
+	  // Gain Controls
+
+	  Vec4  lg;       // low  gain
+	  Vec4  mg;       // mid  gain
+	  Vec4  hg;       // high gain
+	  
+	} EQSTATE;  
+
+
+	// ---------
+	//| Exports |
+	// ---------
+
+	extern void	init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq);
+	extern Vec4	do_3band(EQSTATE* es, Vec4& sample);
+}
+#endif
+
+// the plain float EQ (eq_fpu.cpp), one track per state, no SIMD and no fused
+// multiply-adds: the reference of simd_bench -demo diff
+namespace EQ_FPU
+{
+	// ------------
+	//| Structures |
+	// ------------
+
+	typedef struct
+	{
+	  // Filter #1 (Low band)
+
+	  float  lf;       // Frequency
+	  float  f1p0;     // Poles ...
+	  float  f1p1;     
+	  float  f1p2;
+	  float  f1p3;
+
+	  // Filter #2 (High band)
+
+	  float  hf;       // Frequency
+	  float  f2p0;     // Poles ...
+	  float  f2p1;
+	  float  f2p2;
+	  float  f2p3;
+
+	  // Sample history buffer
+
+	  float  sdm1;     // Sample data minus 1
+	  float  sdm2;     //                   2
+	  float  sdm3;     //                   3
+
+	  // Gain Controls
+
+	  float  lg;       // low  gain
+	  float  mg;       // mid  gain
+	  float  hg;       // high gain
+	  
+	} EQSTATE;  
+
+
+	// ---------
+	//| Exports |
+	// ---------
+
+	extern void	init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq);
+	extern float	do_3band(EQSTATE* es, float sample);
+}
+
 #endif // #ifndef __EQ3BAND__
@@ -0,0 +1,688 @@
+//--------------------------------------------------------------------------------------
+// File: eq_exec.cpp
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#include <xaudio2.h>
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vclass.h"
+#include "vclass_typedef.h"
+#include "vclass_simdtype.h"
+#include "vmath.h"
+#include "common.h"
+#include "arena.h"
+#include "eq.h"
+
+//--------------------------------------------------------------------------------------
+// EQ states & sample buffers
+//--------------------------------------------------------------------------------------
+EQ_VMATH::EQSTATE*							g_pEqVMath = NULL;
+EQ_VCLASS::EQSTATE*							g_pEqVClass = NULL;
+EQ_VCLASS_TYPEDEF::EQSTATE*					g_pEqVClassTypedef = NULL;
+EQ_VCLASS_SIMDTYPE::EQSTATE*				g_pEqVClassSIMDType = NULL;
+EQ_VCLASS_SIMDTYPE_DOUBLE::EQSTATE*			g_pEqVClassSIMDTypeDouble = NULL;
+#if defined(VCLASS_SIMDTYPE_AVX)
+EQ_VCLASS_SIMDTYPE8::EQSTATE*				g_pEqVClassSIMDType8 = NULL;
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+EQ_VCLASS_SIMDTYPE16::EQSTATE*				g_pEqVClassSIMDType16 = NULL;
+#endif
+EQ_FPU::EQSTATE*							g_pEqFPU = NULL;		// one per track
+
+__declspec(align(128))		AudioSampleStruct	g_AudioSample = {0};
+
+// the EQ states and every buffer of g_AudioSample, one region
+static Arena	g_audioArena;
+
+// bytes on top of the AudioSampleInit capacity for the EQ states (a few KB)
+static const size_t	cAudioStateReserve = 16*1024;
+
+//--------------------------------------------------------------------------------------
+// The EQ states open the region, ahead of the sample buffers. AudioSampleReset
+// carves them again at the same place, InitEQStates sets them up.
+//--------------------------------------------------------------------------------------
+static void AudioStatesAlloc(void)
+{
+	g_pEqVMath = (EQ_VMATH::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VMATH::EQSTATE));
+	AllocEQStateXNAMath();
+	g_pEqVClass = (EQ_VCLASS::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS::EQSTATE));
+	g_pEqVClassTypedef = (EQ_VCLASS_TYPEDEF::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS_TYPEDEF::EQSTATE));
+	g_pEqVClassSIMDType = (EQ_VCLASS_SIMDTYPE::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS_SIMDTYPE::EQSTATE));
+	g_pEqVClassSIMDTypeDouble = (EQ_VCLASS_SIMDTYPE_DOUBLE::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS_SIMDTYPE_DOUBLE::EQSTATE));
+#if defined(VCLASS_SIMDTYPE_AVX)
+	g_pEqVClassSIMDType8 = (EQ_VCLASS_SIMDTYPE8::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS_SIMDTYPE8::EQSTATE));
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	g_pEqVClassSIMDType16 = (EQ_VCLASS_SIMDTYPE16::EQSTATE*)AudioSampleAlloc(sizeof(EQ_VCLASS_SIMDTYPE16::EQSTATE));
+#endif
+	g_pEqFPU = (EQ_FPU::EQSTATE*)AudioSampleAlloc(4*sizeof(EQ_FPU::EQSTATE));
+}
+
+//--------------------------------------------------------------------------------------
+// The EQ states and the sample buffers come from one cache line aligned region
+// reserved by AudioSampleInit, capacity is what the buffers take. AudioSampleReset
+// frees the buffers for the next load and keeps the pages, AudioSampleShutDown
+// releases the region.
+//--------------------------------------------------------------------------------------
+bool AudioSampleInit(size_t capacity, bool hugePages)
+{
+	ArenaShutDown(&g_audioArena);
+
+	if (!ArenaInit(&g_audioArena, capacity + cAudioStateReserve, hugePages))
+	{
+		return false;
+	}
+
+	AudioStatesAlloc();
+
+	return true;
+}
+
+void* AudioSampleAlloc(size_t bytes)
+{
+	return ArenaAlloc(&g_audioArena, bytes);
+}
+
+bool AudioSampleHugePages(void)
+{
+	return g_audioArena.hugePages;
+}
+
+void AudioSampleReset(void)
+{
+	ArenaReset(&g_audioArena);
+	AudioStatesAlloc();
+
+	g_AudioSample.pSIMDWavDataSrc = NULL;
+	g_AudioSample.pSIMDWavDataDest = NULL;
+
+	for(int ii=0; ii<4; ii++)
+	{
+		g_AudioSample.pWavDataSrc[ii] = NULL;
+		g_AudioSample.pWavDataDest[ii] = NULL;
+	}
+
+	memset(g_AudioSample.bank, 0x00, sizeof(g_AudioSample.bank));
+}
+
+void AudioSampleShutDown(void)
+{
+	// the states come back NULL from the released region
+	ArenaShutDown(&g_audioArena);
+	AudioSampleReset();
+}
+
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void InitEQStates(void)
+{
+	EQ_VMATH::init_3band_state(g_pEqVMath,880,5000,44100);
+	InitEQStateXNAMath();
+	EQ_VCLASS::init_3band_state(g_pEqVClass,880,5000,44100);
+	EQ_VCLASS_TYPEDEF::init_3band_state(g_pEqVClassTypedef,880,5000,44100);
+	EQ_VCLASS_SIMDTYPE::init_3band_state(g_pEqVClassSIMDType,880,5000,44100);
+	EQ_VCLASS_SIMDTYPE_DOUBLE::init_3band_state(g_pEqVClassSIMDTypeDouble,880,5000,44100);
+#if defined(VCLASS_SIMDTYPE_AVX)
+	EQ_VCLASS_SIMDTYPE8::init_3band_state(g_pEqVClassSIMDType8,880,5000,44100);
+#endif
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	EQ_VCLASS_SIMDTYPE16::init_3band_state(g_pEqVClassSIMDType16,880,5000,44100);
+#endif
+
+	for(int ch=0; ch<4; ch++)
+	{
+		EQ_FPU::init_3band_state(&g_pEqFPU[ch],880,5000,44100);
+	}
+}
+
+//--------------------------------------------------------------------------------------
+// Transpose 4 rows of 4 lanes, r0 .. r3 become the columns
+//--------------------------------------------------------------------------------------
+static inline void AudioSampleTranspose(VCLASS_SIMDTYPE::Vec4& r0, VCLASS_SIMDTYPE::Vec4& r1, VCLASS_SIMDTYPE::Vec4& r2, VCLASS_SIMDTYPE::Vec4& r3)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	Vec4 t0 = Vec4::Permute<0,4,1,5>(r0, r1);
+	Vec4 t1 = Vec4::Permute<0,4,1,5>(r2, r3);
+	Vec4 t2 = Vec4::Permute<2,6,3,7>(r0, r1);
+	Vec4 t3 = Vec4::Permute<2,6,3,7>(r2, r3);
+
+	r0 = Vec4::Permute<0,1,4,5>(t0, t1);
+	r1 = Vec4::Permute<2,3,6,7>(t0, t1);
+	r2 = Vec4::Permute<0,1,4,5>(t2, t3);
+	r3 = Vec4::Permute<2,3,6,7>(t2, t3);
+}
+
+//--------------------------------------------------------------------------------------
+// Bank 0 is the 4 tracks of g_AudioSample, bank k the 4 of g_AudioSample.bank[k - 1]
+//--------------------------------------------------------------------------------------
+static inline __m128*& AudioBankSIMDSrc(int bank)
+{
+	return bank ? g_AudioSample.bank[bank - 1].pSIMDWavDataSrc : g_AudioSample.pSIMDWavDataSrc;
+}
+
+static inline __m128*& AudioBankSIMDDest(int bank)
+{
+	return bank ? g_AudioSample.bank[bank - 1].pSIMDWavDataDest : g_AudioSample.pSIMDWavDataDest;
+}
+
+static inline BYTE** AudioBankWavSrc(int bank)
+{
+	return bank ? g_AudioSample.bank[bank - 1].pWavDataSrc : g_AudioSample.pWavDataSrc;
+}
+
+static inline BYTE** AudioBankWavDest(int bank)
+{
+	return bank ? g_AudioSample.bank[bank - 1].pWavDataDest : g_AudioSample.pWavDataDest;
+}
+
+//--------------------------------------------------------------------------------------
+// Store the 4 source channels SIMD friendly (assuming all channels have the same size)
+//--------------------------------------------------------------------------------------
+HRESULT AudioSampleInterleave(int samples)
+{
+	return AudioSampleInterleaveBank(0, samples);
+}
+
+HRESULT AudioSampleInterleaveBank(int bank, int samples)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	assert(bank >= 0 && bank < cAudioBanks);
+
+	//original samples stored as 16-bit so it takes twice as much in 32-bit floats
+	__m128*& pSIMDSrc = AudioBankSIMDSrc(bank);
+	__m128*& pSIMDDest = AudioBankSIMDDest(bank);
+
+	pSIMDSrc = (__m128*)AudioSampleAlloc(samples*sizeof(__m128));
+	pSIMDDest = (__m128*)AudioSampleAlloc(samples*sizeof(__m128));
+
+	if (!pSIMDSrc || !pSIMDDest)
+	{
+		return E_FAIL;
+	}
+
+	//shuffle the data to be SIMD friendly
+	BYTE**	ppWavSrc = AudioBankWavSrc(bank);
+	short*	bass	= (short*)ppWavSrc[0];
+	short*	guitar	= (short*)ppWavSrc[1];
+	short*	drums	= (short*)ppWavSrc[2];
+	short*	trumpet	= (short*)ppWavSrc[3];
+
+	__m128	*pSIMD = pSIMDSrc;
+	Vec4	*pVec = (Vec4*)pSIMDSrc;
+
+	//4 samples of every track, lane 0 is the trumpet
+	int jj = 0;
+
+	for(; jj + 4<=samples; jj += 4)
+	{
+		Vec4 t = Vec4::VConvertFromInt(IVec4::LoadS16(trumpet + jj));
+		Vec4 d = Vec4::VConvertFromInt(IVec4::LoadS16(drums + jj));
+		Vec4 g = Vec4::VConvertFromInt(IVec4::LoadS16(guitar + jj));
+		Vec4 b = Vec4::VConvertFromInt(IVec4::LoadS16(bass + jj));
+
+		AudioSampleTranspose(t, d, g, b);
+
+		pVec[jj] = t;
+		pVec[jj + 1] = d;
+		pVec[jj + 2] = g;
+		pVec[jj + 3] = b;
+	}
+
+	for(; jj<samples; jj++)
+	{
+		float b = (float)bass[jj];
+		float g = (float)guitar[jj];
+		float d = (float)drums[jj];
+		float t = (float)trumpet[jj];
+
+		pSIMD[jj] = _mm_set_ps(b, g, d, t);
+	}
+
+	memcpy(pSIMDDest, pSIMDSrc, samples*16);
+
+	return S_OK;
+}
+
+//--------------------------------------------------------------------------------------
+// 4 SIMD samples from ii to the 4 data channels, 4 shorts each
+//--------------------------------------------------------------------------------------
+static inline void AudioSampleDeinterleave4(const VCLASS_SIMDTYPE::Vec4 *pDest, short **ppAudioDest, int ii)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	Vec4 s0 = pDest[ii];
+	Vec4 s1 = pDest[ii + 1];
+	Vec4 s2 = pDest[ii + 2];
+	Vec4 s3 = pDest[ii + 3];
+
+	AudioSampleTranspose(s0, s1, s2, s3);
+
+	Vec4::VTruncateToInt(s0).StoreS16(ppAudioDest[0] + ii);
+	Vec4::VTruncateToInt(s1).StoreS16(ppAudioDest[1] + ii);
+	Vec4::VTruncateToInt(s2).StoreS16(ppAudioDest[2] + ii);
+	Vec4::VTruncateToInt(s3).StoreS16(ppAudioDest[3] + ii);
+}
+
+//--------------------------------------------------------------------------------------
+// Unshuffle the SIMD samples [beg, end] and send them to the data channels. The EQ
+// clamps to the 16-bit range, so the truncation and the saturating pack give the
+// same shorts as a (short) cast.
+// The channels go to the voices and are not read again by the CPU, so once all four
+// are 16 byte aligned they are written 8 shorts at a time with non-temporal stores
+// and the SIMD samples, read here for the last time, are prefetched NTA.
+//--------------------------------------------------------------------------------------
+void AudioSampleDeinterleave(int beg, int end)
+{
+	AudioSampleDeinterleaveBank(0, beg, end);
+}
+
+void AudioSampleDeinterleaveBank(int bank, int beg, int end)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	assert(bank >= 0 && bank < cAudioBanks);
+
+	Vec4 *pDest = (Vec4*)AudioBankSIMDDest(bank);
+	BYTE **ppWavDest = AudioBankWavDest(bank);
+
+	short *pAudioDest[4] =
+	{
+		(short*)ppWavDest[0],
+		(short*)ppWavDest[1],
+		(short*)ppWavDest[2],
+		(short*)ppWavDest[3],
+	};
+
+	// the channels reach 16 byte alignment at the same sample
+	UINT_PTR misalign = (UINT_PTR)pAudioDest[0] & 15;
+	bool stream = !(misalign & 1) && misalign == ((UINT_PTR)pAudioDest[1] & 15) && misalign == ((UINT_PTR)pAudioDest[2] & 15) && misalign == ((UINT_PTR)pAudioDest[3] & 15);
+
+	int ii = beg;
+
+	for(; ii + 3<=end; ii += 4)
+	{
+		if (stream && !((UINT_PTR)(pAudioDest[0] + ii) & 15))
+		{
+			break;
+		}
+
+		AudioSampleDeinterleave4(pDest, pAudioDest, ii);
+	}
+
+	if (stream)
+	{
+		for(; ii + 7<=end; ii += 8)
+		{
+			Vec4::PrefetchNTA(pDest + ii + 32);
+
+			Vec4 s0 = pDest[ii];
+			Vec4 s1 = pDest[ii + 1];
+			Vec4 s2 = pDest[ii + 2];
+			Vec4 s3 = pDest[ii + 3];
+			Vec4 t0 = pDest[ii + 4];
+			Vec4 t1 = pDest[ii + 5];
+			Vec4 t2 = pDest[ii + 6];
+			Vec4 t3 = pDest[ii + 7];
+
+			AudioSampleTranspose(s0, s1, s2, s3);
+			AudioSampleTranspose(t0, t1, t2, t3);
+
+			IVec4::PackS16(Vec4::VTruncateToInt(s0), Vec4::VTruncateToInt(t0)).StoreStream((int*)(pAudioDest[0] + ii));
+			IVec4::PackS16(Vec4::VTruncateToInt(s1), Vec4::VTruncateToInt(t1)).StoreStream((int*)(pAudioDest[1] + ii));
+			IVec4::PackS16(Vec4::VTruncateToInt(s2), Vec4::VTruncateToInt(t2)).StoreStream((int*)(pAudioDest[2] + ii));
+			IVec4::PackS16(Vec4::VTruncateToInt(s3), Vec4::VTruncateToInt(t3)).StoreStream((int*)(pAudioDest[3] + ii));
+		}
+
+		Vec4::StoreFence();
+	}
+
+	for(; ii + 3<=end; ii += 4)
+	{
+		AudioSampleDeinterleave4(pDest, pAudioDest, ii);
+	}
+
+	for(; ii<=end; ii++)
+	{
+		int s[4];
+
+		Vec4::VTruncateToInt(pDest[ii]).Store(s);
+
+		pAudioDest[0][ii] = (short)s[0];
+		pAudioDest[1][ii] = (short)s[1];
+		pAudioDest[2][ii] = (short)s[2];
+		pAudioDest[3][ii] = (short)s[3];
+	}
+}
+
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClass(int beg, int end)
+{
+	using namespace VCLASS;
+
+	DenormalScope denormals;
+
+	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+	Vec4 base(32768.f);
+	Vec4 lo(-32768.f);
+	Vec4 hi(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec4 sampleIn = pSrc[ii];
+		sampleIn = sampleIn / base;
+
+		Vec4 sampleOut = EQ_VCLASS::do_3band(g_pEqVClass, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec4::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest[ii] = sampleOut;
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
+
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClassTypedef(int beg, int end)
+{
+	using namespace VCLASS_TYPEDEF;
+
+	DenormalScope denormals;
+
+	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+	Vec4 base(32768.f);
+	Vec4 lo(-32768.f);
+	Vec4 hi(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec4 sampleIn = pSrc[ii];
+		sampleIn = sampleIn / base;
+
+		Vec4 sampleOut = EQ_VCLASS_TYPEDEF::do_3band(g_pEqVClassTypedef, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec4::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest[ii] = sampleOut;
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
+
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClassSIMDType(int beg, int end)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	DenormalScope denormals;
+
+	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+	Vec4 base(32768.f);
+	Vec4 lo(-32768.f);
+	Vec4 hi(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec4 sampleIn = pSrc[ii];
+		sampleIn = sampleIn / base;
+
+		Vec4 sampleOut = EQ_VCLASS_SIMDTYPE::do_3band(g_pEqVClassSIMDType, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec4::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest[ii] = sampleOut;
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
+
+//--------------------------------------------------------------------------------------
+// The VClassSIMDType EQ in double, the samples are converted on load and store
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClassSIMDTypeDouble(int beg, int end)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	DenormalScope denormals;
+
+	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+	Vec4d base(32768.);
+	Vec4d lo(-32768.);
+	Vec4d hi(32767.);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec4d sampleIn = Vec4d(pSrc[ii]);
+		sampleIn = sampleIn / base;
+
+		Vec4d sampleOut = EQ_VCLASS_SIMDTYPE_DOUBLE::do_3band(g_pEqVClassSIMDTypeDouble, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec4d::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest[ii] = Vec4(sampleOut);
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+//--------------------------------------------------------------------------------------
+// 8 tracks per register: the low group filters bank 0, the high group bank 1, two
+// independent sets of 4 tracks interleaved and sized like the first.
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClassSIMDType8(int beg, int end)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	DenormalScope denormals;
+
+	assert(g_AudioSample.bank[0].pSIMDWavDataSrc && end < g_AudioSample.wavSize[0] / 2);
+
+	__m128 *pSrc0 = g_AudioSample.pSIMDWavDataSrc;
+	__m128 *pSrc1 = g_AudioSample.bank[0].pSIMDWavDataSrc;
+	__m128 *pDest0 = g_AudioSample.pSIMDWavDataDest;
+	__m128 *pDest1 = g_AudioSample.bank[0].pSIMDWavDataDest;
+	Vec8 base(32768.f);
+	Vec8 lo(-32768.f);
+	Vec8 hi(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec8 sampleIn = Vec8(simd_type8(pSrc0[ii], pSrc1[ii]));
+		sampleIn = sampleIn / base;
+
+		Vec8 sampleOut = EQ_VCLASS_SIMDTYPE8::do_3band(g_pEqVClassSIMDType8, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec8::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest0[ii] = sampleOut.Group<0>();
+		pDest1[ii] = sampleOut.Group<1>();
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleaveBank(0, beg, end);
+	AudioSampleDeinterleaveBank(1, beg, end);
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+//--------------------------------------------------------------------------------------
+// 16 tracks per register: group k filters bank k, four independent sets of 4 tracks
+// interleaved and sized like the first.
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVClassSIMDType16(int beg, int end)
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	DenormalScope denormals;
+
+	assert(g_AudioSample.bank[2].pSIMDWavDataSrc && end < g_AudioSample.wavSize[0] / 2);
+
+	__m128 *pSrc0 = g_AudioSample.pSIMDWavDataSrc;
+	__m128 *pSrc1 = g_AudioSample.bank[0].pSIMDWavDataSrc;
+	__m128 *pSrc2 = g_AudioSample.bank[1].pSIMDWavDataSrc;
+	__m128 *pSrc3 = g_AudioSample.bank[2].pSIMDWavDataSrc;
+	__m128 *pDest0 = g_AudioSample.pSIMDWavDataDest;
+	__m128 *pDest1 = g_AudioSample.bank[0].pSIMDWavDataDest;
+	__m128 *pDest2 = g_AudioSample.bank[1].pSIMDWavDataDest;
+	__m128 *pDest3 = g_AudioSample.bank[2].pSIMDWavDataDest;
+	Vec16 base(32768.f);
+	Vec16 lo(-32768.f);
+	Vec16 hi(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec16 sampleIn = Vec16(simd_type16(pSrc0[ii], pSrc1[ii], pSrc2[ii], pSrc3[ii]));
+		sampleIn = sampleIn / base;
+
+		Vec16 sampleOut = EQ_VCLASS_SIMDTYPE16::do_3band(g_pEqVClassSIMDType16, sampleIn);
+
+		//denormalize
+		sampleOut = sampleOut*base;
+
+		//clip to 16 bits
+		sampleOut = Vec16::VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest0[ii] = sampleOut.Group<0>();
+		pDest1[ii] = sampleOut.Group<1>();
+		pDest2[ii] = sampleOut.Group<2>();
+		pDest3[ii] = sampleOut.Group<3>();
+	}
+
+	//unshuffle and send it to the data channels
+	for(int bank=0; bank<cAudioBanks; bank++)
+	{
+		AudioSampleDeinterleaveBank(bank, beg, end);
+	}
+}
+#endif
+
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockVMath(int beg, int end)
+{
+	using namespace VMATH;
+
+	DenormalScope denormals;
+
+	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
+	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
+	Vec4 base = VLoad(32768.f);
+	Vec4 lo = VLoad(-32768.f);
+	Vec4 hi = VLoad(32767.f);
+
+	for(int ii=beg; ii<=end; ii++)
+	{
+		//loads
+		Vec4 sampleIn = pSrc[ii];
+
+		//normalize
+		sampleIn = VDiv(sampleIn, base);
+
+		Vec4 sampleOut = EQ_VMATH::do_3band(g_pEqVMath, sampleIn);
+
+		//denormalize
+		sampleOut = VMul(sampleOut, base);
+
+		//clip to 16 bits
+		sampleOut = VClamp(sampleOut, lo, hi);
+
+		//stores
+		pDest[ii] = sampleOut;
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
+
+//--------------------------------------------------------------------------------------
+// The plain float EQ, one track at a time from the 16-bit source channels. The results
+// go to the same lanes of pSIMDWavDataDest as the SIMD EQs (lane 0 is the trumpet).
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockFPU(int beg, int end)
+{
+	DenormalScope denormals;
+
+	float *pDest = (float*)g_AudioSample.pSIMDWavDataDest;
+
+	for(int ch=0; ch<4; ch++)
+	{
+		short *pSrc = (short*)g_AudioSample.pWavDataSrc[ch];
+		int lane = 3 - ch;
+
+		for(int ii=beg; ii<=end; ii++)
+		{
+			//normalize
+			float sampleIn = (float)pSrc[ii] / 32768.f;
+
+			float sampleOut = EQ_FPU::do_3band(&g_pEqFPU[ch], sampleIn);
+
+			//denormalize
+			sampleOut = sampleOut*32768.f;
+
+			//clip to 16 bits
+			sampleOut = (sampleOut < -32768.f) ? -32768.f : ((sampleOut > 32767.f) ? 32767.f : sampleOut);
+
+			//stores
+			pDest[4*ii + lane] = sampleOut;
+		}
+	}
+
+	//unshuffle and send it to the data channels
+	AudioSampleDeinterleave(beg, end);
+}
@@ -0,0 +1,139 @@
+//--------------------------------------------------------------------------------------
+// File: eq_fpu.cpp
+//
+// The 3 band EQ on plain floats, one track at a time: the reference the SIMD EQs are
+// checked against (simd_bench -demo diff). Built with fused multiply-adds off.
+//--------------------------------------------------------------------------------------
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#include <xaudio2.h>
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "vclass.h"
+#include "vclass_typedef.h"
+#include "vclass_simdtype.h"
+#include "eq.h"
+
+namespace EQ_FPU
+{
+	//----------------------------------------------------------------------------
+	//
+	//                                3 Band EQ :)
+	//
+	// EQ.C - Main Source file for 3 band EQ
+	//
+	// (c) Neil C / Etanza Systems / 2K6
+	//
+	// Shouts / Loves / Moans = etanza at lycos dot co dot uk
+	//
+	// This work is hereby placed in the public domain for all purposes, including
+	// use in commercial applications.
+	//
+	// The author assumes NO RESPONSIBILITY for any problems caused by the use of
+	// this software.
+	//
+	//----------------------------------------------------------------------------
+
+	// NOTES :
+	//
+	// - Original filter code by Paul Kellet (musicdsp.pdf)
+	//
+	// - Uses 4 first order filters in series, should give 24dB per octave
+	//
+	// - Now with P4 Denormal fix :)
+
+
+	//----------------------------------------------------------------------------
+
+	// -----------
+	//| Constants |
+	// -----------
+
+	static const float cPi = 3.1415926535897932384626433832795f;
+	static const float vsa = (1.0f / 4294967295.0f);	// Very small amount (Denormal Fix), EQ_DENORMAL_BIAS (eq.h)
+
+
+	// ---------------
+	//| Initialise EQ |
+	// ---------------
+
+	void init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq)
+	{
+	  // Clear state
+
+	  memset(es,0,sizeof(EQSTATE));
+
+	  // Set Low/Mid/High gains to unity
+
+	  es->lg = 1.0f;
+	  es->mg = 1.0f;
+	  es->hg = 1.0f;
+
+	  // Calculate filter cutoff frequencies
+
+	  es->lf = 2 * sinf(cPi * ((float)lowfreq / (float)mixfreq));
+	  es->hf = 2 * sinf(cPi * ((float)highfreq / (float)mixfreq));
+	}
+
+	// ---------------
+	//| EQ one sample |
+	// ---------------
+
+	float do_3band(EQSTATE* es, float sample)
+	{
+	  // Locals
+
+	  float  l,m,h;      // Low / Mid / High - Sample Values
+
+	  // Filter #1 (lowpass)
+
+#ifdef EQ_DENORMAL_BIAS
+	  es->f1p0  += (es->lf * (sample   - es->f1p0)) + vsa;
+#else
+	  es->f1p0  += (es->lf * (sample   - es->f1p0));
+#endif
+	  es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
+	  es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
+	  es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
+
+	  l          = es->f1p3;
+
+	  // Filter #2 (highpass)
+
+#ifdef EQ_DENORMAL_BIAS
+	  es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
+#else
+	  es->f2p0  += (es->hf * (sample   - es->f2p0));
+#endif
+	  es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
+	  es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
+	  es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
+
+	  h          = es->sdm3 - es->f2p3;
+
+	  // Calculate midrange (signal - (low + high))
+
+	  m          = es->sdm3 - (h + l);
+
+	  // Scale, Combine and store
+
+	  l         *= es->lg;
+	  m         *= es->mg;
+	  h         *= es->hg;
+
+	  // Shuffle history buffer
+
+	  es->sdm3   = es->sdm2;
+	  es->sdm2   = es->sdm1;
+	  es->sdm1   = sample;
+
+	  // Return result
+
+	  return(l + m + h);
+	}
+}
@@ -33,10 +33,11 @@
 	//| Constants |
 	// -----------
 
+	// vsa is built in do_3band from its bits, nothing runs at static init (the
+	// dispatch_<isa>.cpp builds must not run AVX code before the cpuid check)
+
 	static const float cPi = 3.1415926535897932384626433832795f;
-	static float vsaf = (1.0f / 4294967295.0f);   // Very small amount (Denormal Fix)
-	static Vec4 vsa (vsaf);
-	static Vec4 M_PI(cPi);
+	static const unsigned int cVsa = 0x2f800000;	// Very small amount (Denormal Fix), 1/4294967295 as a float, EQ_DENORMAL_BIAS (eq.h)
 
 
 	// ---------------
@@ -51,9 +52,23 @@
 	// Set mixfreq to whatever rate your system is using (eg 48Khz)
 	void init_3band_state(EQSTATE* es, int lowfreq, int highfreq, int mixfreq)
 	{
-	  // Clear state 
+	  // Clear state (member by member, Vec4 isn't safe to memset)
+
+	  Vec4	zero(0.0f);
+
+	  es->f1p0 = zero;
+	  es->f1p1 = zero;
+	  es->f1p2 = zero;
+	  es->f1p3 = zero;
+
+	  es->f2p0 = zero;
+	  es->f2p1 = zero;
+	  es->f2p2 = zero;
+	  es->f2p3 = zero;
 
-	  memset(es,0,sizeof(EQSTATE));
+	  es->sdm1 = zero;
+	  es->sdm2 = zero;
+	  es->sdm3 = zero;
 
 	  // Set Low/Mid/High gains to unity
 
@@ -81,6 +96,10 @@
 
 	Vec4 do_3band(EQSTATE* es, Vec4& sample)
 	{
+#ifdef EQ_DENORMAL_BIAS
+		const Vec4 vsa = Vec4::Const<cVsa>();
+#endif
+
 #ifdef EQ_VCLASS_NO_OVERLOADED_OPERATORS
 		// Locals
 
@@ -91,24 +110,24 @@
 
 		//es.f1p0  += (es.lf * (sample   - es.f1p0)) + vsa;
 		tmp0 = Vec4::VSub(sample, es->f1p0);
-		tmp1 = Vec4::VMul(es->lf, tmp0);
-		tmp2 = Vec4::VAdd(tmp1, vsa);
-		es->f1p0 = Vec4::VAdd(es->f1p0, tmp2);
+#ifdef EQ_DENORMAL_BIAS
+		tmp1 = Vec4::VMAdd(es->lf, tmp0, vsa);
+		es->f1p0 = Vec4::VAdd(es->f1p0, tmp1);
+#else
+		es->f1p0 = Vec4::VMAdd(es->lf, tmp0, es->f1p0);
+#endif
 
 		//es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
 		tmp0 = Vec4::VSub(es->f1p0, es->f1p1);
-		tmp1 = Vec4::VMul(es->lf, tmp0);
-		es->f1p1 = Vec4::VAdd(es->f1p1, tmp1);
+		es->f1p1 = Vec4::VMAdd(es->lf, tmp0, es->f1p1);
 
 		//es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
 		tmp0 = Vec4::VSub(es->f1p1, es->f1p2);
-		tmp1 = Vec4::VMul(es->lf, tmp0);
-		es->f1p2 = Vec4::VAdd(es->f1p2, tmp1);
+		es->f1p2 = Vec4::VMAdd(es->lf, tmp0, es->f1p2);
 
 		//es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
 		tmp0 = Vec4::VSub(es->f1p2, es->f1p3);
-		tmp1 = Vec4::VMul(es->lf, tmp0);
-		es->f1p3 = Vec4::VAdd(es->f1p3, tmp1);
+		es->f1p3 = Vec4::VMAdd(es->lf, tmp0, es->f1p3);
 
 		l          = es->f1p3;
 
@@ -116,24 +135,24 @@
 
 		//es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
 		tmp0 = Vec4::VSub(sample, es->f2p0);
-		tmp1 = Vec4::VMul(es->hf, tmp0);
-		tmp2 = Vec4::VAdd(tmp1, vsa);
-		es->f2p0 = Vec4::VAdd(es->f2p0, tmp2);
+#ifdef EQ_DENORMAL_BIAS
+		tmp1 = Vec4::VMAdd(es->hf, tmp0, vsa);
+		es->f2p0 = Vec4::VAdd(es->f2p0, tmp1);
+#else
+		es->f2p0 = Vec4::VMAdd(es->hf, tmp0, es->f2p0);
+#endif
 
 		//es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
 		tmp0 = Vec4::VSub(es->f2p0, es->f2p1);
-		tmp1 = Vec4::VMul(es->hf, tmp0);
-		es->f2p1 = Vec4::VAdd(es->f2p1, tmp1);
+		es->f2p1 = Vec4::VMAdd(es->hf, tmp0, es->f2p1);
 
 		//es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
 		tmp0 = Vec4::VSub(es->f2p1, es->f2p2);
-		tmp1 = Vec4::VMul(es->hf, tmp0);
-		es->f2p2 = Vec4::VAdd(es->f2p2, tmp1);
+		es->f2p2 = Vec4::VMAdd(es->hf, tmp0, es->f2p2);
 
 		//es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
 		tmp0 = Vec4::VSub(es->f2p2, es->f2p3);
-		tmp1 = Vec4::VMul(es->hf, tmp0);
-		es->f2p3 = Vec4::VAdd(es->f2p3, tmp1);
+		es->f2p3 = Vec4::VMAdd(es->hf, tmp0, es->f2p3);
 
 		//h          = es->sdm3 - es->f2p3;
 		h = Vec4::VSub(es->sdm3, es->f2p3);
@@ -149,10 +168,7 @@
 		//l         *= es->lg;
 		//m         *= es->mg;
 		//h         *= es->hg;
-
-		l = Vec4::VMul(l, es->lg);
-		m = Vec4::VMul(m, es->mg);
-		h = Vec4::VMul(h, es->hg);
+		//(fused into the return below)
 
 		// Shuffle history buffer 
 
@@ -162,11 +178,11 @@
 
 		// Return result
 
-		tmp0 = Vec4::VAdd(m, h);
-		tmp1 = Vec4::VAdd(l, tmp0);
+		tmp0 = Vec4::VMul(h, es->hg);
+		tmp1 = Vec4::VMAdd(m, es->mg, tmp0);
 
 		//return(l + m + h);
-		return(tmp1);
+		return(Vec4::VMAdd(l, es->lg, tmp1));
 #else
 
 	  // Locals
@@ -175,19 +191,27 @@
 
 	  // Filter #1 (lowpass)
 
-	  es->f1p0  += (es->lf * (sample   - es->f1p0)) + vsa;
-	  es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
-	  es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
-	  es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
+#ifdef EQ_DENORMAL_BIAS
+	  es->f1p0  += Vec4::VMAdd(es->lf, sample - es->f1p0, vsa);
+#else
+	  es->f1p0   = Vec4::VMAdd(es->lf, sample - es->f1p0, es->f1p0);
+#endif
+	  es->f1p1   = Vec4::VMAdd(es->lf, es->f1p0 - es->f1p1, es->f1p1);
+	  es->f1p2   = Vec4::VMAdd(es->lf, es->f1p1 - es->f1p2, es->f1p2);
+	  es->f1p3   = Vec4::VMAdd(es->lf, es->f1p2 - es->f1p3, es->f1p3);
 
 	  l          = es->f1p3;
 
 	  // Filter #2 (highpass)
 	  
-	  es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
-	  es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
-	  es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
-	  es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
+#ifdef EQ_DENORMAL_BIAS
+	  es->f2p0  += Vec4::VMAdd(es->hf, sample - es->f2p0, vsa);
+#else
+	  es->f2p0   = Vec4::VMAdd(es->hf, sample - es->f2p0, es->f2p0);
+#endif
+	  es->f2p1   = Vec4::VMAdd(es->hf, es->f2p0 - es->f2p1, es->f2p1);
+	  es->f2p2   = Vec4::VMAdd(es->hf, es->f2p1 - es->f2p2, es->f2p2);
+	  es->f2p3   = Vec4::VMAdd(es->hf, es->f2p2 - es->f2p3, es->f2p3);
 
 	  h          = es->sdm3 - es->f2p3;
 
@@ -195,11 +219,7 @@
 
 	  m          = es->sdm3 - (h + l);
 
-	  // Scale, Combine and store
-
-	  l         *= es->lg;
-	  m         *= es->mg;
-	  h         *= es->hg;
+	  // Scale and combine in the return below
 
 	  // Shuffle history buffer 
 
@@ -209,6 +229,6 @@
 
 	  // Return result
 
-	  return(l + m + h);
+	  return(Vec4::VMAdd(l, es->lg, Vec4::VMAdd(m, es->mg, h*es->hg)));
 #endif
 	}
\ No newline at end of file
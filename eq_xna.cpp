@@ -2,14 +2,19 @@
 // File: eq_xna.cpp
 //--------------------------------------------------------------------------------------
 
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include <xaudio2.h>
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include "_xnamath_.h"
 #include <math.h>
 #include "common.h"
 
+#ifndef SIMD_HEADLESS
 #include <windows.h>
 #include <xaudio2.h>
 #include <strsafe.h>
@@ -17,6 +22,7 @@
 #include <mmsystem.h>
 #include <conio.h>
 #include "SDKwavefile.h"
+#endif
 #include "eq_xna.h"
 
 
@@ -58,9 +64,9 @@ namespace EQ_XNAMATH
 	// -----------
 
 	static const float cPi = 3.1415926535897932384626433832795f;
-	static float vsaf = (1.0f / 4294967295.0f);   // Very small amount (Denormal Fix)
-	static XMVECTOR vsa = XMVectorReplicate(vsaf);
-	static XMVECTOR M_PI = XMVectorReplicate(cPi);
+	// Very small amount (Denormal Fix), an aggregate so it is constant initialized.
+	// Added with EQ_DENORMAL_BIAS only (eq.h)
+	static const XMVECTORF32 cVsa = { 1.0f / 4294967295.0f, 1.0f / 4294967295.0f, 1.0f / 4294967295.0f, 1.0f / 4294967295.0f };
 
 
 	// ---------------
@@ -108,10 +114,17 @@ namespace EQ_XNAMATH
 	  // Locals
 
 	  XMVECTOR  l,m,h;      // Low / Mid / High - Sample Values
+#ifdef EQ_DENORMAL_BIAS
+	  XMVECTOR  vsa = cVsa;
+#endif
 
 	  // Filter #1 (lowpass)
 
+#ifdef EQ_DENORMAL_BIAS
 	  es->f1p0  += (es->lf * (sample   - es->f1p0)) + vsa;
+#else
+	  es->f1p0  += (es->lf * (sample   - es->f1p0));
+#endif
 	  es->f1p1  += (es->lf * (es->f1p0 - es->f1p1));
 	  es->f1p2  += (es->lf * (es->f1p1 - es->f1p2));
 	  es->f1p3  += (es->lf * (es->f1p2 - es->f1p3));
@@ -120,7 +133,11 @@ namespace EQ_XNAMATH
 
 	  // Filter #2 (highpass)
 	  
+#ifdef EQ_DENORMAL_BIAS
 	  es->f2p0  += (es->hf * (sample   - es->f2p0)) + vsa;
+#else
+	  es->f2p0  += (es->hf * (sample   - es->f2p0));
+#endif
 	  es->f2p1  += (es->hf * (es->f2p0 - es->f2p1));
 	  es->f2p2  += (es->hf * (es->f2p1 - es->f2p2));
 	  es->f2p3  += (es->hf * (es->f2p2 - es->f2p3));
@@ -2,14 +2,19 @@
 // File: eq_xna_exec.cpp
 //--------------------------------------------------------------------------------------
 
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
 #include "DXUT.h"
 #include <xaudio2.h>
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 #include "_xnamath_.h"
 #include <math.h>
 #include "common.h"
 
+#ifndef SIMD_HEADLESS
 #include <windows.h>
 #include <xaudio2.h>
 #include <strsafe.h>
@@ -17,45 +22,44 @@
 #include <mmsystem.h>
 #include <conio.h>
 #include "SDKwavefile.h"
+#endif
 #include <xmmintrin.h>
 #include <emmintrin.h>
 
 #include "eq_xna.h"
 
 extern __declspec(align(128))		AudioSampleStruct	g_AudioSample;
-extern __declspec(align(128))		EQ_XNAMATH::EQSTATE g_eqXNAMath;
+
+EQ_XNAMATH::EQSTATE*		g_pEqXNAMath = NULL;
 
 //--------------------------------------------------------------------------------------
-// 
+// From the sample region, with the other EQ states (eq_exec.cpp)
 //--------------------------------------------------------------------------------------
-double ProcessAudioXNAMath(int audioFrames)
+void AllocEQStateXNAMath(void)
 {
-	PerformanceCounterStart();
-
-	//use 1st channel as master window (all channels have the same # of samples)
-    XAUDIO2_VOICE_STATE state;
-	g_AudioSample.pSourceVoice[0]->GetState( &state );
-
-	int					samples			= g_AudioSample.wavSize[0] / 2;
-	unsigned __int64	samplesPlayed	= state.SamplesPlayed;
-	int					currSample		= int (samplesPlayed % (unsigned __int64)samples);
-
-	int beg = currSample-audioFrames;
-	int end = currSample+audioFrames;
+	g_pEqXNAMath = (EQ_XNAMATH::EQSTATE*)AudioSampleAlloc(sizeof(EQ_XNAMATH::EQSTATE));
+}
 
-	if (end > samples - 1)
-	{
-		end = samples - 1;
-	}
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void InitEQStateXNAMath(void)
+{
+	EQ_XNAMATH::init_3band_state(g_pEqXNAMath,880,5000,44100);
+}
 
-	if (beg < 0)
-	{
-		beg = 0;
-	}
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+void ProcessAudioBlockXNAMath(int beg, int end)
+{
+	DenormalScope denormals;
 
 	XMVECTOR *pSrc = (XMVECTOR*)g_AudioSample.pSIMDWavDataSrc;
 	XMVECTOR *pDest = (XMVECTOR*)g_AudioSample.pSIMDWavDataDest;
 	XMVECTOR base = XMVectorReplicate(32768.f);
+	XMVECTOR lo = XMVectorReplicate(-32768.f);
+	XMVECTOR hi = XMVectorReplicate(32767.f);
 
 	for(int ii=beg; ii<=end; ii++)
 	{
@@ -65,32 +69,18 @@ double ProcessAudioXNAMath(int audioFrames)
 		//normalize
 		sampleIn = sampleIn / base;
 
-		XMVECTOR sampleOut = EQ_XNAMATH::do_3band(&g_eqXNAMath, sampleIn);
+		XMVECTOR sampleOut = EQ_XNAMATH::do_3band(g_pEqXNAMath, sampleIn);
 
 		//denormalize
 		sampleOut = sampleOut * base;
 
+		//clip to 16 bits
+		sampleOut = XMVectorClamp(sampleOut, lo, hi);
+
 		//stores
 		pDest[ii] = sampleOut;
 	}
 
 	//unshuffle and send it to the data channels
-	short *pAudioDest0 = (short*)g_AudioSample.pWavDataDest[0];
-	short *pAudioDest1 = (short*)g_AudioSample.pWavDataDest[1];
-	short *pAudioDest2 = (short*)g_AudioSample.pWavDataDest[2];
-	short *pAudioDest3 = (short*)g_AudioSample.pWavDataDest[3];
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		__declspec(align(128))	float s[4];
-
-		_mm_store_ps(s, pDest[ii]);
-
-		pAudioDest0[ii] = (short)s[0];
-		pAudioDest1[ii] = (short)s[1];
-		pAudioDest2[ii] = (short)s[2];
-		pAudioDest3[ii] = (short)s[3];
-	}
-
-	return(PerformanceCounterEnd());
+	AudioSampleDeinterleave(beg, end);
 }
@@ -0,0 +1,92 @@
+//--------------------------------------------------------------------------------------
+// File: half.cpp
+//
+// Float against half storage kernels for the headless bench, see half.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "half.h"
+
+namespace HALF_VMATH
+{
+	using namespace VMATH;
+
+	// Cloth::Verlet with the cloth's gravity and a 60Hz step
+	const float	cHalfTimeStep	= 1.f/60.f;
+	const float	cHalfGravity	= -1.5f;
+	const float	cHalfBox		= 50.f;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Verlet
+	///////////////////////////////////////////////////////////////////////////////
+	void VerletFloat(float *pX, void *pStore, int count)
+	{
+		Vec4	*pPos = (Vec4*)pX;
+		Vec4	*pOld = (Vec4*)pStore;
+		Vec4	d1 = VReplicate(0.99902f);
+		Vec4	d2 = VReplicate(0.99897f);
+		Vec4	boxMin = VReplicate(-cHalfBox);
+		Vec4	boxMax = VReplicate(cHalfBox);
+		Vec4	accel = VLoad(0.f, cHalfGravity*cHalfTimeStep*cHalfTimeStep, 0.f, 0.f);
+
+		for(int ii=0; ii<count; ii++)
+		{
+			Vec4 x = pPos[ii];
+			Vec4 t0 = VNMSub(d2, pOld[ii], VMAdd(d1, x, x));
+
+			pPos[ii] = VClamp(VAdd(accel, t0), boxMin, boxMax);
+			pOld[ii] = x;
+		}
+	}
+
+	void VerletHalf(float *pX, void *pStore, int count)
+	{
+		Vec4	*pPos = (Vec4*)pX;
+		Half4	*pOld = (Half4*)pStore;
+		Vec4	d1 = VReplicate(0.99902f);
+		Vec4	d2 = VReplicate(0.99897f);
+		Vec4	boxMin = VReplicate(-cHalfBox);
+		Vec4	boxMax = VReplicate(cHalfBox);
+		Vec4	accel = VLoad(0.f, cHalfGravity*cHalfTimeStep*cHalfTimeStep, 0.f, 0.f);
+
+		for(int ii=0; ii<count; ii++)
+		{
+			Vec4 x = pPos[ii];
+			Vec4 t0 = VNMSub(d2, VSub(x, VLoadHalf(pOld + ii)), VMAdd(d1, x, x));
+			Vec4 xn = VClamp(VAdd(accel, t0), boxMin, boxMax);
+
+			pPos[ii] = xn;
+			VStoreHalf(pOld + ii, VSub(xn, x));
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Vertex positions
+	///////////////////////////////////////////////////////////////////////////////
+	void VerticesFloat3(float *pX, void *pStore, int count)
+	{
+		VStore3Array((Float3*)pStore, (const Vec4*)pX, count);
+	}
+
+	void VerticesHalf(float *pX, void *pStore, int count)
+	{
+		VStoreHalfArray((Half4*)pStore, (const Vec4*)pX, count);
+	}
+
+	bool HalfF16C(void)
+	{
+#if defined(SIMD_F16C)
+		return(true);
+#else
+		return(false);
+#endif
+	}
+}
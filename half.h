@@ -0,0 +1,35 @@
+//--------------------------------------------------------------------------------------
+// File: half.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __HALF__
+#define __HALF__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Float against half (VMATH::Half4) storage for the bandwidth bound parts
+//	of the cloth, over count particles (pX: count Vec4, 16 byte aligned), for
+//	simd_bench -demo half at cloth sizes past the L2.
+//
+//	VerletFloat/Half	one Cloth::Verlet step, pStore is m_oldx as count
+//						Vec4 or the steps m_x - m_oldx as count Half4
+//	VerticesFloat3		pX to the vertex positions as count packed Float3
+//						(the CUSTOMVERTEX position)
+//	VerticesHalf		the same as count Half4 (D3DDECLTYPE_FLOAT16_4)
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace HALF_VMATH
+{
+	extern void VerletFloat(float *pX, void *pStore, int count);
+	extern void VerletHalf(float *pX, void *pStore, int count);
+	extern void VerticesFloat3(float *pX, void *pStore, int count);
+	extern void VerticesHalf(float *pX, void *pStore, int count);
+
+	// VLoadHalf/VStoreHalf on vcvtph2ps/vcvtps2ph, SSE2 integer code otherwise
+	extern bool HalfF16C(void);
+}
+
+#endif // #ifndef __HALF__
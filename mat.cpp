@@ -0,0 +1,251 @@
+//--------------------------------------------------------------------------------------
+// File: mat.cpp
+//
+// Mat4 kernels for the headless bench (simd_bench -demo mat): plain float loops against
+// VMATH::Mat4 and VCLASS_SIMDTYPE::matrix4. See mat.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "vclass_simdtype.h"
+#include "mat.h"
+
+namespace MAT_SCALAR
+{
+	// pOut = pA*pB, pOut is neither pA nor pB
+	static void Mul(const float *pA, const float *pB, float *pOut)
+	{
+		for(int row=0; row<4; row++)
+		{
+			for(int col=0; col<4; col++)
+			{
+				pOut[4*row + col] = pA[4*row]*pB[col] + pA[4*row + 1]*pB[4 + col] + pA[4*row + 2]*pB[8 + col] + pA[4*row + 3]*pB[12 + col];
+			}
+		}
+	}
+
+	void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			if (pParent[ii] < 0)
+			{
+				memcpy(pWorld + 16*ii, pLocal + 16*ii, 16*sizeof(float));
+			}
+			else
+			{
+				Mul(pLocal + 16*ii, pWorld + 16*pParent[ii], pWorld + 16*ii);
+			}
+		}
+	}
+
+	// adjugate over the 2x2 determinants of the top and bottom rows
+	void InvertFrames(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			const float	*m = pWorld + 16*ii;
+			float		*r = pOut + 16*ii;
+
+			float s0 = m[0]*m[5] - m[4]*m[1];
+			float s1 = m[0]*m[6] - m[4]*m[2];
+			float s2 = m[0]*m[7] - m[4]*m[3];
+			float s3 = m[1]*m[6] - m[5]*m[2];
+			float s4 = m[1]*m[7] - m[5]*m[3];
+			float s5 = m[2]*m[7] - m[6]*m[3];
+
+			float c5 = m[10]*m[15] - m[14]*m[11];
+			float c4 = m[9]*m[15] - m[13]*m[11];
+			float c3 = m[9]*m[14] - m[13]*m[10];
+			float c2 = m[8]*m[15] - m[12]*m[11];
+			float c1 = m[8]*m[14] - m[12]*m[10];
+			float c0 = m[8]*m[13] - m[12]*m[9];
+
+			float rdet = 1.f/(s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0);
+
+			r[0] = ( m[5]*c5 - m[6]*c4 + m[7]*c3)*rdet;
+			r[1] = (-m[1]*c5 + m[2]*c4 - m[3]*c3)*rdet;
+			r[2] = ( m[13]*s5 - m[14]*s4 + m[15]*s3)*rdet;
+			r[3] = (-m[9]*s5 + m[10]*s4 - m[11]*s3)*rdet;
+
+			r[4] = (-m[4]*c5 + m[6]*c2 - m[7]*c1)*rdet;
+			r[5] = ( m[0]*c5 - m[2]*c2 + m[3]*c1)*rdet;
+			r[6] = (-m[12]*s5 + m[14]*s2 - m[15]*s1)*rdet;
+			r[7] = ( m[8]*s5 - m[10]*s2 + m[11]*s1)*rdet;
+
+			r[8] = ( m[4]*c4 - m[5]*c2 + m[7]*c0)*rdet;
+			r[9] = (-m[0]*c4 + m[1]*c2 - m[3]*c0)*rdet;
+			r[10] = ( m[12]*s4 - m[13]*s2 + m[15]*s0)*rdet;
+			r[11] = (-m[8]*s4 + m[9]*s2 - m[11]*s0)*rdet;
+
+			r[12] = (-m[4]*c3 + m[5]*c1 - m[6]*c0)*rdet;
+			r[13] = ( m[0]*c3 - m[1]*c1 + m[2]*c0)*rdet;
+			r[14] = (-m[12]*s3 + m[13]*s1 - m[14]*s0)*rdet;
+			r[15] = ( m[8]*s3 - m[9]*s1 + m[10]*s0)*rdet;
+		}
+	}
+
+	// 3x3 cofactors, then the translation through the inverse
+	void InvertFramesAffine(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			const float	*m = pWorld + 16*ii;
+			float		*r = pOut + 16*ii;
+
+			float c00 = m[5]*m[10] - m[6]*m[9];
+			float c01 = m[6]*m[8] - m[4]*m[10];
+			float c02 = m[4]*m[9] - m[5]*m[8];
+
+			float rdet = 1.f/(m[0]*c00 + m[1]*c01 + m[2]*c02);
+
+			r[0] = c00*rdet;
+			r[1] = (m[2]*m[9] - m[1]*m[10])*rdet;
+			r[2] = (m[1]*m[6] - m[2]*m[5])*rdet;
+			r[3] = 0.f;
+
+			r[4] = c01*rdet;
+			r[5] = (m[0]*m[10] - m[2]*m[8])*rdet;
+			r[6] = (m[2]*m[4] - m[0]*m[6])*rdet;
+			r[7] = 0.f;
+
+			r[8] = c02*rdet;
+			r[9] = (m[1]*m[8] - m[0]*m[9])*rdet;
+			r[10] = (m[0]*m[5] - m[1]*m[4])*rdet;
+			r[11] = 0.f;
+
+			r[12] = -(m[12]*r[0] + m[13]*r[4] + m[14]*r[8]);
+			r[13] = -(m[12]*r[1] + m[13]*r[5] + m[14]*r[9]);
+			r[14] = -(m[12]*r[2] + m[13]*r[6] + m[14]*r[10]);
+			r[15] = 1.f;
+		}
+	}
+
+	void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			const float	*v = pIn + 4*ii;
+
+			for(int col=0; col<4; col++)
+			{
+				pOut[4*ii + col] = v[0]*pMat[col] + v[1]*pMat[4 + col] + v[2]*pMat[8 + col] + v[3]*pMat[12 + col];
+			}
+		}
+	}
+}
+
+namespace MAT_VMATH
+{
+	using namespace VMATH;
+
+	void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			Mat4 local = MLoad(pLocal + 16*ii);
+
+			if (pParent[ii] >= 0)
+			{
+				local = MMul(local, MLoad(pWorld + 16*pParent[ii]));
+			}
+
+			MStore(pWorld + 16*ii, local);
+		}
+	}
+
+	void InvertFrames(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			MStore(pOut + 16*ii, MInverse(MLoad(pWorld + 16*ii)));
+		}
+	}
+
+	void InvertFramesAffine(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			MStore(pOut + 16*ii, MInverseAffine(MLoad(pWorld + 16*ii)));
+		}
+	}
+
+	void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count)
+	{
+		VMATH::TransformPoints(MLoad(pMat), (const Vec4*)pIn, (Vec4*)pOut, count);
+	}
+}
+
+namespace MAT_VCLASS_SIMDTYPE
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			Mat4 local(pLocal + 16*ii);
+
+			if (pParent[ii] >= 0)
+			{
+				local = Mat4::Mul(local, Mat4(pWorld + 16*pParent[ii]));
+			}
+
+			local.Store(pWorld + 16*ii);
+		}
+	}
+
+	void InvertFrames(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			Mat4::Inverse(Mat4(pWorld + 16*ii)).Store(pOut + 16*ii);
+		}
+	}
+
+	void InvertFramesAffine(const float *pWorld, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			Mat4::InverseAffine(Mat4(pWorld + 16*ii)).Store(pOut + 16*ii);
+		}
+	}
+
+	void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count)
+	{
+		Mat4::TransformPoints(Mat4(pMat), (const Vec4*)pIn, (Vec4*)pOut, count);
+	}
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace MAT_VCLASS_SIMDTYPE8
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	// 2 points per Vec8
+	void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count)
+	{
+		Mat8::TransformPoints(Mat8(pMat), (const Vec8*)pIn, (Vec8*)pOut, count/2);
+	}
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace MAT_VCLASS_SIMDTYPE16
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	// 4 points per Vec16
+	void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count)
+	{
+		Mat16::TransformPoints(Mat16(pMat), (const Vec16*)pIn, (Vec16*)pOut, count/4);
+	}
+}
+#endif
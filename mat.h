@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------
+// File: mat.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __MAT__
+#define __MAT__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Mat4 kernels for simd_bench -demo mat, modelled on the D3DX calls of
+//	CDXUTSDKMesh (frame hierarchy, bind pose inverse) and the camera.
+//	Matrices are 16 floats in the D3DXMATRIX layout (v*M, translation in the
+//	4th row), every array is 64 byte aligned.
+//
+//	TransformFrames		pWorld[i] = pLocal[i]*pWorld[pParent[i]], a parent
+//						comes before its children, -1 for a root
+//	InvertFrames		pOut[i] = inverse(pWorld[i])
+//	InvertFramesAffine	the same for matrices with a (0,0,0,1) 4th column
+//	TransformPoints		pOut[i] = pIn[i]*M for count points of 4 floats
+//						(a multiple of 4)
+//
+//	The wide builds of VCLASS_SIMDTYPE only have TransformPoints, a Mat8 or
+//	Mat16 holds one matrix per 128 bit lane and pays off on points only.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+// plain float loops, what the code does without D3DX or SIMD
+namespace MAT_SCALAR
+{
+	extern void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count);
+	extern void InvertFrames(const float *pWorld, float *pOut, int count);
+	extern void InvertFramesAffine(const float *pWorld, float *pOut, int count);
+	extern void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count);
+}
+
+namespace MAT_VMATH
+{
+	extern void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count);
+	extern void InvertFrames(const float *pWorld, float *pOut, int count);
+	extern void InvertFramesAffine(const float *pWorld, float *pOut, int count);
+	extern void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count);
+}
+
+namespace MAT_VCLASS_SIMDTYPE
+{
+	extern void TransformFrames(const float *pLocal, const int *pParent, float *pWorld, int count);
+	extern void InvertFrames(const float *pWorld, float *pOut, int count);
+	extern void InvertFramesAffine(const float *pWorld, float *pOut, int count);
+	extern void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count);
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace MAT_VCLASS_SIMDTYPE8
+{
+	extern void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count);
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace MAT_VCLASS_SIMDTYPE16
+{
+	extern void TransformPoints(const float *pMat, const float *pIn, float *pOut, int count);
+}
+#endif
+
+#endif // #ifndef __MAT__
@@ -0,0 +1,75 @@
+//--------------------------------------------------------------------------------------
+// File: platform.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __PLATFORM__
+#define __PLATFORM__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Minimal environment for the headless (SIMD_HEADLESS) build.
+//	The demo sources lean on DXUT.h for the Win32 types and on MSVC keywords
+//	(__declspec, __forceinline, __int64). This header brings in just enough
+//	of both so the math libraries and kernels compile under GCC/Clang too.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#if defined(_WIN32)
+
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+
+#else
+
+	#include <stdint.h>
+	#include <time.h>
+
+	///////////////////////////////////////////
+	// MSVC keywords
+	///////////////////////////////////////////
+
+	#define __declspec(attr)		__declspec_##attr
+	#define __declspec_align(n)		__attribute__((aligned(n)))
+	#define __declspec_selectany	__attribute__((weak))
+	#define __declspec_noinline		__attribute__((noinline))
+	#define __forceinline			inline __attribute__((always_inline))
+	#define __int64					long long
+
+	///////////////////////////////////////////
+	// Win32 types
+	///////////////////////////////////////////
+
+	typedef int32_t				HRESULT;
+	typedef float				FLOAT;
+	typedef int					INT;
+	typedef unsigned int		UINT;
+	typedef int					BOOL;
+	typedef char				CHAR;
+	typedef unsigned char		UCHAR;
+	typedef unsigned char		BYTE;
+	typedef short				SHORT;
+	typedef unsigned short		USHORT;
+	typedef unsigned short		WORD;
+	typedef uint32_t			DWORD;
+	typedef int64_t				INT64;
+	typedef uint64_t			UINT64;
+	typedef uintptr_t			UINT_PTR;
+	typedef wchar_t				WCHAR;
+
+	#define VOID				void
+	#define CONST				const
+
+	#define S_OK				((HRESULT)0)
+	#define E_FAIL				((HRESULT)0x80004005)
+	#define SUCCEEDED(hr)		(((HRESULT)(hr)) >= 0)
+	#define FAILED(hr)			(((HRESULT)(hr)) < 0)
+
+#endif // #if defined(_WIN32)
+
+#endif // #ifndef __PLATFORM__
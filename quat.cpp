@@ -0,0 +1,138 @@
+//--------------------------------------------------------------------------------------
+// File: quat.cpp
+//
+// Quaternion key interpolation kernels for the headless bench (simd_bench -demo quat),
+// see quat.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "quat.h"
+
+namespace QUAT_SCALAR
+{
+	// w0*q0 + w1*q1, normalized
+	static void Blend(const float *q0, const float *q1, float w0, float w1, float *pOut)
+	{
+		float r[4];
+
+		for(int jj=0; jj<4; jj++)
+		{
+			r[jj] = w0*q0[jj] + w1*q1[jj];
+		}
+
+		float rlen = 1.f/sqrtf(r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3]);
+
+		for(int jj=0; jj<4; jj++)
+		{
+			pOut[jj] = r[jj]*rlen;
+		}
+	}
+
+	void NlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			const float	*q0 = pQ0 + 4*ii;
+			const float	*q1 = pQ1 + 4*ii;
+			float		c = q0[0]*q1[0] + q0[1]*q1[1] + q0[2]*q1[2] + q0[3]*q1[3];
+			float		t = pT[ii];
+
+			Blend(q0, q1, 1.f - t, (c < 0.f) ? -t : t, pOut + 4*ii);
+		}
+	}
+
+	void SlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			const float	*q0 = pQ0 + 4*ii;
+			const float	*q1 = pQ1 + 4*ii;
+			float		c = q0[0]*q1[0] + q0[1]*q1[1] + q0[2]*q1[2] + q0[3]*q1[3];
+			float		t = pT[ii];
+			float		sign = (c < 0.f) ? -1.f : 1.f;
+			float		w0 = 1.f - t;
+			float		w1 = t;
+
+			c *= sign;
+
+			if (c <= 0.9995f)
+			{
+				float theta = acosf(c);
+				float rs = 1.f/sinf(theta);
+
+				w0 = sinf((1.f - t)*theta)*rs;
+				w1 = sinf(t*theta)*rs;
+			}
+
+			Blend(q0, q1, w0, w1*sign, pOut + 4*ii);
+		}
+	}
+}
+
+namespace QUAT_VMATH
+{
+	using namespace VMATH;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Nlerp
+	///////////////////////////////////////////////////////////////////////////////
+	void NlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			VStore(pOut + 4*ii, QNlerp(VLoad(pQ0 + 4*ii), VLoad(pQ1 + 4*ii), VReplicate(pT[ii])));
+		}
+	}
+
+	void Nlerp4Array(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4x4 q0 = VTransposeLoad((Vec4*)(pQ0 + 4*ii));
+			Vec4x4 q1 = VTransposeLoad((Vec4*)(pQ1 + 4*ii));
+
+			VTransposeStore((Vec4*)(pOut + 4*ii), QNlerp4(q0, q1, VLoad(pT + ii)));
+		}
+	}
+
+	// arrays already in SoA blocks, no transpose
+	void Nlerp4SoAArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		QNlerpSoA((Vec4x4*)pQ0, (Vec4x4*)pQ1, (Vec4*)pT, (Vec4x4*)pOut, count/4);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Slerp
+	///////////////////////////////////////////////////////////////////////////////
+	void SlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			VStore(pOut + 4*ii, QSlerp(VLoad(pQ0 + 4*ii), VLoad(pQ1 + 4*ii), VReplicate(pT[ii])));
+		}
+	}
+
+	void Slerp4Array(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4x4 q0 = VTransposeLoad((Vec4*)(pQ0 + 4*ii));
+			Vec4x4 q1 = VTransposeLoad((Vec4*)(pQ1 + 4*ii));
+
+			VTransposeStore((Vec4*)(pOut + 4*ii), QSlerp4(q0, q1, VLoad(pT + ii)));
+		}
+	}
+
+	void Slerp4SoAArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count)
+	{
+		QSlerpSoA((Vec4x4*)pQ0, (Vec4x4*)pQ1, (Vec4*)pT, (Vec4x4*)pOut, count/4);
+	}
+}
@@ -0,0 +1,38 @@
+//--------------------------------------------------------------------------------------
+// File: quat.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __QUAT__
+#define __QUAT__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Animation key interpolation for simd_bench -demo quat: pOut[i] =
+//	slerp/nlerp(pQ0[i], pQ1[i], pT[i]) over count keys (a multiple of 4, the
+//	arrays 16 byte aligned). Quaternions are (x, y, z, w) like
+//	D3DXQUATERNION. The *4 versions transpose 4 AoS keys into a Vec4x4 on the
+//	fly, the *4SoA versions take pQ0, pQ1 and pOut already stored as Vec4x4
+//	blocks.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+// one key at a time in float, acosf/sinf like D3DXQuaternionSlerp
+namespace QUAT_SCALAR
+{
+	extern void NlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void SlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+}
+
+namespace QUAT_VMATH
+{
+	extern void NlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void Nlerp4Array(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void Nlerp4SoAArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void SlerpArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void Slerp4Array(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+	extern void Slerp4SoAArray(float *pQ0, float *pQ1, float *pT, float *pOut, int count);
+}
+
+#endif // #ifndef __QUAT__
@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------
+// File: recip.cpp
+//
+// Division against reciprocal estimate array kernels for the headless bench, see recip.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "recip.h"
+
+namespace RECIP_VMATH
+{
+	using namespace VMATH;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// 1/x
+	///////////////////////////////////////////////////////////////////////////////
+	void ReciprocalArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VReciprocal(VLoad(pIn + ii)));
+		}
+	}
+
+	template <int Steps>
+	void ReciprocalEstArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VReciprocalEst<Steps>(VLoad(pIn + ii)));
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// 1/sqrt(x)
+	///////////////////////////////////////////////////////////////////////////////
+	void RsqrtArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VReciprocal(Sqrt(VLoad(pIn + ii))));
+		}
+	}
+
+	template <int Steps>
+	void RsqrtEstArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VRsqrtEst<Steps>(VLoad(pIn + ii)));
+		}
+	}
+
+	template void ReciprocalEstArray<0>(float *pIn, float *pOut, int count);
+	template void ReciprocalEstArray<1>(float *pIn, float *pOut, int count);
+	template void ReciprocalEstArray<2>(float *pIn, float *pOut, int count);
+	template void RsqrtEstArray<0>(float *pIn, float *pOut, int count);
+	template void RsqrtEstArray<1>(float *pIn, float *pOut, int count);
+	template void RsqrtEstArray<2>(float *pIn, float *pOut, int count);
+}
@@ -0,0 +1,28 @@
+//--------------------------------------------------------------------------------------
+// File: recip.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __RECIP__
+#define __RECIP__
+
+///////////////////////////////////////////////////////////////////////////////
+//	1/x and 1/sqrt(x) over count floats (a multiple of 4, 16 byte aligned),
+//	with the division and Sqrt against VMATH::VReciprocalEst/VRsqrtEst
+//	refined by Steps Newton-Raphson steps, for simd_bench -demo rcp.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace RECIP_VMATH
+{
+	extern void ReciprocalArray(float *pIn, float *pOut, int count);
+	extern void RsqrtArray(float *pIn, float *pOut, int count);
+
+	// instantiated for Steps 0, 1 and 2
+	template <int Steps> extern void ReciprocalEstArray(float *pIn, float *pOut, int count);
+	template <int Steps> extern void RsqrtEstArray(float *pIn, float *pOut, int count);
+}
+
+#endif // #ifndef __RECIP__
@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------------
+// File: sine.cpp
+//
+// testsine.cpp's sine polynomials as array kernels for the headless bench
+// (simd_bench -demo sine): VMATH's operator and operator-per-term versions, VCLASS
+// and VCLASS_SIMDTYPE with their plain operators, VMATH::Sin and sinf. sine_expr.cpp
+// builds the class versions again with VCLASS_EXPRESSION_TEMPLATES.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "sine.h"
+
+// always the plain operators here, whatever the rest of the program is built with.
+// The class headers go inside SINE_PLAIN_LIBS, like sine_expr.cpp's SINE_EXPR_LIBS,
+// so with SIMD_EXPRESSION_TEMPLATES these Vec4 stay distinct from VCLASS::Vec4
+#pragma push_macro("VCLASS_EXPRESSION_TEMPLATES")
+#undef VCLASS_EXPRESSION_TEMPLATES
+
+namespace SINE_PLAIN_LIBS
+{
+	#include "vclass.h"
+	#include "vclass_simdtype.h"
+}
+
+#pragma pop_macro("VCLASS_EXPRESSION_TEMPLATES")
+
+////////////////////////////////////////////////////////////////////////////////
+//sin(x) =	- x^15/1307674368000 + x^13/6227020800 - x^11/39916800 + x^9/362880
+//			- x^7/5040 + x^5/120 - x^3/6 + x
+////////////////////////////////////////////////////////////////////////////////
+namespace SINE_VMATH
+{
+	using namespace VMATH;
+
+	// operators, as VMATH::VSin
+	Vec4 VSin(const Vec4& x)
+	{
+		Vec4 c1 = VConst<0xbe2aaaab>();		// -1/3!
+		Vec4 c2 = VConst<0x3c088889>();		// 1/5!
+		Vec4 c3 = VConst<0xb9500d01>();		// -1/7!
+		Vec4 c4 = VConst<0x3638ef1d>();		// 1/9!
+		Vec4 c5 = VConst<0xb2d7322b>();		// -1/11!
+		Vec4 c6 = VConst<0x2f309231>();		// 1/13!
+		Vec4 c7 = VConst<0xab573f9f>();		// -1/15!
+
+		Vec4 res =	x + 
+					c1*x*x*x + 
+					c2*x*x*x*x*x + 
+					c3*x*x*x*x*x*x*x + 
+					c4*x*x*x*x*x*x*x*x*x + 
+					c5*x*x*x*x*x*x*x*x*x*x*x + 
+					c6*x*x*x*x*x*x*x*x*x*x*x*x*x + 
+					c7*x*x*x*x*x*x*x*x*x*x*x*x*x*x*x;
+
+		return (res);
+	}
+
+	// operators, one term at a time reusing the odd powers, as VMATH::VSin2
+	Vec4 VSin2(const Vec4& x)
+	{
+		Vec4 c1 = VConst<0xbe2aaaab>();		// -1/3!
+		Vec4 c2 = VConst<0x3c088889>();		// 1/5!
+		Vec4 c3 = VConst<0xb9500d01>();		// -1/7!
+		Vec4 c4 = VConst<0x3638ef1d>();		// 1/9!
+		Vec4 c5 = VConst<0xb2d7322b>();		// -1/11!
+		Vec4 c6 = VConst<0x2f309231>();		// 1/13!
+		Vec4 c7 = VConst<0xab573f9f>();		// -1/15!
+
+		Vec4 tmp0 = x;
+		Vec4 x3 = x*x*x;
+		Vec4 tmp1 = c1*x3;
+		Vec4 res = tmp0 + tmp1;
+		
+		Vec4 x5 = x3*x*x;
+		tmp0 = c2*x5;
+		res	= res + tmp0;
+
+		Vec4 x7 = x5*x*x;
+		tmp0 = c3*x7;
+		res	= res + tmp0;
+
+		Vec4 x9 = x7*x*x;
+		tmp0 = c4*x9;
+		res	= res + tmp0;
+
+		Vec4 x11 = x9*x*x;
+		tmp0 = c5*x11;
+		res	= res + tmp0;
+
+		Vec4 x13 = x11*x*x;
+		tmp0 = c6*x13;
+		res	= res + tmp0;
+
+		Vec4 x15 = x13*x*x;
+		tmp0 = c7*x15;
+		res	= res + tmp0;
+
+		return (res);
+	}
+
+	void VSinArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VSin(VLoad(pIn + ii)));
+		}
+	}
+
+	void VSin2Array(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VSin2(VLoad(pIn + ii)));
+		}
+	}
+
+	// vtranscendental.inl
+	void SinArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Sin(VLoad(pIn + ii)));
+		}
+	}
+}
+
+namespace SINE_LIBM
+{
+	void SinArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = sinf(pIn[ii]);
+		}
+	}
+}
+
+namespace SINE_VCLASS
+{
+	using namespace SINE_PLAIN_LIBS::VCLASS;
+
+	#include "sine_vclass.inl"
+}
+
+namespace SINE_VCLASS_SIMDTYPE
+{
+	using namespace SINE_PLAIN_LIBS::VCLASS_SIMDTYPE;
+
+	#include "sine_vclass.inl"
+}
@@ -0,0 +1,52 @@
+//--------------------------------------------------------------------------------------
+// File: sine.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __SINE__
+#define __SINE__
+
+///////////////////////////////////////////////////////////////////////////////
+//	The 15th order sine polynomial of testsine.cpp over an array (count is a
+//	multiple of 4, both arrays 16 byte aligned), one build per library, next
+//	to the range reduced VMATH::Sin and libm's sinf.
+//	The *_EXPR builds are VCLASS/VCLASS_SIMDTYPE with the operators in
+//	VCLASS_EXPRESSION_TEMPLATES mode (sine_expr.cpp).
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace SINE_VMATH
+{
+	extern void VSinArray(float *pIn, float *pOut, int count);
+	extern void VSin2Array(float *pIn, float *pOut, int count);
+	extern void SinArray(float *pIn, float *pOut, int count);		// VMATH::Sin, range reduced
+}
+
+namespace SINE_LIBM
+{
+	extern void SinArray(float *pIn, float *pOut, int count);		// sinf
+}
+
+namespace SINE_VCLASS
+{
+	extern void VSinArray(float *pIn, float *pOut, int count);
+}
+
+namespace SINE_VCLASS_SIMDTYPE
+{
+	extern void VSinArray(float *pIn, float *pOut, int count);
+}
+
+namespace SINE_VCLASS_EXPR
+{
+	extern void VSinArray(float *pIn, float *pOut, int count);
+}
+
+namespace SINE_VCLASS_SIMDTYPE_EXPR
+{
+	extern void VSinArray(float *pIn, float *pOut, int count);
+}
+
+#endif // #ifndef __SINE__
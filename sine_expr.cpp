@@ -0,0 +1,43 @@
+//--------------------------------------------------------------------------------------
+// File: sine_expr.cpp
+//
+// sine_vclass.inl built with VCLASS_EXPRESSION_TEMPLATES, next to the plain operator
+// build of sine.cpp. The class headers are included inside SINE_EXPR_LIBS (and
+// sine.cpp's inside SINE_PLAIN_LIBS), so neither Vec4 is the VCLASS::Vec4 of the rest
+// of the program, whichever way SIMD_EXPRESSION_TEMPLATES builds that one.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <math.h>
+#include "sine.h"
+
+#ifndef VCLASS_EXPRESSION_TEMPLATES
+#define VCLASS_EXPRESSION_TEMPLATES
+#endif
+
+namespace SINE_EXPR_LIBS
+{
+	#include "vclass.h"
+	#include "vclass_simdtype.h"
+}
+
+namespace SINE_VCLASS_EXPR
+{
+	using namespace SINE_EXPR_LIBS::VCLASS;
+
+	#include "sine_vclass.inl"
+}
+
+namespace SINE_VCLASS_SIMDTYPE_EXPR
+{
+	using namespace SINE_EXPR_LIBS::VCLASS_SIMDTYPE;
+
+	#include "sine_vclass.inl"
+}
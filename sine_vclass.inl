@@ -0,0 +1,36 @@
+	//--------------------------------------------------------------------------------------
+	// File: sine_vclass.inl
+	//
+	// VSin of testsine.cpp for the class based libraries, included by sine.cpp and
+	// sine_expr.cpp inside a namespace using VCLASS or VCLASS_SIMDTYPE.
+	//--------------------------------------------------------------------------------------
+
+	Vec4 VSin(const Vec4& x)
+	{
+		Vec4 c1 = Vec4::Const<0xbe2aaaab>();		// -1/3!
+		Vec4 c2 = Vec4::Const<0x3c088889>();		// 1/5!
+		Vec4 c3 = Vec4::Const<0xb9500d01>();		// -1/7!
+		Vec4 c4 = Vec4::Const<0x3638ef1d>();		// 1/9!
+		Vec4 c5 = Vec4::Const<0xb2d7322b>();		// -1/11!
+		Vec4 c6 = Vec4::Const<0x2f309231>();		// 1/13!
+		Vec4 c7 = Vec4::Const<0xab573f9f>();		// -1/15!
+
+		Vec4 res =	x + 
+					c1*x*x*x + 
+					c2*x*x*x*x*x + 
+					c3*x*x*x*x*x*x*x + 
+					c4*x*x*x*x*x*x*x*x*x + 
+					c5*x*x*x*x*x*x*x*x*x*x*x + 
+					c6*x*x*x*x*x*x*x*x*x*x*x*x*x + 
+					c7*x*x*x*x*x*x*x*x*x*x*x*x*x*x*x;
+
+		return (res);
+	}
+
+	void VSinArray(float *pIn, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VSin(Vec4(pIn + ii)).Store(pOut + ii);
+		}
+	}
@@ -0,0 +1,125 @@
+//--------------------------------------------------------------------------------------
+// File: soa.cpp
+//
+// AoS against SoA (Vec4x4) array kernels for the headless bench, see soa.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "soa.h"
+
+namespace SOA_VMATH
+{
+	using namespace VMATH;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Dot
+	///////////////////////////////////////////////////////////////////////////////
+	void DotArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			GetX(pOut + ii, Dot(VLoad(pA + 4*ii), VLoad(pB + 4*ii)));
+		}
+	}
+
+	void Dot4Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4x4 va = VTransposeLoad((Vec4*)(pA + 4*ii));
+			Vec4x4 vb = VTransposeLoad((Vec4*)(pB + 4*ii));
+
+			VStore(pOut + ii, Dot4(va, vb));
+		}
+	}
+
+	// arrays already in SoA blocks, no transpose
+	void Dot4SoAArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Dot4(*(Vec4x4*)(pA + 4*ii), *(Vec4x4*)(pB + 4*ii)));
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Normalize
+	///////////////////////////////////////////////////////////////////////////////
+	void NormalizeArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		Vec4 one = VReplicate(1.f);
+
+		for(int ii=0; ii<count; ii++)
+		{
+			Vec4 v = VLoad(pA + 4*ii);
+
+			VStore(pOut + 4*ii, VMul(v, VDiv(one, Sqrt(Dot(v, v)))));
+		}
+	}
+
+	void Normalize4Array(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VTransposeStore((Vec4*)(pOut + 4*ii), Normalize4(VTransposeLoad((Vec4*)(pA + 4*ii))));
+		}
+	}
+
+	// packed Float3 in and out, 12 bytes a vector
+	void Normalize3Array(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VTransposeStore3((Float3*)(pOut + 3*ii), Normalize4(VTransposeLoad3((Float3*)(pA + 3*ii))));
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Reflect
+	///////////////////////////////////////////////////////////////////////////////
+	void ReflectArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			VStore(pOut + 4*ii, Reflect(VLoad(pA + 4*ii), VLoad(pB + 4*ii)));
+		}
+	}
+
+	void Reflect4Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4x4 vi = VTransposeLoad((Vec4*)(pA + 4*ii));
+			Vec4x4 vn = VTransposeLoad((Vec4*)(pB + 4*ii));
+
+			VTransposeStore((Vec4*)(pOut + 4*ii), Reflect4(vi, vn));
+		}
+	}
+
+	void Reflect3Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4x4 vi = VTransposeLoad3((Float3*)(pA + 3*ii));
+			Vec4x4 vn = VTransposeLoad3((Float3*)(pB + 3*ii));
+
+			VTransposeStore3((Float3*)(pOut + 3*ii), Reflect4(vi, vn));
+		}
+	}
+
+	void Reflect4SoAArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			*(Vec4x4*)(pOut + 4*ii) = Reflect4(*(Vec4x4*)(pA + 4*ii), *(Vec4x4*)(pB + 4*ii));
+		}
+	}
+}
@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------------------------
+// File: soa.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __SOA__
+#define __SOA__
+
+///////////////////////////////////////////////////////////////////////////////
+//	VMATH's one vector at a time Dot/Normalize/Reflect against the transposed
+//	Vec4x4 versions (Dot4, Normalize4, Reflect4) over arrays of count Vec4
+//	(a multiple of 4, 16 byte aligned), for simd_bench -demo soa.
+//	Dot writes count floats, Normalize and Reflect count Vec4. Normalize
+//	ignores pB. The *SoA versions take arrays already stored as Vec4x4 blocks,
+//	the *3 versions packed Float3 arrays (count*3 floats, no alignment) through
+//	VTransposeLoad3/VTransposeStore3.
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace SOA_VMATH
+{
+	extern void DotArray(float *pA, float *pB, float *pOut, int count);
+	extern void Dot4Array(float *pA, float *pB, float *pOut, int count);
+	extern void Dot4SoAArray(float *pA, float *pB, float *pOut, int count);
+	extern void NormalizeArray(float *pA, float *pB, float *pOut, int count);
+	extern void Normalize4Array(float *pA, float *pB, float *pOut, int count);
+	extern void Normalize3Array(float *pA, float *pB, float *pOut, int count);
+	extern void ReflectArray(float *pA, float *pB, float *pOut, int count);
+	extern void Reflect4Array(float *pA, float *pB, float *pOut, int count);
+	extern void Reflect3Array(float *pA, float *pB, float *pOut, int count);
+	extern void Reflect4SoAArray(float *pA, float *pB, float *pOut, int count);
+}
+
+#endif // #ifndef __SOA__
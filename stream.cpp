@@ -0,0 +1,112 @@
+//--------------------------------------------------------------------------------------
+// File: stream.cpp
+//
+// Hand written loops against VMATH::Stream for the headless bench, see stream.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "stream.h"
+
+namespace STREAM_VMATH
+{
+	using namespace VMATH;
+
+	///////////////////////////////////////////////////////////////////////////////
+	// MulAdd
+	///////////////////////////////////////////////////////////////////////////////
+	void MulAddLoop(float *pA, float *pB, float *pC, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, VMAdd(VLoad(pA + ii), VLoad(pB + ii), VLoad(pC + ii)));
+		}
+	}
+
+	void MulAddLoopNT(float *pA, float *pB, float *pC, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStoreStream(pOut + ii, VMAdd(VLoad(pA + ii), VLoad(pB + ii), VLoad(pC + ii)));
+		}
+
+		VStoreFence();
+	}
+
+	void MulAddStream(float *pA, float *pB, float *pC, float *pOut, int count)
+	{
+		Stream::MulAdd(pOut, pA, pB, pC, count);
+	}
+
+	void MulAddStreamNT(float *pA, float *pB, float *pC, float *pOut, int count)
+	{
+		Stream::MulAddNT(pOut, pA, pB, pC, count);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Dot
+	///////////////////////////////////////////////////////////////////////////////
+	void DotLoop(float *pA, float *pB, float * /*pC*/, float *pOut, int count)
+	{
+		Vec4 sum = _mm_setzero_ps();
+
+		for(int ii=0; ii<count; ii+=4)
+		{
+			sum = VMAdd(VLoad(pA + ii), VLoad(pB + ii), sum);
+		}
+
+		GetX(pOut, Dot(sum, VConst<0x3f800000>()));
+	}
+
+	void DotStream(float *pA, float *pB, float * /*pC*/, float *pOut, int count)
+	{
+		pOut[0] = Stream::Dot(pA, pB, count);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+	// Peak (max |x|) and energy (sum of squares) of pA, one accumulator in the
+	// loops against the four of Stream::Peak/SumSquares
+	///////////////////////////////////////////////////////////////////////////////
+	void PeakLoop(float *pA, float * /*pB*/, float * /*pC*/, float *pOut, int count)
+	{
+		Vec4 peak = _mm_setzero_ps();
+
+		for(int ii=0; ii<count; ii+=4)
+		{
+			peak = VMax(peak, VAbs(VLoad(pA + ii)));
+		}
+
+		GetX(pOut, HMax(peak));
+	}
+
+	void PeakStream(float *pA, float * /*pB*/, float * /*pC*/, float *pOut, int count)
+	{
+		pOut[0] = Stream::Peak(pA, count);
+	}
+
+	void EnergyLoop(float *pA, float * /*pB*/, float * /*pC*/, float *pOut, int count)
+	{
+		Vec4 sum = _mm_setzero_ps();
+
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4 a = VLoad(pA + ii);
+
+			sum = VMAdd(a, a, sum);
+		}
+
+		GetX(pOut, HSum(sum));
+	}
+
+	void EnergyStream(float *pA, float * /*pB*/, float * /*pC*/, float *pOut, int count)
+	{
+		pOut[0] = Stream::SumSquares(pA, count);
+	}
+}
@@ -0,0 +1,35 @@
+//--------------------------------------------------------------------------------------
+// File: stream.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __STREAM__
+#define __STREAM__
+
+///////////////////////////////////////////////////////////////////////////////
+//	Hand written __m128 loops against VMATH::Stream over count floats, for
+//	simd_bench -demo stream. The *Loop versions need 16 byte aligned arrays
+//	and count a multiple of 4, the Stream versions take any. MulAdd writes
+//	pOut = pA*pB + pC, Dot writes its sum to pOut[0]. The *NT versions write
+//	pOut with non-temporal stores (simd_bench -demo nt). Peak and Energy
+//	write max |pA| and the sum of pA squared to pOut[0].
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace STREAM_VMATH
+{
+	extern void MulAddLoop(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void MulAddLoopNT(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void MulAddStream(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void MulAddStreamNT(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void DotLoop(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void DotStream(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void PeakLoop(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void PeakStream(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void EnergyLoop(float *pA, float *pB, float *pC, float *pOut, int count);
+	extern void EnergyStream(float *pA, float *pB, float *pC, float *pOut, int count);
+}
+
+#endif // #ifndef __STREAM__
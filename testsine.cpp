@@ -25,13 +25,13 @@ namespace VMATH
 {
 	Vec4 VSin(const Vec4& x)
 	{
-		Vec4 c1 = VReplicate(-1.f/6.f);
-		Vec4 c2 = VReplicate(1.f/120.f);
-		Vec4 c3 = VReplicate(-1.f/5040.f);
-		Vec4 c4 = VReplicate(1.f/362880);
-		Vec4 c5 = VReplicate(-1.f/39916800);
-		Vec4 c6 = VReplicate(1.f/6227020800);
-		Vec4 c7 = VReplicate(-1.f/1307674368000);
+		Vec4 c1 = VConst<0xbe2aaaab>();		// -1/3!
+		Vec4 c2 = VConst<0x3c088889>();		// 1/5!
+		Vec4 c3 = VConst<0xb9500d01>();		// -1/7!
+		Vec4 c4 = VConst<0x3638ef1d>();		// 1/9!
+		Vec4 c5 = VConst<0xb2d7322b>();		// -1/11!
+		Vec4 c6 = VConst<0x2f309231>();		// 1/13!
+		Vec4 c7 = VConst<0xab573f9f>();		// -1/15!
 
 		Vec4 res =	x + 
 					c1*x*x*x + 
@@ -47,13 +47,13 @@ namespace VMATH
 
 Vec4 VSin2(const Vec4& x)
 {
-	Vec4 c1 = VReplicate(-1.f/6.f);
-	Vec4 c2 = VReplicate(1.f/120.f);
-	Vec4 c3 = VReplicate(-1.f/5040.f);
-	Vec4 c4 = VReplicate(1.f/362880);
-	Vec4 c5 = VReplicate(-1.f/39916800);
-	Vec4 c6 = VReplicate(1.f/6227020800);
-	Vec4 c7 = VReplicate(-1.f/1307674368000);
+	Vec4 c1 = VConst<0xbe2aaaab>();		// -1/3!
+	Vec4 c2 = VConst<0x3c088889>();		// 1/5!
+	Vec4 c3 = VConst<0xb9500d01>();		// -1/7!
+	Vec4 c4 = VConst<0x3638ef1d>();		// 1/9!
+	Vec4 c5 = VConst<0xb2d7322b>();		// -1/11!
+	Vec4 c6 = VConst<0x2f309231>();		// 1/13!
+	Vec4 c7 = VConst<0xab573f9f>();		// -1/15!
 
 	Vec4 tmp0 = x;
 	Vec4 x3 = x*x*x;
@@ -91,13 +91,13 @@ Vec4 VSin2(const Vec4& x)
 #if 0
 	Vec4 VSinProcedural(const Vec4& x)
 	{
-		Vec4 c1 = VReplicate(-1.f/6.f);
-		Vec4 c2 = VReplicate(1.f/120.f);
-		Vec4 c3 = VReplicate(-1.f/5040.f);
-		Vec4 c4 = VReplicate(1.f/362880);
-		Vec4 c5 = VReplicate(-1.f/39916800);
-		Vec4 c6 = VReplicate(1.f/6227020800);
-		Vec4 c7 = VReplicate(-1.f/1307674368000);
+		Vec4 c1 = VConst<0xbe2aaaab>();		// -1/3!
+		Vec4 c2 = VConst<0x3c088889>();		// 1/5!
+		Vec4 c3 = VConst<0xb9500d01>();		// -1/7!
+		Vec4 c4 = VConst<0x3638ef1d>();		// 1/9!
+		Vec4 c5 = VConst<0xb2d7322b>();		// -1/11!
+		Vec4 c6 = VConst<0x2f309231>();		// 1/13!
+		Vec4 c7 = VConst<0xab573f9f>();		// -1/15!
 
 		Vec4 tmp0 = x;
 		Vec4 x3 = VMul(VMul(x, x), x);
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------------------
+// File: trans.cpp
+//
+// Transcendental array kernels for the headless bench (simd_bench -demo trans): libm
+// one float at a time, VMATH and VCLASS_SIMDTYPE on vtranscendental.inl. See trans.h.
+//--------------------------------------------------------------------------------------
+
+#ifdef SIMD_HEADLESS
+#include "platform.h"
+#else
+#include "DXUT.h"
+#endif
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <math.h>
+#include "vmath.h"
+#include "vclass_simdtype.h"
+#include "trans.h"
+
+namespace TRANS_LIBM
+{
+	void SinArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = sinf(pA[ii]);
+		}
+	}
+
+	void CosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = cosf(pA[ii]);
+		}
+	}
+
+	void SinCosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = sinf(pA[ii]);
+			pOut[count + ii] = cosf(pA[ii]);
+		}
+	}
+
+	void ExpArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = expf(pA[ii]);
+		}
+	}
+
+	void LogArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = logf(pA[ii]);
+		}
+	}
+
+	void PowArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = powf(pA[ii], pB[ii]);
+		}
+	}
+
+	void Atan2Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = atan2f(pA[ii], pB[ii]);
+		}
+	}
+}
+
+namespace TRANS_VMATH
+{
+	using namespace VMATH;
+
+	void SinArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Sin(VLoad(pA + ii)));
+		}
+	}
+
+	void CosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Cos(VLoad(pA + ii)));
+		}
+	}
+
+	void SinCosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			Vec4 s, c;
+
+			SinCos(VLoad(pA + ii), &s, &c);
+
+			VStore(pOut + ii, s);
+			VStore(pOut + count + ii, c);
+		}
+	}
+
+	void ExpArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Exp(VLoad(pA + ii)));
+		}
+	}
+
+	void LogArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Log(VLoad(pA + ii)));
+		}
+	}
+
+	void PowArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Pow(VLoad(pA + ii), VLoad(pB + ii)));
+		}
+	}
+
+	void Atan2Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=4)
+		{
+			VStore(pOut + ii, Atan2(VLoad(pA + ii), VLoad(pB + ii)));
+		}
+	}
+}
+
+namespace TRANS_VCLASS_SIMDTYPE
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	typedef Vec4	VecT;
+
+	#include "trans_vclass.inl"
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace TRANS_VCLASS_SIMDTYPE8
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	typedef Vec8	VecT;
+
+	#include "trans_vclass.inl"
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace TRANS_VCLASS_SIMDTYPE16
+{
+	using namespace VCLASS_SIMDTYPE;
+
+	typedef Vec16	VecT;
+
+	#include "trans_vclass.inl"
+}
+#endif
@@ -0,0 +1,79 @@
+//--------------------------------------------------------------------------------------
+// File: trans.h
+//--------------------------------------------------------------------------------------
+
+#ifndef __TRANS__
+#define __TRANS__
+
+///////////////////////////////////////////////////////////////////////////////
+//	The vtranscendental.inl functions and libm over arrays for simd_bench
+//	-demo trans. count is a multiple of 16 and the arrays are 64 byte aligned
+//	(the width of Vec16). Unary functions read pA, Pow and Atan2 take
+//	(pA, pB) as (x, y) and (y, x) like their scalar versions, SinCos writes sin
+//	to pOut[0, count) and cos to pOut[count, 2*count).
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//								Externs
+///////////////////////////////////////////////////////////////////////////////
+
+namespace TRANS_LIBM
+{
+	extern void SinArray(float *pA, float *pB, float *pOut, int count);
+	extern void CosArray(float *pA, float *pB, float *pOut, int count);
+	extern void SinCosArray(float *pA, float *pB, float *pOut, int count);
+	extern void ExpArray(float *pA, float *pB, float *pOut, int count);
+	extern void LogArray(float *pA, float *pB, float *pOut, int count);
+	extern void PowArray(float *pA, float *pB, float *pOut, int count);
+	extern void Atan2Array(float *pA, float *pB, float *pOut, int count);
+}
+
+namespace TRANS_VMATH
+{
+	extern void SinArray(float *pA, float *pB, float *pOut, int count);
+	extern void CosArray(float *pA, float *pB, float *pOut, int count);
+	extern void SinCosArray(float *pA, float *pB, float *pOut, int count);
+	extern void ExpArray(float *pA, float *pB, float *pOut, int count);
+	extern void LogArray(float *pA, float *pB, float *pOut, int count);
+	extern void PowArray(float *pA, float *pB, float *pOut, int count);
+	extern void Atan2Array(float *pA, float *pB, float *pOut, int count);
+}
+
+namespace TRANS_VCLASS_SIMDTYPE
+{
+	extern void SinArray(float *pA, float *pB, float *pOut, int count);
+	extern void CosArray(float *pA, float *pB, float *pOut, int count);
+	extern void SinCosArray(float *pA, float *pB, float *pOut, int count);
+	extern void ExpArray(float *pA, float *pB, float *pOut, int count);
+	extern void LogArray(float *pA, float *pB, float *pOut, int count);
+	extern void PowArray(float *pA, float *pB, float *pOut, int count);
+	extern void Atan2Array(float *pA, float *pB, float *pOut, int count);
+}
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+namespace TRANS_VCLASS_SIMDTYPE8
+{
+	extern void SinArray(float *pA, float *pB, float *pOut, int count);
+	extern void CosArray(float *pA, float *pB, float *pOut, int count);
+	extern void SinCosArray(float *pA, float *pB, float *pOut, int count);
+	extern void ExpArray(float *pA, float *pB, float *pOut, int count);
+	extern void LogArray(float *pA, float *pB, float *pOut, int count);
+	extern void PowArray(float *pA, float *pB, float *pOut, int count);
+	extern void Atan2Array(float *pA, float *pB, float *pOut, int count);
+}
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+namespace TRANS_VCLASS_SIMDTYPE16
+{
+	extern void SinArray(float *pA, float *pB, float *pOut, int count);
+	extern void CosArray(float *pA, float *pB, float *pOut, int count);
+	extern void SinCosArray(float *pA, float *pB, float *pOut, int count);
+	extern void ExpArray(float *pA, float *pB, float *pOut, int count);
+	extern void LogArray(float *pA, float *pB, float *pOut, int count);
+	extern void PowArray(float *pA, float *pB, float *pOut, int count);
+	extern void Atan2Array(float *pA, float *pB, float *pOut, int count);
+}
+#endif
+
+#endif // #ifndef __TRANS__
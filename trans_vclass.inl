@@ -0,0 +1,67 @@
+	//--------------------------------------------------------------------------------------
+	// File: trans_vclass.inl
+	//
+	// The trans.h array kernels for VCLASS_SIMDTYPE, included by trans.cpp inside a
+	// namespace using VCLASS_SIMDTYPE that defines VecT (Vec4, Vec8 or Vec16).
+	//--------------------------------------------------------------------------------------
+
+	void SinArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Sin(VecT(pA + ii)).Store(pOut + ii);
+		}
+	}
+
+	void CosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Cos(VecT(pA + ii)).Store(pOut + ii);
+		}
+	}
+
+	void SinCosArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT s, c;
+
+			VecT::SinCos(VecT(pA + ii), s, c);
+
+			s.Store(pOut + ii);
+			c.Store(pOut + count + ii);
+		}
+	}
+
+	void ExpArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Exp(VecT(pA + ii)).Store(pOut + ii);
+		}
+	}
+
+	void LogArray(float *pA, float * /*pB*/, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Log(VecT(pA + ii)).Store(pOut + ii);
+		}
+	}
+
+	void PowArray(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Pow(VecT(pA + ii), VecT(pB + ii)).Store(pOut + ii);
+		}
+	}
+
+	void Atan2Array(float *pA, float *pB, float *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii+=VecT::cWidth)
+		{
+			VecT::Atan2(VecT(pA + ii), VecT(pB + ii)).Store(pOut + ii);
+		}
+	}
@@ -5,6 +5,23 @@
 #ifndef __VCLASS__
 #define __VCLASS__
 
+///////////////////////////////////////////////////////////////////////////////
+//	SIMD_FMA - VMAdd/VNMSub compile to a single fused multiply-add when the
+//	compiler targets FMA (-mfma, /arch:AVX2), to mul + add/sub otherwise.
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(SIMD_FMA) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SIMD_FMA
+#endif
+
+#if defined(SIMD_FMA) || defined(__SSE3__) || defined(__AVX__)
+	#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//	VCLASS_EXPRESSION_TEMPLATES - the operators build an expression tree that
+//	is evaluated in one pass on __m128 when assigned (see vclass_expr.inl).
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 //	This example class shows a sketch of how many SIMD game math libraries are
 //	commonly designed, i.e., encapsulating data and functions inside a class.
@@ -17,7 +34,28 @@
 
 namespace VCLASS
 {
+	// Vec4::Swizzle/Permute, see vswizzle.inl
+	#include "vswizzle.inl"
+
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+	#include "vclass_expr.inl"
+
+	template <>
+	struct VExprOps<__m128>
+	{
+		static inline __m128 Add(const __m128& a, const __m128& b) { return _mm_add_ps(a, b); }
+		static inline __m128 Sub(const __m128& a, const __m128& b) { return _mm_sub_ps(a, b); }
+		static inline __m128 Mul(const __m128& a, const __m128& b) { return _mm_mul_ps(a, b); }
+		static inline __m128 Div(const __m128& a, const __m128& b) { return _mm_div_ps(a, b); }
+
+		static inline __m128 Splat(float s) { return _mm_set_ps1(s); }
+	};
+#endif
+
 	class Vec4
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+		: public VExpr<Vec4>
+#endif
 	{
 		public:
 			inline Vec4() {}
@@ -49,6 +87,50 @@ namespace VCLASS
 				return *this;
 			}
 
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+			typedef __m128		value_type;
+			typedef float		scalar_type;
+			typedef const Vec4&	operand_type;
+
+			template <typename E>
+			inline Vec4(const VExpr<E>& e)
+				: xyzw(e.Self().Eval())
+			{ }
+
+			template <typename E>
+			inline Vec4& operator= (const VExpr<E>& e)
+			{
+				xyzw = e.Self().Eval();
+
+				return *this;
+			}
+
+			template <typename E>
+			inline Vec4& operator+=(const VExpr<E>& e)
+			{
+				xyzw = _mm_add_ps(xyzw, e.Self().Eval());
+				return *this;
+			}
+
+			template <typename E>
+			inline Vec4& operator-=(const VExpr<E>& e)
+			{
+				xyzw = _mm_sub_ps(xyzw, e.Self().Eval());
+				return *this;
+			}
+
+			template <typename E>
+			inline Vec4& operator*=(const VExpr<E>& e)
+			{
+				xyzw = _mm_mul_ps(xyzw, e.Self().Eval());
+				return *this;
+			}
+
+			inline const __m128& Eval() const
+			{
+				return xyzw;
+			}
+#else
 			inline Vec4& operator+=(const Vec4 &rhs)
 			{
 				xyzw = _mm_add_ps(xyzw, rhs.xyzw);
@@ -86,27 +168,71 @@ namespace VCLASS
 			{
 				return Vec4(_mm_div_ps(xyzw, rhs.xyzw));
 			}
+#endif
 
 			inline void Store(float *pVec) const
 			{
 				_mm_store_ps(pVec, xyzw);
 			}
 
+			// non-temporal, 16 byte aligned
+			inline void StoreStream(float *pVec) const
+			{
+				_mm_stream_ps(pVec, xyzw);
+			}
+
 			inline void Bc()
 			{
-				xyzw = _mm_shuffle_ps(xyzw, xyzw, _MM_SHUFFLE(3,3,3,3));
+				xyzw = VSwizzle<3,3,3,3>(xyzw);
+			}
+
+			// the float with bit pattern Bits in every lane, Const<0x3f800000>() is 1.
+			// A compile time constant, no static to initialize
+			template <unsigned int Bits>
+			static inline Vec4 Const()
+			{
+				return Vec4(_mm_castsi128_ps(_mm_set1_epi32((int)Bits)));
 			}
 
 			static inline Vec4 Dot(const Vec4& va, const Vec4& vb)
 			{
 				const __m128 t0 = _mm_mul_ps(va.xyzw, vb.xyzw);
-				const __m128 t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1,0,3,2));
+				const __m128 t1 = VSwizzle<2,3,0,1>(t0);
 				const __m128 t2 = _mm_add_ps(t0, t1);
-				const __m128 t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2,3,0,1));
+				const __m128 t3 = VSwizzle<1,0,3,2>(t2);
 
 				return Vec4(_mm_add_ps(t3, t2));
 			}
 
+			// horizontal add/mul/min/max of the 4 lanes, replicated in all 4
+			static inline Vec4 HSum(const Vec4& va)
+			{
+				const __m128 t0 = _mm_add_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return Vec4(_mm_add_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline Vec4 HProduct(const Vec4& va)
+			{
+				const __m128 t0 = _mm_mul_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return Vec4(_mm_mul_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline Vec4 HMin(const Vec4& va)
+			{
+				const __m128 t0 = _mm_min_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return Vec4(_mm_min_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline Vec4 HMax(const Vec4& va)
+			{
+				const __m128 t0 = _mm_max_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return Vec4(_mm_max_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
 			static inline Vec4 Sqrt(const Vec4& va)
 			{
 				return Vec4(_mm_sqrt_ps(va.xyzw));
@@ -127,6 +253,132 @@ namespace VCLASS
 				return Vec4(_mm_mul_ps(va.xyzw, vb.xyzw));
 			}
 
+			// va*vb + vc
+			static inline Vec4 VMAdd(const Vec4& va, const Vec4& vb, const Vec4& vc)
+			{
+			#if defined(SIMD_FMA)
+				return Vec4(_mm_fmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return Vec4(_mm_add_ps(_mm_mul_ps(va.xyzw, vb.xyzw), vc.xyzw));
+			#endif
+			}
+
+			// vc - va*vb
+			static inline Vec4 VNMSub(const Vec4& va, const Vec4& vb, const Vec4& vc)
+			{
+			#if defined(SIMD_FMA)
+				return Vec4(_mm_fnmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return Vec4(_mm_sub_ps(vc.xyzw, _mm_mul_ps(va.xyzw, vb.xyzw)));
+			#endif
+			}
+
+			// 1/va: _mm_rcp_ps (12 bits) refined by Steps (0-2) Newton-Raphson steps
+			template <int Steps>
+			static inline Vec4 VReciprocalEst(const Vec4& va)
+			{
+				const Vec4 one(1.f);
+				Vec4 r(_mm_rcp_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r*(1 - va*r)
+					r = VMAdd(r, VNMSub(va, r, one), r);
+				}
+
+				return r;
+			}
+
+			// 1/sqrt(va): _mm_rsqrt_ps (12 bits) refined by Steps Newton-Raphson steps,
+			// a refined 1/sqrt(0) is NaN
+			template <int Steps>
+			static inline Vec4 VRsqrtEst(const Vec4& va)
+			{
+				const Vec4 one(1.f);
+				const Vec4 half(0.5f);
+				Vec4 r(_mm_rsqrt_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r/2*(1 - va*r*r)
+					r = VMAdd(VMul(half, r), VNMSub(VMul(va, r), r, one), r);
+				}
+
+				return r;
+			}
+
+			// masks: every bit of a lane set (true) or clear (false)
+			static inline Vec4 VCmpLt(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(_mm_cmplt_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline Vec4 VCmpGt(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(_mm_cmpgt_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline Vec4 VCmpEq(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(_mm_cmpeq_ps(va.xyzw, vb.xyzw));
+			}
+
+			// vb where either is NaN
+			static inline Vec4 VMin(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(_mm_min_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline Vec4 VMax(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(_mm_max_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline Vec4 VAbs(const Vec4& va)
+			{
+				return Vec4(_mm_andnot_ps(_mm_set1_ps(-0.f), va.xyzw));
+			}
+
+			// mask ? va : vb
+			static inline Vec4 VSelect(const Vec4& mask, const Vec4& va, const Vec4& vb)
+			{
+			#if defined(__SSE4_1__) || defined(__AVX__)
+				return Vec4(_mm_blendv_ps(vb.xyzw, va.xyzw, mask.xyzw));
+			#else
+				return Vec4(_mm_or_ps(_mm_and_ps(mask.xyzw, va.xyzw), _mm_andnot_ps(mask.xyzw, vb.xyzw)));
+			#endif
+			}
+
+			static inline bool VAny(const Vec4& mask)
+			{
+				return _mm_movemask_ps(mask.xyzw) != 0;
+			}
+
+			static inline bool VAll(const Vec4& mask)
+			{
+				return _mm_movemask_ps(mask.xyzw) == 0xf;
+			}
+
+			// NaN gives lo
+			static inline Vec4 VClamp(const Vec4& va, const Vec4& lo, const Vec4& hi)
+			{
+				return Vec4(_mm_min_ps(_mm_max_ps(va.xyzw, lo.xyzw), hi.xyzw));
+			}
+
+			// (v[X], v[Y], v[Z], v[W])
+			template <int X, int Y, int Z, int W>
+			static inline Vec4 Swizzle(const Vec4& v)
+			{
+				return Vec4(VSwizzle<X,Y,Z,W>(v.xyzw));
+			}
+
+			// lanes 0-3 of va, 4-7 of vb
+			template <int X, int Y, int Z, int W>
+			static inline Vec4 Permute(const Vec4& va, const Vec4& vb)
+			{
+				return Vec4(VPermute<X,Y,Z,W>(va.xyzw, vb.xyzw));
+			}
+
 			static inline void GetX(float *p, const Vec4& v)
 			{
 				_mm_store_ss(p, v.xyzw);
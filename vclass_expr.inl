@@ -0,0 +1,140 @@
+//--------------------------------------------------------------------------------------
+// File: vclass_expr.inl
+//
+// Expression templates for the operators of VCLASS::Vec4 and VCLASS_SIMDTYPE::vector4
+// (VCLASS_EXPRESSION_TEMPLATES), included inside both namespaces.
+//
+// An operator on vectors returns a node that only holds its operands. Assigning the
+// tree to a vector evaluates it in one pass on the register type (value_type), so
+//
+//	res = x + c1*x*x*x;
+//
+// compiles like VMATH's procedural VAdd(x, VMul(VMul(VMul(c1, x), x), x)) with no
+// vector object per operator. The rounding is the same as in the operator mode, an
+// a*b + c tree is not fused (use VMAdd for that).
+//
+// Nodes keep references to the vectors of the expression and die at the end of the
+// full expression: assign them to a vector, never keep one around.
+//
+// A vector or node class E provides
+//	value_type		register type the tree is evaluated on
+//	scalar_type		float operand type (splat)
+//	operand_type	how a node stores E: const E& for vectors, const E for nodes
+//	Eval()			value_type of the expression
+//--------------------------------------------------------------------------------------
+
+	///////////////////////////////////////////
+	// Register ops (value_type), a + b ... by default
+	///////////////////////////////////////////
+
+	template <typename V>
+	struct VExprOps
+	{
+		static inline V Add(const V& a, const V& b) { return a + b; }
+		static inline V Sub(const V& a, const V& b) { return a - b; }
+		static inline V Mul(const V& a, const V& b) { return a * b; }
+		static inline V Div(const V& a, const V& b) { return a / b; }
+
+		template <typename S>
+		static inline V Splat(S s) { return V(s); }
+	};
+
+	///////////////////////////////////////////
+	// Expression base
+	///////////////////////////////////////////
+
+	template <typename E>
+	struct VExpr
+	{
+		inline const E& Self() const
+		{
+			return static_cast<const E&>(*this);
+		}
+	};
+
+	///////////////////////////////////////////
+	// Nodes
+	///////////////////////////////////////////
+
+	struct VExprAdd { template <typename V> static inline V Apply(const V& a, const V& b) { return VExprOps<V>::Add(a, b); } };
+	struct VExprSub { template <typename V> static inline V Apply(const V& a, const V& b) { return VExprOps<V>::Sub(a, b); } };
+	struct VExprMul { template <typename V> static inline V Apply(const V& a, const V& b) { return VExprOps<V>::Mul(a, b); } };
+	struct VExprDiv { template <typename V> static inline V Apply(const V& a, const V& b) { return VExprOps<V>::Div(a, b); } };
+
+	template <typename Op, typename L, typename R>
+	class VExprBinary : public VExpr< VExprBinary<Op, L, R> >
+	{
+		public:
+			typedef typename L::value_type		value_type;
+			typedef typename L::scalar_type		scalar_type;
+			typedef const VExprBinary			operand_type;
+
+			inline VExprBinary(const L& l, const R& r)
+				: _l(l), _r(r)
+			{ }
+
+			inline value_type Eval() const
+			{
+				return Op::Apply(_l.Eval(), _r.Eval());
+			}
+
+		private:
+			typename L::operand_type	_l;
+			typename R::operand_type	_r;
+	};
+
+	// float operand, splatted once when the node is built
+	template <typename V, typename S>
+	class VExprScalar : public VExpr< VExprScalar<V, S> >
+	{
+		public:
+			typedef V							value_type;
+			typedef S							scalar_type;
+			typedef const VExprScalar			operand_type;
+
+			inline explicit VExprScalar(S s)
+				: _v(VExprOps<V>::Splat(s))
+			{ }
+
+			inline const V& Eval() const
+			{
+				return _v;
+			}
+
+		private:
+			V	_v;
+	};
+
+	///////////////////////////////////////////
+	// Operators
+	///////////////////////////////////////////
+
+#define VCLASS_EXPR_OPERATOR(op, Op)																				\
+	template <typename L, typename R>																				\
+	inline VExprBinary<Op, L, R> operator op (const VExpr<L>& l, const VExpr<R>& r)									\
+	{																												\
+		return VExprBinary<Op, L, R>(l.Self(), r.Self());															\
+	}																												\
+																													\
+	template <typename L>																							\
+	inline VExprBinary<Op, L, VExprScalar<typename L::value_type, typename L::scalar_type> >						\
+		operator op (const VExpr<L>& l, typename L::scalar_type s)													\
+	{																												\
+		typedef VExprScalar<typename L::value_type, typename L::scalar_type> S;										\
+		return VExprBinary<Op, L, S>(l.Self(), S(s));																\
+	}																												\
+																													\
+	template <typename R>																							\
+	inline VExprBinary<Op, VExprScalar<typename R::value_type, typename R::scalar_type>, R>							\
+		operator op (typename R::scalar_type s, const VExpr<R>& r)													\
+	{																												\
+		typedef VExprScalar<typename R::value_type, typename R::scalar_type> S;										\
+		return VExprBinary<Op, S, R>(S(s), r.Self());																\
+	}
+
+	VCLASS_EXPR_OPERATOR(+, VExprAdd)
+	VCLASS_EXPR_OPERATOR(-, VExprSub)
+	VCLASS_EXPR_OPERATOR(*, VExprMul)
+	VCLASS_EXPR_OPERATOR(/, VExprDiv)
+
+#undef VCLASS_EXPR_OPERATOR
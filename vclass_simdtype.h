@@ -1,15 +1,230 @@
 #ifndef __CLASS_SIMDTYPE__
 #define __CLASS_SIMDTYPE__
 
+///////////////////////////////////////////////////////////////////////////////
+//	SIMD_FMA - VMAdd/VNMSub compile to a single fused multiply-add when the
+//	compiler targets FMA (-mfma, /arch:AVX2), to mul + add/sub otherwise.
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(SIMD_FMA) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SIMD_FMA
+#endif
+
+#if defined(SIMD_FMA) || defined(__SSE3__) || defined(__AVX__)
+	#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//	Build switches
+//	VCLASS_SIMDTYPE_AVX - adds the 8-wide simd_type8 (__m256), simd_itype8
+//	(__m256i), Vec8 and IVec8.
+//	The translation unit must be compiled for AVX2 (-mavx2, /arch:AVX2).
+//	VCLASS_SIMDTYPE_AVX512 - adds the 16-wide simd_type16 (__m512), simd_itype16
+//	(__m512i), Vec16 and IVec16, implies VCLASS_SIMDTYPE_AVX (-mavx512f, /arch:AVX512).
+//	VCLASS_EXPRESSION_TEMPLATES - the vector4 operators build an expression
+//	tree that is evaluated in one pass on the Rep when assigned
+//	(see vclass_expr.inl).
+///////////////////////////////////////////////////////////////////////////////
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	#if !defined(__AVX512F__)
+		#error VCLASS_SIMDTYPE_AVX512 requires a compiler targeting AVX-512F
+	#endif
+	#if !defined(VCLASS_SIMDTYPE_AVX)
+		#define VCLASS_SIMDTYPE_AVX
+	#endif
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+	#if !defined(__AVX2__)
+		#error VCLASS_SIMDTYPE_AVX requires a compiler targeting AVX2
+	#endif
+	#include <immintrin.h>
+#endif
+
 namespace VCLASS_SIMDTYPE
 {
+	// Sin/Cos/.../Atan2 of every rep, see vtranscendental.inl
+	#include "vtranscendental.inl"
+
+	// Swizzle/Permute of every rep, see vswizzle.inl
+	#include "vswizzle.inl"
+
+	///////////////////////////////////////////
+	// INTEGER SIMD CLASS
+	//	4 int32 lanes on a __m128i, for PCM
+	//	conversion and bit manipulation.
+	//	Loads/stores are unaligned. The *S16
+	//	ops read and write the lanes as
+	//	saturated shorts, in lane order.
+	///////////////////////////////////////////
+
+	class simd_itype
+	{
+		friend class simd_type;
+		friend class simd_dtype;
+
+		public:
+			enum { cWidth = 4 };
+
+			inline simd_itype() {}
+
+			inline simd_itype(const int *pVec)
+				: xyzw(_mm_loadu_si128((const __m128i*)pVec))
+			{ }
+
+			inline simd_itype(int i)
+				: xyzw(_mm_set1_epi32(i))
+			{ }
+
+			inline simd_itype(const __m128i& qword)
+				: xyzw(qword)
+			{ }
+
+			inline simd_itype(int x, int y, int z, int w)
+				: xyzw(_mm_set_epi32(x, y, z, w))
+			{ }
+
+			inline simd_itype operator+(const simd_itype &rhs) const
+			{
+				return simd_itype(_mm_add_epi32(xyzw, rhs.xyzw));
+			}
+
+			inline simd_itype operator-(const simd_itype &rhs) const
+			{
+				return simd_itype(_mm_sub_epi32(xyzw, rhs.xyzw));
+			}
+
+			// low 32 bits of the product
+			inline simd_itype operator*(const simd_itype &rhs) const
+			{
+			#if defined(__SSE4_1__) || defined(__AVX__)
+				return simd_itype(_mm_mullo_epi32(xyzw, rhs.xyzw));
+			#else
+				const __m128i p02 = _mm_mul_epu32(xyzw, rhs.xyzw);
+				const __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(xyzw, 32), _mm_srli_epi64(rhs.xyzw, 32));
+
+				return simd_itype(_mm_unpacklo_epi32(_mm_shuffle_epi32(p02, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(p13, _MM_SHUFFLE(0,0,2,0))));
+			#endif
+			}
+
+			inline simd_itype& operator+=(const simd_itype &rhs)
+			{
+				xyzw = _mm_add_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_itype& operator-=(const simd_itype &rhs)
+			{
+				xyzw = _mm_sub_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline void Store(int *pVec) const
+			{
+				_mm_storeu_si128((__m128i*)pVec, xyzw);
+			}
+
+			// non-temporal, 16 byte aligned
+			inline void StoreStream(int *pVec) const
+			{
+				_mm_stream_si128((__m128i*)pVec, xyzw);
+			}
+
+			static inline simd_itype VAnd(const simd_itype& va, const simd_itype& vb)
+			{
+				return simd_itype(_mm_and_si128(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype VOr(const simd_itype& va, const simd_itype& vb)
+			{
+				return simd_itype(_mm_or_si128(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype VXor(const simd_itype& va, const simd_itype& vb)
+			{
+				return simd_itype(_mm_xor_si128(va.xyzw, vb.xyzw));
+			}
+
+			// ~va & vb
+			static inline simd_itype VAndNot(const simd_itype& va, const simd_itype& vb)
+			{
+				return simd_itype(_mm_andnot_si128(va.xyzw, vb.xyzw));
+			}
+
+			template <int Count>
+			static inline simd_itype ShiftLeft(const simd_itype& va)
+			{
+				return simd_itype(_mm_slli_epi32(va.xyzw, Count));
+			}
+
+			// arithmetic, keeps the sign
+			template <int Count>
+			static inline simd_itype ShiftRight(const simd_itype& va)
+			{
+				return simd_itype(_mm_srai_epi32(va.xyzw, Count));
+			}
+
+			template <int Count>
+			static inline simd_itype ShiftRightLogical(const simd_itype& va)
+			{
+				return simd_itype(_mm_srli_epi32(va.xyzw, Count));
+			}
+
+			// the 8 shorts va[0..3], vb[0..3], saturated
+			static inline simd_itype PackS16(const simd_itype& va, const simd_itype& vb)
+			{
+				return simd_itype(_mm_packs_epi32(va.xyzw, vb.xyzw));
+			}
+
+			// shorts 0-3 / 4-7 of a PackS16 result, sign extended
+			static inline simd_itype UnpackLoS16(const simd_itype& va)
+			{
+			#if defined(__SSE4_1__) || defined(__AVX__)
+				return simd_itype(_mm_cvtepi16_epi32(va.xyzw));
+			#else
+				return simd_itype(_mm_srai_epi32(_mm_unpacklo_epi16(va.xyzw, va.xyzw), 16));
+			#endif
+			}
+
+			static inline simd_itype UnpackHiS16(const simd_itype& va)
+			{
+				return simd_itype(_mm_srai_epi32(_mm_unpackhi_epi16(va.xyzw, va.xyzw), 16));
+			}
+
+			// 4 shorts, sign extended
+			static inline simd_itype LoadS16(const short *p)
+			{
+				return UnpackLoS16(simd_itype(_mm_loadl_epi64((const __m128i*)p)));
+			}
+
+			// 4 shorts, saturated
+			inline void StoreS16(short *p) const
+			{
+				_mm_storel_epi64((__m128i*)p, _mm_packs_epi32(xyzw, xyzw));
+			}
+
+		private:
+			__m128i	xyzw;
+	};
+
 	///////////////////////////////////////////
 	// SIMD CLASS (Same as VCLASS)
 	///////////////////////////////////////////
 
+	class simd_dtype;
+
 	class simd_type
 	{
+		friend class simd_dtype;
+
 		public:
+			enum { cWidth = 4 };
+
+			// comparison result, every bit of a lane set or clear
+			typedef __m128i	mask_type;
+
+			// the integer rep of the same width
+			typedef simd_itype	int_type;
+
 			inline simd_type() {}
 
 			inline simd_type(float *pVec)
@@ -28,6 +243,9 @@ namespace VCLASS_SIMDTYPE
 				: xyzw(_mm_set_ps(x, y, z, w))
 			{ }
 
+			// the double lanes, rounded to nearest
+			inline explicit simd_type(const simd_dtype& d);
+
 			inline simd_type(const simd_type& copy)
 				: xyzw(copy.xyzw)
 			{ }
@@ -82,21 +300,56 @@ namespace VCLASS_SIMDTYPE
 				_mm_store_ps(pVec, xyzw);
 			}
 
+			// non-temporal, 16 byte aligned
+			inline void StoreStream(float *pVec) const
+			{
+				_mm_stream_ps(pVec, xyzw);
+			}
+
 			inline void Bc()
 			{
-				xyzw = _mm_shuffle_ps(xyzw, xyzw, _MM_SHUFFLE(3,3,3,3));
+				xyzw = VSwizzle<3,3,3,3>(xyzw);
 			}
 
 			static inline simd_type Dot(const simd_type& va, const simd_type& vb)
 			{
 				const __m128 t0 = _mm_mul_ps(va.xyzw, vb.xyzw);
-				const __m128 t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1,0,3,2));
+				const __m128 t1 = VSwizzle<2,3,0,1>(t0);
 				const __m128 t2 = _mm_add_ps(t0, t1);
-				const __m128 t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2,3,0,1));
+				const __m128 t3 = VSwizzle<1,0,3,2>(t2);
 				
 				return simd_type(_mm_add_ps(t3, t2));
 			}
 
+			// horizontal add/mul/min/max of the 4 lanes, replicated in all 4
+			static inline simd_type HSum(const simd_type& va)
+			{
+				const __m128 t0 = _mm_add_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type(_mm_add_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type HProduct(const simd_type& va)
+			{
+				const __m128 t0 = _mm_mul_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type(_mm_mul_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type HMin(const simd_type& va)
+			{
+				const __m128 t0 = _mm_min_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type(_mm_min_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type HMax(const simd_type& va)
+			{
+				const __m128 t0 = _mm_max_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type(_mm_max_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
 			static inline simd_type Sqrt(const simd_type& va)
 			{
 				return simd_type(_mm_sqrt_ps(va.xyzw));
@@ -117,138 +370,2571 @@ namespace VCLASS_SIMDTYPE
 				return simd_type(_mm_mul_ps(va.xyzw, vb.xyzw));
 			}
 
-			static inline void GetX(float *p, const simd_type& v)
+			// va*vb + vc
+			static inline simd_type VMAdd(const simd_type& va, const simd_type& vb, const simd_type& vc)
 			{
-				_mm_store_ss(p, v.xyzw);
+			#if defined(SIMD_FMA)
+				return simd_type(_mm_fmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return simd_type(_mm_add_ps(_mm_mul_ps(va.xyzw, vb.xyzw), vc.xyzw));
+			#endif
 			}
 
-		private:
-			__m128	xyzw;
-	};
+			// vc - va*vb
+			static inline simd_type VNMSub(const simd_type& va, const simd_type& vb, const simd_type& vc)
+			{
+			#if defined(SIMD_FMA)
+				return simd_type(_mm_fnmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return simd_type(_mm_sub_ps(vc.xyzw, _mm_mul_ps(va.xyzw, vb.xyzw)));
+			#endif
+			}
 
-	///////////////////////////////////////////
-	// Vec4
-	///////////////////////////////////////////
+			// 1/va: _mm_rcp_ps (12 bits) refined by Steps (0-2) Newton-Raphson steps
+			template <int Steps>
+			static inline simd_type VReciprocalEst(const simd_type& va)
+			{
+				const simd_type one(1.f);
+				simd_type r(_mm_rcp_ps(va.xyzw));
 
-	template <typename Real, typename Rep>
-	class vector4
-	{
-		public:
-			inline vector4() { }
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r*(1 - va*r)
+					r = VMAdd(r, VNMSub(va, r, one), r);
+				}
 
-			inline vector4(Real *pVec)
-				: _rep(pVec)
-			{ }
+				return r;
+			}
 
-			inline vector4(Real f)
-				: _rep(f)
-			{ }
+			// 1/sqrt(va): _mm_rsqrt_ps (12 bits) refined by Steps Newton-Raphson steps,
+			// a refined 1/sqrt(0) is NaN
+			template <int Steps>
+			static inline simd_type VRsqrtEst(const simd_type& va)
+			{
+				const simd_type one(1.f);
+				const simd_type half(0.5f);
+				simd_type r(_mm_rsqrt_ps(va.xyzw));
 
-			inline vector4(Real x, Real y, Real z, Real w)
-				: _rep(x, y, z, w)
-			{ }
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r/2*(1 - va*r*r)
+					r = VMAdd(VMul(half, r), VNMSub(VMul(va, r), r, one), r);
+				}
 
-			inline vector4(const simd_type& rep)
-				: _rep(rep)
-			{ }
+				return r;
+			}
 
-			inline vector4(const vector4& copy)
-				: _rep(copy._rep)
-			{ }
+			// range reduced transcendentals (vtranscendental.inl)
+			static inline simd_type Sin(const simd_type& va)
+			{
+				return simd_type(VTransSin(va.xyzw));
+			}
 
-			inline vector4& operator= (const vector4& copy)
+			static inline simd_type Cos(const simd_type& va)
 			{
-				_rep = copy._rep;
+				return simd_type(VTransCos(va.xyzw));
+			}
 
-				return *this;
+			static inline void SinCos(const simd_type& va, simd_type& s, simd_type& c)
+			{
+				VTransSinCos(va.xyzw, &s.xyzw, &c.xyzw);
 			}
 
-			inline vector4& operator+= (const vector4& rhs)
+			static inline simd_type Exp(const simd_type& va)
 			{
-				_rep += rhs._rep;
+				return simd_type(VTransExp(va.xyzw));
+			}
 
-				return *this;
+			static inline simd_type Log(const simd_type& va)
+			{
+				return simd_type(VTransLog(va.xyzw));
 			}
 
-			inline vector4& operator-= (const vector4& rhs)
+			static inline simd_type Pow(const simd_type& va, const simd_type& vb)
 			{
-				_rep -= rhs._rep;
+				return simd_type(VTransPow(va.xyzw, vb.xyzw));
+			}
 
-				return *this;
+			static inline simd_type Atan2(const simd_type& vy, const simd_type& vx)
+			{
+				return simd_type(VTransAtan2(vy.xyzw, vx.xyzw));
 			}
 
-			inline vector4& operator*= (const vector4& rhs)
+			static inline mask_type VCmpLt(const simd_type& va, const simd_type& vb)
 			{
-				_rep *= rhs._rep;
+				return _mm_castps_si128(_mm_cmplt_ps(va.xyzw, vb.xyzw));
+			}
 
-				return *this;
+			static inline mask_type VCmpGt(const simd_type& va, const simd_type& vb)
+			{
+				return _mm_castps_si128(_mm_cmpgt_ps(va.xyzw, vb.xyzw));
 			}
 
-			inline vector4 operator+ (const vector4& rhs) const
+			static inline mask_type VCmpEq(const simd_type& va, const simd_type& vb)
 			{
-				return vector4(_rep + rhs._rep);
+				return _mm_castps_si128(_mm_cmpeq_ps(va.xyzw, vb.xyzw));
 			}
 
-			inline vector4 operator- (const vector4& rhs) const
+			// vb where either is NaN
+			static inline simd_type VMin(const simd_type& va, const simd_type& vb)
 			{
-				return vector4(_rep - rhs._rep);
+				return simd_type(_mm_min_ps(va.xyzw, vb.xyzw));
 			}
 
-			inline vector4 operator* (const vector4& rhs) const
+			static inline simd_type VMax(const simd_type& va, const simd_type& vb)
 			{
-				return vector4(_rep * rhs._rep);
+				return simd_type(_mm_max_ps(va.xyzw, vb.xyzw));
 			}
 
-			inline vector4 operator/ (const vector4& rhs) const
+			static inline simd_type VAbs(const simd_type& va)
 			{
-				return vector4(_rep / rhs._rep);
+				return simd_type(_mm_andnot_ps(_mm_set1_ps(-0.f), va.xyzw));
 			}
 
-			inline void Store(Real *pVec) const
+			// m ? va : vb
+			static inline simd_type VSelect(const mask_type& m, const simd_type& va, const simd_type& vb)
 			{
-				_rep.Store(pVec);
+			#if defined(__SSE4_1__) || defined(__AVX__)
+				return simd_type(_mm_blendv_ps(vb.xyzw, va.xyzw, _mm_castsi128_ps(m)));
+			#else
+				const __m128 f = _mm_castsi128_ps(m);
+
+				return simd_type(_mm_or_ps(_mm_and_ps(f, va.xyzw), _mm_andnot_ps(f, vb.xyzw)));
+			#endif
 			}
 
-			inline void Bc()
+			static inline bool VAny(const mask_type& m)
 			{
-				_rep.Bc();
+				return _mm_movemask_ps(_mm_castsi128_ps(m)) != 0;
 			}
 
-			static inline vector4 Dot(const vector4& va, const vector4& vb)
+			static inline bool VAll(const mask_type& m)
 			{
-				return vector4(simd_type::Dot(va._rep, vb._rep));
+				return _mm_movemask_ps(_mm_castsi128_ps(m)) == 0xf;
 			}
 
-			static inline vector4 Sqrt(const vector4& va)
+			// NaN gives lo
+			static inline simd_type VClamp(const simd_type& va, const simd_type& lo, const simd_type& hi)
 			{
-				return vector4(simd_type::Sqrt(va._rep));
+				return simd_type(_mm_min_ps(_mm_max_ps(va.xyzw, lo.xyzw), hi.xyzw));
 			}
 
-			static inline vector4 VAdd(const vector4& va, const vector4& vb)
+			// round to nearest (the MXCSR mode)
+			static inline simd_itype VConvertToInt(const simd_type& va)
 			{
-				return vector4(simd_type::VAdd(va._rep, vb._rep));
+				return simd_itype(_mm_cvtps_epi32(va.xyzw));
 			}
 
-			static inline vector4 VSub(const vector4& va, const vector4& vb)
+			// round toward zero, as a C cast
+			static inline simd_itype VTruncateToInt(const simd_type& va)
 			{
-				return vector4(simd_type::VSub(va._rep, vb._rep));
+				return simd_itype(_mm_cvttps_epi32(va.xyzw));
 			}
 
-			static inline vector4 VMul(const vector4& va, const vector4& vb)
+			static inline simd_type VConvertFromInt(const simd_itype& va)
+			{
+				return simd_type(_mm_cvtepi32_ps(va.xyzw));
+			}
+
+			// (v[X], v[Y], v[Z], v[W]) in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type Swizzle(const simd_type& v)
+			{
+				return simd_type(VSwizzle<X,Y,Z,W>(v.xyzw));
+			}
+
+			// lanes 0-3 of va, 4-7 of vb in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type Permute(const simd_type& va, const simd_type& vb)
+			{
+				return simd_type(VPermute<X,Y,Z,W>(va.xyzw, vb.xyzw));
+			}
+
+			// (va[X], va[Y], vb[Z], vb[W]) in every 128 bit lane, as _mm_shuffle_ps
+			template <int X, int Y, int Z, int W>
+			static inline simd_type Shuffle(const simd_type& va, const simd_type& vb)
+			{
+				return simd_type(_mm_shuffle_ps(va.xyzw, vb.xyzw, _MM_SHUFFLE(W,Z,Y,X)));
+			}
+
+			// the float with bit pattern Bits in every lane
+			template <unsigned int Bits>
+			static inline simd_type Const()
 			{
-				return vector4(simd_type::VMul(va._rep, vb._rep));
+				return simd_type(_mm_castsi128_ps(_mm_set1_epi32((int)Bits)));
 			}
 
-			static inline void GetX(Real *p, const vector4& v)
+			// 4 floats (16 byte aligned) into every 128 bit lane
+			static inline simd_type Load4(const float *p4)
 			{
-				simd_type::GetX(p, v._rep);
+				return simd_type(_mm_load_ps(p4));
+			}
+
+			// the first 128 bit lane
+			static inline void Store4(float *p4, const simd_type& v)
+			{
+				_mm_store_ps(p4, v.xyzw);
+			}
+
+			static inline void GetX(float *p, const simd_type& v)
+			{
+				_mm_store_ss(p, v.xyzw);
 			}
 
 		private:
-			Rep _rep;
-	} ;
+			__m128	xyzw;
+	};
 
-	typedef vector4<float, simd_type> Vec4;
+	///////////////////////////////////////////
+	// DOUBLE SIMD CLASS
+	//	4 double lanes, one __m256d with AVX
+	//	and a __m128d pair (xy, zw) otherwise.
+	//	Same interface as simd_type without the
+	//	transcendentals. The estimates start
+	//	from the float _mm_rcp_ps/_mm_rsqrt_ps,
+	//	Newton-Raphson steps run in double.
+	//	mask_type is a simd_dtype with every
+	//	bit of a lane set or clear.
+	///////////////////////////////////////////
+
+	class simd_dtype
+	{
+		friend class simd_type;
+
+		public:
+			enum { cWidth = 4 };
+
+			typedef simd_dtype	mask_type;
+			typedef simd_itype	int_type;
+
+			inline simd_dtype() {}
+
+			// 16 byte aligned
+			inline simd_dtype(double *pVec)
+			#if defined(__AVX__)
+				: xyzw(_mm256_loadu_pd(pVec))
+			#else
+				: xy(_mm_load_pd(pVec)), zw(_mm_load_pd(pVec + 2))
+			#endif
+			{ }
+
+			inline simd_dtype(double f)
+			#if defined(__AVX__)
+				: xyzw(_mm256_set1_pd(f))
+			#else
+				: xy(_mm_set1_pd(f)), zw(_mm_set1_pd(f))
+			#endif
+			{ }
+
+			inline simd_dtype(double x, double y, double z, double w)
+			#if defined(__AVX__)
+				: xyzw(_mm256_set_pd(x, y, z, w))
+			#else
+				: xy(_mm_set_pd(z, w)), zw(_mm_set_pd(x, y))
+			#endif
+			{ }
+
+		#if defined(__AVX__)
+			inline simd_dtype(const __m256d& qword)
+				: xyzw(qword)
+			{ }
+		#else
+			inline simd_dtype(const __m128d& lo, const __m128d& hi)
+				: xy(lo), zw(hi)
+			{ }
+		#endif
+
+			// the float lanes, exact
+			inline explicit simd_dtype(const simd_type& f);
+
+			inline simd_dtype(const simd_dtype& copy)
+			#if defined(__AVX__)
+				: xyzw(copy.xyzw)
+			#else
+				: xy(copy.xy), zw(copy.zw)
+			#endif
+			{ }
+
+			inline simd_dtype& operator= (const simd_dtype& copy)
+			{
+			#if defined(__AVX__)
+				xyzw = copy.xyzw;
+			#else
+				xy = copy.xy;
+				zw = copy.zw;
+			#endif
+
+				return *this;
+			}
+
+			inline simd_dtype& operator+=(const simd_dtype &rhs)
+			{
+				return *this = VAdd(*this, rhs);
+			}
+
+			inline simd_dtype& operator-=(const simd_dtype &rhs)
+			{
+				return *this = VSub(*this, rhs);
+			}
+
+			inline simd_dtype& operator*=(const simd_dtype &rhs)
+			{
+				return *this = VMul(*this, rhs);
+			}
+
+			inline simd_dtype operator+(const simd_dtype &rhs) const
+			{
+				return VAdd(*this, rhs);
+			}
+
+			inline simd_dtype operator*(const simd_dtype &rhs) const
+			{
+				return VMul(*this, rhs);
+			}
+
+			inline simd_dtype operator-(const simd_dtype &rhs) const
+			{
+				return VSub(*this, rhs);
+			}
+
+			inline simd_dtype operator/(const simd_dtype &rhs) const
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_div_pd(xyzw, rhs.xyzw));
+			#else
+				return simd_dtype(_mm_div_pd(xy, rhs.xy), _mm_div_pd(zw, rhs.zw));
+			#endif
+			}
+
+			// 16 byte aligned
+			inline void Store(double *pVec) const
+			{
+			#if defined(__AVX__)
+				_mm256_storeu_pd(pVec, xyzw);
+			#else
+				_mm_store_pd(pVec, xy);
+				_mm_store_pd(pVec + 2, zw);
+			#endif
+			}
+
+			// non-temporal, 32 byte aligned with AVX, 16 otherwise
+			inline void StoreStream(double *pVec) const
+			{
+			#if defined(__AVX__)
+				_mm256_stream_pd(pVec, xyzw);
+			#else
+				_mm_stream_pd(pVec, xy);
+				_mm_stream_pd(pVec + 2, zw);
+			#endif
+			}
+
+			inline void Bc()
+			{
+			#if defined(__AVX__)
+				const __m256d w = _mm256_permute_pd(xyzw, 0xf);
+
+				xyzw = _mm256_permute2f128_pd(w, w, 0x11);
+			#else
+				xy = zw = _mm_unpackhi_pd(zw, zw);
+			#endif
+			}
+
+			static inline simd_dtype Dot(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				const __m256d t0 = _mm256_mul_pd(va.xyzw, vb.xyzw);
+				const __m256d t1 = _mm256_add_pd(t0, _mm256_permute2f128_pd(t0, t0, 0x01));
+
+				return simd_dtype(_mm256_add_pd(t1, _mm256_permute_pd(t1, 0x5)));
+			#else
+				const __m128d t0 = _mm_add_pd(_mm_mul_pd(va.xy, vb.xy), _mm_mul_pd(va.zw, vb.zw));
+				const __m128d t1 = _mm_add_pd(t0, _mm_shuffle_pd(t0, t0, 1));
+
+				return simd_dtype(t1, t1);
+			#endif
+			}
+
+			// horizontal add/mul/min/max of the 4 lanes, replicated in all 4
+			static inline simd_dtype HSum(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				const __m256d t0 = _mm256_add_pd(va.xyzw, _mm256_permute2f128_pd(va.xyzw, va.xyzw, 0x01));
+
+				return simd_dtype(_mm256_add_pd(t0, _mm256_permute_pd(t0, 0x5)));
+			#else
+				const __m128d t0 = _mm_add_pd(va.xy, va.zw);
+				const __m128d t1 = _mm_add_pd(t0, _mm_shuffle_pd(t0, t0, 1));
+
+				return simd_dtype(t1, t1);
+			#endif
+			}
+
+			static inline simd_dtype HProduct(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				const __m256d t0 = _mm256_mul_pd(va.xyzw, _mm256_permute2f128_pd(va.xyzw, va.xyzw, 0x01));
+
+				return simd_dtype(_mm256_mul_pd(t0, _mm256_permute_pd(t0, 0x5)));
+			#else
+				const __m128d t0 = _mm_mul_pd(va.xy, va.zw);
+				const __m128d t1 = _mm_mul_pd(t0, _mm_shuffle_pd(t0, t0, 1));
+
+				return simd_dtype(t1, t1);
+			#endif
+			}
+
+			static inline simd_dtype HMin(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				const __m256d t0 = _mm256_min_pd(va.xyzw, _mm256_permute2f128_pd(va.xyzw, va.xyzw, 0x01));
+
+				return simd_dtype(_mm256_min_pd(t0, _mm256_permute_pd(t0, 0x5)));
+			#else
+				const __m128d t0 = _mm_min_pd(va.xy, va.zw);
+				const __m128d t1 = _mm_min_pd(t0, _mm_shuffle_pd(t0, t0, 1));
+
+				return simd_dtype(t1, t1);
+			#endif
+			}
+
+			static inline simd_dtype HMax(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				const __m256d t0 = _mm256_max_pd(va.xyzw, _mm256_permute2f128_pd(va.xyzw, va.xyzw, 0x01));
+
+				return simd_dtype(_mm256_max_pd(t0, _mm256_permute_pd(t0, 0x5)));
+			#else
+				const __m128d t0 = _mm_max_pd(va.xy, va.zw);
+				const __m128d t1 = _mm_max_pd(t0, _mm_shuffle_pd(t0, t0, 1));
+
+				return simd_dtype(t1, t1);
+			#endif
+			}
+
+			static inline simd_dtype Sqrt(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_sqrt_pd(va.xyzw));
+			#else
+				return simd_dtype(_mm_sqrt_pd(va.xy), _mm_sqrt_pd(va.zw));
+			#endif
+			}
+
+			static inline simd_dtype VAdd(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_add_pd(va.xyzw, vb.xyzw));
+			#else
+				return simd_dtype(_mm_add_pd(va.xy, vb.xy), _mm_add_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline simd_dtype VSub(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_sub_pd(va.xyzw, vb.xyzw));
+			#else
+				return simd_dtype(_mm_sub_pd(va.xy, vb.xy), _mm_sub_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline simd_dtype VMul(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_mul_pd(va.xyzw, vb.xyzw));
+			#else
+				return simd_dtype(_mm_mul_pd(va.xy, vb.xy), _mm_mul_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			// va*vb + vc
+			static inline simd_dtype VMAdd(const simd_dtype& va, const simd_dtype& vb, const simd_dtype& vc)
+			{
+			#if defined(SIMD_FMA)
+				return simd_dtype(_mm256_fmadd_pd(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return VAdd(VMul(va, vb), vc);
+			#endif
+			}
+
+			// vc - va*vb
+			static inline simd_dtype VNMSub(const simd_dtype& va, const simd_dtype& vb, const simd_dtype& vc)
+			{
+			#if defined(SIMD_FMA)
+				return simd_dtype(_mm256_fnmadd_pd(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return VSub(vc, VMul(va, vb));
+			#endif
+			}
+
+			// 1/va: the float _mm_rcp_ps (12 bits) refined by Steps Newton-Raphson steps
+			template <int Steps>
+			static inline simd_dtype VReciprocalEst(const simd_dtype& va)
+			{
+				const simd_dtype one(1.);
+				simd_dtype r(simd_type(_mm_rcp_ps(simd_type(va).xyzw)));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r*(1 - va*r)
+					r = VMAdd(r, VNMSub(va, r, one), r);
+				}
+
+				return r;
+			}
+
+			// 1/sqrt(va): the float _mm_rsqrt_ps (12 bits) refined by Steps Newton-Raphson
+			// steps, a refined 1/sqrt(0) is NaN
+			template <int Steps>
+			static inline simd_dtype VRsqrtEst(const simd_dtype& va)
+			{
+				const simd_dtype one(1.);
+				const simd_dtype half(0.5);
+				simd_dtype r(simd_type(_mm_rsqrt_ps(simd_type(va).xyzw)));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r/2*(1 - va*r*r)
+					r = VMAdd(VMul(half, r), VNMSub(VMul(va, r), r, one), r);
+				}
+
+				return r;
+			}
+
+			static inline mask_type VCmpLt(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_cmp_pd(va.xyzw, vb.xyzw, _CMP_LT_OQ));
+			#else
+				return simd_dtype(_mm_cmplt_pd(va.xy, vb.xy), _mm_cmplt_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline mask_type VCmpGt(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_cmp_pd(va.xyzw, vb.xyzw, _CMP_GT_OQ));
+			#else
+				return simd_dtype(_mm_cmpgt_pd(va.xy, vb.xy), _mm_cmpgt_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline mask_type VCmpEq(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_cmp_pd(va.xyzw, vb.xyzw, _CMP_EQ_OQ));
+			#else
+				return simd_dtype(_mm_cmpeq_pd(va.xy, vb.xy), _mm_cmpeq_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			// vb where either is NaN
+			static inline simd_dtype VMin(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_min_pd(va.xyzw, vb.xyzw));
+			#else
+				return simd_dtype(_mm_min_pd(va.xy, vb.xy), _mm_min_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline simd_dtype VMax(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_max_pd(va.xyzw, vb.xyzw));
+			#else
+				return simd_dtype(_mm_max_pd(va.xy, vb.xy), _mm_max_pd(va.zw, vb.zw));
+			#endif
+			}
+
+			static inline simd_dtype VAbs(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_andnot_pd(_mm256_set1_pd(-0.), va.xyzw));
+			#else
+				const __m128d sign = _mm_set1_pd(-0.);
+
+				return simd_dtype(_mm_andnot_pd(sign, va.xy), _mm_andnot_pd(sign, va.zw));
+			#endif
+			}
+
+			// m ? va : vb
+			static inline simd_dtype VSelect(const mask_type& m, const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_blendv_pd(vb.xyzw, va.xyzw, m.xyzw));
+			#elif defined(__SSE4_1__)
+				return simd_dtype(_mm_blendv_pd(vb.xy, va.xy, m.xy), _mm_blendv_pd(vb.zw, va.zw, m.zw));
+			#else
+				return simd_dtype(_mm_or_pd(_mm_and_pd(m.xy, va.xy), _mm_andnot_pd(m.xy, vb.xy)),
+								  _mm_or_pd(_mm_and_pd(m.zw, va.zw), _mm_andnot_pd(m.zw, vb.zw)));
+			#endif
+			}
+
+			static inline bool VAny(const mask_type& m)
+			{
+			#if defined(__AVX__)
+				return _mm256_movemask_pd(m.xyzw) != 0;
+			#else
+				return (_mm_movemask_pd(m.xy) | _mm_movemask_pd(m.zw)) != 0;
+			#endif
+			}
+
+			static inline bool VAll(const mask_type& m)
+			{
+			#if defined(__AVX__)
+				return _mm256_movemask_pd(m.xyzw) == 0xf;
+			#else
+				return (_mm_movemask_pd(m.xy) & _mm_movemask_pd(m.zw)) == 0x3;
+			#endif
+			}
+
+			// NaN gives lo
+			static inline simd_dtype VClamp(const simd_dtype& va, const simd_dtype& lo, const simd_dtype& hi)
+			{
+				return VMin(VMax(va, lo), hi);
+			}
+
+			// round to nearest (the MXCSR mode)
+			static inline simd_itype VConvertToInt(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				return simd_itype(_mm256_cvtpd_epi32(va.xyzw));
+			#else
+				return simd_itype(_mm_unpacklo_epi64(_mm_cvtpd_epi32(va.xy), _mm_cvtpd_epi32(va.zw)));
+			#endif
+			}
+
+			// round toward zero, as a C cast
+			static inline simd_itype VTruncateToInt(const simd_dtype& va)
+			{
+			#if defined(__AVX__)
+				return simd_itype(_mm256_cvttpd_epi32(va.xyzw));
+			#else
+				return simd_itype(_mm_unpacklo_epi64(_mm_cvttpd_epi32(va.xy), _mm_cvttpd_epi32(va.zw)));
+			#endif
+			}
+
+			static inline simd_dtype VConvertFromInt(const simd_itype& va)
+			{
+			#if defined(__AVX__)
+				return simd_dtype(_mm256_cvtepi32_pd(va.xyzw));
+			#else
+				return simd_dtype(_mm_cvtepi32_pd(va.xyzw), _mm_cvtepi32_pd(_mm_shuffle_epi32(va.xyzw, _MM_SHUFFLE(3,2,3,2))));
+			#endif
+			}
+
+			// (v[X], v[Y], v[Z], v[W])
+			template <int X, int Y, int Z, int W>
+			static inline simd_dtype Swizzle(const simd_dtype& v)
+			{
+			#if defined(__AVX2__)
+				return simd_dtype(_mm256_permute4x64_pd(v.xyzw, _MM_SHUFFLE(W, Z, Y, X)));
+			#else
+				return Permute<X, Y, Z, W>(v, v);
+			#endif
+			}
+
+			// lanes 0-3 of va, 4-7 of vb
+			template <int X, int Y, int Z, int W>
+			static inline simd_dtype Permute(const simd_dtype& va, const simd_dtype& vb)
+			{
+			#if defined(__AVX__)
+				// the pairs {0,1} {2,3} {4,5} {6,7} holding lanes X, Z and Y, W, then the lane in each pair
+				__m256d xz = _mm256_permute2f128_pd(va.xyzw, vb.xyzw, (X >> 1) | ((Z >> 1) << 4));
+				__m256d yw = _mm256_permute2f128_pd(va.xyzw, vb.xyzw, (Y >> 1) | ((W >> 1) << 4));
+
+				xz = _mm256_permute_pd(xz, (X & 1) | ((Z & 1) << 2));
+				yw = _mm256_permute_pd(yw, ((Y & 1) << 1) | ((W & 1) << 3));
+
+				return simd_dtype(_mm256_blend_pd(xz, yw, 0xa));
+			#else
+				return simd_dtype(
+					_mm_shuffle_pd(Pair<(X >> 1)>(va, vb), Pair<(Y >> 1)>(va, vb), (X & 1) | ((Y & 1) << 1)),
+					_mm_shuffle_pd(Pair<(Z >> 1)>(va, vb), Pair<(W >> 1)>(va, vb), (Z & 1) | ((W & 1) << 1)));
+			#endif
+			}
+
+			// (va[X], va[Y], vb[Z], vb[W])
+			template <int X, int Y, int Z, int W>
+			static inline simd_dtype Shuffle(const simd_dtype& va, const simd_dtype& vb)
+			{
+				return Permute<X, Y, Z + 4, W + 4>(va, vb);
+			}
+
+			// the float with bit pattern Bits, widened (exactly) to double
+			template <unsigned int Bits>
+			static inline simd_dtype Const()
+			{
+				union { unsigned int u; float f; } c = { Bits };
+
+				return simd_dtype((double)c.f);
+			}
+
+			// 4 doubles (16 byte aligned)
+			static inline simd_dtype Load4(const double *p4)
+			{
+				return simd_dtype((double*)p4);
+			}
+
+			static inline void Store4(double *p4, const simd_dtype& v)
+			{
+				v.Store(p4);
+			}
+
+			static inline void GetX(double *p, const simd_dtype& v)
+			{
+			#if defined(__AVX__)
+				_mm_store_sd(p, _mm256_castpd256_pd128(v.xyzw));
+			#else
+				_mm_store_sd(p, v.xy);
+			#endif
+			}
+
+			// rounded to float, for the vertex buffers
+			static inline void GetX(float *p, const simd_dtype& v)
+			{
+			#if defined(__AVX__)
+				_mm_store_ss(p, _mm_cvtpd_ps(_mm256_castpd256_pd128(v.xyzw)));
+			#else
+				_mm_store_ss(p, _mm_cvtpd_ps(v.xy));
+			#endif
+			}
+
+		private:
+		#if !defined(__AVX__)
+			// lanes {0,1} {2,3} of va, {4,5} {6,7} of vb
+			template <int P>
+			static inline __m128d Pair(const simd_dtype& va, const simd_dtype& vb)
+			{
+				return (P == 0) ? va.xy : (P == 1) ? va.zw : (P == 2) ? vb.xy : vb.zw;
+			}
+		#endif
+
+		#if defined(__AVX__)
+			__m256d	xyzw;
+		#else
+			__m128d	xy;
+			__m128d	zw;
+		#endif
+	};
+
+	inline simd_dtype::simd_dtype(const simd_type& f)
+	#if defined(__AVX__)
+		: xyzw(_mm256_cvtps_pd(f.xyzw))
+	#else
+		: xy(_mm_cvtps_pd(f.xyzw)), zw(_mm_cvtps_pd(_mm_movehl_ps(f.xyzw, f.xyzw)))
+	#endif
+	{ }
+
+	inline simd_type::simd_type(const simd_dtype& d)
+	#if defined(__AVX__)
+		: xyzw(_mm256_cvtpd_ps(d.xyzw))
+	#else
+		: xyzw(_mm_movelh_ps(_mm_cvtpd_ps(d.xy), _mm_cvtpd_ps(d.zw)))
+	#endif
+	{ }
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+	///////////////////////////////////////////
+	// INTEGER SIMD CLASS 8-wide (AVX2)
+	//	Same interface as simd_itype on a
+	//	__m256i. PackS16 keeps the lane order
+	//	across the 128 bit halves.
+	///////////////////////////////////////////
+
+	class simd_itype8
+	{
+		friend class simd_type8;
+
+		public:
+			enum { cWidth = 8 };
+
+			inline simd_itype8() {}
+
+			inline simd_itype8(const int *pVec)
+				: xyzw(_mm256_loadu_si256((const __m256i*)pVec))
+			{ }
+
+			inline simd_itype8(int i)
+				: xyzw(_mm256_set1_epi32(i))
+			{ }
+
+			inline simd_itype8(const __m256i& qword)
+				: xyzw(qword)
+			{ }
+
+			inline simd_itype8(int x, int y, int z, int w)
+				: xyzw(_mm256_set_epi32(x, y, z, w, x, y, z, w))
+			{ }
+
+			inline simd_itype8 operator+(const simd_itype8 &rhs) const
+			{
+				return simd_itype8(_mm256_add_epi32(xyzw, rhs.xyzw));
+			}
+
+			inline simd_itype8 operator-(const simd_itype8 &rhs) const
+			{
+				return simd_itype8(_mm256_sub_epi32(xyzw, rhs.xyzw));
+			}
+
+			// low 32 bits of the product
+			inline simd_itype8 operator*(const simd_itype8 &rhs) const
+			{
+				return simd_itype8(_mm256_mullo_epi32(xyzw, rhs.xyzw));
+			}
+
+			inline simd_itype8& operator+=(const simd_itype8 &rhs)
+			{
+				xyzw = _mm256_add_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_itype8& operator-=(const simd_itype8 &rhs)
+			{
+				xyzw = _mm256_sub_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline void Store(int *pVec) const
+			{
+				_mm256_storeu_si256((__m256i*)pVec, xyzw);
+			}
+
+			// non-temporal, 32 byte aligned
+			inline void StoreStream(int *pVec) const
+			{
+				_mm256_stream_si256((__m256i*)pVec, xyzw);
+			}
+
+			static inline simd_itype8 VAnd(const simd_itype8& va, const simd_itype8& vb)
+			{
+				return simd_itype8(_mm256_and_si256(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype8 VOr(const simd_itype8& va, const simd_itype8& vb)
+			{
+				return simd_itype8(_mm256_or_si256(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype8 VXor(const simd_itype8& va, const simd_itype8& vb)
+			{
+				return simd_itype8(_mm256_xor_si256(va.xyzw, vb.xyzw));
+			}
+
+			// ~va & vb
+			static inline simd_itype8 VAndNot(const simd_itype8& va, const simd_itype8& vb)
+			{
+				return simd_itype8(_mm256_andnot_si256(va.xyzw, vb.xyzw));
+			}
+
+			template <int Count>
+			static inline simd_itype8 ShiftLeft(const simd_itype8& va)
+			{
+				return simd_itype8(_mm256_slli_epi32(va.xyzw, Count));
+			}
+
+			// arithmetic, keeps the sign
+			template <int Count>
+			static inline simd_itype8 ShiftRight(const simd_itype8& va)
+			{
+				return simd_itype8(_mm256_srai_epi32(va.xyzw, Count));
+			}
+
+			template <int Count>
+			static inline simd_itype8 ShiftRightLogical(const simd_itype8& va)
+			{
+				return simd_itype8(_mm256_srli_epi32(va.xyzw, Count));
+			}
+
+			// the 16 shorts va[0..7], vb[0..7], saturated
+			static inline simd_itype8 PackS16(const simd_itype8& va, const simd_itype8& vb)
+			{
+				return simd_itype8(_mm256_permute4x64_epi64(_mm256_packs_epi32(va.xyzw, vb.xyzw), _MM_SHUFFLE(3,1,2,0)));
+			}
+
+			// shorts 0-7 / 8-15 of a PackS16 result, sign extended
+			static inline simd_itype8 UnpackLoS16(const simd_itype8& va)
+			{
+				return simd_itype8(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(va.xyzw)));
+			}
+
+			static inline simd_itype8 UnpackHiS16(const simd_itype8& va)
+			{
+				return simd_itype8(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(va.xyzw, 1)));
+			}
+
+			// 8 shorts, sign extended
+			static inline simd_itype8 LoadS16(const short *p)
+			{
+				return simd_itype8(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)p)));
+			}
+
+			// 8 shorts, saturated
+			inline void StoreS16(short *p) const
+			{
+				_mm_storeu_si128((__m128i*)p, _mm_packs_epi32(_mm256_castsi256_si128(xyzw), _mm256_extracti128_si256(xyzw, 1)));
+			}
+
+		private:
+			__m256i	xyzw;
+	};
+
+	///////////////////////////////////////////
+	// SIMD CLASS 8-wide (AVX)
+	//	Same interface as simd_type on a __m256.
+	//	Lane-wise ops (Dot, Bc) work on each
+	//	128-bit half, i.e. two Vec4 side by side.
+	//	Loads/stores are unaligned so pairs of
+	//	16-byte aligned Vec4 can be used directly.
+	//	mask_type selects float lanes for the
+	//	masked Load/Store (vmaskmovps), the
+	//	comparisons return one.
+	///////////////////////////////////////////
+
+	class simd_type8
+	{
+		public:
+			enum { cWidth = 8 };
+
+			typedef __m256i	mask_type;
+
+			// the integer rep of the same width
+			typedef simd_itype8	int_type;
+
+			inline simd_type8() {}
+
+			inline simd_type8(float *pVec)
+				: xyzw(_mm256_loadu_ps(pVec))
+			{ }
+
+			inline simd_type8(float f)
+				: xyzw(_mm256_set1_ps(f))
+			{ }
+
+			inline simd_type8(const __m256& qword)
+				: xyzw(qword)
+			{ }
+
+			inline simd_type8(const __m128& lo, const __m128& hi)
+				: xyzw(_mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1))
+			{ }
+
+			inline simd_type8(float x, float y, float z, float w)
+				: xyzw(_mm256_set_ps(x, y, z, w, x, y, z, w))
+			{ }
+
+			inline simd_type8(const simd_type8& copy)
+				: xyzw(copy.xyzw)
+			{ }
+
+			inline simd_type8& operator= (const simd_type8& copy)
+			{
+				xyzw = copy.xyzw;
+
+				return *this;
+			}
+
+			inline simd_type8& operator+=(const simd_type8 &rhs)
+			{
+				xyzw = _mm256_add_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type8& operator-=(const simd_type8 &rhs)
+			{
+				xyzw = _mm256_sub_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type8& operator*=(const simd_type8 &rhs)
+			{
+				xyzw = _mm256_mul_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type8 operator+(const simd_type8 &rhs) const
+			{
+				return simd_type8(_mm256_add_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type8 operator*(const simd_type8 &rhs) const
+			{
+				return simd_type8(_mm256_mul_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type8 operator-(const simd_type8 &rhs) const
+			{
+				return simd_type8(_mm256_sub_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type8 operator/(const simd_type8 &rhs) const
+			{
+				return simd_type8(_mm256_div_ps(xyzw, rhs.xyzw));
+			}
+
+			inline void Store(float *pVec) const
+			{
+				_mm256_storeu_ps(pVec, xyzw);
+			}
+
+			// non-temporal, 32 byte aligned
+			inline void StoreStream(float *pVec) const
+			{
+				_mm256_stream_ps(pVec, xyzw);
+			}
+
+			inline void Store(const mask_type& m, float *pVec) const
+			{
+				_mm256_maskstore_ps(pVec, m, xyzw);
+			}
+
+			// lanes past the mask read as 0 and never touch memory
+			static inline simd_type8 Load(const mask_type& m, float *pVec)
+			{
+				return simd_type8(_mm256_maskload_ps(pVec, m));
+			}
+
+			// first n float lanes
+			static inline mask_type TailMask(int n)
+			{
+				return _mm256_cmpgt_epi32(_mm256_set1_epi32(n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+			}
+
+			// 4 lane group G (0 low, 1 high) as a __m128, without a trip through memory
+			template <int G>
+			inline __m128 Group() const
+			{
+				return G ? _mm256_extractf128_ps(xyzw, G) : _mm256_castps256_ps128(xyzw);
+			}
+
+			inline void Bc()
+			{
+				xyzw = VSwizzle<3,3,3,3>(xyzw);
+			}
+
+			static inline simd_type8 Dot(const simd_type8& va, const simd_type8& vb)
+			{
+				const __m256 t0 = _mm256_mul_ps(va.xyzw, vb.xyzw);
+				const __m256 t1 = VSwizzle<2,3,0,1>(t0);
+				const __m256 t2 = _mm256_add_ps(t0, t1);
+				const __m256 t3 = VSwizzle<1,0,3,2>(t2);
+				
+				return simd_type8(_mm256_add_ps(t3, t2));
+			}
+
+			// horizontal ops within each group of 4 lanes, as Dot
+			static inline simd_type8 HSum(const simd_type8& va)
+			{
+				const __m256 t0 = _mm256_add_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type8(_mm256_add_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type8 HProduct(const simd_type8& va)
+			{
+				const __m256 t0 = _mm256_mul_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type8(_mm256_mul_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type8 HMin(const simd_type8& va)
+			{
+				const __m256 t0 = _mm256_min_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type8(_mm256_min_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type8 HMax(const simd_type8& va)
+			{
+				const __m256 t0 = _mm256_max_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type8(_mm256_max_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type8 Sqrt(const simd_type8& va)
+			{
+				return simd_type8(_mm256_sqrt_ps(va.xyzw));
+			}
+
+			static inline simd_type8 VAdd(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_add_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type8 VSub(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_sub_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type8 VMul(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_mul_ps(va.xyzw, vb.xyzw));
+			}
+
+			// va*vb + vc
+			static inline simd_type8 VMAdd(const simd_type8& va, const simd_type8& vb, const simd_type8& vc)
+			{
+			#if defined(SIMD_FMA)
+				return simd_type8(_mm256_fmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return simd_type8(_mm256_add_ps(_mm256_mul_ps(va.xyzw, vb.xyzw), vc.xyzw));
+			#endif
+			}
+
+			// vc - va*vb
+			static inline simd_type8 VNMSub(const simd_type8& va, const simd_type8& vb, const simd_type8& vc)
+			{
+			#if defined(SIMD_FMA)
+				return simd_type8(_mm256_fnmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			#else
+				return simd_type8(_mm256_sub_ps(vc.xyzw, _mm256_mul_ps(va.xyzw, vb.xyzw)));
+			#endif
+			}
+
+			// 1/va: _mm256_rcp_ps (12 bits) refined by Steps (0-2) Newton-Raphson steps
+			template <int Steps>
+			static inline simd_type8 VReciprocalEst(const simd_type8& va)
+			{
+				const simd_type8 one(1.f);
+				simd_type8 r(_mm256_rcp_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r*(1 - va*r)
+					r = VMAdd(r, VNMSub(va, r, one), r);
+				}
+
+				return r;
+			}
+
+			// 1/sqrt(va): _mm256_rsqrt_ps (12 bits) refined by Steps Newton-Raphson steps,
+			// a refined 1/sqrt(0) is NaN
+			template <int Steps>
+			static inline simd_type8 VRsqrtEst(const simd_type8& va)
+			{
+				const simd_type8 one(1.f);
+				const simd_type8 half(0.5f);
+				simd_type8 r(_mm256_rsqrt_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r/2*(1 - va*r*r)
+					r = VMAdd(VMul(half, r), VNMSub(VMul(va, r), r, one), r);
+				}
+
+				return r;
+			}
+
+			// range reduced transcendentals (vtranscendental.inl)
+			static inline simd_type8 Sin(const simd_type8& va)
+			{
+				return simd_type8(VTransSin(va.xyzw));
+			}
+
+			static inline simd_type8 Cos(const simd_type8& va)
+			{
+				return simd_type8(VTransCos(va.xyzw));
+			}
+
+			static inline void SinCos(const simd_type8& va, simd_type8& s, simd_type8& c)
+			{
+				VTransSinCos(va.xyzw, &s.xyzw, &c.xyzw);
+			}
+
+			static inline simd_type8 Exp(const simd_type8& va)
+			{
+				return simd_type8(VTransExp(va.xyzw));
+			}
+
+			static inline simd_type8 Log(const simd_type8& va)
+			{
+				return simd_type8(VTransLog(va.xyzw));
+			}
+
+			static inline simd_type8 Pow(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(VTransPow(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type8 Atan2(const simd_type8& vy, const simd_type8& vx)
+			{
+				return simd_type8(VTransAtan2(vy.xyzw, vx.xyzw));
+			}
+
+			static inline mask_type VCmpLt(const simd_type8& va, const simd_type8& vb)
+			{
+				return _mm256_castps_si256(_mm256_cmp_ps(va.xyzw, vb.xyzw, _CMP_LT_OQ));
+			}
+
+			static inline mask_type VCmpGt(const simd_type8& va, const simd_type8& vb)
+			{
+				return _mm256_castps_si256(_mm256_cmp_ps(va.xyzw, vb.xyzw, _CMP_GT_OQ));
+			}
+
+			static inline mask_type VCmpEq(const simd_type8& va, const simd_type8& vb)
+			{
+				return _mm256_castps_si256(_mm256_cmp_ps(va.xyzw, vb.xyzw, _CMP_EQ_OQ));
+			}
+
+			// vb where either is NaN
+			static inline simd_type8 VMin(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_min_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type8 VMax(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_max_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type8 VAbs(const simd_type8& va)
+			{
+				return simd_type8(_mm256_andnot_ps(_mm256_set1_ps(-0.f), va.xyzw));
+			}
+
+			// m ? va : vb
+			static inline simd_type8 VSelect(const mask_type& m, const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_blendv_ps(vb.xyzw, va.xyzw, _mm256_castsi256_ps(m)));
+			}
+
+			static inline bool VAny(const mask_type& m)
+			{
+				return _mm256_movemask_ps(_mm256_castsi256_ps(m)) != 0;
+			}
+
+			static inline bool VAll(const mask_type& m)
+			{
+				return _mm256_movemask_ps(_mm256_castsi256_ps(m)) == 0xff;
+			}
+
+			// NaN gives lo
+			static inline simd_type8 VClamp(const simd_type8& va, const simd_type8& lo, const simd_type8& hi)
+			{
+				return simd_type8(_mm256_min_ps(_mm256_max_ps(va.xyzw, lo.xyzw), hi.xyzw));
+			}
+
+			// round to nearest (the MXCSR mode)
+			static inline simd_itype8 VConvertToInt(const simd_type8& va)
+			{
+				return simd_itype8(_mm256_cvtps_epi32(va.xyzw));
+			}
+
+			// round toward zero, as a C cast
+			static inline simd_itype8 VTruncateToInt(const simd_type8& va)
+			{
+				return simd_itype8(_mm256_cvttps_epi32(va.xyzw));
+			}
+
+			static inline simd_type8 VConvertFromInt(const simd_itype8& va)
+			{
+				return simd_type8(_mm256_cvtepi32_ps(va.xyzw));
+			}
+
+			// (v[X], v[Y], v[Z], v[W]) in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type8 Swizzle(const simd_type8& v)
+			{
+				return simd_type8(VSwizzle<X,Y,Z,W>(v.xyzw));
+			}
+
+			// lanes 0-3 of va, 4-7 of vb in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type8 Permute(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(VPermute<X,Y,Z,W>(va.xyzw, vb.xyzw));
+			}
+
+			// (va[X], va[Y], vb[Z], vb[W]) in every 128 bit lane, as _mm_shuffle_ps
+			template <int X, int Y, int Z, int W>
+			static inline simd_type8 Shuffle(const simd_type8& va, const simd_type8& vb)
+			{
+				return simd_type8(_mm256_shuffle_ps(va.xyzw, vb.xyzw, _MM_SHUFFLE(W,Z,Y,X)));
+			}
+
+			// the float with bit pattern Bits in every lane
+			template <unsigned int Bits>
+			static inline simd_type8 Const()
+			{
+				return simd_type8(_mm256_castsi256_ps(_mm256_set1_epi32((int)Bits)));
+			}
+
+			// 4 floats (16 byte aligned) into every 128 bit lane
+			static inline simd_type8 Load4(const float *p4)
+			{
+				return simd_type8(_mm256_broadcast_ps((const __m128*)p4));
+			}
+
+			// the first 128 bit lane
+			static inline void Store4(float *p4, const simd_type8& v)
+			{
+				_mm_store_ps(p4, _mm256_castps256_ps128(v.xyzw));
+			}
+
+			static inline void GetX(float *p, const simd_type8& v)
+			{
+				_mm_store_ss(p, _mm256_castps256_ps128(v.xyzw));
+			}
+
+		private:
+			__m256	xyzw;
+	};
+#endif // #if defined(VCLASS_SIMDTYPE_AVX)
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	///////////////////////////////////////////
+	// INTEGER SIMD CLASS 16-wide (AVX-512)
+	//	Same interface as simd_itype8 on a
+	//	__m512i. The shorts are narrowed with
+	//	vpmovsdw, AVX-512F has no 512 bit pack.
+	///////////////////////////////////////////
+
+	class simd_itype16
+	{
+		friend class simd_type16;
+
+		public:
+			enum { cWidth = 16 };
+
+			inline simd_itype16() {}
+
+			inline simd_itype16(const int *pVec)
+				: xyzw(_mm512_loadu_si512(pVec))
+			{ }
+
+			inline simd_itype16(int i)
+				: xyzw(_mm512_set1_epi32(i))
+			{ }
+
+			inline simd_itype16(const __m512i& qword)
+				: xyzw(qword)
+			{ }
+
+			inline simd_itype16(int x, int y, int z, int w)
+				: xyzw(_mm512_broadcast_i32x4(_mm_set_epi32(x, y, z, w)))
+			{ }
+
+			inline simd_itype16 operator+(const simd_itype16 &rhs) const
+			{
+				return simd_itype16(_mm512_add_epi32(xyzw, rhs.xyzw));
+			}
+
+			inline simd_itype16 operator-(const simd_itype16 &rhs) const
+			{
+				return simd_itype16(_mm512_sub_epi32(xyzw, rhs.xyzw));
+			}
+
+			// low 32 bits of the product
+			inline simd_itype16 operator*(const simd_itype16 &rhs) const
+			{
+				return simd_itype16(_mm512_mullo_epi32(xyzw, rhs.xyzw));
+			}
+
+			inline simd_itype16& operator+=(const simd_itype16 &rhs)
+			{
+				xyzw = _mm512_add_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_itype16& operator-=(const simd_itype16 &rhs)
+			{
+				xyzw = _mm512_sub_epi32(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline void Store(int *pVec) const
+			{
+				_mm512_storeu_si512(pVec, xyzw);
+			}
+
+			// non-temporal, 64 byte aligned
+			inline void StoreStream(int *pVec) const
+			{
+				_mm512_stream_si512((__m512i*)pVec, xyzw);
+			}
+
+			static inline simd_itype16 VAnd(const simd_itype16& va, const simd_itype16& vb)
+			{
+				return simd_itype16(_mm512_and_si512(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype16 VOr(const simd_itype16& va, const simd_itype16& vb)
+			{
+				return simd_itype16(_mm512_or_si512(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_itype16 VXor(const simd_itype16& va, const simd_itype16& vb)
+			{
+				return simd_itype16(_mm512_xor_si512(va.xyzw, vb.xyzw));
+			}
+
+			// ~va & vb
+			static inline simd_itype16 VAndNot(const simd_itype16& va, const simd_itype16& vb)
+			{
+				return simd_itype16(_mm512_andnot_si512(va.xyzw, vb.xyzw));
+			}
+
+			template <int Count>
+			static inline simd_itype16 ShiftLeft(const simd_itype16& va)
+			{
+				return simd_itype16(_mm512_slli_epi32(va.xyzw, Count));
+			}
+
+			// arithmetic, keeps the sign
+			template <int Count>
+			static inline simd_itype16 ShiftRight(const simd_itype16& va)
+			{
+				return simd_itype16(_mm512_srai_epi32(va.xyzw, Count));
+			}
+
+			template <int Count>
+			static inline simd_itype16 ShiftRightLogical(const simd_itype16& va)
+			{
+				return simd_itype16(_mm512_srli_epi32(va.xyzw, Count));
+			}
+
+			// the 32 shorts va[0..15], vb[0..15], saturated
+			static inline simd_itype16 PackS16(const simd_itype16& va, const simd_itype16& vb)
+			{
+				return simd_itype16(_mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtsepi32_epi16(va.xyzw)), _mm512_cvtsepi32_epi16(vb.xyzw), 1));
+			}
+
+			// shorts 0-15 / 16-31 of a PackS16 result, sign extended
+			static inline simd_itype16 UnpackLoS16(const simd_itype16& va)
+			{
+				return simd_itype16(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(va.xyzw)));
+			}
+
+			static inline simd_itype16 UnpackHiS16(const simd_itype16& va)
+			{
+				return simd_itype16(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(va.xyzw, 1)));
+			}
+
+			// 16 shorts, sign extended
+			static inline simd_itype16 LoadS16(const short *p)
+			{
+				return simd_itype16(_mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)p)));
+			}
+
+			// 16 shorts, saturated
+			inline void StoreS16(short *p) const
+			{
+				_mm256_storeu_si256((__m256i*)p, _mm512_cvtsepi32_epi16(xyzw));
+			}
+
+		private:
+			__m512i	xyzw;
+	};
+
+	///////////////////////////////////////////
+	// SIMD CLASS 16-wide (AVX-512)
+	//	Same interface as simd_type8 on a __m512,
+	//	four Vec4 side by side. mask_type is a
+	//	k-register: the masked Load/Store and
+	//	Mask* arithmetic only touch the selected
+	//	lanes, so loop tails run vectorized. The
+	//	comparisons return one.
+	///////////////////////////////////////////
+
+	class simd_type16
+	{
+		public:
+			enum { cWidth = 16 };
+
+			typedef __mmask16	mask_type;
+
+			// the integer rep of the same width
+			typedef simd_itype16	int_type;
+
+			inline simd_type16() {}
+
+			inline simd_type16(float *pVec)
+				: xyzw(_mm512_loadu_ps(pVec))
+			{ }
+
+			inline simd_type16(float f)
+				: xyzw(_mm512_set1_ps(f))
+			{ }
+
+			inline simd_type16(const __m512& qword)
+				: xyzw(qword)
+			{ }
+
+			inline simd_type16(const __m128& a, const __m128& b, const __m128& c, const __m128& d)
+				: xyzw(_mm512_insertf32x4(_mm512_insertf32x4(_mm512_insertf32x4(_mm512_castps128_ps512(a), b, 1), c, 2), d, 3))
+			{ }
+
+			inline simd_type16(float x, float y, float z, float w)
+				: xyzw(_mm512_broadcast_f32x4(_mm_set_ps(x, y, z, w)))
+			{ }
+
+			inline simd_type16(const simd_type16& copy)
+				: xyzw(copy.xyzw)
+			{ }
+
+			inline simd_type16& operator= (const simd_type16& copy)
+			{
+				xyzw = copy.xyzw;
+
+				return *this;
+			}
+
+			inline simd_type16& operator+=(const simd_type16 &rhs)
+			{
+				xyzw = _mm512_add_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type16& operator-=(const simd_type16 &rhs)
+			{
+				xyzw = _mm512_sub_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type16& operator*=(const simd_type16 &rhs)
+			{
+				xyzw = _mm512_mul_ps(xyzw, rhs.xyzw);
+				return *this;
+			}
+
+			inline simd_type16 operator+(const simd_type16 &rhs) const
+			{
+				return simd_type16(_mm512_add_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type16 operator*(const simd_type16 &rhs) const
+			{
+				return simd_type16(_mm512_mul_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type16 operator-(const simd_type16 &rhs) const
+			{
+				return simd_type16(_mm512_sub_ps(xyzw, rhs.xyzw));
+			}
+
+			inline simd_type16 operator/(const simd_type16 &rhs) const
+			{
+				return simd_type16(_mm512_div_ps(xyzw, rhs.xyzw));
+			}
+
+			inline void Store(float *pVec) const
+			{
+				_mm512_storeu_ps(pVec, xyzw);
+			}
+
+			// non-temporal, 64 byte aligned
+			inline void StoreStream(float *pVec) const
+			{
+				_mm512_stream_ps(pVec, xyzw);
+			}
+
+			inline void Store(const mask_type& m, float *pVec) const
+			{
+				_mm512_mask_storeu_ps(pVec, m, xyzw);
+			}
+
+			// lanes past the mask read as 0 and never touch memory
+			static inline simd_type16 Load(const mask_type& m, float *pVec)
+			{
+				return simd_type16(_mm512_maskz_loadu_ps(m, pVec));
+			}
+
+			// first n float lanes
+			static inline mask_type TailMask(int n)
+			{
+				return (mask_type)(n >= 16 ? 0xffff : (n <= 0 ? 0 : (1 << n) - 1));
+			}
+
+			// 4 lane group G (0..3) as a __m128
+			template <int G>
+			inline __m128 Group() const
+			{
+				return G ? _mm512_extractf32x4_ps(xyzw, G) : _mm512_castps512_ps128(xyzw);
+			}
+
+			// masked arithmetic: lanes outside m keep src
+			static inline simd_type16 MaskAdd(const simd_type16& src, const mask_type& m, const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mask_add_ps(src.xyzw, m, va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 MaskSub(const simd_type16& src, const mask_type& m, const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mask_sub_ps(src.xyzw, m, va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 MaskMul(const simd_type16& src, const mask_type& m, const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mask_mul_ps(src.xyzw, m, va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 MaskDiv(const simd_type16& src, const mask_type& m, const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mask_div_ps(src.xyzw, m, va.xyzw, vb.xyzw));
+			}
+
+			inline void Bc()
+			{
+				xyzw = VSwizzle<3,3,3,3>(xyzw);
+			}
+
+			// split the Vec4 elements of (va, vb) into even {a0,a2,b0,b2} and odd {a1,a3,b1,b3}
+			static inline void Deinterleave(const simd_type16& va, const simd_type16& vb, simd_type16& even, simd_type16& odd)
+			{
+				even.xyzw = _mm512_shuffle_f32x4(va.xyzw, vb.xyzw, _MM_SHUFFLE(2,0,2,0));
+				odd.xyzw = _mm512_shuffle_f32x4(va.xyzw, vb.xyzw, _MM_SHUFFLE(3,1,3,1));
+			}
+
+			// inverse of Deinterleave
+			static inline void Interleave(const simd_type16& even, const simd_type16& odd, simd_type16& va, simd_type16& vb)
+			{
+				const __m512 t0 = _mm512_shuffle_f32x4(even.xyzw, odd.xyzw, _MM_SHUFFLE(1,0,1,0));
+				const __m512 t1 = _mm512_shuffle_f32x4(even.xyzw, odd.xyzw, _MM_SHUFFLE(3,2,3,2));
+
+				va.xyzw = _mm512_shuffle_f32x4(t0, t0, _MM_SHUFFLE(3,1,2,0));
+				vb.xyzw = _mm512_shuffle_f32x4(t1, t1, _MM_SHUFFLE(3,1,2,0));
+			}
+
+			static inline simd_type16 Dot(const simd_type16& va, const simd_type16& vb)
+			{
+				const __m512 t0 = _mm512_mul_ps(va.xyzw, vb.xyzw);
+				const __m512 t1 = VSwizzle<2,3,0,1>(t0);
+				const __m512 t2 = _mm512_add_ps(t0, t1);
+				const __m512 t3 = VSwizzle<1,0,3,2>(t2);
+				
+				return simd_type16(_mm512_add_ps(t3, t2));
+			}
+
+			// horizontal ops within each group of 4 lanes, as Dot
+			static inline simd_type16 HSum(const simd_type16& va)
+			{
+				const __m512 t0 = _mm512_add_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type16(_mm512_add_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type16 HProduct(const simd_type16& va)
+			{
+				const __m512 t0 = _mm512_mul_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type16(_mm512_mul_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type16 HMin(const simd_type16& va)
+			{
+				const __m512 t0 = _mm512_min_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type16(_mm512_min_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type16 HMax(const simd_type16& va)
+			{
+				const __m512 t0 = _mm512_max_ps(va.xyzw, VSwizzle<2,3,0,1>(va.xyzw));
+
+				return simd_type16(_mm512_max_ps(t0, VSwizzle<1,0,3,2>(t0)));
+			}
+
+			static inline simd_type16 Sqrt(const simd_type16& va)
+			{
+				return simd_type16(_mm512_sqrt_ps(va.xyzw));
+			}
+
+			static inline simd_type16 VAdd(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_add_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 VSub(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_sub_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 VMul(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mul_ps(va.xyzw, vb.xyzw));
+			}
+
+			// va*vb + vc, AVX-512F always has FMA
+			static inline simd_type16 VMAdd(const simd_type16& va, const simd_type16& vb, const simd_type16& vc)
+			{
+				return simd_type16(_mm512_fmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			}
+
+			// vc - va*vb
+			static inline simd_type16 VNMSub(const simd_type16& va, const simd_type16& vb, const simd_type16& vc)
+			{
+				return simd_type16(_mm512_fnmadd_ps(va.xyzw, vb.xyzw, vc.xyzw));
+			}
+
+			// 1/va: _mm512_rcp14_ps (14 bits) refined by Steps (0-2) Newton-Raphson steps
+			template <int Steps>
+			static inline simd_type16 VReciprocalEst(const simd_type16& va)
+			{
+				const simd_type16 one(1.f);
+				simd_type16 r(_mm512_rcp14_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r*(1 - va*r)
+					r = VMAdd(r, VNMSub(va, r, one), r);
+				}
+
+				return r;
+			}
+
+			// 1/sqrt(va): _mm512_rsqrt14_ps (14 bits) refined by Steps Newton-Raphson steps,
+			// a refined 1/sqrt(0) is NaN
+			template <int Steps>
+			static inline simd_type16 VRsqrtEst(const simd_type16& va)
+			{
+				const simd_type16 one(1.f);
+				const simd_type16 half(0.5f);
+				simd_type16 r(_mm512_rsqrt14_ps(va.xyzw));
+
+				for(int ii=0; ii<Steps; ii++)
+				{
+					// r += r/2*(1 - va*r*r)
+					r = VMAdd(VMul(half, r), VNMSub(VMul(va, r), r, one), r);
+				}
+
+				return r;
+			}
+
+			// range reduced transcendentals (vtranscendental.inl)
+			static inline simd_type16 Sin(const simd_type16& va)
+			{
+				return simd_type16(VTransSin(va.xyzw));
+			}
+
+			static inline simd_type16 Cos(const simd_type16& va)
+			{
+				return simd_type16(VTransCos(va.xyzw));
+			}
+
+			static inline void SinCos(const simd_type16& va, simd_type16& s, simd_type16& c)
+			{
+				VTransSinCos(va.xyzw, &s.xyzw, &c.xyzw);
+			}
+
+			static inline simd_type16 Exp(const simd_type16& va)
+			{
+				return simd_type16(VTransExp(va.xyzw));
+			}
+
+			static inline simd_type16 Log(const simd_type16& va)
+			{
+				return simd_type16(VTransLog(va.xyzw));
+			}
+
+			static inline simd_type16 Pow(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(VTransPow(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 Atan2(const simd_type16& vy, const simd_type16& vx)
+			{
+				return simd_type16(VTransAtan2(vy.xyzw, vx.xyzw));
+			}
+
+			static inline mask_type VCmpLt(const simd_type16& va, const simd_type16& vb)
+			{
+				return _mm512_cmp_ps_mask(va.xyzw, vb.xyzw, _CMP_LT_OQ);
+			}
+
+			static inline mask_type VCmpGt(const simd_type16& va, const simd_type16& vb)
+			{
+				return _mm512_cmp_ps_mask(va.xyzw, vb.xyzw, _CMP_GT_OQ);
+			}
+
+			static inline mask_type VCmpEq(const simd_type16& va, const simd_type16& vb)
+			{
+				return _mm512_cmp_ps_mask(va.xyzw, vb.xyzw, _CMP_EQ_OQ);
+			}
+
+			// vb where either is NaN
+			static inline simd_type16 VMin(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_min_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 VMax(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_max_ps(va.xyzw, vb.xyzw));
+			}
+
+			static inline simd_type16 VAbs(const simd_type16& va)
+			{
+				return simd_type16(_mm512_abs_ps(va.xyzw));
+			}
+
+			// m ? va : vb
+			static inline simd_type16 VSelect(const mask_type& m, const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_mask_blend_ps(m, vb.xyzw, va.xyzw));
+			}
+
+			static inline bool VAny(const mask_type& m)
+			{
+				return m != 0;
+			}
+
+			static inline bool VAll(const mask_type& m)
+			{
+				return m == 0xffff;
+			}
+
+			// NaN gives lo
+			static inline simd_type16 VClamp(const simd_type16& va, const simd_type16& lo, const simd_type16& hi)
+			{
+				return simd_type16(_mm512_min_ps(_mm512_max_ps(va.xyzw, lo.xyzw), hi.xyzw));
+			}
+
+			// round to nearest (the MXCSR mode)
+			static inline simd_itype16 VConvertToInt(const simd_type16& va)
+			{
+				return simd_itype16(_mm512_cvtps_epi32(va.xyzw));
+			}
+
+			// round toward zero, as a C cast
+			static inline simd_itype16 VTruncateToInt(const simd_type16& va)
+			{
+				return simd_itype16(_mm512_cvttps_epi32(va.xyzw));
+			}
+
+			static inline simd_type16 VConvertFromInt(const simd_itype16& va)
+			{
+				return simd_type16(_mm512_cvtepi32_ps(va.xyzw));
+			}
+
+			// (v[X], v[Y], v[Z], v[W]) in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type16 Swizzle(const simd_type16& v)
+			{
+				return simd_type16(VSwizzle<X,Y,Z,W>(v.xyzw));
+			}
+
+			// lanes 0-3 of va, 4-7 of vb in every 128 bit lane
+			template <int X, int Y, int Z, int W>
+			static inline simd_type16 Permute(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(VPermute<X,Y,Z,W>(va.xyzw, vb.xyzw));
+			}
+
+			// (va[X], va[Y], vb[Z], vb[W]) in every 128 bit lane, as _mm_shuffle_ps
+			template <int X, int Y, int Z, int W>
+			static inline simd_type16 Shuffle(const simd_type16& va, const simd_type16& vb)
+			{
+				return simd_type16(_mm512_shuffle_ps(va.xyzw, vb.xyzw, _MM_SHUFFLE(W,Z,Y,X)));
+			}
+
+			// the float with bit pattern Bits in every lane
+			template <unsigned int Bits>
+			static inline simd_type16 Const()
+			{
+				return simd_type16(_mm512_castsi512_ps(_mm512_set1_epi32((int)Bits)));
+			}
+
+			// 4 floats (16 byte aligned) into every 128 bit lane
+			static inline simd_type16 Load4(const float *p4)
+			{
+				return simd_type16(_mm512_broadcast_f32x4(_mm_load_ps(p4)));
+			}
+
+			// the first 128 bit lane
+			static inline void Store4(float *p4, const simd_type16& v)
+			{
+				_mm_store_ps(p4, _mm512_castps512_ps128(v.xyzw));
+			}
+
+			static inline void GetX(float *p, const simd_type16& v)
+			{
+				_mm_store_ss(p, _mm512_castps512_ps128(v.xyzw));
+			}
+
+		private:
+			__m512	xyzw;
+	};
+#endif // #if defined(VCLASS_SIMDTYPE_AVX512)
+
+	///////////////////////////////////////////
+	// Vec4
+	///////////////////////////////////////////
+
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+	#include "vclass_expr.inl"
+#endif
+
+	template <typename Real, typename Rep>
+	class vector4
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+		: public VExpr< vector4<Real, Rep> >
+#endif
+	{
+		public:
+			enum { cWidth = Rep::cWidth };
+
+			typedef Rep	rep_type;
+			typedef typename Rep::int_type	int_type;
+
+			inline vector4() { }
+
+			inline vector4(Real *pVec)
+				: _rep(pVec)
+			{ }
+
+			inline vector4(Real f)
+				: _rep(f)
+			{ }
+
+			inline vector4(Real x, Real y, Real z, Real w)
+				: _rep(x, y, z, w)
+			{ }
+
+			inline vector4(const Rep& rep)
+				: _rep(rep)
+			{ }
+
+			inline vector4(const vector4& copy)
+				: _rep(copy._rep)
+			{ }
+
+			// float <-> double of the same width (Vec4 and Vec4d)
+			template <typename Real2, typename Rep2>
+			inline explicit vector4(const vector4<Real2, Rep2>& v)
+				: _rep(v._rep)
+			{ }
+
+			inline vector4& operator= (const vector4& copy)
+			{
+				_rep = copy._rep;
+
+				return *this;
+			}
+
+#if defined(VCLASS_EXPRESSION_TEMPLATES)
+			typedef Rep					value_type;
+			typedef Real				scalar_type;
+			typedef const vector4&		operand_type;
+
+			template <typename E>
+			inline vector4(const VExpr<E>& e)
+				: _rep(e.Self().Eval())
+			{ }
+
+			template <typename E>
+			inline vector4& operator= (const VExpr<E>& e)
+			{
+				_rep = e.Self().Eval();
+
+				return *this;
+			}
+
+			template <typename E>
+			inline vector4& operator+= (const VExpr<E>& e)
+			{
+				_rep += e.Self().Eval();
+
+				return *this;
+			}
+
+			template <typename E>
+			inline vector4& operator-= (const VExpr<E>& e)
+			{
+				_rep -= e.Self().Eval();
+
+				return *this;
+			}
+
+			template <typename E>
+			inline vector4& operator*= (const VExpr<E>& e)
+			{
+				_rep *= e.Self().Eval();
+
+				return *this;
+			}
+
+			inline const Rep& Eval() const
+			{
+				return _rep;
+			}
+#else
+			inline vector4& operator+= (const vector4& rhs)
+			{
+				_rep += rhs._rep;
+
+				return *this;
+			}
+
+			inline vector4& operator-= (const vector4& rhs)
+			{
+				_rep -= rhs._rep;
+
+				return *this;
+			}
+
+			inline vector4& operator*= (const vector4& rhs)
+			{
+				_rep *= rhs._rep;
+
+				return *this;
+			}
+
+			inline vector4 operator+ (const vector4& rhs) const
+			{
+				return vector4(_rep + rhs._rep);
+			}
+
+			inline vector4 operator- (const vector4& rhs) const
+			{
+				return vector4(_rep - rhs._rep);
+			}
+
+			inline vector4 operator* (const vector4& rhs) const
+			{
+				return vector4(_rep * rhs._rep);
+			}
+
+			inline vector4 operator/ (const vector4& rhs) const
+			{
+				return vector4(_rep / rhs._rep);
+			}
+#endif
+
+			inline void Store(Real *pVec) const
+			{
+				_rep.Store(pVec);
+			}
+
+			// around the cache, aligned to the rep width, StoreFence before
+			// anyone else reads it
+			inline void StoreStream(Real *pVec) const
+			{
+				_rep.StoreStream(pVec);
+			}
+
+			static inline void StoreFence()
+			{
+				_mm_sfence();
+			}
+
+			// T0 every cache level, T1 L2 and out, NTA least evicting
+			static inline void PrefetchT0(const void *p)
+			{
+				_mm_prefetch((const char*)p, _MM_HINT_T0);
+			}
+
+			static inline void PrefetchT1(const void *p)
+			{
+				_mm_prefetch((const char*)p, _MM_HINT_T1);
+			}
+
+			static inline void PrefetchNTA(const void *p)
+			{
+				_mm_prefetch((const char*)p, _MM_HINT_NTA);
+			}
+
+			// masked Load/Store for the wide reps (Mask is rep_type::mask_type)
+			template <typename Mask>
+			inline void Store(const Mask& m, Real *pVec) const
+			{
+				_rep.Store(m, pVec);
+			}
+
+			template <typename Mask>
+			static inline vector4 Load(const Mask& m, Real *pVec)
+			{
+				return vector4(Rep::Load(m, pVec));
+			}
+
+			// 4 lane group G of the wide reps
+			template <int G>
+			inline __m128 Group() const
+			{
+				return _rep.template Group<G>();
+			}
+
+			static inline void Deinterleave(const vector4& va, const vector4& vb, vector4& even, vector4& odd)
+			{
+				Rep::Deinterleave(va._rep, vb._rep, even._rep, odd._rep);
+			}
+
+			static inline void Interleave(const vector4& even, const vector4& odd, vector4& va, vector4& vb)
+			{
+				Rep::Interleave(even._rep, odd._rep, va._rep, vb._rep);
+			}
+
+			inline void Bc()
+			{
+				_rep.Bc();
+			}
+
+			static inline vector4 Dot(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::Dot(va._rep, vb._rep));
+			}
+
+			static inline vector4 HSum(const vector4& va)
+			{
+				return vector4(Rep::HSum(va._rep));
+			}
+
+			static inline vector4 HProduct(const vector4& va)
+			{
+				return vector4(Rep::HProduct(va._rep));
+			}
+
+			static inline vector4 HMin(const vector4& va)
+			{
+				return vector4(Rep::HMin(va._rep));
+			}
+
+			static inline vector4 HMax(const vector4& va)
+			{
+				return vector4(Rep::HMax(va._rep));
+			}
+
+			static inline vector4 Sqrt(const vector4& va)
+			{
+				return vector4(Rep::Sqrt(va._rep));
+			}
+
+			static inline vector4 VAdd(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VAdd(va._rep, vb._rep));
+			}
+
+			static inline vector4 VSub(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VSub(va._rep, vb._rep));
+			}
+
+			static inline vector4 VMul(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VMul(va._rep, vb._rep));
+			}
+
+			static inline vector4 VMAdd(const vector4& va, const vector4& vb, const vector4& vc)
+			{
+				return vector4(Rep::VMAdd(va._rep, vb._rep, vc._rep));
+			}
+
+			static inline vector4 VNMSub(const vector4& va, const vector4& vb, const vector4& vc)
+			{
+				return vector4(Rep::VNMSub(va._rep, vb._rep, vc._rep));
+			}
+
+			template <int Steps>
+			static inline vector4 VReciprocalEst(const vector4& va)
+			{
+				return vector4(Rep::template VReciprocalEst<Steps>(va._rep));
+			}
+
+			template <int Steps>
+			static inline vector4 VRsqrtEst(const vector4& va)
+			{
+				return vector4(Rep::template VRsqrtEst<Steps>(va._rep));
+			}
+
+			static inline vector4 Sin(const vector4& va)
+			{
+				return vector4(Rep::Sin(va._rep));
+			}
+
+			static inline vector4 Cos(const vector4& va)
+			{
+				return vector4(Rep::Cos(va._rep));
+			}
+
+			static inline void SinCos(const vector4& va, vector4& s, vector4& c)
+			{
+				Rep::SinCos(va._rep, s._rep, c._rep);
+			}
+
+			static inline vector4 Exp(const vector4& va)
+			{
+				return vector4(Rep::Exp(va._rep));
+			}
+
+			static inline vector4 Log(const vector4& va)
+			{
+				return vector4(Rep::Log(va._rep));
+			}
+
+			static inline vector4 Pow(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::Pow(va._rep, vb._rep));
+			}
+
+			static inline vector4 Atan2(const vector4& vy, const vector4& vx)
+			{
+				return vector4(Rep::Atan2(vy._rep, vx._rep));
+			}
+
+			// Rep::mask_type: a vector with every bit of a lane set or clear, or on
+			// simd_type16 an __mmask16 with one bit per lane
+			static inline typename Rep::mask_type VCmpLt(const vector4& va, const vector4& vb)
+			{
+				return Rep::VCmpLt(va._rep, vb._rep);
+			}
+
+			static inline typename Rep::mask_type VCmpGt(const vector4& va, const vector4& vb)
+			{
+				return Rep::VCmpGt(va._rep, vb._rep);
+			}
+
+			static inline typename Rep::mask_type VCmpEq(const vector4& va, const vector4& vb)
+			{
+				return Rep::VCmpEq(va._rep, vb._rep);
+			}
+
+			static inline vector4 VMin(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VMin(va._rep, vb._rep));
+			}
+
+			static inline vector4 VMax(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VMax(va._rep, vb._rep));
+			}
+
+			static inline vector4 VAbs(const vector4& va)
+			{
+				return vector4(Rep::VAbs(va._rep));
+			}
+
+			static inline vector4 VSelect(const typename Rep::mask_type& m, const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::VSelect(m, va._rep, vb._rep));
+			}
+
+			static inline bool VAny(const typename Rep::mask_type& m)
+			{
+				return Rep::VAny(m);
+			}
+
+			static inline bool VAll(const typename Rep::mask_type& m)
+			{
+				return Rep::VAll(m);
+			}
+
+			static inline vector4 VClamp(const vector4& va, const vector4& lo, const vector4& hi)
+			{
+				return vector4(Rep::VClamp(va._rep, lo._rep, hi._rep));
+			}
+
+			static inline int_type VConvertToInt(const vector4& va)
+			{
+				return Rep::VConvertToInt(va._rep);
+			}
+
+			static inline int_type VTruncateToInt(const vector4& va)
+			{
+				return Rep::VTruncateToInt(va._rep);
+			}
+
+			static inline vector4 VConvertFromInt(const int_type& va)
+			{
+				return vector4(Rep::VConvertFromInt(va));
+			}
+
+			template <int X, int Y, int Z, int W>
+			static inline vector4 Swizzle(const vector4& v)
+			{
+				return vector4(Rep::template Swizzle<X,Y,Z,W>(v._rep));
+			}
+
+			template <int X, int Y, int Z, int W>
+			static inline vector4 Permute(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::template Permute<X,Y,Z,W>(va._rep, vb._rep));
+			}
+
+			template <int X, int Y, int Z, int W>
+			static inline vector4 Shuffle(const vector4& va, const vector4& vb)
+			{
+				return vector4(Rep::template Shuffle<X,Y,Z,W>(va._rep, vb._rep));
+			}
+
+			// Bits is the pattern of a float, Const<0x3f800000>() is 1 (widened on
+			// Vec4d). A compile time constant, no static to initialize
+			template <unsigned int Bits>
+			static inline vector4 Const()
+			{
+				return vector4(Rep::template Const<Bits>());
+			}
+
+			static inline vector4 Load4(const Real *p4)
+			{
+				return vector4(Rep::Load4(p4));
+			}
+
+			inline void Store4(Real *p4) const
+			{
+				Rep::Store4(p4, _rep);
+			}
+
+			// Vec4d also stores to a float
+			template <typename T>
+			static inline void GetX(T *p, const vector4& v)
+			{
+				Rep::GetX(p, v._rep);
+			}
+
+		private:
+			template <typename, typename> friend class vector4;
+
+			Rep _rep;
+	} ;
+
+	typedef vector4<float, simd_type> Vec4;
+	typedef simd_itype IVec4;
+	typedef vector4<double, simd_dtype> Vec4d;
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+	typedef vector4<float, simd_type8> Vec8;
+	typedef simd_itype8 IVec8;
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	typedef vector4<float, simd_type16> Vec16;
+	typedef simd_itype16 IVec16;
+#endif
+
+	///////////////////////////////////////////
+	// Mat4
+	//	4 row vector4, same layout and convention
+	//	as D3DXMATRIX and VMATH::Mat4 (v*M,
+	//	translation in row 3, Mul(a, b) is a
+	//	then b). Only in-lane shuffles, so on
+	//	the wide reps every 128 bit lane holds
+	//	a copy of the matrix and one Vec8/Vec16
+	//	transforms 2/4 points.
+	///////////////////////////////////////////
+
+	template <typename Real, typename Rep>
+	class matrix4
+	{
+		public:
+			typedef vector4<Real, Rep>	vector_type;
+
+			inline matrix4() { }
+
+			// 16 floats, 16 byte aligned
+			inline matrix4(const Real *pMat)
+			{
+				_r[0] = vector_type::Load4(pMat);
+				_r[1] = vector_type::Load4(pMat + 4);
+				_r[2] = vector_type::Load4(pMat + 8);
+				_r[3] = vector_type::Load4(pMat + 12);
+			}
+
+			inline matrix4(const vector_type& r0, const vector_type& r1, const vector_type& r2, const vector_type& r3)
+			{
+				_r[0] = r0;
+				_r[1] = r1;
+				_r[2] = r2;
+				_r[3] = r3;
+			}
+
+			inline const vector_type& operator[] (int row) const
+			{
+				return _r[row];
+			}
+
+			inline vector_type& operator[] (int row)
+			{
+				return _r[row];
+			}
+
+			// 16 floats (16 byte aligned) from the first 128 bit lane
+			inline void Store(Real *pMat) const
+			{
+				_r[0].Store4(pMat);
+				_r[1].Store4(pMat + 4);
+				_r[2].Store4(pMat + 8);
+				_r[3].Store4(pMat + 12);
+			}
+
+			static inline matrix4 Identity()
+			{
+				__declspec(align(16)) static const Real cIdentity[16] =
+				{
+					1, 0, 0, 0,
+					0, 1, 0, 0,
+					0, 0, 1, 0,
+					0, 0, 0, 1,
+				};
+
+				return matrix4(cIdentity);
+			}
+
+			// v*m
+			static inline vector_type Transform(const vector_type& v, const matrix4& m)
+			{
+				return Transform(v, m._r[0], m._r[1], m._r[2], m._r[3]);
+			}
+
+			// ma*mb
+			static inline matrix4 Mul(const matrix4& ma, const matrix4& mb)
+			{
+				return matrix4(Transform(ma._r[0], mb), Transform(ma._r[1], mb), Transform(ma._r[2], mb), Transform(ma._r[3], mb));
+			}
+
+			static inline matrix4 Transpose(const matrix4& m)
+			{
+				return Transpose(m._r[0], m._r[1], m._r[2], m._r[3]);
+			}
+
+			// Inverse of a matrix whose 4th column is (0,0,0,1), see VMATH::MInverseAffine
+			static inline matrix4 InverseAffine(const matrix4& m)
+			{
+				const vector_type one(1.f);
+
+				vector_type c0 = Cross(m._r[1], m._r[2]);
+				vector_type c1 = Cross(m._r[2], m._r[0]);
+				vector_type c2 = Cross(m._r[0], m._r[1]);
+				vector_type rdet = vector_type::Dot(m._r[0], c0);
+
+				rdet = one / rdet;
+
+				matrix4 r = Transpose(vector_type::VMul(c0, rdet), vector_type::VMul(c1, rdet), vector_type::VMul(c2, rdet), vector_type(0.f));
+
+				// -p*inverse(3x3), w = 1
+				const vector_type& p = m._r[3];
+
+				vector_type t = vector_type::VNMSub(vector_type::template Swizzle<0,0,0,0>(p), r._r[0], Identity()._r[3]);
+				t = vector_type::VNMSub(vector_type::template Swizzle<1,1,1,1>(p), r._r[1], t);
+				r._r[3] = vector_type::VNMSub(vector_type::template Swizzle<2,2,2,2>(p), r._r[2], t);
+
+				return r;
+			}
+
+			// General inverse by 2x2 blocks, see VMATH::MInverse. A singular m gives inf/NaN.
+			static inline matrix4 Inverse(const matrix4& m)
+			{
+				const vector_type& r0 = m._r[0];
+				const vector_type& r1 = m._r[1];
+				const vector_type& r2 = m._r[2];
+				const vector_type& r3 = m._r[3];
+
+				vector_type A = vector_type::template Permute<0,1,4,5>(r0, r1);
+				vector_type B = vector_type::template Permute<2,3,6,7>(r0, r1);
+				vector_type C = vector_type::template Permute<0,1,4,5>(r2, r3);
+				vector_type D = vector_type::template Permute<2,3,6,7>(r2, r3);
+
+				// (|A|, |B|, |C|, |D|)
+				vector_type detSub = vector_type::VNMSub(vector_type::template Permute<1,3,5,7>(r0, r2), vector_type::template Permute<0,2,4,6>(r1, r3),
+					vector_type::VMul(vector_type::template Permute<0,2,4,6>(r0, r2), vector_type::template Permute<1,3,5,7>(r1, r3)));
+
+				vector_type detA = vector_type::template Swizzle<0,0,0,0>(detSub);
+				vector_type detB = vector_type::template Swizzle<1,1,1,1>(detSub);
+				vector_type detC = vector_type::template Swizzle<2,2,2,2>(detSub);
+				vector_type detD = vector_type::template Swizzle<3,3,3,3>(detSub);
+
+				vector_type D_C = M2AdjMul(D, C);
+				vector_type A_B = M2AdjMul(A, B);
+
+				// adjugates of the blocks of the inverse (X Y / Z W)
+				vector_type X_ = vector_type::VSub(vector_type::VMul(detD, A), M2Mul(B, D_C));
+				vector_type W_ = vector_type::VSub(vector_type::VMul(detA, D), M2Mul(C, A_B));
+				vector_type Y_ = vector_type::VSub(vector_type::VMul(detB, C), M2MulAdj(D, A_B));
+				vector_type Z_ = vector_type::VSub(vector_type::VMul(detC, B), M2MulAdj(A, D_C));
+
+				// |m| = |A||D| + |B||C| - tr((A#B)(D#C))
+				vector_type det = vector_type::VMAdd(detB, detC, vector_type::VMul(detA, detD));
+				det = vector_type::VSub(det, vector_type::Dot(A_B, vector_type::template Swizzle<0,2,1,3>(D_C)));
+
+				__declspec(align(16)) static const Real cSign[4] = { 1, -1, -1, 1 };
+
+				vector_type rdet = vector_type::Load4(cSign) / det;
+
+				X_ = vector_type::VMul(X_, rdet);
+				Y_ = vector_type::VMul(Y_, rdet);
+				Z_ = vector_type::VMul(Z_, rdet);
+				W_ = vector_type::VMul(W_, rdet);
+
+				return matrix4(vector_type::template Permute<3,1,7,5>(X_, Y_), vector_type::template Permute<2,0,6,4>(X_, Y_),
+					vector_type::template Permute<3,1,7,5>(Z_, W_), vector_type::template Permute<2,0,6,4>(Z_, W_));
+			}
+
+			// pOut[ii] = pIn[ii]*m for count vectors (cWidth/4 points each), pOut may be pIn.
+			// The rows are copied to locals so they stay in registers across the stores.
+			static inline void TransformPoints(const matrix4& m, const vector_type *pIn, vector_type *pOut, int count)
+			{
+				const vector_type r0 = m._r[0];
+				const vector_type r1 = m._r[1];
+				const vector_type r2 = m._r[2];
+				const vector_type r3 = m._r[3];
+
+				for(int ii=0; ii<count; ii++)
+				{
+					pOut[ii] = Transform(pIn[ii], r0, r1, r2, r3);
+				}
+			}
+
+		private:
+			static inline vector_type Transform(const vector_type& v, const vector_type& r0, const vector_type& r1, const vector_type& r2, const vector_type& r3)
+			{
+				// two independent chains, x*r0 + y*r1 and z*r2 + w*r3
+				vector_type xy = vector_type::VMAdd(vector_type::template Swizzle<1,1,1,1>(v), r1, vector_type::VMul(vector_type::template Swizzle<0,0,0,0>(v), r0));
+				vector_type zw = vector_type::VMAdd(vector_type::template Swizzle<3,3,3,3>(v), r3, vector_type::VMul(vector_type::template Swizzle<2,2,2,2>(v), r2));
+
+				return vector_type::VAdd(xy, zw);
+			}
+
+			static inline matrix4 Transpose(const vector_type& r0, const vector_type& r1, const vector_type& r2, const vector_type& r3)
+			{
+				vector_type t0 = vector_type::template Permute<0,1,4,5>(r0, r1);		// x0 y0 x1 y1
+				vector_type t1 = vector_type::template Permute<2,3,6,7>(r0, r1);		// z0 w0 z1 w1
+				vector_type t2 = vector_type::template Permute<0,1,4,5>(r2, r3);		// x2 y2 x3 y3
+				vector_type t3 = vector_type::template Permute<2,3,6,7>(r2, r3);		// z2 w2 z3 w3
+
+				return matrix4(vector_type::template Permute<0,2,4,6>(t0, t2), vector_type::template Permute<1,3,5,7>(t0, t2),
+					vector_type::template Permute<0,2,4,6>(t1, t3), vector_type::template Permute<1,3,5,7>(t1, t3));
+			}
+
+			// va x vb, w = 0
+			static inline vector_type Cross(const vector_type& va, const vector_type& vb)
+			{
+				return vector_type::VNMSub(vector_type::template Swizzle<2,0,1,3>(va), vector_type::template Swizzle<1,2,0,3>(vb),
+					vector_type::VMul(vector_type::template Swizzle<1,2,0,3>(va), vector_type::template Swizzle<2,0,1,3>(vb)));
+			}
+
+			// 2x2 matrices (x y / z w) in one vector, for Inverse
+			// va*vb
+			static inline vector_type M2Mul(const vector_type& va, const vector_type& vb)
+			{
+				return vector_type::VMAdd(va, vector_type::template Swizzle<0,3,0,3>(vb),
+					vector_type::VMul(vector_type::template Swizzle<1,0,3,2>(va), vector_type::template Swizzle<2,1,2,1>(vb)));
+			}
+
+			// adjugate(va)*vb
+			static inline vector_type M2AdjMul(const vector_type& va, const vector_type& vb)
+			{
+				return vector_type::VNMSub(vector_type::template Swizzle<1,1,2,2>(va), vector_type::template Swizzle<2,3,0,1>(vb),
+					vector_type::VMul(vector_type::template Swizzle<3,3,0,0>(va), vb));
+			}
+
+			// va*adjugate(vb)
+			static inline vector_type M2MulAdj(const vector_type& va, const vector_type& vb)
+			{
+				return vector_type::VNMSub(vector_type::template Swizzle<1,0,3,2>(va), vector_type::template Swizzle<2,1,2,1>(vb),
+					vector_type::VMul(va, vector_type::template Swizzle<3,0,3,0>(vb)));
+			}
+
+			vector_type	_r[4];
+	} ;
+
+	typedef matrix4<float, simd_type> Mat4;
+
+#if defined(VCLASS_SIMDTYPE_AVX)
+	typedef matrix4<float, simd_type8> Mat8;
+#endif
+
+#if defined(VCLASS_SIMDTYPE_AVX512)
+	typedef matrix4<float, simd_type16> Mat16;
+#endif
 }
 
 #endif
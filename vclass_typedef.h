@@ -1,6 +1,18 @@
 #ifndef __VCLASS_TYPEDEF__
 #define __VCLASS_TYPEDEF__
 
+///////////////////////////////////////////////////////////////////////////////
+//	SIMD_FMA - VMAdd/VNMSub compile to a single fused multiply-add when the
+//	compiler targets FMA (-mfma, /arch:AVX2), to mul + add/sub otherwise.
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(SIMD_FMA) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SIMD_FMA
+#endif
+
+#if defined(SIMD_FMA) || defined(__SSE3__) || defined(__AVX__)
+	#include <immintrin.h>
+#endif
+
 namespace VCLASS_TYPEDEF
 {
 	///////////////////////////////////////////
@@ -20,6 +32,13 @@ namespace VCLASS_TYPEDEF
 		return _mm_set_ps1(f);
 	}
 
+	// the float with bit pattern Bits in every lane, a compile time constant
+	template <unsigned int Bits>
+	inline simd_type VBConst()
+	{
+		return _mm_castsi128_ps(_mm_set1_epi32((int)Bits));
+	}
+
 	inline simd_type VLoad(float x, float y, float z, float w)
 	{
 		return _mm_set_ps(x, y, z, w);
@@ -45,26 +64,190 @@ namespace VCLASS_TYPEDEF
 		return _mm_div_ps(va, vb);
 	}
 
+	// va*vb + vc
+	inline simd_type VBMAdd(simd_param va, simd_param vb, simd_param vc)
+	{
+	#if defined(SIMD_FMA)
+		return _mm_fmadd_ps(va, vb, vc);
+	#else
+		return _mm_add_ps(_mm_mul_ps(va, vb), vc);
+	#endif
+	}
+
+	// vc - va*vb
+	inline simd_type VBNMSub(simd_param va, simd_param vb, simd_param vc)
+	{
+	#if defined(SIMD_FMA)
+		return _mm_fnmadd_ps(va, vb, vc);
+	#else
+		return _mm_sub_ps(vc, _mm_mul_ps(va, vb));
+	#endif
+	}
+
+	// 1/va: _mm_rcp_ps (12 bits) refined by Steps (0-2) Newton-Raphson steps
+	template <int Steps>
+	inline simd_type VBReciprocalEst(simd_param va)
+	{
+		const simd_type one = _mm_set_ps1(1.f);
+		simd_type r = _mm_rcp_ps(va);
+
+		for(int ii=0; ii<Steps; ii++)
+		{
+			// r += r*(1 - va*r)
+			r = VBMAdd(r, VBNMSub(va, r, one), r);
+		}
+
+		return r;
+	}
+
+	// 1/sqrt(va): _mm_rsqrt_ps (12 bits) refined by Steps Newton-Raphson steps,
+	// a refined 1/sqrt(0) is NaN
+	template <int Steps>
+	inline simd_type VBRsqrtEst(simd_param va)
+	{
+		const simd_type one = _mm_set_ps1(1.f);
+		const simd_type half = _mm_set_ps1(0.5f);
+		simd_type r = _mm_rsqrt_ps(va);
+
+		for(int ii=0; ii<Steps; ii++)
+		{
+			// r += r/2*(1 - va*r*r)
+			r = VBMAdd(_mm_mul_ps(half, r), VBNMSub(_mm_mul_ps(va, r), r, one), r);
+		}
+
+		return r;
+	}
+
 	inline void VBStore(float *pVec, simd_param v)
 	{
 		return _mm_store_ps(pVec, v);
 	}
 
+	// non-temporal, 16 byte aligned
+	inline void VBStoreStream(float *pVec, simd_param v)
+	{
+		_mm_stream_ps(pVec, v);
+	}
+
+	// masks: every bit of a lane set (true) or clear (false)
+	inline simd_type VBCmpLt(simd_param va, simd_param vb)
+	{
+		return _mm_cmplt_ps(va, vb);
+	}
+
+	inline simd_type VBCmpGt(simd_param va, simd_param vb)
+	{
+		return _mm_cmpgt_ps(va, vb);
+	}
+
+	inline simd_type VBCmpEq(simd_param va, simd_param vb)
+	{
+		return _mm_cmpeq_ps(va, vb);
+	}
+
+	// vb where either is NaN
+	inline simd_type VBMin(simd_param va, simd_param vb)
+	{
+		return _mm_min_ps(va, vb);
+	}
+
+	inline simd_type VBMax(simd_param va, simd_param vb)
+	{
+		return _mm_max_ps(va, vb);
+	}
+
+	inline simd_type VBAbs(simd_param v)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+	}
+
+	// mask ? va : vb
+	inline simd_type VBSelect(simd_param mask, simd_param va, simd_param vb)
+	{
+	#if defined(__SSE4_1__) || defined(__AVX__)
+		return _mm_blendv_ps(vb, va, mask);
+	#else
+		return _mm_or_ps(_mm_and_ps(mask, va), _mm_andnot_ps(mask, vb));
+	#endif
+	}
+
+	inline bool VBAny(simd_param mask)
+	{
+		return _mm_movemask_ps(mask) != 0;
+	}
+
+	inline bool VBAll(simd_param mask)
+	{
+		return _mm_movemask_ps(mask) == 0xf;
+	}
+
+	// NaN gives lo
+	inline simd_type VBClamp(simd_param v, simd_param lo, simd_param hi)
+	{
+		return VBMin(VBMax(v, lo), hi);
+	}
+
+	// VBSwizzle/VBPermute, see vswizzle.inl
+	#include "vswizzle.inl"
+
+	// (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W>
+	inline simd_type VBSwizzle(simd_param v)
+	{
+		return VSwizzle<X,Y,Z,W>(v);
+	}
+
+	// lanes 0-3 of va, 4-7 of vb
+	template <int X, int Y, int Z, int W>
+	inline simd_type VBPermute(simd_param va, simd_param vb)
+	{
+		return VPermute<X,Y,Z,W>(va, vb);
+	}
+
 	inline simd_type VBc(simd_param v)
 	{
-		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3));
+		return VBSwizzle<3,3,3,3>(v);
 	}
 
 	inline simd_type VBDot(simd_param va, simd_param vb)
 	{
 		const simd_type t0 = _mm_mul_ps(va, vb);
-		const simd_type t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1,0,3,2));
+		const simd_type t1 = VBSwizzle<2,3,0,1>(t0);
 		const simd_type t2 = _mm_add_ps(t0, t1);
-		const simd_type t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2,3,0,1));
+		const simd_type t3 = VBSwizzle<1,0,3,2>(t2);
 
 		return _mm_add_ps(t3, t2);
 	}
 
+	// horizontal add/mul/min/max of the 4 lanes, replicated in all 4
+	inline simd_type VBHSum(simd_param v)
+	{
+		const simd_type t0 = _mm_add_ps(v, VBSwizzle<2,3,0,1>(v));
+
+		return _mm_add_ps(t0, VBSwizzle<1,0,3,2>(t0));
+	}
+
+	inline simd_type VBHProduct(simd_param v)
+	{
+		const simd_type t0 = _mm_mul_ps(v, VBSwizzle<2,3,0,1>(v));
+
+		return _mm_mul_ps(t0, VBSwizzle<1,0,3,2>(t0));
+	}
+
+	inline simd_type VBHMin(simd_param v)
+	{
+		const simd_type t0 = _mm_min_ps(v, VBSwizzle<2,3,0,1>(v));
+
+		return _mm_min_ps(t0, VBSwizzle<1,0,3,2>(t0));
+	}
+
+	inline simd_type VBHMax(simd_param v)
+	{
+		const simd_type t0 = _mm_max_ps(v, VBSwizzle<2,3,0,1>(v));
+
+		return _mm_max_ps(t0, VBSwizzle<1,0,3,2>(t0));
+	}
+
 	inline simd_type VBSqrt(simd_param v)
 	{
 		return _mm_sqrt_ps(v);
@@ -167,16 +350,48 @@ namespace VCLASS_TYPEDEF
 				VBStore(pVec, _rep);
 			}
 
+			inline void StoreStream(Real *pVec) const
+			{
+				VBStoreStream(pVec, _rep);
+			}
+
 			inline void Bc()
 			{
 				VBc(_rep);
 			}
 
+			// Const<0x3f800000>() is 1
+			template <unsigned int Bits>
+			static inline vector4 Const()
+			{
+				return vector4(VBConst<Bits>());
+			}
+
 			static inline vector4 Dot(const vector4& va, const vector4& vb)
 			{
 				return vector4(VBDot(va._rep, vb._rep));
 			}
 
+			static inline vector4 HSum(const vector4& va)
+			{
+				return vector4(VBHSum(va._rep));
+			}
+
+			static inline vector4 HProduct(const vector4& va)
+			{
+				return vector4(VBHProduct(va._rep));
+			}
+
+			static inline vector4 HMin(const vector4& va)
+			{
+				return vector4(VBHMin(va._rep));
+			}
+
+			static inline vector4 HMax(const vector4& va)
+			{
+				return vector4(VBHMax(va._rep));
+			}
+
 			static inline vector4 Sqrt(const vector4& va)
 			{
 				return vector4(VBSqrt(va._rep));
@@ -197,6 +412,90 @@ namespace VCLASS_TYPEDEF
 				return vector4(VBMul(va._rep, vb._rep));
 			}
 
+			static inline vector4 VMAdd(const vector4& va, const vector4& vb, const vector4& vc)
+			{
+				return vector4(VBMAdd(va._rep, vb._rep, vc._rep));
+			}
+
+			static inline vector4 VNMSub(const vector4& va, const vector4& vb, const vector4& vc)
+			{
+				return vector4(VBNMSub(va._rep, vb._rep, vc._rep));
+			}
+
+			template <int Steps>
+			static inline vector4 VReciprocalEst(const vector4& va)
+			{
+				return vector4(VBReciprocalEst<Steps>(va._rep));
+			}
+
+			template <int Steps>
+			static inline vector4 VRsqrtEst(const vector4& va)
+			{
+				return vector4(VBRsqrtEst<Steps>(va._rep));
+			}
+
+			static inline vector4 VCmpLt(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBCmpLt(va._rep, vb._rep));
+			}
+
+			static inline vector4 VCmpGt(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBCmpGt(va._rep, vb._rep));
+			}
+
+			static inline vector4 VCmpEq(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBCmpEq(va._rep, vb._rep));
+			}
+
+			static inline vector4 VMin(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBMin(va._rep, vb._rep));
+			}
+
+			static inline vector4 VMax(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBMax(va._rep, vb._rep));
+			}
+
+			static inline vector4 VAbs(const vector4& va)
+			{
+				return vector4(VBAbs(va._rep));
+			}
+
+			static inline vector4 VSelect(const vector4& mask, const vector4& va, const vector4& vb)
+			{
+				return vector4(VBSelect(mask._rep, va._rep, vb._rep));
+			}
+
+			static inline bool VAny(const vector4& mask)
+			{
+				return VBAny(mask._rep);
+			}
+
+			static inline bool VAll(const vector4& mask)
+			{
+				return VBAll(mask._rep);
+			}
+
+			static inline vector4 VClamp(const vector4& va, const vector4& lo, const vector4& hi)
+			{
+				return vector4(VBClamp(va._rep, lo._rep, hi._rep));
+			}
+
+			template <int X, int Y, int Z, int W>
+			static inline vector4 Swizzle(const vector4& v)
+			{
+				return vector4(VBSwizzle<X,Y,Z,W>(v._rep));
+			}
+
+			template <int X, int Y, int Z, int W>
+			static inline vector4 Permute(const vector4& va, const vector4& vb)
+			{
+				return vector4(VBPermute<X,Y,Z,W>(va._rep, vb._rep));
+			}
+
 			static inline void GetX(Real *p, const vector4& v)
 			{
 				VBGetX(p, v._rep);
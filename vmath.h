@@ -6,6 +6,26 @@
 #ifndef __VMATH__
 #define __VMATH__
 
+///////////////////////////////////////////////////////////////////////////////
+//	SIMD_FMA - VMAdd/VNMSub compile to a single fused multiply-add when the
+//	compiler targets FMA (-mfma, /arch:AVX2), to mul + add/sub otherwise.
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(SIMD_FMA) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SIMD_FMA
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//	SIMD_F16C - VLoadHalf/VStoreHalf use the F16C conversions when the
+//	compiler targets them (-mf16c, /arch:AVX2), SSE2 integer code otherwise.
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(SIMD_F16C) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SIMD_F16C
+#endif
+
+#if defined(SIMD_FMA) || defined(SIMD_F16C) || defined(__SSE3__) || defined(__AVX__)
+	#include <immintrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //	This example show the fastest SIMD design for vector calculations
 //	1 - Not structured data, instead use atomic datatypes
@@ -64,6 +84,16 @@ namespace VMATH
 		return _mm_set_ps1(f);
 	}
 
+	// the float with bit pattern Bits in every lane, VConst<0x3f800000>() is 1.f.
+	// A compile time constant (a load from read-only data, xorps/pcmpeqd for 0 and
+	// ~0), no static to initialize and nothing the compiler has to reload after a
+	// store through a Vec4 pointer
+	template <unsigned int Bits>
+	inline Vec4 VConst()
+	{
+		return(_mm_castsi128_ps(_mm_set1_epi32((int)Bits)));
+	}
+
 	inline Vec4 VLoad(float x, float y, float z, float w)
 	{
 		return(_mm_set_ps(x, y, z, w));
@@ -101,14 +131,126 @@ namespace VMATH
 	    return VMul(va, InvV);
 	}
 
+	// va*vb + vc
+	inline Vec4 VMAdd(Vec4 va, Vec4 vb, Vec4 vc)
+	{
+	#if defined(SIMD_FMA)
+		return(_mm_fmadd_ps(va, vb, vc));
+	#else
+		return(_mm_add_ps(_mm_mul_ps(va, vb), vc));
+	#endif
+	};
+
+	// vc - va*vb
+	inline Vec4 VNMSub(Vec4 va, Vec4 vb, Vec4 vc)
+	{
+	#if defined(SIMD_FMA)
+		return(_mm_fnmadd_ps(va, vb, vc));
+	#else
+		return(_mm_sub_ps(vc, _mm_mul_ps(va, vb)));
+	#endif
+	};
+
+	// 1/v: _mm_rcp_ps (12 bits) refined by Steps (0-2) Newton-Raphson steps,
+	// VReciprocal/VDiv when the last bits matter
+	template <int Steps>
+	inline Vec4 VReciprocalEst(Vec4 v)
+	{
+		Vec4 one = _mm_set_ps1(1.f);
+		Vec4 r = _mm_rcp_ps(v);
+
+		for(int ii=0; ii<Steps; ii++)
+		{
+			// r += r*(1 - v*r)
+			r = VMAdd(r, VNMSub(v, r, one), r);
+		}
+
+		return(r);
+	}
+
+	// 1/sqrt(v): _mm_rsqrt_ps (12 bits) refined by Steps Newton-Raphson steps,
+	// a refined 1/sqrt(0) is NaN
+	template <int Steps>
+	inline Vec4 VRsqrtEst(Vec4 v)
+	{
+		Vec4 one = _mm_set_ps1(1.f);
+		Vec4 half = _mm_set_ps1(0.5f);
+		Vec4 r = _mm_rsqrt_ps(v);
+
+		for(int ii=0; ii<Steps; ii++)
+		{
+			// r += r/2*(1 - v*r*r)
+			r = VMAdd(VMul(half, r), VNMSub(VMul(v, r), r, one), r);
+		}
+
+		return(r);
+	}
+
 	inline void VStore(float *pVec, Vec4 v)
 	{
 		_mm_store_ps(pVec, v);
 	};
 
+	///////////////////////////////////////////
+	// Non-temporal stores and prefetch
+	//	VStoreStream writes around the cache
+	//	(movntps, 16 byte aligned) for output
+	//	nobody reads back soon, VStoreFence
+	//	orders it before a flag or another
+	//	thread sees the data. The VPrefetch*
+	//	hints: T0 every level, T1 L2 and out,
+	//	NTA close to the core, least evicting.
+	///////////////////////////////////////////
+
+	inline void VStoreStream(float *pVec, Vec4 v)
+	{
+		_mm_stream_ps(pVec, v);
+	}
+
+	inline void VStoreFence()
+	{
+		_mm_sfence();
+	}
+
+	inline void VPrefetchT0(const void *p)
+	{
+		_mm_prefetch((const char*)p, _MM_HINT_T0);
+	}
+
+	inline void VPrefetchT1(const void *p)
+	{
+		_mm_prefetch((const char*)p, _MM_HINT_T1);
+	}
+
+	inline void VPrefetchNTA(const void *p)
+	{
+		_mm_prefetch((const char*)p, _MM_HINT_NTA);
+	}
+
+	///////////////////////////////////////////
+	// Lane reordering, the instruction is picked
+	// at compile time (see vswizzle.inl)
+	///////////////////////////////////////////
+
+	#include "vswizzle.inl"
+
+	// (v[X], v[Y], v[Z], v[W])
+	template <int X, int Y, int Z, int W>
+	inline Vec4 Swizzle(Vec4 v)
+	{
+		return(VSwizzle<X,Y,Z,W>(v));
+	}
+
+	// lanes 0-3 of va, 4-7 of vb, Permute<0,1,4,5>(va, vb) = (va.x, va.y, vb.x, vb.y)
+	template <int X, int Y, int Z, int W>
+	inline Vec4 Permute(Vec4 va, Vec4 vb)
+	{
+		return(VPermute<X,Y,Z,W>(va, vb));
+	}
+
 	inline Vec4 VBc(Vec4 v)
 	{
-		return(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3)));
+		return(Swizzle<3,3,3,3>(v));
 	}
 
 	//////////////////////////////////////////////////////////////////////////////
@@ -126,9 +268,9 @@ namespace VMATH
 	inline Vec4 Dot(Vec4 va, Vec4 vb)
 	{
 		Vec4 t0 = _mm_mul_ps(va, vb);
-		Vec4 t1 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(1,0,3,2));
+		Vec4 t1 = Swizzle<2,3,0,1>(t0);
 		Vec4 t2 = _mm_add_ps(t0, t1);
-		Vec4 t3 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2,3,0,1));
+		Vec4 t3 = Swizzle<1,0,3,2>(t2);
 		Vec4 dot = _mm_add_ps(t3, t2);
 		return (dot);
 	}
@@ -153,10 +295,1201 @@ namespace VMATH
 		return Result;
 	}
 
+	///////////////////////////////////////////
+	// Comparisons and selects. A mask has every
+	// bit of a lane set (true) or clear (false).
+	///////////////////////////////////////////
+
+	inline Vec4 VCmpLt(Vec4 va, Vec4 vb)
+	{
+		return(_mm_cmplt_ps(va, vb));
+	}
+
+	inline Vec4 VCmpGt(Vec4 va, Vec4 vb)
+	{
+		return(_mm_cmpgt_ps(va, vb));
+	}
+
+	inline Vec4 VCmpEq(Vec4 va, Vec4 vb)
+	{
+		return(_mm_cmpeq_ps(va, vb));
+	}
+
+	// vb where either is NaN
+	inline Vec4 VMin(Vec4 va, Vec4 vb)
+	{
+		return(_mm_min_ps(va, vb));
+	}
+
+	inline Vec4 VMax(Vec4 va, Vec4 vb)
+	{
+		return(_mm_max_ps(va, vb));
+	}
+
+	inline Vec4 VAbs(Vec4 v)
+	{
+		return(_mm_andnot_ps(_mm_set1_ps(-0.f), v));
+	}
+
+	// mask ? va : vb
+	inline Vec4 VSelect(Vec4 mask, Vec4 va, Vec4 vb)
+	{
+	#if defined(__SSE4_1__) || defined(__AVX__)
+		return(_mm_blendv_ps(vb, va, mask));
+	#else
+		return(_mm_or_ps(_mm_and_ps(mask, va), _mm_andnot_ps(mask, vb)));
+	#endif
+	}
+
+	// true if any / every lane of mask is set
+	inline bool VAny(Vec4 mask)
+	{
+		return(_mm_movemask_ps(mask) != 0);
+	}
+
+	inline bool VAll(Vec4 mask)
+	{
+		return(_mm_movemask_ps(mask) == 0xf);
+	}
+
+	// lo <= v <= hi lane by lane, NaN gives lo
+	inline Vec4 VClamp(Vec4 v, Vec4 lo, Vec4 hi)
+	{
+		return(VMin(VMax(v, lo), hi));
+	}
+
+	///////////////////////////////////////////
+	// Horizontal reductions over the 4 lanes, the
+	// result replicated in all 4 (rule 5). Two
+	// swizzle+op steps, as Dot.
+	///////////////////////////////////////////
+
+	inline Vec4 HSum(Vec4 v)
+	{
+		Vec4 t0 = _mm_add_ps(v, Swizzle<2,3,0,1>(v));
+		return(_mm_add_ps(t0, Swizzle<1,0,3,2>(t0)));
+	}
+
+	inline Vec4 HProduct(Vec4 v)
+	{
+		Vec4 t0 = _mm_mul_ps(v, Swizzle<2,3,0,1>(v));
+		return(_mm_mul_ps(t0, Swizzle<1,0,3,2>(t0)));
+	}
+
+	inline Vec4 HMin(Vec4 v)
+	{
+		Vec4 t0 = _mm_min_ps(v, Swizzle<2,3,0,1>(v));
+		return(_mm_min_ps(t0, Swizzle<1,0,3,2>(t0)));
+	}
+
+	inline Vec4 HMax(Vec4 v)
+	{
+		Vec4 t0 = _mm_max_ps(v, Swizzle<2,3,0,1>(v));
+		return(_mm_max_ps(t0, Swizzle<1,0,3,2>(t0)));
+	}
+
+	///////////////////////////////////////////
+	// Transcendentals, range reduced (see vtranscendental.inl
+	// for the domains and the ulp bounds)
+	///////////////////////////////////////////
+
+	#include "vtranscendental.inl"
+
+	inline Vec4 Sin(Vec4 v)
+	{
+		return(VTransSin(v));
+	}
+
+	inline Vec4 Cos(Vec4 v)
+	{
+		return(VTransCos(v));
+	}
+
+	// both for the price of one range reduction
+	inline void SinCos(Vec4 v, Vec4* pSin, Vec4* pCos)
+	{
+		VTransSinCos(v, pSin, pCos);
+	}
+
+	inline Vec4 Exp(Vec4 v)
+	{
+		return(VTransExp(v));
+	}
+
+	inline Vec4 Log(Vec4 v)
+	{
+		return(VTransLog(v));
+	}
+
+	inline Vec4 Pow(Vec4 va, Vec4 vb)
+	{
+		return(VTransPow(va, vb));
+	}
+
+	// angle of (x, y), in [-pi, pi]
+	inline Vec4 Atan2(Vec4 vy, Vec4 vx)
+	{
+		return(VTransAtan2(vy, vx));
+	}
+
+	///////////////////////////////////////////
+	// SoA: four Vec4 transposed into one register per component,
+	// x = (x0,x1,x2,x3) ... The *4 functions give the four results
+	// with vertical ops only, no shuffles.
+	///////////////////////////////////////////
+
+	typedef struct Vec4x4
+	{
+		Vec4	x;
+		Vec4	y;
+		Vec4	z;
+		Vec4	w;
+
+	}	Vec4x4;
+
+	// 4 AoS vectors to SoA
+	inline Vec4x4 VTransposeLoad(Vec4 v0, Vec4 v1, Vec4 v2, Vec4 v3)
+	{
+		Vec4 t0 = _mm_unpacklo_ps(v0, v1);		// x0 x1 y0 y1
+		Vec4 t1 = _mm_unpacklo_ps(v2, v3);		// x2 x3 y2 y3
+		Vec4 t2 = _mm_unpackhi_ps(v0, v1);		// z0 z1 w0 w1
+		Vec4 t3 = _mm_unpackhi_ps(v2, v3);		// z2 z3 w2 w3
+
+		Vec4x4 r;
+
+		r.x = _mm_movelh_ps(t0, t1);
+		r.y = _mm_movehl_ps(t1, t0);
+		r.z = _mm_movelh_ps(t2, t3);
+		r.w = _mm_movehl_ps(t3, t2);
+
+		return(r);
+	}
+
+	inline Vec4x4 VTransposeLoad(const Vec4 *pAoS)
+	{
+		return(VTransposeLoad(pAoS[0], pAoS[1], pAoS[2], pAoS[3]));
+	}
+
+	// SoA back to 4 AoS vectors (the transpose is its own inverse)
+	inline void VTransposeStore(Vec4 *pAoS, const Vec4x4& v)
+	{
+		Vec4x4 r = VTransposeLoad(v.x, v.y, v.z, v.w);
+
+		pAoS[0] = r.x;
+		pAoS[1] = r.y;
+		pAoS[2] = r.z;
+		pAoS[3] = r.w;
+	}
+
+	///////////////////////////////////////////
+	// Float3: packed 12 byte x,y,z for vertex
+	// streams and particle arrays, same layout
+	// as D3DXVECTOR3/XMFLOAT3. No alignment, w
+	// loads as 0 and is dropped on store.
+	///////////////////////////////////////////
+
+	typedef struct Float3
+	{
+		float	x;
+		float	y;
+		float	z;
+
+	}	Float3;
+
+	// (x, y, z, 0), never reads past p->z
+	inline Vec4 VLoad3(const Float3 *p)
+	{
+		Vec4 xy = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)p);
+		return(_mm_movelh_ps(xy, _mm_load_ss(&p->z)));
+	}
+
+	inline void VStore3(Float3 *p, Vec4 v)
+	{
+		_mm_storel_pi((__m64*)p, v);
+		_mm_store_ss(&p->z, _mm_movehl_ps(v, v));
+	}
+
+	// count Vec4 to packed Float3, 4 at a time in three stores
+	inline void VStore3Array(Float3 *pOut, const Vec4 *pIn, int count)
+	{
+		int ii = 0;
+
+		for(; ii+4<=count; ii+=4)
+		{
+			_mm_storeu_ps(&pOut[ii].x, Permute<0,1,2,4>(pIn[ii], pIn[ii+1]));		// x0 y0 z0 x1
+			_mm_storeu_ps(&pOut[ii+1].y, Permute<1,2,4,5>(pIn[ii+1], pIn[ii+2]));	// y1 z1 x2 y2
+			_mm_storeu_ps(&pOut[ii+2].z, Permute<2,4,5,6>(pIn[ii+2], pIn[ii+3]));	// z2 x3 y3 z3
+		}
+
+		for(; ii<count; ii++)
+		{
+			VStore3(pOut + ii, pIn[ii]);
+		}
+	}
+
+	// 4 packed Float3 (48 bytes, three loads) to SoA, w = 0
+	inline Vec4x4 VTransposeLoad3(const Float3 *p)
+	{
+		Vec4 a = _mm_loadu_ps(&p[0].x);				// x0 y0 z0 x1
+		Vec4 b = _mm_loadu_ps(&p[1].y);				// y1 z1 x2 y2
+		Vec4 c = _mm_loadu_ps(&p[2].z);				// z2 x3 y3 z3
+
+		Vec4 xy = Permute<2,3,5,6>(b, c);			// x2 y2 x3 y3
+		Vec4 yz = Permute<1,2,4,5>(a, b);			// y0 z0 y1 z1
+
+		Vec4x4 r;
+
+		r.x = Permute<0,3,4,6>(a, xy);
+		r.y = Permute<0,2,5,7>(yz, xy);
+		r.z = Permute<1,3,4,7>(yz, c);
+		r.w = _mm_setzero_ps();
+
+		return(r);
+	}
+
+	// SoA back to 4 packed Float3 (three stores), v.w is ignored
+	inline void VTransposeStore3(Float3 *p, const Vec4x4& v)
+	{
+		Vec4 xy = Permute<2,6,3,7>(v.x, v.y);		// x2 y2 x3 y3
+		Vec4 yz = Permute<0,4,1,5>(v.y, v.z);		// y0 z0 y1 z1
+
+		_mm_storeu_ps(&p[0].x, Swizzle<0,1,3,2>(Permute<0,4,1,5>(v.x, yz)));
+		_mm_storeu_ps(&p[1].y, Permute<2,3,4,5>(yz, xy));
+		_mm_storeu_ps(&p[2].z, Swizzle<2,0,1,3>(Permute<2,3,6,7>(xy, v.z)));
+	}
+
+	///////////////////////////////////////////
+	// Half4: x,y,z,w as IEEE half floats, 8
+	// bytes, for streams where bandwidth counts
+	// more than precision (11 bit mantissa,
+	// +-65504). Rounds to nearest even, like
+	// D3DXFloat32To16Array.
+	///////////////////////////////////////////
+
+	typedef struct Half4
+	{
+		unsigned short	x;
+		unsigned short	y;
+		unsigned short	z;
+		unsigned short	w;
+
+	}	Half4;
+
+#if !defined(SIMD_F16C)
+	// 4 halves in the low 16 bits of each lane to float. Exact, the denormal
+	// halves go through a float subtraction on normal floats, so DAZ can't
+	// flush them
+	inline Vec4 VHalfToFloatSSE2(__m128i h)
+	{
+		__m128i	em = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+		__m128i	o = _mm_slli_epi32(em, 13);
+		__m128i	e = _mm_and_si128(o, _mm_set1_epi32(0x7c00 << 13));
+
+		o = _mm_add_epi32(o, _mm_set1_epi32((127 - 15) << 23));
+
+		// inf/nan keep their exponent at 255, a nan turns quiet as in vcvtph2ps
+		__m128i	infnan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0x7c00 << 13));
+		__m128i	nan = _mm_cmpgt_epi32(em, _mm_set1_epi32(0x7c00));
+		o = _mm_add_epi32(o, _mm_and_si128(infnan, _mm_set1_epi32((128 - 16) << 23)));
+		o = _mm_or_si128(o, _mm_and_si128(nan, _mm_set1_epi32(0x00400000)));
+
+		// denormals: renormalize by subtracting 2^-14
+		__m128i	denorm = _mm_cmpeq_epi32(e, _mm_setzero_si128());
+		Vec4	d = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+		o = _mm_or_si128(_mm_andnot_si128(denorm, o), _mm_and_si128(denorm, _mm_castps_si128(d)));
+
+		__m128i	sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+		return(_mm_castsi128_ps(_mm_or_si128(o, sign)));
+	}
+
+	// float to 4 halves in the low 16 bits of each lane, round to nearest
+	// even, overflow to inf, nan stays nan
+	inline __m128i VFloatToHalfSSE2(Vec4 v)
+	{
+		__m128i	f = _mm_castps_si128(v);
+		__m128i	sign = _mm_and_si128(f, _mm_set1_epi32(0x80000000));
+		__m128i	a = _mm_xor_si128(f, sign);
+
+		// too large for a half (>= 65520 rounds up to inf), or inf/nan. A nan
+		// keeps the top of its payload and turns quiet, as vcvtps2ph does
+		__m128i	big = _mm_cmpgt_epi32(a, _mm_set1_epi32(((127 + 16) << 23) - 1));
+		__m128i	nan = _mm_cmpgt_epi32(a, _mm_set1_epi32(255 << 23));
+		__m128i	payload = _mm_or_si128(_mm_srli_epi32(_mm_and_si128(a, _mm_set1_epi32(0x007fffff)), 13), _mm_set1_epi32(0x0200));
+		__m128i	inf = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(nan, payload));
+
+		// half denormals and zero: the float add rounds the mantissa into place
+		__m128i	small = _mm_cmplt_epi32(a, _mm_set1_epi32(113 << 23));
+		__m128i	magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		__m128i	d = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(magic))), magic);
+
+		// normals: rebias and round on the 13 dropped bits, ties to the even one
+		__m128i	odd = _mm_and_si128(_mm_srli_epi32(a, 13), _mm_set1_epi32(1));
+		__m128i	n = _mm_add_epi32(a, _mm_set1_epi32(-((127 - 15) << 23) + 0xfff));
+		n = _mm_srli_epi32(_mm_add_epi32(n, odd), 13);
+
+		__m128i	o = _mm_or_si128(_mm_andnot_si128(small, n), _mm_and_si128(small, d));
+		o = _mm_or_si128(_mm_andnot_si128(big, o), _mm_and_si128(big, inf));
+
+		return(_mm_or_si128(o, _mm_srli_epi32(sign, 16)));
+	}
+#endif
+
+	inline Vec4 VLoadHalf(const Half4 *p)
+	{
+#if defined(SIMD_F16C)
+		return(_mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)p)));
+#else
+		return(VHalfToFloatSSE2(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)p), _mm_setzero_si128())));
+#endif
+	}
+
+	inline void VStoreHalf(Half4 *p, Vec4 v)
+	{
+#if defined(SIMD_F16C)
+		_mm_storel_epi64((__m128i*)p, _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+		// sign extend so the signed saturating pack keeps all 16 bits
+		__m128i h = _mm_srai_epi32(_mm_slli_epi32(VFloatToHalfSSE2(v), 16), 16);
+		_mm_storel_epi64((__m128i*)p, _mm_packs_epi32(h, h));
+#endif
+	}
+
+	// count Half4 to Vec4 and back, 2 vectors per instruction with F16C on AVX
+	inline void VLoadHalfArray(Vec4 *pOut, const Half4 *pIn, int count)
+	{
+		int ii = 0;
+#if defined(SIMD_F16C) && defined(__AVX__)
+		for(; ii+2<=count; ii+=2)
+		{
+			__m256 v = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(pIn + ii)));
+
+			pOut[ii] = _mm256_castps256_ps128(v);
+			pOut[ii+1] = _mm256_extractf128_ps(v, 1);
+		}
+#endif
+		for(; ii<count; ii++)
+		{
+			pOut[ii] = VLoadHalf(pIn + ii);
+		}
+	}
+
+	inline void VStoreHalfArray(Half4 *pOut, const Vec4 *pIn, int count)
+	{
+		int ii = 0;
+#if defined(SIMD_F16C) && defined(__AVX__)
+		for(; ii+2<=count; ii+=2)
+		{
+			__m256 v = _mm256_insertf128_ps(_mm256_castps128_ps256(pIn[ii]), pIn[ii+1], 1);
+
+			_mm_storeu_si128((__m128i*)(pOut + ii), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+		}
+#endif
+		for(; ii<count; ii++)
+		{
+			VStoreHalf(pOut + ii, pIn[ii]);
+		}
+	}
+
+	// (Dot(a0,b0), Dot(a1,b1), Dot(a2,b2), Dot(a3,b3))
+	inline Vec4 Dot4(const Vec4x4& va, const Vec4x4& vb)
+	{
+		Vec4 dot = VMul(va.x, vb.x);
+		dot = VMAdd(va.y, vb.y, dot);
+		dot = VMAdd(va.z, vb.z, dot);
+		dot = VMAdd(va.w, vb.w, dot);
+		return (dot);
+	}
+
+	inline Vec4 Length4(const Vec4x4& v)
+	{
+		return(Sqrt(Dot4(v, v)));
+	}
+
+	inline Vec4x4 Normalize4(const Vec4x4& v)
+	{
+		Vec4 invLength = VDiv(VReplicate(1.f), Length4(v));
+
+		Vec4x4 r;
+
+		r.x = VMul(v.x, invLength);
+		r.y = VMul(v.y, invLength);
+		r.z = VMul(v.z, invLength);
+		r.w = VMul(v.w, invLength);
+
+		return(r);
+	}
+
+	// Reflect on each of the 4 pairs
+	inline Vec4x4 Reflect4(const Vec4x4& Incident, const Vec4x4& Normal)
+	{
+		// Result = Incident - (2 * dot(Incident, Normal)) * Normal
+		Vec4 twoDot = Dot4(Incident, Normal);
+		twoDot = VAdd(twoDot, twoDot);
+
+		Vec4x4 r;
+
+		r.x = VNMSub(twoDot, Normal.x, Incident.x);
+		r.y = VNMSub(twoDot, Normal.y, Incident.y);
+		r.z = VNMSub(twoDot, Normal.z, Incident.z);
+		r.w = VNMSub(twoDot, Normal.w, Incident.w);
+
+		return(r);
+	}
+
+	///////////////////////////////////////////
+	// Mat4: 4x4 matrix as 4 row Vec4, same layout
+	// and convention as D3DXMATRIX: row vectors
+	// (v*M), translation in r[3], MMul(a, b) is
+	// a then b like D3DXMatrixMultiply.
+	///////////////////////////////////////////
+
+	typedef struct Mat4
+	{
+		Vec4	r[4];
+
+	}	Mat4;
+
+	// 16 floats, any alignment (a D3DXMATRIX is only 4 byte aligned)
+	inline Mat4 MLoad(const float *pMat)
+	{
+		Mat4 m;
+
+		m.r[0] = _mm_loadu_ps(pMat);
+		m.r[1] = _mm_loadu_ps(pMat + 4);
+		m.r[2] = _mm_loadu_ps(pMat + 8);
+		m.r[3] = _mm_loadu_ps(pMat + 12);
+
+		return(m);
+	}
+
+	inline void MStore(float *pMat, const Mat4& m)
+	{
+		_mm_storeu_ps(pMat, m.r[0]);
+		_mm_storeu_ps(pMat + 4, m.r[1]);
+		_mm_storeu_ps(pMat + 8, m.r[2]);
+		_mm_storeu_ps(pMat + 12, m.r[3]);
+	}
+
+	inline Mat4 MIdentity()
+	{
+		Mat4 m;
+
+		m.r[0] = _mm_setr_ps(1.f, 0.f, 0.f, 0.f);
+		m.r[1] = _mm_setr_ps(0.f, 1.f, 0.f, 0.f);
+		m.r[2] = _mm_setr_ps(0.f, 0.f, 1.f, 0.f);
+		m.r[3] = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+
+		return(m);
+	}
+
+	// v*m
+	inline Vec4 MTransform(Vec4 v, const Mat4& m)
+	{
+		// two independent chains, x*r0 + y*r1 and z*r2 + w*r3
+		Vec4 xy = VMAdd(Swizzle<1,1,1,1>(v), m.r[1], VMul(Swizzle<0,0,0,0>(v), m.r[0]));
+		Vec4 zw = VMAdd(Swizzle<3,3,3,3>(v), m.r[3], VMul(Swizzle<2,2,2,2>(v), m.r[2]));
+		return(VAdd(xy, zw));
+	}
+
+	// ma*mb
+	inline Mat4 MMul(const Mat4& ma, const Mat4& mb)
+	{
+		Mat4 m;
+
+		m.r[0] = MTransform(ma.r[0], mb);
+		m.r[1] = MTransform(ma.r[1], mb);
+		m.r[2] = MTransform(ma.r[2], mb);
+		m.r[3] = MTransform(ma.r[3], mb);
+
+		return(m);
+	}
+
+	inline Mat4 MTranspose(const Mat4& m)
+	{
+		Vec4x4 t = VTransposeLoad(m.r);
+
+		Mat4 r;
+
+		r.r[0] = t.x;
+		r.r[1] = t.y;
+		r.r[2] = t.z;
+		r.r[3] = t.w;
+
+		return(r);
+	}
+
+	// Inverse of a matrix whose 4th column is (0,0,0,1): rotation, scale and
+	// shear in the 3x3, translation in r[3]. Cheaper than MInverse and the
+	// only kind of matrix a frame hierarchy or a view matrix holds.
+	inline Mat4 MInverseAffine(const Mat4& m)
+	{
+		// rows of the inverse 3x3 are the columns of (r1 x r2, r2 x r0, r0 x r1)/det,
+		// the w of a cross product is exactly 0
+		Vec4 c[4];
+
+		for(int ii=0; ii<3; ii++)
+		{
+			Vec4 a = m.r[(ii + 1) % 3];
+			Vec4 b = m.r[(ii + 2) % 3];
+
+			c[ii] = VNMSub(Swizzle<2,0,1,3>(a), Swizzle<1,2,0,3>(b),
+				VMul(Swizzle<1,2,0,3>(a), Swizzle<2,0,1,3>(b)));
+		}
+
+		Vec4 rdet = VDiv(VReplicate(1.f), Dot(m.r[0], c[0]));
+
+		c[0] = VMul(c[0], rdet);
+		c[1] = VMul(c[1], rdet);
+		c[2] = VMul(c[2], rdet);
+		c[3] = _mm_setzero_ps();
+
+		Vec4x4 t = VTransposeLoad(c);
+		Vec4 p = m.r[3];
+
+		Mat4 r;
+
+		r.r[0] = t.x;
+		r.r[1] = t.y;
+		r.r[2] = t.z;
+
+		// -p*inverse(3x3), w = 1
+		r.r[3] = VNMSub(Swizzle<0,0,0,0>(p), t.x, _mm_setr_ps(0.f, 0.f, 0.f, 1.f));
+		r.r[3] = VNMSub(Swizzle<1,1,1,1>(p), t.y, r.r[3]);
+		r.r[3] = VNMSub(Swizzle<2,2,2,2>(p), t.z, r.r[3]);
+
+		return(r);
+	}
+
+	// 2x2 matrices (x y / z w) in one Vec4, for MInverse
+	// va*vb
+	inline Vec4 M2Mul(Vec4 va, Vec4 vb)
+	{
+		return(VMAdd(va, Swizzle<0,3,0,3>(vb),
+			VMul(Swizzle<1,0,3,2>(va), Swizzle<2,1,2,1>(vb))));
+	}
+
+	// adjugate(va)*vb
+	inline Vec4 M2AdjMul(Vec4 va, Vec4 vb)
+	{
+		return(VNMSub(Swizzle<1,1,2,2>(va), Swizzle<2,3,0,1>(vb),
+			VMul(Swizzle<3,3,0,0>(va), vb)));
+	}
+
+	// va*adjugate(vb)
+	inline Vec4 M2MulAdj(Vec4 va, Vec4 vb)
+	{
+		return(VNMSub(Swizzle<1,0,3,2>(va), Swizzle<2,1,2,1>(vb),
+			VMul(va, Swizzle<3,0,3,0>(vb))));
+	}
+
+	// General inverse by 2x2 blocks (m = A B / C D), the determinant goes to
+	// *pDet (replicated) when given. A singular m gives inf/NaN, test *pDet
+	// when that can happen.
+	inline Mat4 MInverse(const Mat4& m, Vec4 *pDet = NULL)
+	{
+		Vec4 A = Permute<0,1,4,5>(m.r[0], m.r[1]);
+		Vec4 B = Permute<2,3,6,7>(m.r[0], m.r[1]);
+		Vec4 C = Permute<0,1,4,5>(m.r[2], m.r[3]);
+		Vec4 D = Permute<2,3,6,7>(m.r[2], m.r[3]);
+
+		// (|A|, |B|, |C|, |D|)
+		Vec4 detSub = VNMSub(Permute<1,3,5,7>(m.r[0], m.r[2]), Permute<0,2,4,6>(m.r[1], m.r[3]),
+			VMul(Permute<0,2,4,6>(m.r[0], m.r[2]), Permute<1,3,5,7>(m.r[1], m.r[3])));
+
+		Vec4 detA = Swizzle<0,0,0,0>(detSub);
+		Vec4 detB = Swizzle<1,1,1,1>(detSub);
+		Vec4 detC = Swizzle<2,2,2,2>(detSub);
+		Vec4 detD = Swizzle<3,3,3,3>(detSub);
+
+		Vec4 D_C = M2AdjMul(D, C);
+		Vec4 A_B = M2AdjMul(A, B);
+
+		// adjugates of the blocks of the inverse (X Y / Z W)
+		Vec4 X_ = VSub(VMul(detD, A), M2Mul(B, D_C));
+		Vec4 W_ = VSub(VMul(detA, D), M2Mul(C, A_B));
+		Vec4 Y_ = VSub(VMul(detB, C), M2MulAdj(D, A_B));
+		Vec4 Z_ = VSub(VMul(detC, B), M2MulAdj(A, D_C));
+
+		// |m| = |A||D| + |B||C| - tr((A#B)(D#C))
+		Vec4 det = VMAdd(detB, detC, VMul(detA, detD));
+		det = VSub(det, Dot(A_B, Swizzle<0,2,1,3>(D_C)));
+
+		if (pDet)
+		{
+			*pDet = det;
+		}
+
+		Vec4 rdet = VDiv(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+
+		X_ = VMul(X_, rdet);
+		Y_ = VMul(Y_, rdet);
+		Z_ = VMul(Z_, rdet);
+		W_ = VMul(W_, rdet);
+
+		Mat4 r;
+
+		r.r[0] = Permute<3,1,7,5>(X_, Y_);
+		r.r[1] = Permute<2,0,6,4>(X_, Y_);
+		r.r[2] = Permute<3,1,7,5>(Z_, W_);
+		r.r[3] = Permute<2,0,6,4>(Z_, W_);
+
+		return(r);
+	}
+
+	// pOut[ii] = pIn[ii]*m for count Vec4, pOut may be pIn. The rows are copied
+	// to locals so they stay in registers across the stores.
+	inline void TransformPoints(const Mat4& m, const Vec4 *pIn, Vec4 *pOut, int count)
+	{
+		const Vec4 r0 = m.r[0];
+		const Vec4 r1 = m.r[1];
+		const Vec4 r2 = m.r[2];
+		const Vec4 r3 = m.r[3];
+
+		for(int ii=0; ii<count; ii++)
+		{
+			Vec4 v = pIn[ii];
+			Vec4 xy = VMAdd(Swizzle<1,1,1,1>(v), r1, VMul(Swizzle<0,0,0,0>(v), r0));
+			Vec4 zw = VMAdd(Swizzle<3,3,3,3>(v), r3, VMul(Swizzle<2,2,2,2>(v), r2));
+
+			pOut[ii] = VAdd(xy, zw);
+		}
+	}
+
+	///////////////////////////////////////////
+	// Quaternions: (x, y, z, w) in one Vec4, the
+	// D3DXQUATERNION layout and conventions.
+	// QMul(qa, qb) rotates by qa then qb like
+	// D3DXQuaternionMultiply (qb*qa).
+	///////////////////////////////////////////
+
+	typedef Vec4 Quat;
+
+	inline Quat QIdentity()
+	{
+		return(_mm_setr_ps(0.f, 0.f, 0.f, 1.f));
+	}
+
+	inline Quat QConjugate(Quat q)
+	{
+		return(_mm_xor_ps(q, _mm_setr_ps(-0.f, -0.f, -0.f, 0.f)));
+	}
+
+	inline Quat QNormalize(Quat q)
+	{
+		return(VDiv(q, Sqrt(Dot(q, q))));
+	}
+
+	// rotation qa then qb
+	inline Quat QMul(Quat qa, Quat qb)
+	{
+		// qb*qa = bw*qa + bx*(aw,-az,ay,-ax) + by*(az,aw,-ax,-ay) + bz*(-ay,ax,aw,-az)
+		Vec4 r = VMul(Swizzle<3,3,3,3>(qb), qa);
+		r = VMAdd(Swizzle<0,0,0,0>(qb), _mm_xor_ps(Swizzle<3,2,1,0>(qa), _mm_setr_ps(0.f, -0.f, 0.f, -0.f)), r);
+		r = VMAdd(Swizzle<1,1,1,1>(qb), _mm_xor_ps(Swizzle<2,3,0,1>(qa), _mm_setr_ps(0.f, 0.f, -0.f, -0.f)), r);
+		r = VMAdd(Swizzle<2,2,2,2>(qb), _mm_xor_ps(Swizzle<1,0,3,2>(qa), _mm_setr_ps(-0.f, 0.f, 0.f, -0.f)), r);
+		return(r);
+	}
+
+	// q*v*conjugate(q) for a unit q, v.w is kept
+	inline Vec4 QRotate(Vec4 v, Quat q)
+	{
+		// t = 2*(u x v), v + w*t + u x t with u = q.xyz, the w of a cross product is 0
+		Vec4 qyzx = Swizzle<1,2,0,3>(q);
+		Vec4 qzxy = Swizzle<2,0,1,3>(q);
+		Vec4 t = VNMSub(qzxy, Swizzle<1,2,0,3>(v), VMul(qyzx, Swizzle<2,0,1,3>(v)));
+		t = VAdd(t, t);
+
+		Vec4 r = VMAdd(Swizzle<3,3,3,3>(q), t, v);
+		r = VMAdd(qyzx, Swizzle<2,0,1,3>(t), r);
+		r = VNMSub(qzxy, Swizzle<1,2,0,3>(t), r);
+		return(r);
+	}
+
+	// D3DXMatrixRotationQuaternion, the rows are the rotated axes
+	inline Mat4 MRotationQuaternion(Quat q)
+	{
+		Mat4 m = MIdentity();
+
+		m.r[0] = QRotate(m.r[0], q);
+		m.r[1] = QRotate(m.r[1], q);
+		m.r[2] = QRotate(m.r[2], q);
+
+		return(m);
+	}
+
+	// normalize((1-t)*q0 + t*q1) with q1 flipped to q0's side, t replicated
+	inline Quat QNlerp(Quat q0, Quat q1, Vec4 t)
+	{
+		Vec4 sign = _mm_and_ps(Dot(q0, q1), _mm_set1_ps(-0.f));
+
+		q1 = _mm_xor_ps(q1, sign);
+
+		return(QNormalize(VMAdd(VSub(q1, q0), t, q0)));
+	}
+
+	// Spherical interpolation along the shortest arc, t replicated. Falls back to
+	// QNlerp when q0 and q1 are less than ~3.6 degrees apart.
+	inline Quat QSlerp(Quat q0, Quat q1, Vec4 t)
+	{
+		const Vec4 one = VReplicate(1.f);
+
+		Vec4 c = Dot(q0, q1);
+		Vec4 sign = _mm_and_ps(c, _mm_set1_ps(-0.f));
+
+		c = _mm_xor_ps(c, sign);
+		q1 = _mm_xor_ps(q1, sign);
+
+		Vec4 s = Sqrt(_mm_max_ps(VNMSub(c, c, one), _mm_setzero_ps()));
+		Vec4 theta = Atan2(s, c);
+
+		// (sin((1-t)*theta), sin(t*theta), ...)/sin(theta) with one Sin
+		Vec4 w = VDiv(Sin(_mm_unpacklo_ps(VMul(VSub(one, t), theta), VMul(t, theta))), s);
+		Vec4 w0 = Swizzle<0,0,0,0>(w);
+		Vec4 w1 = Swizzle<1,1,1,1>(w);
+
+		Vec4 nearby = _mm_cmpgt_ps(c, VReplicate(0.9995f));
+		w0 = _mm_or_ps(_mm_and_ps(nearby, VSub(one, t)), _mm_andnot_ps(nearby, w0));
+		w1 = _mm_or_ps(_mm_and_ps(nearby, t), _mm_andnot_ps(nearby, w1));
+
+		return(QNormalize(VMAdd(q1, w1, VMul(q0, w0))));
+	}
+
+	// 4 quaternions transposed into a Vec4x4 (x = (x0,x1,x2,x3) ...), one key
+	// per lane and t = (t0,t1,t2,t3): the same results as QNlerp/QSlerp on
+	// each key with vertical ops only
+	inline Vec4x4 QNlerp4(const Vec4x4& q0, const Vec4x4& q1, Vec4 t)
+	{
+		Vec4 sign = _mm_and_ps(Dot4(q0, q1), _mm_set1_ps(-0.f));
+
+		Vec4x4 r;
+
+		r.x = VMAdd(VSub(_mm_xor_ps(q1.x, sign), q0.x), t, q0.x);
+		r.y = VMAdd(VSub(_mm_xor_ps(q1.y, sign), q0.y), t, q0.y);
+		r.z = VMAdd(VSub(_mm_xor_ps(q1.z, sign), q0.z), t, q0.z);
+		r.w = VMAdd(VSub(_mm_xor_ps(q1.w, sign), q0.w), t, q0.w);
+
+		return(Normalize4(r));
+	}
+
+	inline Vec4x4 QSlerp4(const Vec4x4& q0, const Vec4x4& q1, Vec4 t)
+	{
+		const Vec4 one = VReplicate(1.f);
+
+		Vec4 c = Dot4(q0, q1);
+		Vec4 sign = _mm_and_ps(c, _mm_set1_ps(-0.f));
+
+		c = _mm_xor_ps(c, sign);
+
+		Vec4 s = Sqrt(_mm_max_ps(VNMSub(c, c, one), _mm_setzero_ps()));
+		Vec4 theta = Atan2(s, c);
+		Vec4 rs = VDiv(one, s);
+		Vec4 w0 = VMul(Sin(VMul(VSub(one, t), theta)), rs);
+		Vec4 w1 = VMul(Sin(VMul(t, theta)), rs);
+
+		Vec4 nearby = _mm_cmpgt_ps(c, VReplicate(0.9995f));
+		w0 = _mm_or_ps(_mm_and_ps(nearby, VSub(one, t)), _mm_andnot_ps(nearby, w0));
+		w1 = _mm_or_ps(_mm_and_ps(nearby, t), _mm_andnot_ps(nearby, w1));
+		w1 = _mm_xor_ps(w1, sign);
+
+		Vec4x4 r;
+
+		r.x = VMAdd(q1.x, w1, VMul(q0.x, w0));
+		r.y = VMAdd(q1.y, w1, VMul(q0.y, w0));
+		r.z = VMAdd(q1.z, w1, VMul(q0.z, w0));
+		r.w = VMAdd(q1.w, w1, VMul(q0.w, w0));
+
+		return(Normalize4(r));
+	}
+
+	// count blocks of 4 keys stored as Vec4x4, pT holds one t per key. pOut may
+	// be pQ0 or pQ1.
+	inline void QNlerpSoA(const Vec4x4 *pQ0, const Vec4x4 *pQ1, const Vec4 *pT, Vec4x4 *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = QNlerp4(pQ0[ii], pQ1[ii], pT[ii]);
+		}
+	}
+
+	inline void QSlerpSoA(const Vec4x4 *pQ0, const Vec4x4 *pQ1, const Vec4 *pT, Vec4x4 *pOut, int count)
+	{
+		for(int ii=0; ii<count; ii++)
+		{
+			pOut[ii] = QSlerp4(pQ0[ii], pQ1[ii], pT[ii]);
+		}
+	}
+
+	///////////////////////////////////////////
+	// Stream: bulk ops over float arrays (pointer, count in floats), any
+	// alignment and count. A scalar head runs until pDest is 16 byte
+	// aligned, the body is unrolled to 16 floats (one cache line) per
+	// iteration with aligned stores and the sources prefetched
+	// cPrefetch bytes ahead, a Vec4 and a scalar tail finish.
+	// pDest may be one of the sources. The *NT versions write the
+	// body with VStoreStream and fence, for outputs larger than the
+	// cache that are not read back right away.
+	///////////////////////////////////////////
+
+	namespace Stream
+	{
+		const int cPrefetch = 512;
+
+		// loads used by the ops, full vector in the body, lane 0 in head/tail
+		struct LoadV { static inline Vec4 Load(const float *p) { return _mm_loadu_ps(p); } };
+		struct LoadS { static inline Vec4 Load(const float *p) { return _mm_load_ss(p); } };
+
+		// body stores, cached or non-temporal
+		struct StoreA { static inline void Store(float *p, Vec4 v) { _mm_store_ps(p, v); } };
+		struct StoreNT { static inline void Store(float *p, Vec4 v) { VStoreStream(p, v); } };
+
+		inline void Prefetch(const float *p)
+		{
+			VPrefetchT0((const char*)p + cPrefetch);
+		}
+
+		// floats before p is 16 byte aligned, at most count
+		inline int HeadCount(const float *p, int count)
+		{
+			int head = (int)(((16 - ((UINT_PTR)p & 15)) & 15) >> 2);
+
+			return(head < count ? head : count);
+		}
+
+		// pDest[ii] = op.Eval<Load>(ii) for ii in [0, count)
+		template <typename Store, typename Op>
+		inline void TransformT(float *pDest, const Op& op, int count)
+		{
+			int ii = 0;
+			int head = HeadCount(pDest, count);
+
+			for(; ii<head; ii++)
+			{
+				_mm_store_ss(pDest + ii, op.template Eval<LoadS>(ii));
+			}
+
+			for(; ii+16<=count; ii+=16)
+			{
+				op.Prefetch(ii);
+
+				Store::Store(pDest + ii, op.template Eval<LoadV>(ii));
+				Store::Store(pDest + ii + 4, op.template Eval<LoadV>(ii + 4));
+				Store::Store(pDest + ii + 8, op.template Eval<LoadV>(ii + 8));
+				Store::Store(pDest + ii + 12, op.template Eval<LoadV>(ii + 12));
+			}
+
+			for(; ii+4<=count; ii+=4)
+			{
+				Store::Store(pDest + ii, op.template Eval<LoadV>(ii));
+			}
+
+			for(; ii<count; ii++)
+			{
+				_mm_store_ss(pDest + ii, op.template Eval<LoadS>(ii));
+			}
+		}
+
+		template <typename Op>
+		inline void Transform(float *pDest, const Op& op, int count)
+		{
+			TransformT<StoreA>(pDest, op, count);
+		}
+
+		template <typename Op>
+		inline void TransformNT(float *pDest, const Op& op, int count)
+		{
+			TransformT<StoreNT>(pDest, op, count);
+			VStoreFence();
+		}
+
+		struct OpAdd
+		{
+			const float *pA, *pB;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VAdd(L::Load(pA + ii), L::Load(pB + ii)); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); Stream::Prefetch(pB + ii); }
+		};
+
+		struct OpSub
+		{
+			const float *pA, *pB;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VSub(L::Load(pA + ii), L::Load(pB + ii)); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); Stream::Prefetch(pB + ii); }
+		};
+
+		struct OpMul
+		{
+			const float *pA, *pB;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VMul(L::Load(pA + ii), L::Load(pB + ii)); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); Stream::Prefetch(pB + ii); }
+		};
+
+		struct OpMulAdd
+		{
+			const float *pA, *pB, *pC;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VMAdd(L::Load(pA + ii), L::Load(pB + ii), L::Load(pC + ii)); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); Stream::Prefetch(pB + ii); Stream::Prefetch(pC + ii); }
+		};
+
+		struct OpScale
+		{
+			const float *pA;
+			Vec4 s;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VMul(L::Load(pA + ii), s); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); }
+		};
+
+		struct OpScaleAdd
+		{
+			const float *pA, *pB;
+			Vec4 s;
+
+			template <typename L> inline Vec4 Eval(int ii) const { return VMAdd(L::Load(pA + ii), s, L::Load(pB + ii)); }
+			inline void Prefetch(int ii) const { Stream::Prefetch(pA + ii); Stream::Prefetch(pB + ii); }
+		};
+
+		// pDest = pA + pB
+		inline void Add(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpAdd op = { pA, pB };
+			Transform(pDest, op, count);
+		}
+
+		inline void AddNT(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpAdd op = { pA, pB };
+			TransformNT(pDest, op, count);
+		}
+
+		// pDest = pA - pB
+		inline void Sub(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpSub op = { pA, pB };
+			Transform(pDest, op, count);
+		}
+
+		inline void SubNT(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpSub op = { pA, pB };
+			TransformNT(pDest, op, count);
+		}
+
+		// pDest = pA * pB
+		inline void Mul(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpMul op = { pA, pB };
+			Transform(pDest, op, count);
+		}
+
+		inline void MulNT(float *pDest, const float *pA, const float *pB, int count)
+		{
+			OpMul op = { pA, pB };
+			TransformNT(pDest, op, count);
+		}
+
+		// pDest = pA * pB + pC
+		inline void MulAdd(float *pDest, const float *pA, const float *pB, const float *pC, int count)
+		{
+			OpMulAdd op = { pA, pB, pC };
+			Transform(pDest, op, count);
+		}
+
+		inline void MulAddNT(float *pDest, const float *pA, const float *pB, const float *pC, int count)
+		{
+			OpMulAdd op = { pA, pB, pC };
+			TransformNT(pDest, op, count);
+		}
+
+		// pDest = pA * s
+		inline void Scale(float *pDest, const float *pA, float s, int count)
+		{
+			OpScale op = { pA, VReplicate(s) };
+			Transform(pDest, op, count);
+		}
+
+		inline void ScaleNT(float *pDest, const float *pA, float s, int count)
+		{
+			OpScale op = { pA, VReplicate(s) };
+			TransformNT(pDest, op, count);
+		}
+
+		// pDest = pA * s + pB
+		inline void ScaleAdd(float *pDest, const float *pA, float s, const float *pB, int count)
+		{
+			OpScaleAdd op = { pA, pB, VReplicate(s) };
+			Transform(pDest, op, count);
+		}
+
+		inline void ScaleAddNT(float *pDest, const float *pA, float s, const float *pB, int count)
+		{
+			OpScaleAdd op = { pA, pB, VReplicate(s) };
+			TransformNT(pDest, op, count);
+		}
+
+		// sum of pA[ii]*pB[ii], four partial sums in the body
+		inline float Dot(const float *pA, const float *pB, int count)
+		{
+			Vec4 sum0 = _mm_setzero_ps();
+			Vec4 sum1 = _mm_setzero_ps();
+			Vec4 sum2 = _mm_setzero_ps();
+			Vec4 sum3 = _mm_setzero_ps();
+			int ii = 0;
+			int head = HeadCount(pA, count);
+
+			for(; ii<head; ii++)
+			{
+				sum0 = VMAdd(_mm_load_ss(pA + ii), _mm_load_ss(pB + ii), sum0);
+			}
+
+			for(; ii+16<=count; ii+=16)
+			{
+				Prefetch(pA + ii);
+				Prefetch(pB + ii);
+
+				sum0 = VMAdd(_mm_load_ps(pA + ii), _mm_loadu_ps(pB + ii), sum0);
+				sum1 = VMAdd(_mm_load_ps(pA + ii + 4), _mm_loadu_ps(pB + ii + 4), sum1);
+				sum2 = VMAdd(_mm_load_ps(pA + ii + 8), _mm_loadu_ps(pB + ii + 8), sum2);
+				sum3 = VMAdd(_mm_load_ps(pA + ii + 12), _mm_loadu_ps(pB + ii + 12), sum3);
+			}
+
+			for(; ii+4<=count; ii+=4)
+			{
+				sum0 = VMAdd(_mm_load_ps(pA + ii), _mm_loadu_ps(pB + ii), sum0);
+			}
+
+			for(; ii<count; ii++)
+			{
+				sum0 = VMAdd(_mm_load_ss(pA + ii), _mm_load_ss(pB + ii), sum0);
+			}
+
+			float dot;
+
+			GetX(&dot, VMATH::Dot(VAdd(VAdd(sum0, sum1), VAdd(sum2, sum3)), VConst<0x3f800000>()));
+
+			return(dot);
+		}
+
+		// reductions for ReduceT: Init is the identity, Step folds
+		// one vector in, Combine merges two accumulators, H the 4
+		// lanes. Min/Max load the head/tail broadcast (LoadB), the
+		// zeros of _mm_load_ss would win.
+		struct LoadB { static inline Vec4 Load(const float *p) { return _mm_load1_ps(p); } };
+
+		struct RedSum
+		{
+			typedef LoadS Tail;
+			static inline Vec4 Init() { return _mm_setzero_ps(); }
+			static inline Vec4 Step(Vec4 acc, Vec4 v) { return VAdd(acc, v); }
+			static inline Vec4 Combine(Vec4 va, Vec4 vb) { return VAdd(va, vb); }
+			static inline Vec4 H(Vec4 v) { return HSum(v); }
+		};
+
+		struct RedSumSquares
+		{
+			typedef LoadS Tail;
+			static inline Vec4 Init() { return _mm_setzero_ps(); }
+			static inline Vec4 Step(Vec4 acc, Vec4 v) { return VMAdd(v, v, acc); }
+			static inline Vec4 Combine(Vec4 va, Vec4 vb) { return VAdd(va, vb); }
+			static inline Vec4 H(Vec4 v) { return HSum(v); }
+		};
+
+		struct RedMin
+		{
+			typedef LoadB Tail;
+			static inline Vec4 Init() { return VConst<0x7f800000>(); }
+			static inline Vec4 Step(Vec4 acc, Vec4 v) { return VMin(acc, v); }
+			static inline Vec4 Combine(Vec4 va, Vec4 vb) { return VMin(va, vb); }
+			static inline Vec4 H(Vec4 v) { return HMin(v); }
+		};
+
+		struct RedMax
+		{
+			typedef LoadB Tail;
+			static inline Vec4 Init() { return VConst<0xff800000>(); }
+			static inline Vec4 Step(Vec4 acc, Vec4 v) { return VMax(acc, v); }
+			static inline Vec4 Combine(Vec4 va, Vec4 vb) { return VMax(va, vb); }
+			static inline Vec4 H(Vec4 v) { return HMax(v); }
+		};
+
+		// |x| >= 0, so the zeros of _mm_load_ss are harmless
+		struct RedPeak
+		{
+			typedef LoadS Tail;
+			static inline Vec4 Init() { return _mm_setzero_ps(); }
+			static inline Vec4 Step(Vec4 acc, Vec4 v) { return VMax(acc, VAbs(v)); }
+			static inline Vec4 Combine(Vec4 va, Vec4 vb) { return VMax(va, vb); }
+			static inline Vec4 H(Vec4 v) { return HMax(v); }
+		};
+
+		// Red over pA[0, count), four independent accumulators in
+		// the body so a Step does not wait on the one before it,
+		// merged as a tree at the end. The result is in all 4 lanes.
+		template <typename Red>
+		inline Vec4 ReduceT(const float *pA, int count)
+		{
+			Vec4 acc0 = Red::Init();
+			Vec4 acc1 = acc0;
+			Vec4 acc2 = acc0;
+			Vec4 acc3 = acc0;
+			int ii = 0;
+			int head = HeadCount(pA, count);
+
+			for(; ii<head; ii++)
+			{
+				acc0 = Red::Step(acc0, Red::Tail::Load(pA + ii));
+			}
+
+			for(; ii+16<=count; ii+=16)
+			{
+				Prefetch(pA + ii);
+
+				acc0 = Red::Step(acc0, _mm_load_ps(pA + ii));
+				acc1 = Red::Step(acc1, _mm_load_ps(pA + ii + 4));
+				acc2 = Red::Step(acc2, _mm_load_ps(pA + ii + 8));
+				acc3 = Red::Step(acc3, _mm_load_ps(pA + ii + 12));
+			}
+
+			for(; ii+4<=count; ii+=4)
+			{
+				acc0 = Red::Step(acc0, _mm_load_ps(pA + ii));
+			}
+
+			for(; ii<count; ii++)
+			{
+				acc0 = Red::Step(acc0, Red::Tail::Load(pA + ii));
+			}
+
+			return(Red::H(Red::Combine(Red::Combine(acc0, acc1), Red::Combine(acc2, acc3))));
+		}
+
+		template <typename Red>
+		inline float Reduce(const float *pA, int count)
+		{
+			float r;
+
+			GetX(&r, ReduceT<Red>(pA, count));
+
+			return(r);
+		}
+
+		// sum, energy (sum of squares), min, max and peak (max |x|) of
+		// pA[0, count). Min/Max of nothing are +inf/-inf.
+		inline float Sum(const float *pA, int count) { return Reduce<RedSum>(pA, count); }
+		inline float SumSquares(const float *pA, int count) { return Reduce<RedSumSquares>(pA, count); }
+		inline float Min(const float *pA, int count) { return Reduce<RedMin>(pA, count); }
+		inline float Max(const float *pA, int count) { return Reduce<RedMax>(pA, count); }
+		inline float Peak(const float *pA, int count) { return Reduce<RedPeak>(pA, count); }
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	//	Overloaded operators, left here just as a reference.
 	//	WARNING: This bloats the code as expressions grow
+	//	GCC/Clang provide them natively for __m128 and reject user overloads
 	////////////////////////////////////////////////////////////////////////////////
+#if !defined(__GNUC__)
 	inline Vec4 operator+(Vec4 va, Vec4 vb)
 	{
 		return(VAdd(va, vb));
@@ -200,6 +1533,7 @@ namespace VMATH
 		va = VDiv(va, vb);
 		return (va);
 	}
+#endif // #if !defined(__GNUC__)
 }
 
 #endif // #ifndef __VMATH__
\ No newline at end of file
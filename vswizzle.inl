@@ -0,0 +1,323 @@
+//--------------------------------------------------------------------------------------
+// File: vswizzle.inl
+//
+// Compile time lane reordering, included inside VMATH (vmath.h), VCLASS (vclass.h),
+// VCLASS_TYPEDEF (vclass_typedef.h) and VCLASS_SIMDTYPE (vclass_simdtype.h) like
+// vtranscendental.inl.
+//
+//	VSwizzle<X,Y,Z,W>(v)		(v[X], v[Y], v[Z], v[W])
+//	VPermute<X,Y,Z,W>(a, b)		lanes 0-3 are a, 4-7 are b (XMVectorPermute order)
+//
+// The pattern picks the instruction:
+//
+//	<0,1,2,3>						nothing
+//	<0,0,1,1> <2,2,3,3>				unpcklps / unpckhps
+//	<0,0,2,2> <1,1,3,3>				movsldup / movshdup (SSE3)
+//	<0,1,0,1> <2,3,2,3>				movlhps / movhlps (__m128)
+//	<0,0,0,0>						vbroadcastss (__m128, AVX2)
+//	any other swizzle				vpermilps (AVX), shufps
+//
+//	a a b b, b b a a				one shufps
+//	<0,4,1,5> <2,6,3,7> and b a		unpcklps / unpckhps
+//	<0,1,4,5> <4,5,0,1>				movlhps (__m128)
+//	<2,3,6,7> <6,7,2,3>				movhlps (__m128)
+//	every lane in place				blendps (SSE4.1), and/andnot/or
+//	any other permute				a swizzle of each, then the blend
+//
+// pshufd is left out, it would move the floats to the integer domain and back. __m256
+// and __m512 get the same patterns in every 128 bit lane, the way shufps works there.
+//--------------------------------------------------------------------------------------
+
+	///////////////////////////////////////////
+	// Register ops
+	///////////////////////////////////////////
+
+	template <typename V>
+	struct VSwizzleOps;
+
+	template <>
+	struct VSwizzleOps<__m128>
+	{
+		template <int Imm>
+		static inline __m128 Shuffle(__m128 a, __m128 b) { return _mm_shuffle_ps(a, b, Imm); }
+
+		template <int Imm>
+		static inline __m128 Permute(__m128 a)
+		{
+		#if defined(__AVX__)
+			return _mm_permute_ps(a, Imm);
+		#else
+			return _mm_shuffle_ps(a, a, Imm);
+		#endif
+		}
+
+		static inline __m128 UnpackLo(__m128 a, __m128 b) { return _mm_unpacklo_ps(a, b); }
+		static inline __m128 UnpackHi(__m128 a, __m128 b) { return _mm_unpackhi_ps(a, b); }
+
+		static inline __m128 DupEven(__m128 a)
+		{
+		#if defined(__SSE3__) || defined(__AVX__)
+			return _mm_moveldup_ps(a);
+		#else
+			return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,2,0,0));
+		#endif
+		}
+
+		static inline __m128 DupOdd(__m128 a)
+		{
+		#if defined(__SSE3__) || defined(__AVX__)
+			return _mm_movehdup_ps(a);
+		#else
+			return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,1,1));
+		#endif
+		}
+
+		// lane i from b where bit i of Mask is set
+		template <int Mask>
+		static inline __m128 Blend(__m128 a, __m128 b)
+		{
+		#if defined(__SSE4_1__) || defined(__AVX__)
+			return _mm_blend_ps(a, b, Mask);
+		#else
+			const __m128 m = _mm_castsi128_ps(_mm_setr_epi32(-(Mask & 1), -((Mask >> 1) & 1), -((Mask >> 2) & 1), -((Mask >> 3) & 1)));
+
+			return _mm_or_ps(_mm_andnot_ps(m, a), _mm_and_ps(m, b));
+		#endif
+		}
+	};
+
+#if defined(__AVX__)
+	template <>
+	struct VSwizzleOps<__m256>
+	{
+		template <int Imm>
+		static inline __m256 Shuffle(__m256 a, __m256 b) { return _mm256_shuffle_ps(a, b, Imm); }
+
+		template <int Imm>
+		static inline __m256 Permute(__m256 a) { return _mm256_permute_ps(a, Imm); }
+
+		static inline __m256 UnpackLo(__m256 a, __m256 b) { return _mm256_unpacklo_ps(a, b); }
+		static inline __m256 UnpackHi(__m256 a, __m256 b) { return _mm256_unpackhi_ps(a, b); }
+		static inline __m256 DupEven(__m256 a) { return _mm256_moveldup_ps(a); }
+		static inline __m256 DupOdd(__m256 a) { return _mm256_movehdup_ps(a); }
+
+		template <int Mask>
+		static inline __m256 Blend(__m256 a, __m256 b) { return _mm256_blend_ps(a, b, Mask | (Mask << 4)); }
+	};
+#endif
+
+#if defined(__AVX512F__)
+	template <>
+	struct VSwizzleOps<__m512>
+	{
+		template <int Imm>
+		static inline __m512 Shuffle(__m512 a, __m512 b) { return _mm512_shuffle_ps(a, b, Imm); }
+
+		template <int Imm>
+		static inline __m512 Permute(__m512 a) { return _mm512_permute_ps(a, Imm); }
+
+		static inline __m512 UnpackLo(__m512 a, __m512 b) { return _mm512_unpacklo_ps(a, b); }
+		static inline __m512 UnpackHi(__m512 a, __m512 b) { return _mm512_unpackhi_ps(a, b); }
+		static inline __m512 DupEven(__m512 a) { return _mm512_moveldup_ps(a); }
+		static inline __m512 DupOdd(__m512 a) { return _mm512_movehdup_ps(a); }
+
+		template <int Mask>
+		static inline __m512 Blend(__m512 a, __m512 b) { return _mm512_mask_blend_ps((__mmask16)(Mask*0x1111), a, b); }
+	};
+#endif
+
+	///////////////////////////////////////////
+	// Swizzle
+	///////////////////////////////////////////
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VSwizzleSel
+	{
+		static inline V Apply(const V& v) { return VSwizzleOps<V>::template Permute<_MM_SHUFFLE(W,Z,Y,X)>(v); }
+	};
+
+	template <typename V>
+	struct VSwizzleSel<V,0,1,2,3>
+	{
+		static inline V Apply(const V& v) { return v; }
+	};
+
+	template <typename V>
+	struct VSwizzleSel<V,0,0,1,1>
+	{
+		static inline V Apply(const V& v) { return VSwizzleOps<V>::UnpackLo(v, v); }
+	};
+
+	template <typename V>
+	struct VSwizzleSel<V,2,2,3,3>
+	{
+		static inline V Apply(const V& v) { return VSwizzleOps<V>::UnpackHi(v, v); }
+	};
+
+	template <typename V>
+	struct VSwizzleSel<V,0,0,2,2>
+	{
+		static inline V Apply(const V& v) { return VSwizzleOps<V>::DupEven(v); }
+	};
+
+	template <typename V>
+	struct VSwizzleSel<V,1,1,3,3>
+	{
+		static inline V Apply(const V& v) { return VSwizzleOps<V>::DupOdd(v); }
+	};
+
+	template <>
+	struct VSwizzleSel<__m128,0,1,0,1>
+	{
+		static inline __m128 Apply(const __m128& v) { return _mm_movelh_ps(v, v); }
+	};
+
+	template <>
+	struct VSwizzleSel<__m128,2,3,2,3>
+	{
+		static inline __m128 Apply(const __m128& v) { return _mm_movehl_ps(v, v); }
+	};
+
+#if defined(__AVX2__)
+	template <>
+	struct VSwizzleSel<__m128,0,0,0,0>
+	{
+		static inline __m128 Apply(const __m128& v) { return _mm_broadcastss_ps(v); }
+	};
+#endif
+
+	template <int X, int Y, int Z, int W, typename V>
+	inline V VSwizzle(const V& v)
+	{
+		return VSwizzleSel<V,X,Y,Z,W>::Apply(v);
+	}
+
+	///////////////////////////////////////////
+	// Permute
+	///////////////////////////////////////////
+
+	enum
+	{
+		VPERMUTE_A,				// a only
+		VPERMUTE_B,				// b only
+		VPERMUTE_AB,			// a a b b
+		VPERMUTE_BA,			// b b a a
+		VPERMUTE_BLEND,			// every lane in place
+		VPERMUTE_ANY
+	};
+
+	template <int X, int Y, int Z, int W>
+	struct VPermuteKind
+	{
+		enum
+		{
+			// bit i set: lane i comes from b
+			fromB = ((X >> 2) & 1) | ((Y >> 1) & 2) | (Z & 4) | ((W << 1) & 8),
+			inPlace = (X & 3) == 0 && (Y & 3) == 1 && (Z & 3) == 2 && (W & 3) == 3,
+
+			value = fromB == 0 ? VPERMUTE_A :
+					fromB == 15 ? VPERMUTE_B :
+					fromB == 12 ? VPERMUTE_AB :
+					fromB == 3 ? VPERMUTE_BA :
+					inPlace ? VPERMUTE_BLEND : VPERMUTE_ANY
+		};
+	};
+
+	template <typename V, int Kind, int X, int Y, int Z, int W>
+	struct VPermuteOp
+	{
+		static inline V Apply(const V& a, const V& b)
+		{
+			return VSwizzleOps<V>::template Blend<VPermuteKind<X,Y,Z,W>::fromB>(VSwizzle<X & 3, Y & 3, Z & 3, W & 3>(a), VSwizzle<X & 3, Y & 3, Z & 3, W & 3>(b));
+		}
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteOp<V,VPERMUTE_A,X,Y,Z,W>
+	{
+		static inline V Apply(const V& a, const V&) { return VSwizzle<X,Y,Z,W>(a); }
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteOp<V,VPERMUTE_B,X,Y,Z,W>
+	{
+		static inline V Apply(const V&, const V& b) { return VSwizzle<X & 3, Y & 3, Z & 3, W & 3>(b); }
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteOp<V,VPERMUTE_AB,X,Y,Z,W>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::template Shuffle<_MM_SHUFFLE(W & 3, Z & 3, Y, X)>(a, b); }
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteOp<V,VPERMUTE_BA,X,Y,Z,W>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::template Shuffle<_MM_SHUFFLE(W, Z, Y & 3, X & 3)>(b, a); }
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteOp<V,VPERMUTE_BLEND,X,Y,Z,W>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::template Blend<VPermuteKind<X,Y,Z,W>::fromB>(a, b); }
+	};
+
+	template <typename V, int X, int Y, int Z, int W>
+	struct VPermuteSel
+	{
+		static inline V Apply(const V& a, const V& b) { return VPermuteOp<V,VPermuteKind<X,Y,Z,W>::value,X,Y,Z,W>::Apply(a, b); }
+	};
+
+	template <typename V>
+	struct VPermuteSel<V,0,4,1,5>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::UnpackLo(a, b); }
+	};
+
+	template <typename V>
+	struct VPermuteSel<V,4,0,5,1>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::UnpackLo(b, a); }
+	};
+
+	template <typename V>
+	struct VPermuteSel<V,2,6,3,7>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::UnpackHi(a, b); }
+	};
+
+	template <typename V>
+	struct VPermuteSel<V,6,2,7,3>
+	{
+		static inline V Apply(const V& a, const V& b) { return VSwizzleOps<V>::UnpackHi(b, a); }
+	};
+
+	template <>
+	struct VPermuteSel<__m128,0,1,4,5>
+	{
+		static inline __m128 Apply(const __m128& a, const __m128& b) { return _mm_movelh_ps(a, b); }
+	};
+
+	template <>
+	struct VPermuteSel<__m128,4,5,0,1>
+	{
+		static inline __m128 Apply(const __m128& a, const __m128& b) { return _mm_movelh_ps(b, a); }
+	};
+
+	template <>
+	struct VPermuteSel<__m128,2,3,6,7>
+	{
+		static inline __m128 Apply(const __m128& a, const __m128& b) { return _mm_movehl_ps(b, a); }
+	};
+
+	template <>
+	struct VPermuteSel<__m128,6,7,2,3>
+	{
+		static inline __m128 Apply(const __m128& a, const __m128& b) { return _mm_movehl_ps(a, b); }
+	};
+
+	template <int X, int Y, int Z, int W, typename V>
+	inline V VPermute(const V& a, const V& b)
+	{
+		return VPermuteSel<V,X,Y,Z,W>::Apply(a, b);
+	}
@@ -0,0 +1,513 @@
+//--------------------------------------------------------------------------------------
+// File: vtranscendental.inl
+//
+// Sin, Cos, SinCos, Exp, Log, Pow and Atan2 on a SIMD register, included inside VMATH
+// (vmath.h) and VCLASS_SIMDTYPE (vclass_simdtype.h) like vclass_expr.inl.
+//
+// The algorithms are the Cephes single precision ones (sinf, cosf, expf, logf, atanf):
+// Cody-Waite range reduction followed by a short minimax polynomial, with branches
+// replaced by selects. Each function is written once as a template on the register
+// type, VTransOps<V> holds the instructions that differ between __m128, __m256 and
+// __m512 (the wide ones exist when the unit is compiled for AVX2 / AVX-512F).
+//
+// Max error against the double libm result (simd_bench -demo trans, SSE2 and FMA builds):
+//
+//	Sin, Cos, SinCos	|x| <= 8192					2.3 ulp
+//	Exp					-87 <= x <= 88				1.3 ulp
+//	Log					x > 0						0.8 ulp
+//	Pow					0.01 <= x <= 100, |y| <= 8	1.9 ulp, grows with |y|
+//	Atan2				finite y, x					2.6 ulp
+//
+// Out of range: Sin/Cos lose bits past |x| = 8192 and are garbage past 2^31 or for
+// inf/NaN. Exp gives 0 below -104 and inf above 88.72, Log gives NaN for x < 0,
+// -inf for 0 and inf for inf. Pow gives NaN for x < 0 (integer y included), follows
+// libm for x = +-0 (-0 to an odd integer y keeps its sign), x = inf, y = 0 and x = 1,
+// and is garbage for |y| past 2^20.
+// Atan2(0, 0) is 0 and Atan2(+-inf, +-inf) is +-pi/4 or +-3pi/4, as in libm, a NaN
+// operand gives an unspecified result.
+//--------------------------------------------------------------------------------------
+
+	///////////////////////////////////////////
+	// Register ops
+	///////////////////////////////////////////
+
+	template <typename V>
+	struct VTransOps;
+
+	template <>
+	struct VTransOps<__m128>
+	{
+		typedef __m128		mask_type;
+		typedef __m128i		int_type;
+
+		static inline __m128 Splat(float f) { return _mm_set1_ps(f); }
+		static inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+		static inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+		static inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+		static inline __m128 Div(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+		static inline __m128 Min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }		// b if either is NaN
+		static inline __m128 Max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+		static inline __m128 And(__m128 a, __m128 b) { return _mm_and_ps(a, b); }
+		static inline __m128 Or(__m128 a, __m128 b) { return _mm_or_ps(a, b); }
+		static inline __m128 Xor(__m128 a, __m128 b) { return _mm_xor_ps(a, b); }
+
+		// a*b + c, c - a*b
+		static inline __m128 MAdd(__m128 a, __m128 b, __m128 c)
+		{
+		#if defined(SIMD_FMA)
+			return _mm_fmadd_ps(a, b, c);
+		#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+		#endif
+		}
+
+		static inline __m128 NMSub(__m128 a, __m128 b, __m128 c)
+		{
+		#if defined(SIMD_FMA)
+			return _mm_fnmadd_ps(a, b, c);
+		#else
+			return _mm_sub_ps(c, _mm_mul_ps(a, b));
+		#endif
+		}
+
+		static inline mask_type Lt(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
+		static inline mask_type Gt(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+		static inline mask_type Eq(__m128 a, __m128 b) { return _mm_cmpeq_ps(a, b); }
+
+		// m ? a : b
+		static inline __m128 Select(mask_type m, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+		// sign bit set (-0 included)
+		static inline mask_type Negative(__m128 a) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(a), 31)); }
+
+		static inline int_type SplatI(int i) { return _mm_set1_epi32(i); }
+		static inline int_type Round(__m128 a) { return _mm_cvtps_epi32(a); }
+		static inline __m128 ToFloat(int_type i) { return _mm_cvtepi32_ps(i); }
+		static inline __m128 AsFloat(int_type i) { return _mm_castsi128_ps(i); }
+		static inline int_type AsInt(__m128 a) { return _mm_castps_si128(a); }
+		static inline int_type AddI(int_type a, int_type b) { return _mm_add_epi32(a, b); }
+		static inline int_type SubI(int_type a, int_type b) { return _mm_sub_epi32(a, b); }
+		static inline int_type AndI(int_type a, int_type b) { return _mm_and_si128(a, b); }
+		static inline int_type SllI(int_type a, int n) { return _mm_slli_epi32(a, n); }
+		static inline int_type SraI(int_type a, int n) { return _mm_srai_epi32(a, n); }
+		static inline int_type SrlI(int_type a, int n) { return _mm_srli_epi32(a, n); }
+
+		// all of bits set in i
+		static inline mask_type TestI(int_type i, int bits) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, _mm_set1_epi32(bits)), _mm_set1_epi32(bits))); }
+	};
+
+#if defined(__AVX2__)
+	template <>
+	struct VTransOps<__m256>
+	{
+		typedef __m256		mask_type;
+		typedef __m256i		int_type;
+
+		static inline __m256 Splat(float f) { return _mm256_set1_ps(f); }
+		static inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+		static inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+		static inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+		static inline __m256 Div(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+		static inline __m256 Min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+		static inline __m256 Max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+		static inline __m256 And(__m256 a, __m256 b) { return _mm256_and_ps(a, b); }
+		static inline __m256 Or(__m256 a, __m256 b) { return _mm256_or_ps(a, b); }
+		static inline __m256 Xor(__m256 a, __m256 b) { return _mm256_xor_ps(a, b); }
+
+		static inline __m256 MAdd(__m256 a, __m256 b, __m256 c)
+		{
+		#if defined(SIMD_FMA)
+			return _mm256_fmadd_ps(a, b, c);
+		#else
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+		#endif
+		}
+
+		static inline __m256 NMSub(__m256 a, __m256 b, __m256 c)
+		{
+		#if defined(SIMD_FMA)
+			return _mm256_fnmadd_ps(a, b, c);
+		#else
+			return _mm256_sub_ps(c, _mm256_mul_ps(a, b));
+		#endif
+		}
+
+		static inline mask_type Lt(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static inline mask_type Gt(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static inline mask_type Eq(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+
+		static inline __m256 Select(mask_type m, __m256 a, __m256 b) { return _mm256_blendv_ps(b, a, m); }
+
+		static inline mask_type Negative(__m256 a) { return _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(a), 31)); }
+
+		static inline int_type SplatI(int i) { return _mm256_set1_epi32(i); }
+		static inline int_type Round(__m256 a) { return _mm256_cvtps_epi32(a); }
+		static inline __m256 ToFloat(int_type i) { return _mm256_cvtepi32_ps(i); }
+		static inline __m256 AsFloat(int_type i) { return _mm256_castsi256_ps(i); }
+		static inline int_type AsInt(__m256 a) { return _mm256_castps_si256(a); }
+		static inline int_type AddI(int_type a, int_type b) { return _mm256_add_epi32(a, b); }
+		static inline int_type SubI(int_type a, int_type b) { return _mm256_sub_epi32(a, b); }
+		static inline int_type AndI(int_type a, int_type b) { return _mm256_and_si256(a, b); }
+		static inline int_type SllI(int_type a, int n) { return _mm256_slli_epi32(a, n); }
+		static inline int_type SraI(int_type a, int n) { return _mm256_srai_epi32(a, n); }
+		static inline int_type SrlI(int_type a, int n) { return _mm256_srli_epi32(a, n); }
+
+		static inline mask_type TestI(int_type i, int bits) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(i, _mm256_set1_epi32(bits)), _mm256_set1_epi32(bits))); }
+	};
+#endif // #if defined(__AVX2__)
+
+#if defined(__AVX512F__)
+	// AVX-512F only: the float and/or/xor are AVX-512DQ, so they go through the integer ops
+	template <>
+	struct VTransOps<__m512>
+	{
+		typedef __mmask16	mask_type;
+		typedef __m512i		int_type;
+
+		static inline __m512 Splat(float f) { return _mm512_set1_ps(f); }
+		static inline __m512 Add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+		static inline __m512 Sub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+		static inline __m512 Mul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+		static inline __m512 Div(__m512 a, __m512 b) { return _mm512_div_ps(a, b); }
+		static inline __m512 Min(__m512 a, __m512 b) { return _mm512_min_ps(a, b); }
+		static inline __m512 Max(__m512 a, __m512 b) { return _mm512_max_ps(a, b); }
+		static inline __m512 And(__m512 a, __m512 b) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b))); }
+		static inline __m512 Or(__m512 a, __m512 b) { return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a), _mm512_castps_si512(b))); }
+		static inline __m512 Xor(__m512 a, __m512 b) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b))); }
+		static inline __m512 MAdd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+		static inline __m512 NMSub(__m512 a, __m512 b, __m512 c) { return _mm512_fnmadd_ps(a, b, c); }
+
+		static inline mask_type Lt(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		static inline mask_type Gt(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+		static inline mask_type Eq(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+
+		static inline __m512 Select(mask_type m, __m512 a, __m512 b) { return _mm512_mask_blend_ps(m, b, a); }
+
+		static inline mask_type Negative(__m512 a) { return _mm512_test_epi32_mask(_mm512_castps_si512(a), _mm512_set1_epi32(0x80000000)); }
+
+		static inline int_type SplatI(int i) { return _mm512_set1_epi32(i); }
+		static inline int_type Round(__m512 a) { return _mm512_cvtps_epi32(a); }
+		static inline __m512 ToFloat(int_type i) { return _mm512_cvtepi32_ps(i); }
+		static inline __m512 AsFloat(int_type i) { return _mm512_castsi512_ps(i); }
+		static inline int_type AsInt(__m512 a) { return _mm512_castps_si512(a); }
+		static inline int_type AddI(int_type a, int_type b) { return _mm512_add_epi32(a, b); }
+		static inline int_type SubI(int_type a, int_type b) { return _mm512_sub_epi32(a, b); }
+		static inline int_type AndI(int_type a, int_type b) { return _mm512_and_si512(a, b); }
+		static inline int_type SllI(int_type a, int n) { return _mm512_slli_epi32(a, n); }
+		static inline int_type SraI(int_type a, int n) { return _mm512_srai_epi32(a, n); }
+		static inline int_type SrlI(int_type a, int n) { return _mm512_srli_epi32(a, n); }
+
+		static inline mask_type TestI(int_type i, int bits) { return _mm512_cmpeq_epi32_mask(_mm512_and_si512(i, _mm512_set1_epi32(bits)), _mm512_set1_epi32(bits)); }
+	};
+#endif // #if defined(__AVX512F__)
+
+	///////////////////////////////////////////
+	// sin/cos: x = q*pi/2 + r, |r| <= pi/4, both polynomials on r
+	// and q picks and signs them
+	///////////////////////////////////////////
+
+	template <typename V>
+	inline void VTransSinCos(V x, V* pSin, V* pCos)
+	{
+		typedef VTransOps<V>				O;
+		typedef typename O::int_type		I;
+		typedef typename O::mask_type		M;
+
+		// pi/2 in four parts, q*DP1, q*DP2 and q*DP3 are exact for |q| < 2^13
+		const float	cDP1 = 1.5703125f;
+		const float	cDP2 = 4.837512969970703125e-4f;
+		const float	cDP3 = 7.54953362047672271729e-8f;
+		const float	cDP4 = 2.56334406825708960298e-12f;
+
+		I q = O::Round(O::Mul(x, O::Splat(0.636619772367581343f)));
+		V fq = O::ToFloat(q);
+
+		V r = O::NMSub(fq, O::Splat(cDP1), x);
+		r = O::NMSub(fq, O::Splat(cDP2), r);
+		r = O::NMSub(fq, O::Splat(cDP3), r);
+		r = O::NMSub(fq, O::Splat(cDP4), r);
+
+		V r2 = O::Mul(r, r);
+
+		// sin(r) = r + r^3*S(r^2)
+		V ps = O::MAdd(O::Splat(-1.9515295891e-4f), r2, O::Splat(8.3321608736e-3f));
+		ps = O::MAdd(ps, r2, O::Splat(-1.6666654611e-1f));
+		ps = O::MAdd(O::Mul(ps, r2), r, r);
+
+		// cos(r) = 1 - r^2/2 + r^4*C(r^2)
+		V pc = O::MAdd(O::Splat(2.443315711809948e-5f), r2, O::Splat(-1.388731625493765e-3f));
+		pc = O::MAdd(pc, r2, O::Splat(4.166664568298827e-2f));
+		pc = O::MAdd(O::Mul(pc, r2), r2, O::NMSub(O::Splat(0.5f), r2, O::Splat(1.f)));
+
+		// q&1 swaps sin and cos, q&2 negates sin, (q+1)&2 negates cos
+		M swap = O::TestI(q, 1);
+		V signSin = O::AsFloat(O::SllI(O::AndI(q, O::SplatI(2)), 30));
+		V signCos = O::AsFloat(O::SllI(O::AndI(O::AddI(q, O::SplatI(1)), O::SplatI(2)), 30));
+
+		*pSin = O::Xor(O::Select(swap, pc, ps), signSin);
+		*pCos = O::Xor(O::Select(swap, ps, pc), signCos);
+	}
+
+	template <typename V>
+	inline V VTransSin(V x)
+	{
+		V s, c;
+
+		VTransSinCos(x, &s, &c);
+
+		return s;
+	}
+
+	template <typename V>
+	inline V VTransCos(V x)
+	{
+		V s, c;
+
+		VTransSinCos(x, &s, &c);
+
+		return c;
+	}
+
+	///////////////////////////////////////////
+	// exp: x = n*ln2 + r, |r| <= ln2/2, exp(x) = 2^n * exp(r)
+	///////////////////////////////////////////
+
+	// exp(x) * (1 + c) * 2^k, c a small correction to x, k an integer float, n + k
+	// is clamped to [-252, 254] so the result overflows to inf and underflows
+	// through the denormals to 0
+	template <typename V>
+	inline V VTransExpScaled(V x, V c, V k)
+	{
+		typedef VTransOps<V>				O;
+		typedef typename O::int_type		I;
+
+		V fn = O::ToFloat(O::Round(O::Mul(x, O::Splat(1.44269504088896341f))));
+
+		// ln2 in two parts
+		V r = O::NMSub(fn, O::Splat(0.693359375f), x);
+		r = O::NMSub(fn, O::Splat(-2.12194440e-4f), r);
+
+		V p = O::MAdd(O::Splat(1.9875691500e-4f), r, O::Splat(1.3981999507e-3f));
+		p = O::MAdd(p, r, O::Splat(8.3334519073e-3f));
+		p = O::MAdd(p, r, O::Splat(4.1665795894e-2f));
+		p = O::MAdd(p, r, O::Splat(1.6666665459e-1f));
+		p = O::MAdd(p, r, O::Splat(5.0000001201e-1f));
+		p = O::MAdd(p, O::Mul(r, r), O::Add(r, O::Splat(1.f)));
+		p = O::MAdd(p, c, p);
+
+		// 2^(n+k) as two normal powers of two
+		I n = O::Round(O::Min(O::Splat(254.f), O::Max(O::Splat(-252.f), O::Add(fn, k))));
+		I n1 = O::SraI(n, 1);
+		I n2 = O::SubI(n, n1);
+		V s1 = O::AsFloat(O::SllI(O::AddI(n1, O::SplatI(127)), 23));
+		V s2 = O::AsFloat(O::SllI(O::AddI(n2, O::SplatI(127)), 23));
+
+		return O::Mul(O::Mul(p, s1), s2);
+	}
+
+	template <typename V>
+	inline V VTransExp(V x)
+	{
+		typedef VTransOps<V>				O;
+
+		// Max(lo, x), Min(hi, x) keep a NaN x
+		x = O::Min(O::Splat(88.8f), O::Max(O::Splat(-104.f), x));
+
+		return VTransExpScaled(x, O::Splat(0.f), O::Splat(0.f));
+	}
+
+	///////////////////////////////////////////
+	// log: x = m*2^e, sqrt(1/2) <= m < sqrt(2), log(x) = e*ln2 + log(m)
+	///////////////////////////////////////////
+
+	// e, m - 1 and log(m) - (m - 1) of a positive finite x
+	template <typename V>
+	inline void VTransLogReduce(V x, V* pE, V* pM, V* pY)
+	{
+		typedef VTransOps<V>				O;
+		typedef typename O::int_type		I;
+		typedef typename O::mask_type		M;
+
+		// denormals are scaled by 2^23 first
+		M denormal = O::Lt(x, O::Splat(1.17549435e-38f));
+		V xn = O::Mul(x, O::Select(denormal, O::Splat(8388608.f), O::Splat(1.f)));
+
+		I bits = O::AsInt(xn);
+		V e = O::Sub(O::ToFloat(O::SrlI(bits, 23)), O::Select(denormal, O::Splat(126.f + 23.f), O::Splat(126.f)));
+
+		// m in [0.5, 1)
+		V m = O::AsFloat(O::AddI(O::AndI(bits, O::SplatI(0x007fffff)), O::SplatI(0x3f000000)));
+
+		// m < sqrt(1/2): m = 2m - 1, e - 1, else m - 1
+		M small = O::Lt(m, O::Splat(0.707106781186547524f));
+		e = O::Sub(e, O::Select(small, O::Splat(1.f), O::Splat(0.f)));
+		m = O::Sub(O::Add(m, O::Select(small, m, O::Splat(0.f))), O::Splat(1.f));
+
+		V z = O::Mul(m, m);
+
+		V p = O::MAdd(O::Splat(7.0376836292e-2f), m, O::Splat(-1.1514610310e-1f));
+		p = O::MAdd(p, m, O::Splat(1.1676998740e-1f));
+		p = O::MAdd(p, m, O::Splat(-1.2420140846e-1f));
+		p = O::MAdd(p, m, O::Splat(1.4249322787e-1f));
+		p = O::MAdd(p, m, O::Splat(-1.6668057665e-1f));
+		p = O::MAdd(p, m, O::Splat(2.0000714765e-1f));
+		p = O::MAdd(p, m, O::Splat(-2.4999993993e-1f));
+		p = O::MAdd(p, m, O::Splat(3.3333331174e-1f));
+
+		*pE = e;
+		*pM = m;
+		*pY = O::NMSub(O::Splat(0.5f), z, O::Mul(O::Mul(p, m), z));
+	}
+
+	template <typename V>
+	inline V VTransLog(V x)
+	{
+		typedef VTransOps<V>				O;
+
+		V e, m, y;
+
+		VTransLogReduce(x, &e, &m, &y);
+
+		// ln2 in two parts, the big one last
+		y = O::MAdd(e, O::Splat(-2.12194440e-4f), y);
+
+		V res = O::Add(m, y);
+		res = O::MAdd(e, O::Splat(0.693359375f), res);
+
+		// x < 0 and NaN: NaN, 0: -inf, inf: inf
+		const V inf = O::AsFloat(O::SplatI(0x7f800000));
+
+		res = O::Select(O::Gt(x, O::Splat(0.f)), res, O::AsFloat(O::SplatI(0x7fc00000)));
+		res = O::Select(O::Eq(x, O::Splat(0.f)), O::Sub(O::Splat(0.f), inf), res);
+		res = O::Select(O::Eq(x, inf), inf, res);
+
+		return res;
+	}
+
+	///////////////////////////////////////////
+	// pow: x^y = 2^(y*e) * exp(y*log(m)). y*e is split into an integer n
+	// and a fraction without rounding (y is cut into two 12 bit halves),
+	// so the error grows with |y*log(m)| <= 0.35*|y| instead of |y*log(x)|.
+	// y*log(m) keeps the bits the float sums and products drop and hands
+	// them to exp as a correction, what's left is mostly the log polynomial
+	///////////////////////////////////////////
+
+	// a + b = s + *pErr exactly (Knuth's two sum), s is returned
+	template <typename V>
+	inline V VTransTwoSum(V a, V b, V* pErr)
+	{
+		typedef VTransOps<V>				O;
+
+		V s = O::Add(a, b);
+		V bb = O::Sub(s, a);
+
+		*pErr = O::Add(O::Sub(a, O::Sub(s, bb)), O::Sub(b, bb));
+
+		return s;
+	}
+
+	template <typename V>
+	inline V VTransPow(V x, V y)
+	{
+		typedef VTransOps<V>				O;
+		typedef typename O::int_type		I;
+
+		V e, m, ly;
+
+		VTransLogReduce(x, &e, &m, &ly);
+
+		// y*e = n + f exactly: yh*e and yl*e have at most 20 bits
+		V yh = O::And(y, O::AsFloat(O::SplatI(0xfffff000)));
+		V yl = O::Sub(y, yh);
+		V ye = O::Mul(yh, e);
+		V n = O::ToFloat(O::Round(ye));
+		V f = O::MAdd(yl, e, O::Sub(ye, n));
+
+		// log(m) = lh + ll, the sum of m and the small ly kept to 48 bits
+		V lh = O::Add(m, ly);
+		V ll = O::Sub(ly, O::Sub(lh, m));
+
+		// y*lh = ph + pl, ph = yh*lh with lh cut to 12 bits is exact
+		V lhh = O::And(lh, O::AsFloat(O::SplatI(0xfffff000)));
+		V ph = O::Mul(yh, lhh);
+		V pl = O::MAdd(yh, O::Sub(lh, lhh), O::MAdd(yl, lh, O::Mul(y, ll)));
+
+		// u = ph + f*ln2 + pl, the rounding errors of the two sums in ue, |y| past
+		// 2^20 or so is out of range
+		V ue, ue2;
+		V u = VTransTwoSum(ph, O::Mul(f, O::Splat(0.693147180559945309f)), &ue);
+		u = VTransTwoSum(u, pl, &ue2);
+		u = O::Min(O::Splat(1.e6f), O::Max(O::Splat(-1.e6f), u));
+
+		// exp(u + ue + ue2) = exp(u)*(1 + ue + ue2)
+		V res = VTransExpScaled(u, O::Add(ue, ue2), n);
+
+		// x = inf, x = 0, x < 0, NaN, then the exact ones: y = 0 or x = 1 give 1
+		const V zero = O::Splat(0.f);
+		const V one = O::Splat(1.f);
+		const V inf = O::AsFloat(O::SplatI(0x7f800000));
+
+		// -0 keeps its sign for an odd integer y: bit 0 of y shifted to the sign bit
+		I yi = O::Round(y);
+		V odd = O::Select(O::Eq(O::ToFloat(yi), y), O::AsFloat(O::SllI(yi, 31)), zero);
+
+		res = O::Select(O::Eq(x, inf), O::Select(O::Gt(y, zero), inf, zero), res);
+		res = O::Select(O::Eq(x, zero), O::Or(O::Select(O::Gt(y, zero), zero, inf), O::And(x, odd)), res);
+		res = O::Select(O::Lt(x, zero), O::AsFloat(O::SplatI(0x7fc00000)), res);
+		res = O::Select(O::Eq(x, x), res, x);
+		res = O::Select(O::Eq(y, y), res, y);
+		res = O::Select(O::Eq(y, zero), one, res);
+		res = O::Select(O::Eq(x, one), one, res);
+
+		return res;
+	}
+
+	///////////////////////////////////////////
+	// atan2: atan of min(|x|,|y|)/max(|x|,|y|) in [0, 1], then reflected
+	// into the octant of (x, y)
+	///////////////////////////////////////////
+
+	template <typename V>
+	inline V VTransAtan2(V y, V x)
+	{
+		typedef VTransOps<V>				O;
+		typedef typename O::mask_type		M;
+
+		const V sign = O::Splat(-0.f);
+		const V one = O::Splat(1.f);
+		const V inf = O::AsFloat(O::SplatI(0x7f800000));
+
+		V ax = O::Xor(x, O::And(x, sign));
+		V ay = O::Xor(y, O::And(y, sign));
+		V hi = O::Max(ax, ay);
+		V lo = O::Min(ax, ay);
+
+		// 0/0 is 0, inf/inf is 1
+		V z = O::Div(lo, hi);
+		z = O::Select(O::Eq(hi, O::Splat(0.f)), O::Splat(0.f), z);
+		z = O::Select(O::Eq(lo, inf), one, z);
+
+		// z > tan(pi/8): atan(z) = pi/4 + atan((z-1)/(z+1))
+		M big = O::Gt(z, O::Splat(0.414213562373095f));
+		z = O::Select(big, O::Div(O::Sub(z, one), O::Add(z, one)), z);
+
+		V z2 = O::Mul(z, z);
+
+		V p = O::MAdd(O::Splat(8.05374449538e-2f), z2, O::Splat(-1.38776856032e-1f));
+		p = O::MAdd(p, z2, O::Splat(1.99777106478e-1f));
+		p = O::MAdd(p, z2, O::Splat(-3.33329491539e-1f));
+		p = O::MAdd(O::Mul(p, z2), z, z);
+
+		// the octant of (|x|, |y|) makes the angle k*pi/4 +- p: |y| > |x| gives
+		// pi/2 - a, x < 0 gives pi - a, both pi/2 + a, with a = p or pi/4 + p
+		V flip = O::Xor(O::Select(O::Gt(ay, ax), sign, O::Splat(0.f)), O::Select(O::Negative(x), sign, O::Splat(0.f)));
+		V k = O::Select(O::Gt(ay, ax), O::Splat(2.f), O::Select(O::Negative(x), O::Splat(4.f), O::Splat(0.f)));
+		k = O::Add(k, O::Xor(O::Select(big, one, O::Splat(0.f)), flip));
+
+		// k*pi/4 in the three parts of sinf, k*DP1..k*DP3 are exact, added smallest first
+		V res = O::MAdd(k, O::Splat(3.77489497744594108e-8f), O::Xor(p, flip));
+		res = O::MAdd(k, O::Splat(2.4187564849853515625e-4f), res);
+		res = O::MAdd(k, O::Splat(0.78515625f), res);
+
+		return O::Or(res, O::And(y, sign));
+	}
@@ -71,13 +71,16 @@ HRESULT PlayChannels(void);
 IXAudio2*					g_pXAudio2 = NULL;
 IXAudio2MasteringVoice*		g_pMasteringVoice = NULL;
 
-__declspec(align(128))		EQ_XNAMATH::EQSTATE g_eqXNAMath;
-__declspec(align(128))		EQ_VMATH::EQSTATE g_eqVMath;
-__declspec(align(128))		EQ_VCLASS::EQSTATE g_eqVClass;
-__declspec(align(128))		EQ_VCLASS_TYPEDEF::EQSTATE g_eqVClassTypedef;
-__declspec(align(128))		EQ_VCLASS_SIMDTYPE::EQSTATE g_eqVClassSIMDType;
+extern EQ_XNAMATH::EQSTATE*			g_pEqXNAMath;
+extern EQ_VMATH::EQSTATE*			g_pEqVMath;
+extern EQ_VCLASS::EQSTATE*			g_pEqVClass;
+extern EQ_VCLASS_TYPEDEF::EQSTATE*	g_pEqVClassTypedef;
+extern EQ_VCLASS_SIMDTYPE::EQSTATE*	g_pEqVClassSIMDType;
 
-__declspec(align(128))		AudioSampleStruct	g_AudioSample = {0};
+extern __declspec(align(128))		AudioSampleStruct	g_AudioSample;
+
+//address space LoadPCM reserves for the sample buffers, only what is used is backed
+static const size_t	cAudioSampleReserve = 256*1024*1024;
 
 //--------------------------------------------------------------------------------------
 // Init XAudio2
@@ -132,14 +135,7 @@ HRESULT ShutdownXAudio2(void)
 
     SAFE_RELEASE( g_pXAudio2 );
 
-	for(int ii=0; ii<4; ii++)
-	{
-		free( g_AudioSample.pWavDataSrc[ii] );
-		free( g_AudioSample.pWavDataDest[ii] );
-	}
-
-	free( g_AudioSample.pSIMDWavDataSrc );
-	free( g_AudioSample.pSIMDWavDataDest );
+	AudioSampleShutDown();
 
 
     CoUninitialize();
@@ -198,6 +194,13 @@ HRESULT LoadPCM( IXAudio2* pXaudio2)
 		L"Media\\Wavs\\article_trumpet_16b.wav",
 	};
 
+	//the wav copies and the SIMD samples share one region, the 4 tracks take ~80 MB
+	if (!AudioSampleInit(cAudioSampleReserve, false))
+	{
+		wprintf( L"Failed to reserve %u MB for the samples\n", (UINT)(cAudioSampleReserve >> 20) );
+		return E_OUTOFMEMORY;
+	}
+
     //
     // Locate the wave file
     //
@@ -229,12 +232,18 @@ HRESULT LoadPCM( IXAudio2* pXaudio2)
 		DWORD cbWaveSize = wav.GetSize();
 
 		// Read the sample data into memory
-		BYTE* pbWaveData = new BYTE[ cbWaveSize ];
+		BYTE* pbWaveData = (BYTE*)AudioSampleAlloc( cbWaveSize );
+		BYTE* pbWaveDest = (BYTE*)AudioSampleAlloc( cbWaveSize );
+
+		if( !pbWaveData || !pbWaveDest )
+		{
+			wprintf( L"Out of sample memory for %s\n", strFilePath );
+			return E_OUTOFMEMORY;
+		}
 	
 		if( FAILED( hr = wav.Read( pbWaveData, cbWaveSize, &cbWaveSize ) ) )
 		{
 			wprintf( L"Failed to read WAV data: %#X\n", hr );
-			SAFE_DELETE_ARRAY( pbWaveData );
 			return hr;
 		}
 
@@ -242,13 +251,12 @@ HRESULT LoadPCM( IXAudio2* pXaudio2)
 		if( FAILED( hr = pXaudio2->CreateSourceVoice( &g_AudioSample.pSourceVoice[ii], pwfx ) ) )
 		{
 			wprintf( L"Error %#X creating source voice\n", hr );
-			SAFE_DELETE_ARRAY( pbWaveData );
 			return hr;
 		}
 
 		//save src & dest voice for audio processing
 		g_AudioSample.pWavDataSrc[ii] = pbWaveData;
-		g_AudioSample.pWavDataDest[ii] = new BYTE[ cbWaveSize ];
+		g_AudioSample.pWavDataDest[ii] = pbWaveDest;
 		memcpy(g_AudioSample.pWavDataDest[ii], g_AudioSample.pWavDataSrc[ii], cbWaveSize);
 
 		g_AudioSample.wavSize[ii] = cbWaveSize;
@@ -265,55 +273,11 @@ HRESULT LoadPCM( IXAudio2* pXaudio2)
 		{
 			wprintf( L"Error %#X submitting source buffer\n", hr );
 			g_AudioSample.pSourceVoice[ii]->DestroyVoice();
-			SAFE_DELETE_ARRAY( g_AudioSample.pWavDataSrc[ii] );
-			SAFE_DELETE_ARRAY( g_AudioSample.pWavDataDest[ii] );
 			return hr;
 		}
 	}
 	
-	{
-		using namespace	VMATH;
-		Vec4 lg = VLoad(1.f);
-		Vec4 mg	= VLoad(1.f);
-		Vec4 hg = VLoad(1.f);
-
-		EQ_VMATH::init_3band_state(&g_eqVMath,880,5000,44100);
-	}
-
-	{
-		XMVECTOR lg = XMVectorReplicate(1.f);
-		XMVECTOR mg	= XMVectorReplicate(1.f);
-		XMVECTOR hg = XMVectorReplicate(1.f);
-
-		EQ_XNAMATH::init_3band_state(&g_eqXNAMath,880,5000,44100);
-	}
-
-	{
-		using namespace	VCLASS;
-		Vec4 lg = Vec4(1.f);
-		Vec4 mg	= Vec4(1.f);
-		Vec4 hg = Vec4(1.f);
-
-		EQ_VCLASS::init_3band_state(&g_eqVClass,880,5000,44100);
-	}
-
-	{
-		using namespace	VCLASS;
-		Vec4 lg = Vec4(1.f);
-		Vec4 mg	= Vec4(1.f);
-		Vec4 hg = Vec4(1.f);
-
-		EQ_VCLASS_TYPEDEF::init_3band_state(&g_eqVClassTypedef,880,5000,44100);
-	}
-
-	{
-		using namespace	VCLASS;
-		Vec4 lg = Vec4(1.f);
-		Vec4 mg	= Vec4(1.f);
-		Vec4 hg = Vec4(1.f);
-
-		EQ_VCLASS_SIMDTYPE::init_3band_state(&g_eqVClassSIMDType,880,5000,44100);
-	}
+	InitEQStates();
 
 	//store source data SIMD friendly (assuming all channels have the same data size)
 	for(int ii=0; ii<3; ii++)
@@ -321,32 +285,12 @@ HRESULT LoadPCM( IXAudio2* pXaudio2)
 		assert (g_AudioSample.wavSize[ii] == g_AudioSample.wavSize[ii+1]);
 	}
 
-	int samples = g_AudioSample.wavSize[0] / 2; 
-
-	//original samples stored as 16-bit so it takes twice as much in 32-bit floats
-	g_AudioSample.pSIMDWavDataSrc = new __m128[ samples ];	
-	g_AudioSample.pSIMDWavDataDest = new __m128[ samples ];	
-
-	//shuffle the data to be SIMD friendly
-	short*	bass	= (short*)g_AudioSample.pWavDataSrc[0];
-	short*	guitar	= (short*)g_AudioSample.pWavDataSrc[1];
-	short*	drums	= (short*)g_AudioSample.pWavDataSrc[2];
-	short*	trumpet	= (short*)g_AudioSample.pWavDataSrc[3];
-
-	__m128	*pSIMD = (__m128*)g_AudioSample.pSIMDWavDataSrc;
-
-	for(int jj=0; jj<samples; jj++)
+	if( FAILED( hr = AudioSampleInterleave(g_AudioSample.wavSize[0] / 2) ) )
 	{
-		float b = (float)bass[jj];
-		float g = (float)guitar[jj];
-		float d = (float)drums[jj];
-		float t = (float)trumpet[jj];
-
-		pSIMD[jj] = _mm_set_ps(b, g, d, t);
+		wprintf( L"Out of sample memory for the SIMD samples\n" );
+		return hr;
 	}
 
-	memcpy(g_AudioSample.pSIMDWavDataDest, g_AudioSample.pSIMDWavDataSrc, samples*16);
-
 	return (hr);
 }
 
@@ -357,70 +301,72 @@ void UpdateEQ( float *pGainArr)
 {
 	int	gi = 0;
 
+	//the EQ states come with the samples, none before LoadPCM
+	if (!g_pEqVMath)
+	{
+		return;
+	}
+
 	{
 		using namespace	VMATH;
 
 		int ch = 0;
-		g_eqVMath.lg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVMath->lg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVMath.mg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVMath->mg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVMath.hg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVMath->hg = VLoad(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 	}
 
 	{
 		int ch = 0;
-		g_eqXNAMath.lg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqXNAMath->lg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqXNAMath.mg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqXNAMath->mg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqXNAMath.hg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqXNAMath->hg = _mm_set_ps(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 	}
 
 	{
 		using namespace	VCLASS;
 
 		int ch = 0;
-		g_eqVClass.lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClass->lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClass.mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClass->mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClass.hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClass->hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 	}
 
 	{
 		using namespace	VCLASS_TYPEDEF;
 
 		int ch = 0;
-		g_eqVClassTypedef.lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassTypedef->lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClassTypedef.mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassTypedef->mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClassTypedef.hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassTypedef->hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 	}
 
 	{
 		using namespace	VCLASS_SIMDTYPE;
 
 		int ch = 0;
-		g_eqVClassSIMDType.lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassSIMDType->lg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClassSIMDType.mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassSIMDType->mg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 		ch++;
-		g_eqVClassSIMDType.hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
+		g_pEqVClassSIMDType->hg = Vec4(pGainArr[ch], pGainArr[ch+3], pGainArr[ch+6], pGainArr[ch+9]);
 	}
 
 }
 
 //--------------------------------------------------------------------------------------
-// 
+// Sample window [beg, end] around the current play position
 //--------------------------------------------------------------------------------------
-double ProcessAudioVClass(int audioFrames)
+void GetAudioWindow(int audioFrames, int *pBeg, int *pEnd)
 {
-	using namespace VCLASS;
-
-	PerformanceCounterStart();
-
 	//use 1st channel as master window (all channels have the same # of samples)
     XAUDIO2_VOICE_STATE state;
 	g_AudioSample.pSourceVoice[0]->GetState( &state );
@@ -442,42 +388,36 @@ double ProcessAudioVClass(int audioFrames)
 		beg = 0;
 	}
 
-	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
-	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
-	Vec4 base(32768.f);
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		//loads
-		Vec4 sampleIn = pSrc[ii];
-		sampleIn = sampleIn / base;
+	*pBeg = beg;
+	*pEnd = end;
+}
 
-		Vec4 sampleOut = EQ_VCLASS::do_3band(&g_eqVClass, sampleIn);
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+double ProcessAudioXNAMath(int audioFrames)
+{
+	PerformanceCounterStart();
 
-		//denormalize
-		sampleOut = sampleOut*base;
+	int beg, end;
+	GetAudioWindow(audioFrames, &beg, &end);
 
-		//stores
-		pDest[ii] = sampleOut;
-	}
+	ProcessAudioBlockXNAMath(beg, end);
 
-	//unshuffle and send it to the data channels
-	short *pAudioDest0 = (short*)g_AudioSample.pWavDataDest[0];
-	short *pAudioDest1 = (short*)g_AudioSample.pWavDataDest[1];
-	short *pAudioDest2 = (short*)g_AudioSample.pWavDataDest[2];
-	short *pAudioDest3 = (short*)g_AudioSample.pWavDataDest[3];
+	return(PerformanceCounterEnd());
+}
 
-	for(int ii=beg; ii<=end; ii++)
-	{
-		__declspec(align(128))	float s[4];
+//--------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------
+double ProcessAudioVClass(int audioFrames)
+{
+	PerformanceCounterStart();
 
-		pDest[ii].Store(s);
+	int beg, end;
+	GetAudioWindow(audioFrames, &beg, &end);
 
-		pAudioDest0[ii] = (short)s[0];
-		pAudioDest1[ii] = (short)s[1];
-		pAudioDest2[ii] = (short)s[2];
-		pAudioDest3[ii] = (short)s[3];
-	}
+	ProcessAudioBlockVClass(beg, end);
 
 	return(PerformanceCounterEnd());
 }
@@ -487,67 +427,12 @@ double ProcessAudioVClass(int audioFrames)
 //--------------------------------------------------------------------------------------
 double ProcessAudioVClassTypedef(int audioFrames)
 {
-	using namespace VCLASS_TYPEDEF;
-
 	PerformanceCounterStart();
 
-	//use 1st channel as master window (all channels have the same # of samples)
-    XAUDIO2_VOICE_STATE state;
-	g_AudioSample.pSourceVoice[0]->GetState( &state );
+	int beg, end;
+	GetAudioWindow(audioFrames, &beg, &end);
 
-	int					samples			= g_AudioSample.wavSize[0] / 2;
-	unsigned __int64	samplesPlayed	= state.SamplesPlayed;
-	int					currSample		= int (samplesPlayed % (unsigned __int64)samples);
-
-	int beg = currSample-audioFrames;
-	int end = currSample+audioFrames;
-
-	if (end > samples - 1)
-	{
-		end = samples - 1;
-	}
-
-	if (beg < 0)
-	{
-		beg = 0;
-	}
-
-	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
-	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
-	Vec4 base(32768.f);
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		//loads
-		Vec4 sampleIn = pSrc[ii];
-		sampleIn = sampleIn / base;
-
-		Vec4 sampleOut = EQ_VCLASS_TYPEDEF::do_3band(&g_eqVClassTypedef, sampleIn);
-
-		//denormalize
-		sampleOut = sampleOut*base;
-
-		//stores
-		pDest[ii] = sampleOut;
-	}
-
-	//unshuffle and send it to the data channels
-	short *pAudioDest0 = (short*)g_AudioSample.pWavDataDest[0];
-	short *pAudioDest1 = (short*)g_AudioSample.pWavDataDest[1];
-	short *pAudioDest2 = (short*)g_AudioSample.pWavDataDest[2];
-	short *pAudioDest3 = (short*)g_AudioSample.pWavDataDest[3];
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		__declspec(align(128))	float s[4];
-
-		pDest[ii].Store(s);
-
-		pAudioDest0[ii] = (short)s[0];
-		pAudioDest1[ii] = (short)s[1];
-		pAudioDest2[ii] = (short)s[2];
-		pAudioDest3[ii] = (short)s[3];
-	}
+	ProcessAudioBlockVClassTypedef(beg, end);
 
 	return(PerformanceCounterEnd());
 }
@@ -557,67 +442,12 @@ double ProcessAudioVClassTypedef(int audioFrames)
 //--------------------------------------------------------------------------------------
 double ProcessAudioVClassSIMDType(int audioFrames)
 {
-	using namespace VCLASS_SIMDTYPE;
-
 	PerformanceCounterStart();
 
-	//use 1st channel as master window (all channels have the same # of samples)
-    XAUDIO2_VOICE_STATE state;
-	g_AudioSample.pSourceVoice[0]->GetState( &state );
-
-	int					samples			= g_AudioSample.wavSize[0] / 2;
-	unsigned __int64	samplesPlayed	= state.SamplesPlayed;
-	int					currSample		= int (samplesPlayed % (unsigned __int64)samples);
+	int beg, end;
+	GetAudioWindow(audioFrames, &beg, &end);
 
-	int beg = currSample-audioFrames;
-	int end = currSample+audioFrames;
-
-	if (end > samples - 1)
-	{
-		end = samples - 1;
-	}
-
-	if (beg < 0)
-	{
-		beg = 0;
-	}
-
-	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
-	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
-	Vec4 base(32768.f);
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		//loads
-		Vec4 sampleIn = pSrc[ii];
-		sampleIn = sampleIn / base;
-
-		Vec4 sampleOut = EQ_VCLASS_SIMDTYPE::do_3band(&g_eqVClassSIMDType, sampleIn);
-
-		//denormalize
-		sampleOut = sampleOut*base;
-
-		//stores
-		pDest[ii] = sampleOut;
-	}
-
-	//unshuffle and send it to the data channels
-	short *pAudioDest0 = (short*)g_AudioSample.pWavDataDest[0];
-	short *pAudioDest1 = (short*)g_AudioSample.pWavDataDest[1];
-	short *pAudioDest2 = (short*)g_AudioSample.pWavDataDest[2];
-	short *pAudioDest3 = (short*)g_AudioSample.pWavDataDest[3];
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		__declspec(align(128))	float s[4];
-
-		pDest[ii].Store(s);
-
-		pAudioDest0[ii] = (short)s[0];
-		pAudioDest1[ii] = (short)s[1];
-		pAudioDest2[ii] = (short)s[2];
-		pAudioDest3[ii] = (short)s[3];
-	}
+	ProcessAudioBlockVClassSIMDType(beg, end);
 
 	return(PerformanceCounterEnd());
 }
@@ -627,69 +457,12 @@ double ProcessAudioVClassSIMDType(int audioFrames)
 //--------------------------------------------------------------------------------------
 double ProcessAudioVMath(int audioFrames)
 {
-	using namespace VMATH;
-
 	PerformanceCounterStart();
 
-	//use 1st channel as master window (all channels have the same # of samples)
-    XAUDIO2_VOICE_STATE state;
-	g_AudioSample.pSourceVoice[0]->GetState( &state );
+	int beg, end;
+	GetAudioWindow(audioFrames, &beg, &end);
 
-	int					samples			= g_AudioSample.wavSize[0] / 2;
-	unsigned __int64	samplesPlayed	= state.SamplesPlayed;
-	int					currSample		= int (samplesPlayed % (unsigned __int64)samples);
-
-	int beg = currSample-audioFrames;
-	int end = currSample+audioFrames;
-
-	if (end > samples - 1)
-	{
-		end = samples - 1;
-	}
-
-	if (beg < 0)
-	{
-		beg = 0;
-	}
-
-	Vec4 *pSrc = (Vec4*)g_AudioSample.pSIMDWavDataSrc;
-	Vec4 *pDest = (Vec4*)g_AudioSample.pSIMDWavDataDest;
-	Vec4 base = VLoad(32768.f);
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		//loads
-		Vec4 sampleIn = pSrc[ii];
-
-		//normalize
-		sampleIn = VDiv(sampleIn, base);
-
-		Vec4 sampleOut = EQ_VMATH::do_3band(&g_eqVMath, sampleIn);
-
-		//denormalize
-		sampleOut = VMul(sampleOut, base);
-
-		//stores
-		pDest[ii] = sampleOut;
-	}
-
-	//unshuffle and send it to the data channels
-	short *pAudioDest0 = (short*)g_AudioSample.pWavDataDest[0];
-	short *pAudioDest1 = (short*)g_AudioSample.pWavDataDest[1];
-	short *pAudioDest2 = (short*)g_AudioSample.pWavDataDest[2];
-	short *pAudioDest3 = (short*)g_AudioSample.pWavDataDest[3];
-
-	for(int ii=beg; ii<=end; ii++)
-	{
-		__declspec(align(128))	float s[4];
-
-		VStore(s, pDest[ii]);
-
-		pAudioDest0[ii] = (short)s[0];
-		pAudioDest1[ii] = (short)s[1];
-		pAudioDest2[ii] = (short)s[2];
-		pAudioDest3[ii] = (short)s[3];
-	}
+	ProcessAudioBlockVMath(beg, end);
 
 	return(PerformanceCounterEnd());
 }